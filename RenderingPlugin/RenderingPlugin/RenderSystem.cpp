@@ -110,6 +110,15 @@ void RenderSystem::ProcessDeviceEvent(UnityGfxDeviceEventType type, IUnityInterf
         config_2.ensureActiveRenderTextureIsBound = true;
         s_d3d12->ConfigureEvent(2, &config_2);
 
+        // Sharc 占用统计只录制拷贝命令，不需要绑定渲染目标
+        UnityD3D12PluginEventConfig config_3;
+        config_3.graphicsQueueAccess = kUnityD3D12GraphicsQueueAccess_DontCare;
+        config_3.flags = kUnityD3D12EventConfigFlag_SyncWorkerThreads |
+            kUnityD3D12EventConfigFlag_ModifiesCommandBuffersState |
+            kUnityD3D12EventConfigFlag_EnsurePreviousFrameSubmission;
+        config_3.ensureActiveRenderTextureIsBound = false;
+        s_d3d12->ConfigureEvent(3, &config_3);
+
         // initialize_and_create_resources();
         break;
     case kUnityGfxDeviceEventShutdown:
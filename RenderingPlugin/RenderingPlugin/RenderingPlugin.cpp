@@ -5,6 +5,7 @@
 #include "RenderSystem.h"
 #include "NrdInstance.h"
 #include "RRFrameData.h"
+#include "SharcCacheInstance.h"
 #include "Unity/IUnityLog.h"
 
 
@@ -29,6 +30,10 @@ namespace
     std::mutex g_DLRRInstanceMutex;
     int32_t g_DLRRNextInstanceId = 1;
 
+    std::unordered_map<int32_t, SharcCacheInstance*> g_SharcInstances;
+    std::mutex g_SharcInstanceMutex;
+    int32_t g_SharcNextInstanceId = 1;
+
 
     // 图形设备事件回调
     void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType eventType)
@@ -49,6 +54,10 @@ namespace
             for (auto& pair : g_NrdInstances) delete pair.second;
             g_NrdInstances.clear();
 
+            std::scoped_lock sharcLock(g_SharcInstanceMutex);
+            for (auto& pair : g_SharcInstances) delete pair.second;
+            g_SharcInstances.clear();
+
             RenderSystem::Get().Shutdown();
         }
     }
@@ -79,6 +88,18 @@ namespace
                 it->second->DispatchCompute(frameData);
             }
         }
+        else if (eventID == 3)
+        {
+            // Sharc 占用统计读回
+            SharcFrameData* frameData = static_cast<SharcFrameData*>(data);
+
+            std::scoped_lock lock(g_SharcInstanceMutex);
+            auto it = g_SharcInstances.find(frameData->instanceId);
+            if (it != g_SharcInstances.end())
+            {
+                it->second->CollectStats(frameData);
+            }
+        }
     }
 }
 
@@ -176,4 +197,45 @@ void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UpdateDenoiserResources(
         it->second->UpdateResources(resources, count);
     }
 }
+
+// ================= Sharc 容量管理 =================
+// settings 为空时使用默认值
+UNITY_INTERFACE_EXPORT int UNITY_INTERFACE_API CreateSharcCacheInstance(const SharcCapacitySettings* settings, uint32_t initialCapacity)
+{
+    std::scoped_lock lock(g_SharcInstanceMutex);
+    int id = g_SharcNextInstanceId++;
+    g_SharcInstances[id] = new SharcCacheInstance(s_UnityInterfaces, id, settings ? *settings : SharcCapacitySettings{}, initialCapacity);
+    return id;
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroySharcCacheInstance(int id)
+{
+    std::scoped_lock lock(g_SharcInstanceMutex);
+    auto it = g_SharcInstances.find(id);
+    if (it != g_SharcInstances.end())
+    {
+        delete it->second;
+        g_SharcInstances.erase(it);
+    }
+}
+
+UNITY_INTERFACE_EXPORT SharcCapacityDecision UNITY_INTERFACE_API GetSharcCacheDecision(int id)
+{
+    std::scoped_lock lock(g_SharcInstanceMutex);
+    auto it = g_SharcInstances.find(id);
+    if (it == g_SharcInstances.end())
+        return {};
+    return it->second->GetDecision();
+}
+
+// C# 完成新缓冲的分配和 rehash 之后调用
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetSharcCacheCapacity(int id, uint32_t capacity)
+{
+    std::scoped_lock lock(g_SharcInstanceMutex);
+    auto it = g_SharcInstances.find(id);
+    if (it != g_SharcInstances.end())
+    {
+        it->second->SetCapacity(capacity);
+    }
+}
 }
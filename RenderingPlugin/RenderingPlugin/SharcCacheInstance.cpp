@@ -0,0 +1,171 @@
+﻿#include "SharcCacheInstance.h"
+
+#include <cstring>
+#include <string>
+
+#include "d3dx12.h"
+
+#define LOG(msg) UNITY_LOG(s_Log, msg)
+
+SharcCacheInstance::SharcCacheInstance(IUnityInterfaces* interfaces, int instanceId, const SharcCapacitySettings& settings, uint32_t initialCapacity) :
+    m_Policy(settings, initialCapacity)
+{
+    s_d3d12 = interfaces->Get<IUnityGraphicsD3D12v8>();
+    s_Log = interfaces->Get<IUnityLog>();
+    id = instanceId;
+
+    if (!CreateResources())
+    {
+        LOG(("[Sharc Native] id:" + std::to_string(id) + " - Failed to create readback buffers.").c_str());
+        ReleaseResources();
+    }
+}
+
+SharcCacheInstance::~SharcCacheInstance()
+{
+    ReleaseResources();
+}
+
+bool SharcCacheInstance::CreateResources()
+{
+    ID3D12Device* device = s_d3d12 ? s_d3d12->GetDevice() : nullptr;
+    if (!device)
+        return false;
+
+    const CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(SharcOccupancyStats));
+
+    const CD3DX12_HEAP_PROPERTIES readbackHeap(D3D12_HEAP_TYPE_READBACK);
+    for (ReadbackSlot& slot : m_Slots)
+    {
+        if (FAILED(device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&slot.buffer))))
+            return false;
+    }
+
+    const CD3DX12_HEAP_PROPERTIES uploadHeap(D3D12_HEAP_TYPE_UPLOAD);
+    if (FAILED(device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_ZeroBuffer))))
+        return false;
+
+    void* mapped = nullptr;
+    const D3D12_RANGE emptyRange = {0, 0};
+    if (FAILED(m_ZeroBuffer->Map(0, &emptyRange, &mapped)))
+        return false;
+    memset(mapped, 0, sizeof(SharcOccupancyStats));
+    m_ZeroBuffer->Unmap(0, nullptr);
+
+    return true;
+}
+
+void SharcCacheInstance::ReleaseResources()
+{
+    // 调用方保证 GPU 已经不再使用（C# Dispose 发生在渲染线程之外，且 Unity 关闭设备前会等待）
+    for (ReadbackSlot& slot : m_Slots)
+    {
+        if (slot.buffer)
+        {
+            slot.buffer->Release();
+            slot.buffer = nullptr;
+        }
+        slot.fenceValue = 0;
+    }
+
+    if (m_ZeroBuffer)
+    {
+        m_ZeroBuffer->Release();
+        m_ZeroBuffer = nullptr;
+    }
+}
+
+void SharcCacheInstance::PollReadbacks()
+{
+    ID3D12Fence* fence = s_d3d12->GetFrameFence();
+    if (!fence)
+        return;
+
+    const uint64_t completed = fence->GetCompletedValue();
+
+    // 按提交顺序读回，保证策略看到的统计是按帧递增的
+    for (;;)
+    {
+        ReadbackSlot* oldest = nullptr;
+        for (ReadbackSlot& slot : m_Slots)
+        {
+            if (slot.fenceValue != 0 && slot.fenceValue <= completed && (!oldest || slot.fenceValue < oldest->fenceValue))
+                oldest = &slot;
+        }
+        if (!oldest)
+            break;
+
+        SharcOccupancyStats stats = {};
+        void* mapped = nullptr;
+        const D3D12_RANGE readRange = {0, sizeof(SharcOccupancyStats)};
+        if (SUCCEEDED(oldest->buffer->Map(0, &readRange, &mapped)))
+        {
+            memcpy(&stats, mapped, sizeof(SharcOccupancyStats));
+            const D3D12_RANGE emptyRange = {0, 0};
+            oldest->buffer->Unmap(0, &emptyRange);
+
+            m_Policy.AddSample(stats, oldest->capacity);
+        }
+
+        oldest->fenceValue = 0;
+    }
+}
+
+void SharcCacheInstance::CollectStats(const SharcFrameData* data)
+{
+    if (data == nullptr || data->statsBuffer == nullptr || m_ZeroBuffer == nullptr)
+        return;
+
+    UnityGraphicsD3D12RecordingState recording_state;
+    if (!s_d3d12->CommandRecordingState(&recording_state))
+        return;
+
+    std::scoped_lock lock(m_Mutex);
+
+    PollReadbacks();
+
+    ReadbackSlot* freeSlot = nullptr;
+    for (ReadbackSlot& slot : m_Slots)
+    {
+        if (slot.fenceValue == 0)
+        {
+            freeSlot = &slot;
+            break;
+        }
+    }
+
+    ID3D12GraphicsCommandList* commandList = recording_state.commandList;
+
+    // 所有槽位都在等待 GPU 时跳过这一帧的统计，但仍然清零，下一帧的计数不会累加
+    s_d3d12->RequestResourceState(data->statsBuffer, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    if (freeSlot)
+    {
+        commandList->CopyBufferRegion(freeSlot->buffer, 0, data->statsBuffer, 0, sizeof(SharcOccupancyStats));
+        freeSlot->fenceValue = s_d3d12->GetNextFrameFenceValue();
+        freeSlot->capacity = data->capacity;
+    }
+    else if ((m_DroppedFrames++ & 255) == 0)
+    {
+        LOG(("[Sharc Native] id:" + std::to_string(id) + " - All readback slots busy, dropping occupancy stats.").c_str());
+    }
+
+    // CopyBufferRegion 之间需要 COPY_SOURCE -> COPY_DEST 的转换
+    const CD3DX12_RESOURCE_BARRIER toCopyDest = CD3DX12_RESOURCE_BARRIER::Transition(data->statsBuffer, D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+    commandList->ResourceBarrier(1, &toCopyDest);
+    commandList->CopyBufferRegion(data->statsBuffer, 0, m_ZeroBuffer, 0, sizeof(SharcOccupancyStats));
+    s_d3d12->NotifyResourceState(data->statsBuffer, D3D12_RESOURCE_STATE_COPY_DEST, false);
+}
+
+SharcCapacityDecision SharcCacheInstance::GetDecision()
+{
+    std::scoped_lock lock(m_Mutex);
+    return m_Policy.GetDecision();
+}
+
+void SharcCacheInstance::SetCapacity(uint32_t capacity)
+{
+    std::scoped_lock lock(m_Mutex);
+    m_Policy.SetCapacity(capacity);
+
+    LOG(("[Sharc Native] id:" + std::to_string(id) + " - Capacity changed to " + std::to_string(capacity) + ".").c_str());
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <mutex>
+#include <d3d12.h>
+
+#include "SharcCapacityPolicy.h"
+#include "SharcFrameData.h"
+
+#include "Unity/IUnityGraphicsD3D12.h"
+#include "Unity/IUnityLog.h"
+
+// 每帧把 resolve 产生的占用统计拷到 readback 缓冲，几帧之后 GPU 完成时读回并交给 SharcCapacityPolicy
+// 缓冲本身仍由 C# 分配（Unity 无法把原生创建的缓冲绑定到自己的 shader 上），C# 按 GetDecision 重新分配并 rehash
+class SharcCacheInstance
+{
+public:
+    SharcCacheInstance(IUnityInterfaces* interfaces, int instanceId, const SharcCapacitySettings& settings, uint32_t initialCapacity);
+    ~SharcCacheInstance();
+
+    void CollectStats(const SharcFrameData* data);
+
+    SharcCapacityDecision GetDecision();
+    void SetCapacity(uint32_t capacity);
+
+private:
+    static constexpr int kReadbackSlotCount = 4;
+
+    struct ReadbackSlot
+    {
+        ID3D12Resource* buffer = nullptr;
+        uint64_t fenceValue = 0;    // 为 0 表示空闲
+        uint32_t capacity = 0;
+    };
+
+    bool CreateResources();
+    void ReleaseResources();
+    void PollReadbacks();
+
+    IUnityGraphicsD3D12v8* s_d3d12 = nullptr;
+    IUnityLog* s_Log = nullptr;
+    int id;
+
+    std::mutex m_Mutex;
+    SharcCapacityPolicy m_Policy;
+
+    ReadbackSlot m_Slots[kReadbackSlotCount];
+    ID3D12Resource* m_ZeroBuffer = nullptr;     // 用于每帧清零 statsBuffer
+    uint32_t m_DroppedFrames = 0;
+};
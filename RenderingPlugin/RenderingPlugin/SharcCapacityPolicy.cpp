@@ -0,0 +1,116 @@
+﻿#include "SharcCapacityPolicy.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr uint32_t c_DefaultMinCapacity = 1u << 18;
+    constexpr uint32_t c_DefaultMaxCapacity = 1u << 23;
+    // 与 HASH_GRID_HASH_MAP_BUCKET_SIZE 一致，capacity 不能小于一个 bucket
+    constexpr uint32_t c_BucketSize = 16;
+
+    SharcCapacitySettings ResolveSettings(const SharcCapacitySettings& settings)
+    {
+        SharcCapacitySettings resolved = settings;
+        if (resolved.minCapacity == 0) resolved.minCapacity = c_DefaultMinCapacity;
+        if (resolved.maxCapacity == 0) resolved.maxCapacity = c_DefaultMaxCapacity;
+        resolved.minCapacity = SharcCapacityPolicy::RoundUpCapacity(std::max(resolved.minCapacity, c_BucketSize));
+        resolved.maxCapacity = SharcCapacityPolicy::RoundUpCapacity(std::max(std::min(resolved.maxCapacity, c_DefaultMaxCapacity), resolved.minCapacity));
+        if (resolved.growOccupancy <= 0.f || resolved.growOccupancy > 1.f) resolved.growOccupancy = 0.5f;
+        if (resolved.shrinkOccupancy <= 0.f || resolved.shrinkOccupancy >= resolved.growOccupancy) resolved.shrinkOccupancy = resolved.growOccupancy * 0.25f;
+        if (resolved.targetOccupancy <= resolved.shrinkOccupancy || resolved.targetOccupancy >= resolved.growOccupancy)
+            resolved.targetOccupancy = (resolved.shrinkOccupancy + resolved.growOccupancy) * 0.4f;
+        if (resolved.growFrames == 0) resolved.growFrames = 4;
+        if (resolved.shrinkFrames == 0) resolved.shrinkFrames = 300;
+        if (resolved.cooldownFrames == 0) resolved.cooldownFrames = 120;
+        return resolved;
+    }
+}
+
+SharcCapacityPolicy::SharcCapacityPolicy(const SharcCapacitySettings& settings, uint32_t initialCapacity) :
+    m_Settings(ResolveSettings(settings))
+{
+    m_Capacity = std::clamp(RoundUpCapacity(initialCapacity), m_Settings.minCapacity, m_Settings.maxCapacity);
+    m_RequestedCapacity = m_Capacity;
+}
+
+// 取 2 的幂，resolve 和 rehash 按 LINEAR_BLOCK_SIZE 分组时不会有不完整的组
+uint32_t SharcCapacityPolicy::RoundUpCapacity(uint32_t capacity)
+{
+    uint32_t result = 1;
+    while (result < capacity && result < (1u << 31))
+        result <<= 1;
+    return result;
+}
+
+uint32_t SharcCapacityPolicy::GetCapacityForEntries(uint64_t liveEntries) const
+{
+    const double capacity = double(liveEntries) / double(m_Settings.targetOccupancy);
+    const uint32_t clamped = uint32_t(std::min(capacity, double(m_Settings.maxCapacity)));
+    return std::clamp(RoundUpCapacity(clamped), m_Settings.minCapacity, m_Settings.maxCapacity);
+}
+
+void SharcCapacityPolicy::AddSample(const SharcOccupancyStats& stats, uint32_t capacity)
+{
+    if (capacity != m_Capacity || capacity == 0)
+        return;
+
+    const float occupancy = float(double(stats.liveEntries) / double(capacity));
+
+    m_LastStats = stats;
+    m_SampleCount++;
+    m_PeakOccupancy = std::max(m_PeakOccupancy, occupancy);
+
+    // 上一次请求还没有被执行，不再重复判断
+    if (m_RequestedCapacity != m_Capacity)
+        return;
+
+    if (occupancy > m_Settings.growOccupancy)
+    {
+        m_GrowFrames++;
+        m_ShrinkFrames = 0;
+        m_WindowMaxLiveEntries = 0;
+
+        // 满载时 liveEntries 低估了实际需求，至少翻倍，不够的话下一轮继续扩
+        if (m_GrowFrames >= m_Settings.growFrames && m_Capacity < m_Settings.maxCapacity)
+            m_RequestedCapacity = std::max(GetCapacityForEntries(stats.liveEntries), m_Capacity * 2);
+    }
+    else if (occupancy < m_Settings.shrinkOccupancy)
+    {
+        m_GrowFrames = 0;
+        m_ShrinkFrames++;
+        m_WindowMaxLiveEntries = std::max(m_WindowMaxLiveEntries, stats.liveEntries);
+
+        if (m_ShrinkFrames >= m_Settings.shrinkFrames && m_SampleCount >= m_Settings.cooldownFrames && m_Capacity > m_Settings.minCapacity)
+            m_RequestedCapacity = std::min(GetCapacityForEntries(m_WindowMaxLiveEntries), m_Capacity / 2);
+    }
+    else
+    {
+        m_GrowFrames = 0;
+        m_ShrinkFrames = 0;
+        m_WindowMaxLiveEntries = 0;
+    }
+}
+
+void SharcCapacityPolicy::SetCapacity(uint32_t capacity)
+{
+    m_Capacity = capacity;
+    m_RequestedCapacity = capacity;
+    m_SampleCount = 0;
+    m_GrowFrames = 0;
+    m_ShrinkFrames = 0;
+    m_WindowMaxLiveEntries = 0;
+    m_PeakOccupancy = 0.f;
+}
+
+SharcCapacityDecision SharcCapacityPolicy::GetDecision() const
+{
+    SharcCapacityDecision decision = {};
+    decision.capacity = m_Capacity;
+    decision.requestedCapacity = m_RequestedCapacity;
+    decision.sampleCount = m_SampleCount;
+    decision.occupancy = m_Capacity ? float(double(m_LastStats.liveEntries) / double(m_Capacity)) : 0.f;
+    decision.peakOccupancy = m_PeakOccupancy;
+    decision.lastStats = m_LastStats;
+    return decision;
+}
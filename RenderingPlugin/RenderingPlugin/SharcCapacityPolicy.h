@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// 与 SharcResolve.compute 中 gInOut_SharcStats 的布局一致，每帧 resolve 之后的计数
+struct SharcOccupancyStats
+{
+    uint32_t liveEntries;       // resolve 之后仍然有效的 entry，即 HashGridDebugOccupancy 中亮起的槽位
+    uint32_t evictedEntries;    // 本帧因 stale 被清除的 entry
+    uint32_t sampledEntries;    // 本帧收到新采样的 entry
+    uint32_t pad1;
+};
+
+// 数值为 0 时使用默认值
+struct SharcCapacitySettings
+{
+    uint32_t minCapacity;       // 默认 1 << 18
+    uint32_t maxCapacity;       // 默认 1 << 23，resolve 按 256 一组派发，1 << 24 会超过 65535 个线程组的上限
+    float growOccupancy;        // 默认 0.5，bucket 为 16 时超过这个占用率插入失败开始明显增加
+    float shrinkOccupancy;      // 默认 0.125
+    float targetOccupancy;      // 调整后期望的占用率，默认 0.25
+    uint32_t growFrames;        // 连续超过 growOccupancy 这么多帧才扩容，默认 4
+    uint32_t shrinkFrames;      // 连续低于 shrinkOccupancy 这么多帧才缩容，默认 300
+    uint32_t cooldownFrames;    // 调整之后至少这么多帧不缩容，默认 120
+};
+
+struct SharcCapacityDecision
+{
+    uint32_t capacity;          // 当前使用的 capacity
+    uint32_t requestedCapacity; // 与 capacity 不同时需要重新分配缓冲并 rehash，完成后调用 SetCapacity
+    uint32_t sampleCount;       // 当前 capacity 下已读回的帧数
+    uint32_t pad1;
+    float occupancy;            // 最近一次读回的占用率
+    float peakOccupancy;        // 当前 capacity 下的最大占用率
+    SharcOccupancyStats lastStats;
+};
+
+// 只依赖读回的统计数据，不涉及 GPU，可以用录制的占用率序列离线验证
+// 扩容和缩容的阈值相差 4 倍，capacity 每次至少翻倍或减半，调整之后占用率落在两个阈值之间，不会来回切换
+class SharcCapacityPolicy
+{
+public:
+    SharcCapacityPolicy(const SharcCapacitySettings& settings, uint32_t initialCapacity);
+
+    // capacity 为这份统计对应的 hash 表大小，resize 之前提交、之后才读回的数据与当前 capacity 不同，直接丢弃
+    void AddSample(const SharcOccupancyStats& stats, uint32_t capacity);
+
+    // 新缓冲已经分配并完成 rehash
+    void SetCapacity(uint32_t capacity);
+
+    SharcCapacityDecision GetDecision() const;
+
+    static uint32_t RoundUpCapacity(uint32_t capacity);
+
+private:
+    uint32_t GetCapacityForEntries(uint64_t liveEntries) const;
+
+    SharcCapacitySettings m_Settings;
+    uint32_t m_Capacity;
+    uint32_t m_RequestedCapacity;
+
+    uint32_t m_SampleCount = 0;
+    uint32_t m_GrowFrames = 0;
+    uint32_t m_ShrinkFrames = 0;
+    uint32_t m_WindowMaxLiveEntries = 0;    // 当前这段连续低占用期间的最大值，缩容时按它计算
+    float m_PeakOccupancy = 0.f;
+    SharcOccupancyStats m_LastStats = {};
+};
@@ -0,0 +1,15 @@
+﻿#pragma once
+#include <cstdint>
+#include <d3d12.h>
+
+#pragma pack(push, 1)
+
+// 由 C# 在 SharcResolve 之后通过 IssuePluginEventAndData(3) 传入
+struct SharcFrameData
+{
+    ID3D12Resource* statsBuffer;    // gInOut_SharcStats 的原生指针，SharcOccupancyStats 布局
+    uint32_t capacity;              // 本帧 resolve 时使用的 capacity
+    int instanceId;
+};
+
+#pragma pack(pop)
@@ -0,0 +1,258 @@
+﻿#include <cstring>
+#include <string>
+#include <vector>
+
+#include "InstanceTable.h"
+#include "TestFramework.h"
+
+namespace
+{
+    InstanceData MakeRow(uint32_t seed)
+    {
+        InstanceData row = {};
+        row.overloadedMatrix[0] = row.overloadedMatrix[5] = row.overloadedMatrix[10] = 1.f;
+        row.overloadedMatrix[3] = float(seed);
+        row.baseColorAndMetalnessScale[0] = uint16_t(0x3C00 + seed);
+        row.textureOffsetAndFlags = seed * 3;
+        row.primitiveOffset = seed * 100;
+        row.scale = 1.f;
+        return row;
+    }
+
+    // 每个 renderer 的行内容互不相同，AddRenderer 一定会标记脏行
+    uint32_t AddRenderer(InstanceTable& table, int32_t rendererId, uint32_t submeshCount)
+    {
+        std::vector<InstanceData> rows;
+        for (uint32_t i = 0; i < submeshCount; i++)
+            rows.push_back(MakeRow(uint32_t(rendererId) * 16 + i + 1));
+        return table.AddRenderer(rendererId, submeshCount, rows.data());
+    }
+
+    void MarkRowsDirty(InstanceTable& table, const std::vector<uint32_t>& rowIndices)
+    {
+        std::vector<InstanceData> rows;
+        for (uint32_t row : rowIndices)
+        {
+            InstanceData data = table.GetRows()[row];
+            data.overloadedMatrix[7] += 1.f;
+            rows.push_back(data);
+        }
+        table.UpdateRows(rowIndices.data(), rows.data(), uint32_t(rows.size()), InstanceField_Transform);
+    }
+
+    std::vector<InstanceRowRange> Collect(InstanceTable& table, uint32_t maxRanges, uint32_t mergeGap)
+    {
+        std::vector<InstanceRowRange> ranges(maxRanges);
+        ranges.resize(table.CollectDirtyRanges(ranges.data(), maxRanges, mergeGap));
+        return ranges;
+    }
+
+    bool RangesEqual(const std::vector<InstanceRowRange>& ranges, const std::vector<InstanceRowRange>& expected)
+    {
+        if (ranges.size() != expected.size())
+            return false;
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            if (ranges[i].firstRow != expected[i].firstRow || ranges[i].rowCount != expected[i].rowCount)
+                return false;
+        }
+        return true;
+    }
+
+    std::string ToString(const std::vector<InstanceRowRange>& ranges)
+    {
+        std::string text;
+        for (const InstanceRowRange& range : ranges)
+            text += "[" + std::to_string(range.firstRow) + ", +" + std::to_string(range.rowCount) + ") ";
+        return text;
+    }
+
+    // 200 行，每个 renderer 一行，加入后清空脏标记
+    void MakeCleanTable(InstanceTable& table)
+    {
+        for (int32_t i = 0; i < 200; i++)
+            AddRenderer(table, i, 1);
+        Collect(table, 256, 0);
+    }
+}
+
+TEST_CASE(InstanceTable_DirtyRangesMergeGap)
+{
+    InstanceTable table;
+    MakeCleanTable(table);
+    const std::vector<uint32_t> dirtyRows = { 0, 1, 5, 20, 62, 63, 64, 65, 66, 130 };
+
+    // 连续的脏行跨越 64 行的边界也是一个区间
+    MarkRowsDirty(table, dirtyRows);
+    std::vector<InstanceRowRange> ranges = Collect(table, 16, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 2 }, { 5, 1 }, { 20, 1 }, { 62, 5 }, { 130, 1 } }), ToString(ranges));
+
+    // 间隔 3 行：mergeGap 为 2 时分开，为 3 时合并
+    MarkRowsDirty(table, dirtyRows);
+    ranges = Collect(table, 16, 2);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 2 }, { 5, 1 }, { 20, 1 }, { 62, 5 }, { 130, 1 } }), ToString(ranges));
+
+    MarkRowsDirty(table, dirtyRows);
+    ranges = Collect(table, 16, 3);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 6 }, { 20, 1 }, { 62, 5 }, { 130, 1 } }), ToString(ranges));
+
+    MarkRowsDirty(table, dirtyRows);
+    ranges = Collect(table, 16, 62);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 67 }, { 130, 1 } }), ToString(ranges));
+
+    // 取走后脏标记清空
+    CHECK(table.GetStats().dirtyRowCount == 0);
+    CHECK(Collect(table, 16, 0).empty());
+}
+
+TEST_CASE(InstanceTable_DirtyRangesClampToMaxRanges)
+{
+    InstanceTable table;
+    MakeCleanTable(table);
+    const std::vector<uint32_t> dirtyRows = { 0, 10, 20, 30, 40, 199 };
+
+    // 最后一个区间延伸到最后一个脏行，覆盖全部脏行
+    MarkRowsDirty(table, dirtyRows);
+    std::vector<InstanceRowRange> ranges = Collect(table, 3, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 1 }, { 10, 1 }, { 20, 180 } }), ToString(ranges));
+
+    MarkRowsDirty(table, dirtyRows);
+    ranges = Collect(table, 1, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 200 } }), ToString(ranges));
+
+    // 区间数正好等于 maxRanges 时不截断
+    MarkRowsDirty(table, dirtyRows);
+    ranges = Collect(table, 6, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 1 }, { 10, 1 }, { 20, 1 }, { 30, 1 }, { 40, 1 }, { 199, 1 } }), ToString(ranges));
+
+    // 截断和合并同时发生
+    MarkRowsDirty(table, dirtyRows);
+    ranges = Collect(table, 2, 10);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 0, 41 }, { 199, 1 } }), ToString(ranges));
+
+    MarkRowsDirty(table, dirtyRows);
+    CHECK(table.CollectDirtyRanges(nullptr, 4, 0) == 0);
+    CHECK(Collect(table, 0, 0).empty());
+    // 没有输出时脏标记保留
+    CHECK(table.GetStats().dirtyRowCount == dirtyRows.size());
+}
+
+TEST_CASE(InstanceTable_FreeRangesCoalesce)
+{
+    InstanceTable table;
+    CHECK(AddRenderer(table, 1, 2) == 0);
+    CHECK(AddRenderer(table, 2, 3) == 2);
+    CHECK(AddRenderer(table, 3, 1) == 5);
+    CHECK(AddRenderer(table, 4, 4) == 6);
+    CHECK(AddRenderer(table, 5, 2) == 10);
+    Collect(table, 16, 0);
+
+    // 释放的行清零并上传
+    table.RemoveRenderer(2);
+    std::vector<InstanceRowRange> ranges = Collect(table, 16, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { 2, 3 } }), ToString(ranges));
+    const InstanceData zero = {};
+    for (uint32_t row = 2; row < 5; row++)
+        CHECK(memcmp(&table.GetRows()[row], &zero, sizeof(InstanceData)) == 0);
+
+    // [2, 5) 与 [5, 6) 合并后才放得下 4 行
+    table.RemoveRenderer(3);
+    CHECK(AddRenderer(table, 6, 4) == 2);
+    CHECK(table.GetStats().rowCount == 12);
+
+    // 先释放后一个再释放前一个：[0, 2) 与 [2, 6) 合并
+    table.RemoveRenderer(6);
+    table.RemoveRenderer(1);
+    CHECK(AddRenderer(table, 7, 6) == 0);
+
+    // 三段合并：[6, 10) 两侧都是空闲行
+    table.RemoveRenderer(7);
+    table.RemoveRenderer(5);
+    table.RemoveRenderer(4);
+    CHECK(table.GetStats().liveRowCount == 0);
+    CHECK(AddRenderer(table, 8, 12) == 0);
+    CHECK(table.GetStats().rowCount == 12);
+
+    // 没有足够大的空闲区间时在末尾追加
+    table.RemoveRenderer(8);
+    CHECK(AddRenderer(table, 9, 13) == 12);
+    CHECK(table.GetStats().rowCount == 25);
+}
+
+TEST_CASE(InstanceTable_RowsStayStable)
+{
+    InstanceTable table;
+    std::vector<uint32_t> firstRows;
+    for (int32_t i = 0; i < 64; i++)
+        firstRows.push_back(AddRenderer(table, i, 1 + uint32_t(i) % 3));
+
+    // 删除一半后再加入新的 renderer，其余 renderer 的行不变
+    for (int32_t i = 0; i < 64; i += 2)
+        table.RemoveRenderer(i);
+    for (int32_t i = 100; i < 120; i++)
+        AddRenderer(table, i, 1 + uint32_t(i) % 3);
+    for (int32_t i = 1; i < 64; i += 2)
+        CHECK_MESSAGE(table.GetFirstRow(i) == firstRows[i], "renderer " + std::to_string(i));
+    CHECK(table.GetFirstRow(0) == ~0u);
+
+    // submesh 数不变时重新加入保留原来的行，内容没有变化时不产生脏行
+    Collect(table, 1024, 0);
+    const uint32_t rowCount = table.GetStats().rowCount;
+    CHECK(AddRenderer(table, 1, 2) == firstRows[1]);
+    CHECK(table.GetStats().dirtyRowCount == 0);
+
+    std::vector<InstanceData> rows = { MakeRow(1000), MakeRow(1001) };
+    CHECK(table.AddRenderer(1, 2, rows.data()) == firstRows[1]);
+    std::vector<InstanceRowRange> ranges = Collect(table, 16, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { firstRows[1], 2 } }), ToString(ranges));
+    CHECK(table.GetStats().rowCount == rowCount);
+
+    // submesh 数变化时释放旧行重新分配
+    const uint32_t liveRowCount = table.GetStats().liveRowCount;
+    const uint32_t newFirstRow = AddRenderer(table, 3, 4);
+    CHECK(newFirstRow != ~0u);
+    CHECK(table.GetFirstRow(3) == newFirstRow);
+    CHECK(table.GetStats().liveRowCount == liveRowCount + 3);
+    const InstanceData expected = MakeRow(3 * 16 + 4);
+    CHECK(memcmp(&table.GetRows()[newFirstRow + 3], &expected, sizeof(InstanceData)) == 0);
+    CHECK(table.GetFirstRow(5) == firstRows[5]);
+}
+
+TEST_CASE(InstanceTable_FieldMaskUpdates)
+{
+    InstanceTable table;
+    const uint32_t row = AddRenderer(table, 7, 1);
+    Collect(table, 16, 0);
+    const InstanceData original = table.GetRows()[row];
+
+    // 只有材质不同，按变换更新时既不复制也不标记
+    InstanceData material = original;
+    material.baseColorAndMetalnessScale[1] = 0x3800;
+    material.textureOffsetAndFlags = 12345;
+    CHECK(table.UpdateRows(&row, &material, 1, InstanceField_Transform) == 0);
+    CHECK(table.GetStats().dirtyRowCount == 0);
+    CHECK(memcmp(&table.GetRows()[row], &original, sizeof(InstanceData)) == 0);
+
+    // 变换和几何都变化，只按变换更新时几何保持原值
+    InstanceData moved = material;
+    moved.overloadedMatrix[3] += 2.f;
+    moved.scale = 3.f;
+    moved.primitiveOffset = 777;
+    moved.compactIndexOffset = 55;
+    CHECK(table.UpdateRows(&row, &moved, 1, InstanceField_Transform) == 1);
+    CHECK(table.GetRows()[row].overloadedMatrix[3] == moved.overloadedMatrix[3]);
+    CHECK(table.GetRows()[row].scale == 3.f);
+    CHECK(table.GetRows()[row].primitiveOffset == original.primitiveOffset);
+    CHECK(table.GetRows()[row].compactIndexOffset == original.compactIndexOffset);
+    CHECK(table.GetRows()[row].textureOffsetAndFlags == original.textureOffsetAndFlags);
+    std::vector<InstanceRowRange> ranges = Collect(table, 4, 0);
+    CHECK_MESSAGE(RangesEqual(ranges, { { row, 1 } }), ToString(ranges));
+
+    CHECK(table.UpdateRows(&row, &moved, 1, InstanceField_Material | InstanceField_Geometry) == 1);
+    CHECK(memcmp(&table.GetRows()[row], &moved, sizeof(InstanceData)) == 0);
+    CHECK(table.UpdateRows(&row, &moved, 1, InstanceField_All) == 0);
+
+    // 越界的行被忽略
+    const uint32_t outOfRange = row + 100;
+    CHECK(table.UpdateRows(&outOfRange, &moved, 1, InstanceField_All) == 0);
+}
@@ -0,0 +1,157 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "LocalLightAliasTable.h"
+#include "TestFramework.h"
+
+namespace
+{
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return float(NextRandom(state) >> 8) * (1.f / 16777216.f);
+    }
+
+    // 与 shader 中的读取方式相同：i = floor(u * entryCount)，u' < probability 时取 i，否则取 alias
+    uint32_t SampleAliasTable(const std::vector<RTXDI_AliasTableEntry>& entries, float u0, float u1, float& pdf)
+    {
+        const uint32_t entryCount = uint32_t(entries.size());
+        const uint32_t index = std::min(uint32_t(u0 * float(entryCount)), entryCount - 1);
+        const RTXDI_AliasTableEntry& entry = entries[index];
+        if (u1 < entry.probability)
+        {
+            pdf = entry.pdf;
+            return index;
+        }
+
+        pdf = entry.aliasPdf;
+        return entry.alias;
+    }
+}
+
+TEST_CASE(LocalLightAliasTable_SampledHistogramMatchesPdf)
+{
+    // 功率跨 5 个数量级，另有两个 0 功率光源
+    constexpr uint32_t c_LightCount = 64;
+    std::vector<float> powers(c_LightCount);
+    for (uint32_t i = 0; i < c_LightCount; i++)
+        powers[i] = std::exp2(float(i % 17) - 8.f);
+    powers[5] = 0.f;
+    powers[40] = 0.f;
+
+    double totalPower = 0.0;
+    for (float power : powers)
+        totalPower += power;
+
+    LocalLightAliasTable table;
+    std::vector<RTXDI_AliasTableEntry> entries(c_LightCount);
+    const RTXDI_AliasTableParameters params = table.Build(powers.data(), c_LightCount, entries.data());
+    CHECK(params.entryCount == c_LightCount);
+    CHECK(std::fabs(params.totalPower - float(totalPower)) < 1e-4f * float(totalPower));
+
+    constexpr uint32_t c_SampleCount = 4u << 20;
+    std::vector<uint32_t> histogram(c_LightCount, 0);
+    uint32_t random = 0x9e3779b9u;
+    uint32_t pdfMismatches = 0;
+    for (uint32_t s = 0; s < c_SampleCount; s++)
+    {
+        const float u0 = NextRandomFloat(random);
+        const float u1 = NextRandomFloat(random);
+        float pdf = 0.f;
+        const uint32_t light = SampleAliasTable(entries, u0, u1, pdf);
+        histogram[light]++;
+
+        // 返回的 pdf 必须是被选中光源自己的概率
+        const float expected = float(powers[light] / totalPower);
+        pdfMismatches += std::fabs(pdf - expected) > 1e-6f * std::max(expected, 1e-3f) ? 1 : 0;
+    }
+    CHECK(pdfMismatches == 0);
+    CHECK(histogram[5] == 0);
+    CHECK(histogram[40] == 0);
+
+    // 对非零功率的光源做卡方检验，62 个光源即自由度 61，p = 0.001 的临界值约为 100.9
+    double chiSquare = 0.0;
+    uint32_t nonZeroCount = 0;
+    for (uint32_t i = 0; i < c_LightCount; i++)
+    {
+        if (powers[i] == 0.f)
+            continue;
+        const double expectedCount = double(c_SampleCount) * powers[i] / totalPower;
+        const double difference = double(histogram[i]) - expectedCount;
+        chiSquare += difference * difference / expectedCount;
+        nonZeroCount++;
+    }
+    CHECK(nonZeroCount == 62);
+    CHECK_MESSAGE(chiSquare < 100.9, std::to_string(chiSquare));
+}
+
+TEST_CASE(LocalLightAliasTable_ZeroPowerIsUniform)
+{
+    constexpr uint32_t c_LightCount = 10;
+    const std::vector<float> powers(c_LightCount, 0.f);
+
+    LocalLightAliasTable table;
+    std::vector<RTXDI_AliasTableEntry> entries(c_LightCount);
+    const RTXDI_AliasTableParameters params = table.Build(powers.data(), c_LightCount, entries.data());
+    CHECK(params.entryCount == c_LightCount);
+    CHECK(params.totalPower == 0.f);
+
+    for (uint32_t i = 0; i < c_LightCount; i++)
+    {
+        CHECK(entries[i].alias == i);
+        CHECK(entries[i].probability == 1.f);
+        CHECK(entries[i].pdf == 1.f / float(c_LightCount));
+        CHECK(entries[i].aliasPdf == entries[i].pdf);
+    }
+
+    CHECK(table.Build(powers.data(), 0, entries.data()).entryCount == 0);
+}
+
+TEST_CASE(LocalLightAliasTable_NegativeAndNaNPowersAreZero)
+{
+    const float powers[] = { 1.f, -4.f, std::numeric_limits<float>::quiet_NaN(), 3.f, -0.f };
+    constexpr uint32_t c_LightCount = 5;
+
+    LocalLightAliasTable table;
+    std::vector<RTXDI_AliasTableEntry> entries(c_LightCount);
+    const RTXDI_AliasTableParameters params = table.Build(powers, c_LightCount, entries.data());
+    CHECK(params.totalPower == 4.f);
+
+    // 还原每个光源的选中概率：自身的 probability 加上以它为 alias 的项剩下的部分
+    std::vector<double> selected(c_LightCount, 0.0);
+    for (uint32_t i = 0; i < c_LightCount; i++)
+    {
+        CHECK(entries[i].alias < c_LightCount);
+        selected[i] += entries[i].probability;
+        selected[entries[i].alias] += 1.0 - entries[i].probability;
+    }
+
+    const double expected[] = { 0.25, 0.0, 0.0, 0.75, 0.0 };
+    for (uint32_t i = 0; i < c_LightCount; i++)
+    {
+        CHECK(entries[i].pdf == float(expected[i]));
+        CHECK_MESSAGE(std::fabs(selected[i] / c_LightCount - expected[i]) < 1e-6, std::to_string(i));
+    }
+}
+
+TEST_CASE(LocalLightAliasTable_Benchmark1M)
+{
+    const LocalLightAliasTableBenchmarkResult result = BenchmarkLocalLightAliasTableBuild(1u << 20, 8);
+    std::printf("  %u lights: build %.2f ms, max pdf error %g, max distribution error %g\n",
+        result.lightCount, result.buildMilliseconds, result.maxPdfError, result.maxDistributionError);
+
+    CHECK(result.lightCount == (1u << 20));
+    CHECK(result.buildMilliseconds > 0.f);
+    CHECK(result.maxPdfError < 1e-5f);
+    CHECK(result.maxDistributionError < 1e-3f);
+}
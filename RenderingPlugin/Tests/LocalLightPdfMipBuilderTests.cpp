@@ -0,0 +1,59 @@
+﻿#include <cmath>
+#include <string>
+#include <vector>
+
+#include "LocalLightPdfMipBuilder.h"
+#include "TestFramework.h"
+
+TEST_CASE(LocalLightPdfMipBuilder_UpdateMatchesBuild)
+{
+    // 5000 个光源对应 128x64 的纹理，最后几级 mip 只有一行
+    constexpr uint32_t c_LightCount = 5000;
+    LocalLightPdfMipBuilder builder(c_LightCount);
+    const PdfTextureDesc desc = builder.GetTextureDesc();
+
+    std::vector<float> powers(c_LightCount);
+    for (uint32_t i = 0; i < c_LightCount; i++)
+        powers[i] = float(i % 97) + 0.5f;
+
+    std::vector<float> uploadBuffer(desc.uploadBufferSizeInTexels);
+    builder.Build(powers.data(), c_LightCount, uploadBuffer.data());
+
+    const uint32_t indices[] = { 0, 1, 1234, c_LightCount - 1 };
+    const float newPowers[] = { 100.f, 0.f, 7.f, 3.f };
+    for (uint32_t i = 0; i < 4; i++)
+        powers[indices[i]] = newPowers[i];
+    const uint32_t texelsWritten = builder.Update(indices, newPowers, 4, uploadBuffer.data());
+    CHECK(texelsWritten > 4);
+    CHECK(texelsWritten < desc.uploadBufferSizeInTexels / 100);
+
+    LocalLightPdfMipBuilder reference(c_LightCount);
+    std::vector<float> referenceBuffer(desc.uploadBufferSizeInTexels);
+    reference.Build(powers.data(), c_LightCount, referenceBuffer.data());
+
+    float maxError = 0.f;
+    for (uint32_t i = 0; i < desc.uploadBufferSizeInTexels; i++)
+        maxError = std::max(maxError, std::fabs(uploadBuffer[i] - referenceBuffer[i]) / std::max(referenceBuffer[i], 1.f));
+    CHECK_MESSAGE(maxError < 1e-5f, std::to_string(maxError));
+
+    // 脏行区间覆盖所有改写过的行，最高一级 mip 必然变化
+    const std::vector<PdfMipDirtyRows>& dirtyRows = builder.GetDirtyRows();
+    CHECK(dirtyRows.size() == desc.mipLevels);
+    CHECK(dirtyRows.back().rowCount == 1);
+}
+
+TEST_CASE(LocalLightPdfMipBuilder_Benchmark1M)
+{
+    // 1M 光源，每帧 1% 变化
+    const LocalLightPdfBenchmarkResult result = BenchmarkLocalLightPdfUpdates(1u << 20, 0.01f, 32);
+    std::printf("  %u lights, %u changed per frame, %u mips: build %.2f ms, update %.3f ms, %.0f texels and %.1f KB uploaded per frame (full chain %.1f KB), max relative error %g\n",
+        result.lightCount, result.changedLightsPerFrame, result.mipLevels, result.buildMilliseconds, result.updateMilliseconds,
+        result.texelsWrittenPerFrame, result.uploadedBytesPerFrame / 1024.f, result.fullUploadBytes / 1024.f, result.maxRelativeError);
+
+    CHECK(result.lightCount == (1u << 20));
+    CHECK(result.changedLightsPerFrame == 10485);
+    CHECK(result.mipLevels == 11);
+    CHECK(result.maxRelativeError < 1e-5f);
+    CHECK(result.texelsWrittenPerFrame > float(result.changedLightsPerFrame));
+    CHECK(result.updateMilliseconds < result.buildMilliseconds);
+}
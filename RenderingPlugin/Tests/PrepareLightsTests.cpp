@@ -0,0 +1,87 @@
+﻿#include <vector>
+
+#include "PrepareLights.h"
+#include "TestFramework.h"
+
+namespace
+{
+    // 单位矩阵，四个顶点组成 z = 0 平面上的两个三角形
+    const float c_Identity[12] = { 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+    const float c_Positions[] = { 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 0.f };
+
+    PrepareLightsInstance MakeInstance(const uint32_t* indices, uint32_t triangleCount, uint32_t vertexCount, uint32_t geometryInstanceIndex)
+    {
+        PrepareLightsInstance instance = {};
+        for (uint32_t i = 0; i < 12; i++)
+            instance.objectToWorld[i] = c_Identity[i];
+        instance.emissiveRadiance[0] = 1.f;
+        instance.emissiveRadiance[1] = 2.f;
+        instance.emissiveRadiance[2] = 3.f;
+        instance.geometryInstanceIndex = geometryInstanceIndex;
+        instance.positions = c_Positions;
+        instance.indices = indices;
+        instance.triangleCount = triangleCount;
+        instance.vertexCount = vertexCount;
+        return instance;
+    }
+
+    bool IsZeroLight(const RAB_LightInfo& light)
+    {
+        return light.radiance[0] == 0 && light.radiance[1] == 0 && light.scalars == 0 &&
+            light.center[0] == 0.f && light.center[1] == 0.f && light.center[2] == 0.f;
+    }
+}
+
+TEST_CASE(PrepareLights_OutOfRangeIndicesEmitNoLight)
+{
+    // 第二个三角形引用了不存在的顶点 4，第三个用 0xFFFFFFFF
+    const uint32_t indices[] = { 0, 1, 2, 0, 2, 4, 0xFFFFFFFFu, 1, 2, 0, 2, 3 };
+    const PrepareLightsInstance instance = MakeInstance(indices, 4, 4, 0);
+
+    std::vector<RAB_LightInfo> lights(8);
+    std::vector<uint32_t> geometryInstanceToLight(1);
+
+    PrepareLightsDesc desc = {};
+    desc.instances = &instance;
+    desc.instanceCount = 1;
+    desc.lightBuffer = lights.data();
+    desc.maxLights = uint32_t(lights.size());
+    desc.geometryInstanceToLight = geometryInstanceToLight.data();
+    desc.geometryInstanceCount = 1;
+
+    const RTXDI_LightBufferParameters params = PrepareLights(desc);
+
+    // 越界的三角形仍然占用槽位，保持三角形下标与光源下标一一对应
+    CHECK(params.localLightBufferRegion.numLights == 4);
+    CHECK(geometryInstanceToLight[0] == 0);
+    CHECK(!IsZeroLight(lights[0]));
+    CHECK(IsZeroLight(lights[1]));
+    CHECK(IsZeroLight(lights[2]));
+    CHECK(!IsZeroLight(lights[3]));
+}
+
+TEST_CASE(PrepareLights_ZeroVertexCountIsSkipped)
+{
+    const uint32_t indices[] = { 0, 1, 2, 0, 2, 3 };
+    const PrepareLightsInstance instances[] = { MakeInstance(indices, 2, 0, 0), MakeInstance(indices, 2, 4, 1) };
+
+    std::vector<RAB_LightInfo> lights(8);
+    std::vector<uint32_t> geometryInstanceToLight(2);
+
+    PrepareLightsDesc desc = {};
+    desc.instances = instances;
+    desc.instanceCount = 2;
+    desc.lightBuffer = lights.data();
+    desc.maxLights = uint32_t(lights.size());
+    desc.geometryInstanceToLight = geometryInstanceToLight.data();
+    desc.geometryInstanceCount = 2;
+
+    const RTXDI_LightBufferParameters params = PrepareLights(desc);
+
+    // 没有顶点的实例不生成光源
+    CHECK(params.localLightBufferRegion.numLights == 2);
+    CHECK(geometryInstanceToLight[0] == RTXDI_INVALID_LIGHT_INDEX);
+    CHECK(geometryInstanceToLight[1] == 0);
+    CHECK(!IsZeroLight(lights[0]));
+    CHECK(!IsZeroLight(lights[1]));
+}
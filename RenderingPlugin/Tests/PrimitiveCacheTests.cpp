@@ -0,0 +1,316 @@
+﻿#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "PrimitiveCache.h"
+#include "TestFramework.h"
+
+namespace
+{
+    // 与 PrimitiveCache.cpp 中的 CacheHeader、CacheEntry 布局一致
+    constexpr size_t c_HeaderVersionOffset = 4;
+    constexpr size_t c_HeaderPrimitiveDataVersionOffset = 12;
+    constexpr size_t c_HeaderPrimitiveDataSizeOffset = 16;
+    constexpr size_t c_EntryTableOffset = 48;
+    constexpr size_t c_EntryBytes = 48;
+    constexpr size_t c_EntryDataOffsetOffset = 8;
+
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    struct TestMesh
+    {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> uvs;
+        std::vector<std::vector<uint32_t>> submeshIndices;
+    };
+
+    TestMesh MakeMesh(uint32_t vertexCount, const std::vector<uint32_t>& triangleCounts, uint32_t seed)
+    {
+        TestMesh mesh;
+        uint32_t random = seed;
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                mesh.positions.push_back(float(NextRandom(random) % 2000) * 0.01f - 10.f);
+                mesh.normals.push_back(float(NextRandom(random) % 200) * 0.01f - 1.f);
+            }
+            for (uint32_t c = 0; c < 2; c++)
+                mesh.uvs.push_back(float(NextRandom(random) % 1000) * 0.001f);
+        }
+        for (uint32_t triangleCount : triangleCounts)
+        {
+            std::vector<uint32_t> indices;
+            for (uint32_t i = 0; i < triangleCount * 3; i++)
+                indices.push_back(NextRandom(random) % vertexCount);
+            mesh.submeshIndices.push_back(indices);
+        }
+        return mesh;
+    }
+
+    // 三个 mesh 依次写入输出，第一个有两个 submesh
+    struct TestScene
+    {
+        std::vector<TestMesh> meshes;
+        std::vector<PrimitiveBuildDesc> descs;
+        uint32_t primitiveCount = 0;
+    };
+
+    TestScene MakeScene()
+    {
+        TestScene scene;
+        scene.meshes.push_back(MakeMesh(300, { 100, 37 }, 1));
+        scene.meshes.push_back(MakeMesh(64, { 50 }, 2));
+        scene.meshes.push_back(MakeMesh(500, { 211 }, 3));
+        for (const TestMesh& mesh : scene.meshes)
+        {
+            for (const std::vector<uint32_t>& indices : mesh.submeshIndices)
+            {
+                PrimitiveBuildDesc desc = {};
+                desc.positions = mesh.positions.data();
+                desc.normals = mesh.normals.data();
+                desc.uvs = mesh.uvs.data();
+                desc.indices = indices.data();
+                desc.vertexCount = uint32_t(mesh.positions.size() / 3);
+                desc.indexCount = uint32_t(indices.size());
+                desc.primitiveOffset = scene.primitiveCount;
+                scene.descs.push_back(desc);
+                scene.primitiveCount += desc.indexCount / 3;
+            }
+        }
+        return scene;
+    }
+
+    std::vector<PrimitiveData> BuildReference(const TestScene& scene)
+    {
+        std::vector<PrimitiveData> primitives(scene.primitiveCount);
+        BuildPrimitiveData(scene.descs.data(), uint32_t(scene.descs.size()), primitives.data(), scene.primitiveCount, false);
+        return primitives;
+    }
+
+    // 输出先填充无效值，命中和重新生成的结果都必须与直接生成的一致
+    PrimitiveCacheBuildStats BuildAndCompare(PrimitiveCache& cache, const TestScene& scene, const std::vector<PrimitiveData>& reference,
+        const std::string& label)
+    {
+        std::vector<PrimitiveData> primitives(scene.primitiveCount);
+        memset(primitives.data(), 0xCD, primitives.size() * sizeof(PrimitiveData));
+        const PrimitiveCacheBuildStats stats = cache.Build(scene.descs.data(), uint32_t(scene.descs.size()), primitives.data(),
+            scene.primitiveCount, false);
+        CHECK_MESSAGE(stats.meshCount == 3, label);
+        CHECK_MESSAGE(stats.primitiveCount == scene.primitiveCount, label);
+        CHECK_MESSAGE(memcmp(primitives.data(), reference.data(), primitives.size() * sizeof(PrimitiveData)) == 0, label);
+        return stats;
+    }
+
+    std::string GetCachePath(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<uint8_t> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const std::string& path, const std::vector<uint8_t>& bytes)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+    }
+
+    // 生成整个场景并保存，返回文件内容
+    std::vector<uint8_t> SaveScene(const std::string& path, const TestScene& scene, const std::vector<PrimitiveData>& reference)
+    {
+        std::filesystem::remove(path);
+        PrimitiveCache cache(path.c_str());
+        BuildAndCompare(cache, scene, reference, "initial build");
+        CHECK(cache.Save(0).result == PrimitiveCacheResult_Ok);
+        return ReadFile(path);
+    }
+
+    uint64_t ReadEntryDataOffset(const std::vector<uint8_t>& bytes, uint32_t entry)
+    {
+        uint64_t dataOffset;
+        memcpy(&dataOffset, bytes.data() + c_EntryTableOffset + entry * c_EntryBytes + c_EntryDataOffsetOffset, sizeof(dataOffset));
+        return dataOffset;
+    }
+
+    // 文件被整个丢弃时所有 mesh 重新生成，保存后再次打开全部命中
+    void CheckDiscardedAndRebuilt(const std::string& path, const TestScene& scene, const std::vector<PrimitiveData>& reference,
+        PrimitiveCacheResult expected, const std::string& label)
+    {
+        {
+            PrimitiveCache cache(path.c_str());
+            const PrimitiveCacheInfo info = cache.GetInfo();
+            CHECK_MESSAGE(info.loadResult == expected, label);
+            CHECK_MESSAGE(info.entryCount == 0, label);
+
+            const PrimitiveCacheBuildStats stats = BuildAndCompare(cache, scene, reference, label);
+            CHECK_MESSAGE(stats.hitMeshCount == 0 && stats.builtMeshCount == 3, label);
+            CHECK_MESSAGE(cache.Save(0).result == PrimitiveCacheResult_Ok, label);
+        }
+
+        PrimitiveCache reopened(path.c_str());
+        CHECK_MESSAGE(reopened.GetInfo().loadResult == PrimitiveCacheResult_Ok, label);
+        CHECK_MESSAGE(BuildAndCompare(reopened, scene, reference, label).hitMeshCount == 3, label);
+    }
+}
+
+TEST_CASE(PrimitiveCache_RoundTrip)
+{
+    const TestScene scene = MakeScene();
+    const std::vector<PrimitiveData> reference = BuildReference(scene);
+    const std::string path = GetCachePath("PrimitiveCacheTests_RoundTrip.bin");
+    std::filesystem::remove(path);
+
+    {
+        PrimitiveCache cache(path.c_str());
+        CHECK(cache.GetInfo().loadResult == PrimitiveCacheResult_Ok);
+        const PrimitiveCacheBuildStats built = BuildAndCompare(cache, scene, reference, "first build");
+        CHECK(built.hitMeshCount == 0 && built.builtMeshCount == 3);
+        CHECK(cache.GetInfo().pendingEntryCount == 3);
+
+        // 同一个 cache 中再次构建直接使用尚未保存的 entry
+        CHECK(BuildAndCompare(cache, scene, reference, "pending hit").hitMeshCount == 3);
+
+        const PrimitiveCacheSaveStats saved = cache.Save(0);
+        CHECK(saved.result == PrimitiveCacheResult_Ok);
+        CHECK(saved.entryCount == 3);
+        CHECK(saved.fileBytes > scene.primitiveCount * sizeof(PrimitiveData));
+        CHECK(cache.GetInfo().pendingEntryCount == 0);
+    }
+
+    PrimitiveCache reopened(path.c_str());
+    const PrimitiveCacheInfo info = reopened.GetInfo();
+    CHECK(info.loadResult == PrimitiveCacheResult_Ok);
+    CHECK(info.entryCount == 3);
+    CHECK(info.fileBytes == std::filesystem::file_size(path));
+
+    const PrimitiveCacheBuildStats hit = BuildAndCompare(reopened, scene, reference, "reopened");
+    CHECK(hit.hitMeshCount == 3);
+    CHECK(hit.builtMeshCount == 0);
+    CHECK(hit.corruptMeshCount == 0);
+    CHECK(hit.hitPrimitiveCount == scene.primitiveCount);
+
+    // 顶点内容变化后 hash 不同，只有这个 mesh 重新生成
+    TestScene modified = MakeScene();
+    modified.meshes[1].positions[7] += 0.5f;
+    for (PrimitiveBuildDesc& desc : modified.descs)
+    {
+        if (desc.vertexCount == 64)
+            desc.positions = modified.meshes[1].positions.data();
+    }
+    const PrimitiveCacheBuildStats partial = BuildAndCompare(reopened, modified, BuildReference(modified), "modified");
+    CHECK(partial.hitMeshCount == 2);
+    CHECK(partial.builtMeshCount == 1);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(PrimitiveCache_VersionMismatchDiscardsFile)
+{
+    const TestScene scene = MakeScene();
+    const std::vector<PrimitiveData> reference = BuildReference(scene);
+    const std::string path = GetCachePath("PrimitiveCacheTests_Version.bin");
+
+    // 文件格式版本、c_PrimitiveDataVersion 和 sizeof(PrimitiveData) 任何一个不同都丢弃整个文件
+    const size_t offsets[] = { c_HeaderVersionOffset, c_HeaderPrimitiveDataVersionOffset, c_HeaderPrimitiveDataSizeOffset };
+    for (size_t offset : offsets)
+    {
+        std::vector<uint8_t> bytes = SaveScene(path, scene, reference);
+        uint32_t value;
+        memcpy(&value, bytes.data() + offset, sizeof(value));
+        CHECK(offset != c_HeaderPrimitiveDataVersionOffset || value == c_PrimitiveDataVersion);
+        CHECK(offset != c_HeaderPrimitiveDataSizeOffset || value == sizeof(PrimitiveData));
+        value += 1;
+        memcpy(bytes.data() + offset, &value, sizeof(value));
+        WriteFile(path, bytes);
+
+        CheckDiscardedAndRebuilt(path, scene, reference, PrimitiveCacheResult_VersionMismatch, "header offset " + std::to_string(offset));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(PrimitiveCache_RejectsCorruptEntry)
+{
+    const TestScene scene = MakeScene();
+    const std::vector<PrimitiveData> reference = BuildReference(scene);
+    const std::string path = GetCachePath("PrimitiveCacheTests_CorruptEntry.bin");
+
+    // entry 按 Build 中 mesh 的顺序写入，修改第二个 mesh 数据中的一个字节
+    std::vector<uint8_t> bytes = SaveScene(path, scene, reference);
+    const uint64_t dataOffset = ReadEntryDataOffset(bytes, 1);
+    CHECK(dataOffset + 16 + sizeof(PrimitiveData) * 50 <= bytes.size());
+    bytes[size_t(dataOffset + 16 + sizeof(PrimitiveData) * 20 + 3)] ^= 0x40;
+    WriteFile(path, bytes);
+
+    {
+        // entry 数据在命中时才校验，打开文件本身成功
+        PrimitiveCache cache(path.c_str());
+        CHECK(cache.GetInfo().loadResult == PrimitiveCacheResult_Ok);
+        CHECK(cache.GetInfo().entryCount == 3);
+
+        const PrimitiveCacheBuildStats stats = BuildAndCompare(cache, scene, reference, "corrupt entry");
+        CHECK(stats.corruptMeshCount == 1);
+        CHECK(stats.hitMeshCount == 2);
+        CHECK(stats.builtMeshCount == 1);
+        CHECK(stats.hitPrimitiveCount == scene.primitiveCount - 50);
+        CHECK(cache.GetInfo().pendingEntryCount == 1);
+
+        // 重新生成的 entry 替换损坏的数据
+        const PrimitiveCacheSaveStats saved = cache.Save(0);
+        CHECK(saved.result == PrimitiveCacheResult_Ok);
+        CHECK(saved.entryCount == 3);
+    }
+
+    PrimitiveCache reopened(path.c_str());
+    const PrimitiveCacheBuildStats repaired = BuildAndCompare(reopened, scene, reference, "repaired");
+    CHECK(repaired.hitMeshCount == 3);
+    CHECK(repaired.corruptMeshCount == 0);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(PrimitiveCache_RejectsCorruptEntryTable)
+{
+    const TestScene scene = MakeScene();
+    const std::vector<PrimitiveData> reference = BuildReference(scene);
+    const std::string path = GetCachePath("PrimitiveCacheTests_CorruptTable.bin");
+    const std::vector<uint8_t> original = SaveScene(path, scene, reference);
+
+    // entry 表的每个字段都在 entryTableChecksum 之内：contentHash、dataOffset、primitiveCount
+    const size_t offsets[] = { c_EntryTableOffset, c_EntryTableOffset + c_EntryBytes + c_EntryDataOffsetOffset,
+        c_EntryTableOffset + 2 * c_EntryBytes + 36 };
+    for (size_t offset : offsets)
+    {
+        std::vector<uint8_t> bytes = original;
+        bytes[offset] ^= 0x01;
+        WriteFile(path, bytes);
+        CheckDiscardedAndRebuilt(path, scene, reference, PrimitiveCacheResult_InvalidFormat, "entry table byte " + std::to_string(offset));
+    }
+
+    // magic 错误或文件被截断
+    std::vector<uint8_t> magic = original;
+    magic[0] ^= 0x01;
+    WriteFile(path, magic);
+    CheckDiscardedAndRebuilt(path, scene, reference, PrimitiveCacheResult_InvalidFormat, "magic");
+
+    for (size_t size : { size_t(16), c_EntryTableOffset + c_EntryBytes, original.size() - 1 })
+    {
+        WriteFile(path, std::vector<uint8_t>(original.begin(), original.begin() + size));
+        CheckDiscardedAndRebuilt(path, scene, reference, PrimitiveCacheResult_InvalidFormat, "truncated to " + std::to_string(size));
+    }
+
+    std::filesystem::remove(path);
+}
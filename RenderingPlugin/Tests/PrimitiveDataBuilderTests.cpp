@@ -0,0 +1,191 @@
+﻿#include <cstring>
+#include <string>
+#include <vector>
+
+#include "PrimitiveDataBuilder.h"
+#include "TestFramework.h"
+
+namespace
+{
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return float(NextRandom(state) >> 8) * (1.f / 16777216.f) * 2.f - 1.f;
+    }
+
+    // 向量路径容易与标量路径分歧的输入，按顶点序号循环使用
+    const float c_SpecialNormals[][3] =
+    {
+        { 0.f, 0.f, 0.f },          // 零向量编码为 0
+        { -0.f, -0.f, -0.f },
+        { 0.f, 1.f, -0.f },         // z = -0 走上半球
+        { -0.f, 0.f, -1.f },        // 下半球 x = -0，SafeSign 取 1
+        { 1e-30f, -1e-30f, 1e-30f },
+        { 3.f, -4.f, -12.f },
+    };
+
+    const float c_SpecialUvs[][2] =
+    {
+        { 65504.f, -65504.f },      // half 最大值
+        { 65519.f, 65520.f },       // 65520 开始舍入为 inf
+        { 1e5f, -7e4f },            // 超出 half 范围
+        { 6.1035156e-5f, 6.0e-5f }, // 最小规格化数和其下的非规格化数
+        { 5.9604645e-8f, 2.9802322e-8f }, // 最小非规格化数和正好一半（舍入到 0）
+        { 8.940697e-8f, -1.4901161e-7f }, // 非规格化数的舍入到偶数
+        { 1e-10f, -1e-40f },        // 下溢到 0，float 非规格化数
+        { 0.33333334f, 2047.5f },
+    };
+
+    struct TestMesh
+    {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> tangents;
+        std::vector<float> uvs;
+        std::vector<uint32_t> indices;
+    };
+
+    TestMesh MakeMesh(uint32_t vertexCount, uint32_t triangleCount, uint32_t seed)
+    {
+        TestMesh mesh;
+        uint32_t random = seed;
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            for (uint32_t c = 0; c < 3; c++)
+                mesh.positions.push_back(NextRandomFloat(random) * 10.f);
+
+            const uint32_t special = v % 4 == 0 ? v / 4 : ~0u;
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                const float random3 = NextRandomFloat(random);
+                mesh.normals.push_back(special != ~0u ? c_SpecialNormals[special % 6][c] : random3);
+            }
+            for (uint32_t c = 0; c < 3; c++)
+                mesh.tangents.push_back(special != ~0u ? c_SpecialNormals[(special + 3) % 6][c] : NextRandomFloat(random));
+            mesh.tangents.push_back(NextRandom(random) & 1 ? 1.f : -1.f);
+
+            const uint32_t specialUv = v % 3 == 0 ? v / 3 : ~0u;
+            for (uint32_t c = 0; c < 2; c++)
+            {
+                const float random2 = NextRandomFloat(random) * 4.f;
+                mesh.uvs.push_back(specialUv != ~0u ? c_SpecialUvs[specialUv % 8][c] : random2);
+            }
+        }
+
+        // 包括退化三角形和重复使用的顶点
+        for (uint32_t t = 0; t < triangleCount * 3; t++)
+            mesh.indices.push_back(t % 17 == 0 ? 0 : NextRandom(random) % vertexCount);
+        return mesh;
+    }
+
+    PrimitiveBuildDesc MakeDesc(const TestMesh& mesh, uint32_t primitiveOffset, bool normals, bool tangents, bool uvs)
+    {
+        PrimitiveBuildDesc desc = {};
+        desc.positions = mesh.positions.data();
+        desc.normals = normals ? mesh.normals.data() : nullptr;
+        desc.tangents = tangents ? mesh.tangents.data() : nullptr;
+        desc.uvs = uvs ? mesh.uvs.data() : nullptr;
+        desc.indices = mesh.indices.data();
+        desc.vertexCount = uint32_t(mesh.positions.size() / 3);
+        desc.indexCount = uint32_t(mesh.indices.size());
+        desc.primitiveOffset = primitiveOffset;
+        return desc;
+    }
+
+    // 同一组 submesh 分别走向量和标量路径，输出逐字节比较
+    bool BuildsIdentically(const std::vector<PrimitiveBuildDesc>& descs, uint32_t primitiveCount, const std::string& label)
+    {
+        std::vector<PrimitiveData> simd(primitiveCount);
+        std::vector<PrimitiveData> scalar(primitiveCount);
+        memset(simd.data(), 0xCD, simd.size() * sizeof(PrimitiveData));
+        memset(scalar.data(), 0xCD, scalar.size() * sizeof(PrimitiveData));
+
+        const PrimitiveBuildStats simdStats = BuildPrimitiveData(descs.data(), uint32_t(descs.size()), simd.data(), primitiveCount, true);
+        const PrimitiveBuildStats scalarStats = BuildPrimitiveData(descs.data(), uint32_t(descs.size()), scalar.data(), primitiveCount, false);
+        CHECK_MESSAGE(scalarStats.path == PrimitiveBuildPath_Scalar, label);
+        CHECK_MESSAGE(simdStats.primitiveCount == scalarStats.primitiveCount, label);
+        CHECK_MESSAGE(simdStats.invalidSubmeshCount == 0 && scalarStats.invalidSubmeshCount == 0, label);
+
+        for (uint32_t i = 0; i < primitiveCount; i++)
+        {
+            if (memcmp(&simd[i], &scalar[i], sizeof(PrimitiveData)) != 0)
+            {
+                CHECK_MESSAGE(false, label + ", primitive " + std::to_string(i));
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(PrimitiveDataBuilder_SimdMatchesScalar)
+{
+    // 三角形数覆盖不足一组、正好一组和带尾部的情况
+    for (uint32_t triangleCount : { 1u, 7u, 8u, 9u, 15u, 16u, 17u, 1003u })
+    {
+        const TestMesh mesh = MakeMesh(97, triangleCount, triangleCount * 7919u + 1u);
+        for (uint32_t attributes = 0; attributes < 8; attributes++)
+        {
+            const bool normals = (attributes & 1) != 0, tangents = (attributes & 2) != 0, uvs = (attributes & 4) != 0;
+            const std::vector<PrimitiveBuildDesc> descs = { MakeDesc(mesh, 0, normals, tangents, uvs) };
+            BuildsIdentically(descs, triangleCount, std::to_string(triangleCount) + " triangles, attributes " + std::to_string(attributes));
+        }
+    }
+}
+
+TEST_CASE(PrimitiveDataBuilder_SimdMatchesScalarAcrossSubmeshes)
+{
+    // 多个 submesh 连续写入，批次跨越 submesh 边界，每个 submesh 的尾部都不是 8 的倍数
+    std::vector<TestMesh> meshes;
+    const uint32_t triangleCounts[] = { 5, 20011, 3, 12345, 1, 16389 };
+    for (uint32_t i = 0; i < 6; i++)
+        meshes.push_back(MakeMesh(4096 + i, triangleCounts[i], i + 11));
+
+    std::vector<PrimitiveBuildDesc> descs;
+    uint32_t primitiveCount = 0;
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        descs.push_back(MakeDesc(meshes[i], primitiveCount, i != 2, i % 2 == 0, i != 4));
+        primitiveCount += triangleCounts[i];
+    }
+    BuildsIdentically(descs, primitiveCount, "submeshes");
+}
+
+TEST_CASE(PrimitiveDataBuilder_Avx2PathIsCompiled)
+{
+    // CPU 支持时向量路径必须真正以 AVX2 编译，否则 BuildPrimitivesAvx2 返回 0，上面的比较只是标量对标量
+    const TestMesh mesh = MakeMesh(64, 16, 3);
+    const PrimitiveBuildDesc desc = MakeDesc(mesh, 0, true, true, true);
+    std::vector<PrimitiveData> primitives(16);
+    const PrimitiveBuildStats stats = BuildPrimitiveData(&desc, 1, primitives.data(), 16, true);
+    if (stats.path != PrimitiveBuildPath_Avx2)
+    {
+        std::printf("  CPU does not support AVX2 / F16C, only the scalar path was tested\n");
+        return;
+    }
+    CHECK(BuildPrimitivesAvx2(desc, 0, 16, primitives.data()) == 16);
+    CHECK(BuildPrimitivesAvx2(desc, 0, 15, primitives.data()) == 8);
+}
+
+TEST_CASE(PrimitiveDataBuilder_HalfEdgeCases)
+{
+    // 标量路径本身的参考值，向量路径通过上面的逐字节比较与它一致
+    CHECK(PackHalf2(65504.f, -65504.f) == (0x7BFFu | 0xFBFFu << 16));
+    CHECK(PackHalf2(65519.f, 65520.f) == (0x7BFFu | 0x7C00u << 16));
+    CHECK(PackHalf2(1e5f, -7e4f) == (0x7C00u | 0xFC00u << 16));
+    CHECK(PackHalf2(6.1035156e-5f, 5.9604645e-8f) == (0x0400u | 0x0001u << 16));
+    CHECK(PackHalf2(2.9802322e-8f, 8.940697e-8f) == (0x0000u | 0x0002u << 16));
+    CHECK(PackHalf2(-1e-40f, -0.f) == (0x8000u | 0x8000u << 16));
+
+    const float zero[3] = { 0.f, 0.f, 0.f };
+    const float negativeZero[3] = { -0.f, -0.f, -0.f };
+    CHECK(EncodeUnitVector(zero) == 0);
+    CHECK(EncodeUnitVector(negativeZero) == 0);
+}
@@ -0,0 +1,262 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ReGIRAutoSizing.h"
+#include "TestFramework.h"
+
+namespace
+{
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return float(NextRandom(state) >> 8) * (1.f / 16777216.f);
+    }
+
+    // 以原点为中心、间距为 1 的 n^3 点阵
+    std::vector<float> MakeLattice(uint32_t n)
+    {
+        std::vector<float> positions;
+        positions.reserve(size_t(n) * n * n * 3);
+        const float offset = float(n - 1) * 0.5f;
+        for (uint32_t z = 0; z < n; z++)
+            for (uint32_t y = 0; y < n; y++)
+                for (uint32_t x = 0; x < n; x++)
+                {
+                    positions.push_back(float(x) - offset);
+                    positions.push_back(float(y) - offset);
+                    positions.push_back(float(z) - offset);
+                }
+        return positions;
+    }
+
+    // 半径 radius 的球内均匀分布，另有 clusterFraction 的光源集中在 (clusterOffset, 0, 0) 附近
+    std::vector<float> MakeClusteredLights(uint32_t count, float radius, float clusterFraction, float clusterOffset, uint32_t seed)
+    {
+        std::vector<float> positions;
+        positions.reserve(size_t(count) * 3);
+        uint32_t random = seed;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const bool clustered = NextRandomFloat(random) < clusterFraction;
+            const float scale = clustered ? radius * 0.05f : radius;
+            float p[3];
+            do
+            {
+                for (float& v : p)
+                    v = NextRandomFloat(random) * 2.f - 1.f;
+            } while (p[0] * p[0] + p[1] * p[1] + p[2] * p[2] > 1.f);
+
+            positions.push_back(p[0] * scale + (clustered ? clusterOffset : 0.f));
+            positions.push_back(p[1] * scale);
+            positions.push_back(p[2] * scale);
+        }
+        return positions;
+    }
+
+    ReGIRAutoSizeDesc MakeDesc(const std::vector<float>& positions, rtxdi::ReGIRMode mode, uint64_t memoryBudgetInBytes)
+    {
+        ReGIRAutoSizeDesc desc = {};
+        desc.lightPositions = positions.data();
+        desc.lightCount = uint32_t(positions.size() / 3);
+        desc.mode = mode;
+        desc.memoryBudgetInBytes = memoryBudgetInBytes;
+        return desc;
+    }
+
+    // 与 RAB_LightInfo 一样把位置放在更大的结构体里，验证 lightPositionStride
+    struct StridedLight
+    {
+        float position[3];
+        uint32_t payload[5];
+    };
+
+    bool Near(float a, float b)
+    {
+        return std::fabs(a - b) <= 1e-4f * std::fabs(b);
+    }
+
+    void CheckOccupancyInvariants(const ReGIROccupancyStats& stats, uint32_t lightCount, uint32_t lightsPerCell, const std::string& label)
+    {
+        CHECK_MESSAGE(stats.occupiedCellCount <= stats.cellCount, label);
+        CHECK_MESSAGE(stats.overloadedCellCount <= stats.occupiedCellCount, label);
+        CHECK_MESSAGE(stats.lightsInside + stats.lightsOutside == lightCount, label);
+        CHECK_MESSAGE(stats.maxCellOccupancy <= stats.lightsInside, label);
+        CHECK_MESSAGE(stats.slotUtilization >= 0.f && stats.slotUtilization <= 1.f, label);
+        CHECK_MESSAGE((stats.overloadedCellCount > 0) == (stats.maxCellOccupancy > lightsPerCell), label);
+        if (stats.occupiedCellCount > 0)
+            CHECK_MESSAGE(stats.meanOccupancy * float(stats.occupiedCellCount) <= float(stats.lightsInside) * 1.001f, label);
+    }
+}
+
+TEST_CASE(ReGIRAutoSizing_LatticeGrid)
+{
+    // 16^3 个光源，extent 为 7.5，8^3 个 cell 时每个 cell 正好 8 个光源
+    const std::vector<float> lattice = MakeLattice(16);
+    const ReGIRAutoSizeResult result = AutoSizeReGIR(MakeDesc(lattice, rtxdi::ReGIRMode::Grid, 1u << 20));
+
+    CHECK(result.valid);
+    CHECK(result.staticParams.Mode == rtxdi::ReGIRMode::Grid);
+    CHECK(result.staticParams.gridParameters.GridSize.x == 8);
+    CHECK(result.staticParams.gridParameters.GridSize.y == 8);
+    CHECK(result.staticParams.gridParameters.GridSize.z == 8);
+    CHECK(result.staticParams.LightsPerCell == 32);
+    CHECK(Near(result.dynamicParams.regirCellSize, 2.f * 7.5f * 1.001f / 8.f));
+    CHECK(result.lightSlotCount == 8 * 8 * 8 * 32);
+    CHECK(result.sizeInBytes == uint64_t(result.lightSlotCount) * 8);
+    CHECK(result.occupancy.cellCount == 512);
+    CHECK(result.occupancy.occupiedCellCount == 512);
+    CHECK(result.occupancy.overloadedCellCount == 0);
+    CHECK(result.occupancy.maxCellOccupancy == 8);
+    CHECK(result.occupancy.lightsOutside == 0);
+    CHECK(Near(result.occupancy.slotUtilization, 0.25f));
+
+    // 预算只够 6^3 个 cell
+    const ReGIRAutoSizeResult small = AutoSizeReGIR(MakeDesc(lattice, rtxdi::ReGIRMode::Grid, 64u << 10));
+    CHECK(small.valid);
+    CHECK(small.staticParams.gridParameters.GridSize.x == 6);
+    CHECK(small.staticParams.LightsPerCell == 32);
+    CHECK(small.lightSlotCount == 6 * 6 * 6 * 32);
+    CHECK(small.sizeInBytes <= (64u << 10));
+    CHECK(small.occupancy.overloadedCellCount == 0);
+}
+
+TEST_CASE(ReGIRAutoSizing_PinnedConfigurations)
+{
+    const std::vector<float> lattice = MakeLattice(16);
+    const ReGIRAutoSizeResult latticeOnion = AutoSizeReGIR(MakeDesc(lattice, rtxdi::ReGIRMode::Onion, 1u << 20));
+    CHECK(latticeOnion.valid);
+    CHECK(latticeOnion.staticParams.Mode == rtxdi::ReGIRMode::Onion);
+    CHECK(latticeOnion.staticParams.onionParameters.OnionDetailLayers == 2);
+    CHECK(latticeOnion.staticParams.onionParameters.OnionCoverageLayers == 5);
+    CHECK(latticeOnion.staticParams.LightsPerCell == 48);
+    CHECK(Near(latticeOnion.dynamicParams.regirCellSize, 0.483241f));
+    CHECK(latticeOnion.lightSlotCount == 13680);
+    CHECK(latticeOnion.occupancy.cellCount == 285);
+    CHECK(latticeOnion.occupancy.occupiedCellCount == 174);
+
+    // 半数光源集中在偏离相机 40 的小球内
+    const std::vector<float> clustered = MakeClusteredLights(8192, 100.f, 0.5f, 40.f, 11);
+    const ReGIRAutoSizeResult clusteredGrid = AutoSizeReGIR(MakeDesc(clustered, rtxdi::ReGIRMode::Grid, 1u << 20));
+    CHECK(clusteredGrid.valid);
+    CHECK(clusteredGrid.staticParams.gridParameters.GridSize.x == 8);
+    CHECK(clusteredGrid.staticParams.LightsPerCell == 32);
+    CHECK(Near(clusteredGrid.dynamicParams.regirCellSize, 24.9438f));
+    CHECK(clusteredGrid.lightSlotCount == 16384);
+    CHECK(clusteredGrid.occupancy.occupiedCellCount == 362);
+    CHECK(clusteredGrid.occupancy.overloadedCellCount == 4);
+
+    const ReGIRAutoSizeResult clusteredOnion = AutoSizeReGIR(MakeDesc(clustered, rtxdi::ReGIRMode::Onion, 1u << 20));
+    CHECK(clusteredOnion.valid);
+    CHECK(clusteredOnion.staticParams.onionParameters.OnionDetailLayers == 1);
+    CHECK(clusteredOnion.staticParams.onionParameters.OnionCoverageLayers == 6);
+    CHECK(clusteredOnion.staticParams.LightsPerCell == 112);
+    CHECK(Near(clusteredOnion.dynamicParams.regirCellSize, 1.10538f));
+    CHECK(clusteredOnion.lightSlotCount == 15792);
+    CHECK(clusteredOnion.occupancy.cellCount == 141);
+    CHECK(clusteredOnion.occupancy.occupiedCellCount == 72);
+
+    for (const ReGIRAutoSizeResult* result : { &latticeOnion, &clusteredGrid, &clusteredOnion })
+    {
+        CHECK(result->sizeInBytes <= (1u << 20));
+        CHECK(result->occupancy.lightsOutside == 0);
+    }
+}
+
+TEST_CASE(ReGIRAutoSizing_BudgetTooSmall)
+{
+    // 一个 cell 都放不下 minLightsPerCell 个槽位
+    const std::vector<float> lattice = MakeLattice(16);
+    const ReGIRAutoSizeResult result = AutoSizeReGIR(MakeDesc(lattice, rtxdi::ReGIRMode::Grid, 100));
+    CHECK(!result.valid);
+    CHECK(result.lightSlotCount == 0);
+    CHECK(result.sizeInBytes == 0);
+}
+
+TEST_CASE(ReGIRAutoSizing_PositionStride)
+{
+    const std::vector<float> packed = MakeClusteredLights(4096, 50.f, 0.3f, 20.f, 5);
+    std::vector<StridedLight> strided(packed.size() / 3);
+    for (size_t i = 0; i < strided.size(); i++)
+    {
+        strided[i] = {};
+        for (uint32_t c = 0; c < 3; c++)
+            strided[i].position[c] = packed[i * 3 + c];
+    }
+
+    ReGIRAutoSizeDesc desc = MakeDesc(packed, rtxdi::ReGIRMode::Grid, 1u << 20);
+    const ReGIRAutoSizeResult expected = AutoSizeReGIR(desc);
+
+    desc.lightPositions = strided[0].position;
+    desc.lightPositionStride = sizeof(StridedLight);
+    const ReGIRAutoSizeResult result = AutoSizeReGIR(desc);
+
+    CHECK(result.valid == expected.valid);
+    CHECK(result.staticParams.gridParameters.GridSize.x == expected.staticParams.gridParameters.GridSize.x);
+    CHECK(result.staticParams.LightsPerCell == expected.staticParams.LightsPerCell);
+    CHECK(result.dynamicParams.regirCellSize == expected.dynamicParams.regirCellSize);
+    CHECK(result.lightSlotCount == expected.lightSlotCount);
+    CHECK(result.occupancy.occupiedCellCount == expected.occupancy.occupiedCellCount);
+}
+
+TEST_CASE(ReGIRAutoSizing_OccupancyInvariants)
+{
+    // 不超过 65536 个光源时不抽样，统计是精确的
+    const std::vector<float> all = MakeClusteredLights(16384, 100.f, 0.5f, 40.f, 23);
+    const ReGIRAutoSizeResult grid = AutoSizeReGIR(MakeDesc(all, rtxdi::ReGIRMode::Grid, 1u << 20));
+    const ReGIRAutoSizeResult onion = AutoSizeReGIR(MakeDesc(all, rtxdi::ReGIRMode::Onion, 1u << 20));
+    CHECK(grid.valid);
+    CHECK(onion.valid);
+
+    for (const ReGIRAutoSizeResult* sized : { &grid, &onion })
+    {
+        const std::string mode = sized == &grid ? "grid" : "onion";
+        ReGIROccupancyStats previous = {};
+        // 光源集合逐步增大，前一个集合是后一个的子集
+        for (uint32_t lightCount : { 0u, 1u, 256u, 1024u, 4096u, 16384u })
+        {
+            std::vector<float> subset(all.begin(), all.begin() + size_t(lightCount) * 3);
+            ReGIRAutoSizeDesc desc = MakeDesc(subset, rtxdi::ReGIRMode::Grid, 0);
+            const ReGIROccupancyStats stats = SimulateReGIROccupancy(desc, sized->staticParams, sized->dynamicParams);
+            const std::string label = mode + " " + std::to_string(lightCount) + " lights";
+
+            CheckOccupancyInvariants(stats, lightCount, sized->staticParams.LightsPerCell, label);
+            CHECK_MESSAGE(stats.cellCount == sized->occupancy.cellCount, label);
+            CHECK_MESSAGE(stats.occupiedCellCount >= previous.occupiedCellCount, label);
+            CHECK_MESSAGE(stats.overloadedCellCount >= previous.overloadedCellCount, label);
+            CHECK_MESSAGE(stats.maxCellOccupancy >= previous.maxCellOccupancy, label);
+            CHECK_MESSAGE(stats.lightsInside >= previous.lightsInside, label);
+            CHECK_MESSAGE(stats.slotUtilization >= previous.slotUtilization, label);
+            previous = stats;
+        }
+
+        // 全部光源时与 AutoSizeReGIR 的统计一致
+        CHECK_MESSAGE(previous.occupiedCellCount == sized->occupancy.occupiedCellCount, mode);
+        CHECK_MESSAGE(previous.maxCellOccupancy == sized->occupancy.maxCellOccupancy, mode);
+    }
+}
+
+TEST_CASE(ReGIRAutoSizing_LightsOutsideGrid)
+{
+    const std::vector<float> lattice = MakeLattice(16);
+    const ReGIRAutoSizeResult result = AutoSizeReGIR(MakeDesc(lattice, rtxdi::ReGIRMode::Grid, 1u << 20));
+    CHECK(result.valid);
+
+    // grid 以相机为中心，向 +x 平移 8 后有一半以上的列落在 grid 外
+    std::vector<float> shifted = lattice;
+    for (size_t i = 0; i < shifted.size(); i += 3)
+        shifted[i] += 8.f;
+    const ReGIROccupancyStats stats = SimulateReGIROccupancy(MakeDesc(shifted, rtxdi::ReGIRMode::Grid, 0), result.staticParams, result.dynamicParams);
+    CheckOccupancyInvariants(stats, 16 * 16 * 16, result.staticParams.LightsPerCell, "shifted");
+    CHECK(stats.lightsOutside > 0);
+    CHECK(stats.lightsInside > 0);
+    CHECK(stats.occupiedCellCount < result.occupancy.occupiedCellCount);
+}
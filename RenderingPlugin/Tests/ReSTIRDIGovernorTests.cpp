@@ -0,0 +1,285 @@
+﻿#include <cmath>
+#include <string>
+#include <vector>
+
+#include "ReSTIRDIGovernor.h"
+#include "TestFramework.h"
+
+namespace
+{
+    constexpr float c_TargetMs = 1.8f;
+    // 与 ReSTIRDIGovernor.cpp 中的默认值一致
+    constexpr float c_UpperTolerance = 0.05f;
+    constexpr float c_LowerTolerance = 0.2f;
+    constexpr uint32_t c_UpFrames = 30;
+
+    ReSTIRDIGovernorLevel GetBaseLevel()
+    {
+        ReSTIRDIGovernorLevel level = {};
+        level.resamplingMode = rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial;
+        level.numPrimaryLocalLightSamples = 8;
+        level.numPrimaryInfiniteLightSamples = 1;
+        level.numPrimaryEnvironmentSamples = 1;
+        level.numPrimaryBrdfSamples = 1;
+        level.numSpatialSamples = 4;
+        level.numDisocclusionBoostSamples = 8;
+        return level;
+    }
+
+    ReSTIRDIGovernorSettings GetSettings()
+    {
+        ReSTIRDIGovernorSettings settings = {};
+        settings.targetMs = c_TargetMs;
+        settings.allowModeChanges = 1;
+        return settings;
+    }
+
+    // 合成的 GPU 耗时：各 pass 的开销与采样数成正比，load 为场景负载（光源数、分辨率等）的倍数
+    // 第 0 档在 load 为 1 时约 1.73 ms
+    ReSTIRDIPassTimings SimulateTimings(const ReSTIRDIGovernorLevel& level, float load)
+    {
+        const uint32_t initialSamples = level.numPrimaryLocalLightSamples + level.numPrimaryInfiniteLightSamples +
+            level.numPrimaryEnvironmentSamples + level.numPrimaryBrdfSamples;
+        const bool temporal = level.resamplingMode != rtxdi::ReSTIRDI_ResamplingMode::None &&
+            level.resamplingMode != rtxdi::ReSTIRDI_ResamplingMode::Spatial;
+        const bool spatial = level.resamplingMode == rtxdi::ReSTIRDI_ResamplingMode::Spatial ||
+            level.resamplingMode == rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial ||
+            level.resamplingMode == rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal;
+
+        ReSTIRDIPassTimings timings = {};
+        timings.initialSamplingMs = 0.05f * float(initialSamples) * load;
+        timings.temporalResamplingMs = temporal ? 0.3f * load : 0.f;
+        const float spatialMs = spatial ? 0.12f * float(level.numSpatialSamples) * load : 0.f;
+        // Fused 模式的空间部分计入合并的 pass，且比独立 pass 便宜
+        if (level.resamplingMode == rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal)
+            timings.temporalResamplingMs += spatialMs * 0.5f;
+        else
+            timings.spatialResamplingMs = spatialMs;
+        timings.shadingMs = 0.4f * load;
+        return timings;
+    }
+
+    float GetTotalMs(const ReSTIRDIPassTimings& timings)
+    {
+        return timings.initialSamplingMs + timings.temporalResamplingMs + timings.spatialResamplingMs + timings.shadingMs;
+    }
+
+    // 固定种子的 [-1, 1) 噪声
+    struct Noise
+    {
+        uint32_t state;
+
+        float Next()
+        {
+            state = state * 1664525u + 1013904223u;
+            return float(state >> 8) / float(1u << 23) - 1.f;
+        }
+    };
+
+    struct LoadSegment
+    {
+        uint32_t frameCount;
+        float load;
+    };
+
+    struct ReplayResult
+    {
+        std::vector<uint32_t> levels;       // 每帧决策之后的档位
+        std::vector<float> measuredMs;      // 每帧在决策之前的档位上测得的耗时
+        std::vector<uint32_t> changeFrames;
+    };
+
+    // 闭环回放：每帧用当前档位的配置模拟耗时，再交给 governor 决定下一帧的档位
+    ReplayResult Replay(ReSTIRDIBudgetGovernor& governor, const std::vector<LoadSegment>& segments, float noiseAmplitude, uint32_t seed)
+    {
+        ReplayResult result;
+        Noise noise = { seed };
+        uint32_t frame = 0;
+        for (const LoadSegment& segment : segments)
+        {
+            for (uint32_t i = 0; i < segment.frameCount; i++, frame++)
+            {
+                const float load = segment.load * (1.f + noiseAmplitude * noise.Next());
+                const ReSTIRDIPassTimings timings = SimulateTimings(governor.GetCurrentLevel(), load);
+                const ReSTIRDIGovernorDecision decision = governor.Update(timings);
+
+                result.measuredMs.push_back(GetTotalMs(timings));
+                result.levels.push_back(decision.level);
+                if (decision.levelChange != 0)
+                    result.changeFrames.push_back(frame);
+            }
+        }
+        return result;
+    }
+
+    uint32_t CountChanges(const ReplayResult& result, uint32_t beginFrame, uint32_t endFrame)
+    {
+        uint32_t count = 0;
+        for (uint32_t frame : result.changeFrames)
+            count += frame >= beginFrame && frame < endFrame ? 1 : 0;
+        return count;
+    }
+
+    // 升档之后又降回去（或反过来）视为来回切换
+    uint32_t CountReversals(const ReplayResult& result)
+    {
+        uint32_t count = 0;
+        int previousDirection = 0;
+        for (uint32_t frame : result.changeFrames)
+        {
+            const int direction = result.levels[frame] > result.levels[frame - 1] ? 1 : -1;
+            if (previousDirection != 0 && direction != previousDirection)
+                count++;
+            previousDirection = direction;
+        }
+        return count;
+    }
+}
+
+TEST_CASE(ReSTIRDIGovernor_LadderIsMonotonic)
+{
+    // 预算极低时一路降到最后一档，经过的每一档开销都比上一档低，最后几档降级 resampling 模式
+    ReSTIRDIGovernorSettings settings = GetSettings();
+    settings.targetMs = 0.01f;
+    ReSTIRDIBudgetGovernor governor(GetBaseLevel(), settings);
+    CHECK(governor.GetLevelCount() > 4);
+
+    float previousMs = GetTotalMs(SimulateTimings(governor.GetCurrentLevel(), 1.f));
+    uint32_t previousLevel = 0;
+    for (uint32_t frame = 0; frame < 1000; frame++)
+    {
+        const ReSTIRDIGovernorDecision decision = governor.Update(SimulateTimings(governor.GetCurrentLevel(), 1.f));
+        if (decision.levelChange == 0)
+            continue;
+
+        CHECK(decision.levelChange > 0);
+        CHECK(decision.reason == ReSTIRDIGovernorReason_OverBudget);
+        const float ms = GetTotalMs(SimulateTimings(governor.GetCurrentLevel(), 1.f));
+        CHECK_MESSAGE(ms < previousMs, "level " + std::to_string(decision.level));
+        previousMs = ms;
+        previousLevel = decision.level;
+    }
+
+    CHECK(previousLevel == governor.GetLevelCount() - 1);
+    CHECK(governor.GetCurrentLevel().resamplingMode == rtxdi::ReSTIRDI_ResamplingMode::Temporal);
+    CHECK(governor.Update(SimulateTimings(governor.GetCurrentLevel(), 1.f)).reason == ReSTIRDIGovernorReason_AtLimit);
+}
+
+TEST_CASE(ReSTIRDIGovernor_StepsDownAndRecovers)
+{
+    ReSTIRDIBudgetGovernor governor(GetBaseLevel(), GetSettings());
+
+    // 负载突增 60% 后恢复，3% 的帧间噪声
+    const std::vector<LoadSegment> segments = { { 200, 1.0f }, { 400, 1.6f }, { 600, 1.0f } };
+    const ReplayResult result = Replay(governor, segments, 0.03f, 1);
+
+    const float upperMs = c_TargetMs * (1.f + c_UpperTolerance);
+    const float lowerMs = c_TargetMs * (1.f - c_LowerTolerance);
+
+    // 负载正常时第 0 档就在预算内
+    CHECK(CountChanges(result, 0, 200) == 0);
+    CHECK(result.levels[199] == 0);
+
+    // 超预算之后很快降档，之后稳定在预算内
+    CHECK(CountChanges(result, 200, 230) > 0);
+    CHECK(result.levels[229] > 0);
+    for (uint32_t frame = 260; frame < 600; frame++)
+        CHECK_MESSAGE(result.measuredMs[frame] <= upperMs, "frame " + std::to_string(frame));
+    CHECK(CountChanges(result, 260, 600) == 0);
+
+    // 负载恢复后逐档升回去，停在第 0 档或再升一档就会超出死区的档位
+    const uint32_t peakLevel = result.levels[599];
+    const uint32_t finalLevel = result.levels.back();
+    CHECK(finalLevel < peakLevel);
+    CHECK(CountChanges(result, 1000, 1200) == 0);
+    CHECK(result.measuredMs.back() <= upperMs);
+    CHECK(finalLevel == 0 || result.measuredMs.back() >= lowerMs * 0.97f);
+
+    // 升档每次一档，且两次升档之间至少间隔 upFrames
+    uint32_t lastUpFrame = 0;
+    for (uint32_t frame : result.changeFrames)
+    {
+        if (frame < 600 || result.levels[frame] > result.levels[frame - 1])
+            continue;
+        CHECK(result.levels[frame - 1] - result.levels[frame] == 1);
+        CHECK_MESSAGE(lastUpFrame == 0 || frame - lastUpFrame >= c_UpFrames, "frame " + std::to_string(frame));
+        lastUpFrame = frame;
+    }
+
+    CHECK(CountReversals(result) == 1);
+}
+
+TEST_CASE(ReSTIRDIGovernor_HoldsInsideDeadband)
+{
+    ReSTIRDIBudgetGovernor governor(GetBaseLevel(), GetSettings());
+
+    // 第 0 档正好在目标附近，±8% 的噪声单帧会超出上限，但平滑之后不应触发任何调整
+    const float load = c_TargetMs / GetTotalMs(SimulateTimings(GetBaseLevel(), 1.f));
+    const ReplayResult result = Replay(governor, { { 2000, load } }, 0.08f, 7);
+
+    const float upperMs = c_TargetMs * (1.f + c_UpperTolerance);
+    uint32_t framesAboveUpper = 0;
+    for (float ms : result.measuredMs)
+        framesAboveUpper += ms > upperMs ? 1 : 0;
+
+    CHECK(framesAboveUpper > 0);
+    CHECK(result.changeFrames.empty());
+}
+
+TEST_CASE(ReSTIRDIGovernor_NoOscillationAtBoundary)
+{
+    // 负载使第 0 档略超预算：降档之后稳定下来，不再来回调整
+    for (float overshoot : { 1.06f, 1.1f, 1.2f })
+    {
+        ReSTIRDIBudgetGovernor governor(GetBaseLevel(), GetSettings());
+        const float load = overshoot * c_TargetMs / GetTotalMs(SimulateTimings(GetBaseLevel(), 1.f));
+        const ReplayResult result = Replay(governor, { { 3000, load } }, 0.03f, 11);
+
+        const std::string label = "overshoot " + std::to_string(overshoot);
+        CHECK_MESSAGE(!result.changeFrames.empty(), label);
+        CHECK_MESSAGE(CountReversals(result) == 0, label);
+        CHECK_MESSAGE(CountChanges(result, 100, 3000) == 0, label);
+    }
+
+    // 档位间隔很大时，第 0 档超出上限而第 1 档低于下限，只靠死区挡不住；
+    // 升档前的预测必须发现第 0 档仍会超预算，停在第 1 档
+    ReSTIRDIGovernorLevel coarseLevel = GetBaseLevel();
+    coarseLevel.numSpatialSamples = 16;
+    const float coarseLoad = 0.62f;
+    ReSTIRDIBudgetGovernor governor(coarseLevel, GetSettings());
+    CHECK(GetTotalMs(SimulateTimings(coarseLevel, coarseLoad * 0.98f)) > c_TargetMs * (1.f + c_UpperTolerance));
+
+    const ReplayResult result = Replay(governor, { { 3000, coarseLoad } }, 0.02f, 5);
+    CHECK(result.levels.back() == 1);
+    CHECK(result.measuredMs.back() < c_TargetMs * (1.f - c_LowerTolerance));
+    CHECK(CountReversals(result) == 0);
+    CHECK(result.changeFrames.size() == 1);
+}
+
+TEST_CASE(ReSTIRDIGovernor_UpWaitsForUpFrames)
+{
+    ReSTIRDIBudgetGovernor governor(GetBaseLevel(), GetSettings());
+
+    // 先用高负载推到较低的档位
+    while (governor.GetLevelIndex() < 3)
+        governor.Update(SimulateTimings(governor.GetCurrentLevel(), 3.f));
+    const uint32_t level = governor.GetLevelIndex();
+
+    // 负载大幅下降后，平滑后的耗时低于下限起连续 upFrames 帧才升一档，期间保持不动
+    const float lowerMs = c_TargetMs * (1.f - c_LowerTolerance);
+    uint32_t headroomFrames = 0;
+    for (uint32_t frame = 0; frame < 200; frame++)
+    {
+        const ReSTIRDIGovernorDecision decision = governor.Update(SimulateTimings(governor.GetCurrentLevel(), 0.3f));
+        headroomFrames = decision.levelChange == 0 && decision.smoothedMs < lowerMs ? headroomFrames + 1 : headroomFrames;
+        if (decision.levelChange != 0)
+        {
+            CHECK(decision.levelChange == -1);
+            CHECK(decision.reason == ReSTIRDIGovernorReason_Headroom);
+            break;
+        }
+    }
+
+    CHECK(governor.GetLevelIndex() == level - 1);
+    CHECK_MESSAGE(headroomFrames == c_UpFrames - 1, std::to_string(headroomFrames));
+}
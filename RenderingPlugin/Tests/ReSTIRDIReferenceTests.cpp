@@ -0,0 +1,132 @@
+﻿#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include <Rtxdi/DI/ReSTIRDI.h>
+
+#include "ReSTIRDIReference.h"
+#include "TestFramework.h"
+
+namespace
+{
+    using rtxdi::ReSTIRDI_ResamplingMode;
+
+    constexpr uint32_t c_FrameCount = 16;
+
+    ReSTIRDIReferenceSceneDesc MakeSceneDesc()
+    {
+        ReSTIRDIReferenceSceneDesc desc = {};
+        desc.width = 96;
+        desc.height = 64;
+        desc.lightCount = 512;
+        desc.seed = 7;
+        desc.lightPowerSpread = 4.f;
+        return desc;
+    }
+
+    // 参数取 ReSTIRDIContext 的默认值，与编辑器里对 live context 运行时相同
+    ReSTIRDIReferenceParameters MakeParameters(ReSTIRDI_ResamplingMode mode)
+    {
+        rtxdi::ReSTIRDIStaticParameters staticParams;
+        staticParams.RenderWidth = MakeSceneDesc().width;
+        staticParams.RenderHeight = MakeSceneDesc().height;
+
+        rtxdi::ReSTIRDIContext context(staticParams);
+        context.SetResamplingMode(mode);
+        return ReSTIRDIReferenceParameters::FromContext(context);
+    }
+
+    const char* GetModeName(ReSTIRDI_ResamplingMode mode)
+    {
+        switch (mode)
+        {
+        case ReSTIRDI_ResamplingMode::None: return "None";
+        case ReSTIRDI_ResamplingMode::Temporal: return "Temporal";
+        case ReSTIRDI_ResamplingMode::Spatial: return "Spatial";
+        case ReSTIRDI_ResamplingMode::TemporalAndSpatial: return "TemporalAndSpatial";
+        case ReSTIRDI_ResamplingMode::FusedSpatiotemporal: return "FusedSpatiotemporal";
+        }
+        return "?";
+    }
+
+    void PrintStats(const char* name, const ReSTIRDIReferenceStats& stats)
+    {
+        std::printf("  %-32s relMSE %.4f (last %.4f), bias %+.4f, %.1f pdf evals/pixel, %.2f ms/frame, efficiency %.2f\n",
+            name, stats.relativeMSE, stats.lastFrameRelativeMSE, stats.relativeBias, stats.targetPdfEvaluationsPerPixel,
+            stats.millisecondsPerFrame, stats.efficiency);
+    }
+}
+
+TEST_CASE(ReSTIRDIReference_IsDeterministic)
+{
+    const ReSTIRDIReferenceParameters params = MakeParameters(ReSTIRDI_ResamplingMode::TemporalAndSpatial);
+
+    ReSTIRDIReference first(MakeSceneDesc());
+    ReSTIRDIReference second(MakeSceneDesc());
+    const ReSTIRDIReferenceStats a = first.Run(params, 4);
+    const ReSTIRDIReferenceStats b = second.Run(params, 4);
+    const ReSTIRDIReferenceStats c = first.Run(params, 4);
+
+    // 同一场景同样的参数结果逐位相同，Run 每次从空的历史开始
+    CHECK(a.frameCount == 4);
+    CHECK(a.relativeMSE == b.relativeMSE && a.relativeBias == b.relativeBias);
+    CHECK(a.relativeMSE == c.relativeMSE && a.lastFrameRelativeMSE == c.lastFrameRelativeMSE);
+}
+
+TEST_CASE(ReSTIRDIReference_ResamplingModes)
+{
+    ReSTIRDIReference reference(MakeSceneDesc());
+
+    const ReSTIRDI_ResamplingMode modes[] = { ReSTIRDI_ResamplingMode::None, ReSTIRDI_ResamplingMode::Temporal,
+        ReSTIRDI_ResamplingMode::Spatial, ReSTIRDI_ResamplingMode::TemporalAndSpatial, ReSTIRDI_ResamplingMode::FusedSpatiotemporal };
+    ReSTIRDIReferenceStats stats[5];
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        stats[i] = reference.Run(MakeParameters(modes[i]), c_FrameCount);
+        PrintStats(GetModeName(modes[i]), stats[i]);
+        CHECK(stats[i].frameCount == c_FrameCount);
+        CHECK(std::isfinite(stats[i].relativeMSE) && stats[i].relativeMSE > 0.f);
+    }
+
+    // 每种复用都比只有初始采样的误差低，时域累积后最后一帧的误差低于平均值
+    for (uint32_t i = 1; i < 5; i++)
+        CHECK_MESSAGE(stats[i].relativeMSE < stats[0].relativeMSE, GetModeName(modes[i]));
+    CHECK(stats[1].lastFrameRelativeMSE < stats[1].relativeMSE);
+    CHECK(stats[3].lastFrameRelativeMSE < stats[3].relativeMSE);
+
+    // 默认的偏差校正下所有模式都是无偏的
+    for (uint32_t i = 0; i < 5; i++)
+        CHECK_MESSAGE(std::fabs(stats[i].relativeBias) < 0.02f, std::string(GetModeName(modes[i])) + ": " + std::to_string(stats[i].relativeBias));
+
+    // 合成场景中 FusedSpatiotemporal 按 TemporalAndSpatial 处理
+    CHECK(stats[4].relativeMSE == stats[3].relativeMSE);
+}
+
+TEST_CASE(ReSTIRDIReference_BiasCorrection)
+{
+    ReSTIRDIReference reference(MakeSceneDesc());
+
+    const ReSTIRDI_TemporalBiasCorrectionMode temporalModes[] = { ReSTIRDI_TemporalBiasCorrectionMode::Off,
+        ReSTIRDI_TemporalBiasCorrectionMode::Basic, ReSTIRDI_TemporalBiasCorrectionMode::Pairwise };
+    const ReSTIRDI_SpatialBiasCorrectionMode spatialModes[] = { ReSTIRDI_SpatialBiasCorrectionMode::Off,
+        ReSTIRDI_SpatialBiasCorrectionMode::Basic, ReSTIRDI_SpatialBiasCorrectionMode::Pairwise };
+    const char* names[] = { "TemporalAndSpatial, Off", "TemporalAndSpatial, Basic", "TemporalAndSpatial, Pairwise" };
+
+    ReSTIRDIReferenceStats stats[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ReSTIRDIReferenceParameters params = MakeParameters(ReSTIRDI_ResamplingMode::TemporalAndSpatial);
+        params.temporalResamplingParams.temporalBiasCorrection = temporalModes[i];
+        params.spatialResamplingParams.spatialBiasCorrection = spatialModes[i];
+        stats[i] = reference.Run(params, c_FrameCount);
+        PrintStats(names[i], stats[i]);
+    }
+
+    // 关闭偏差校正时复用了相邻像素目标 pdf 不同的样本，结果明显偏离真值；Basic 和 Pairwise 都是无偏的
+    CHECK_MESSAGE(std::fabs(stats[0].relativeBias) > 0.05f, std::to_string(stats[0].relativeBias));
+    CHECK_MESSAGE(std::fabs(stats[1].relativeBias) < 0.02f, std::to_string(stats[1].relativeBias));
+    CHECK_MESSAGE(std::fabs(stats[2].relativeBias) < 0.02f, std::to_string(stats[2].relativeBias));
+
+    // Pairwise MIS 的误差不高于 Basic
+    CHECK(stats[2].relativeMSE < stats[1].relativeMSE);
+}
@@ -0,0 +1,103 @@
+﻿#include <string>
+
+#include "ReservoirBufferSizing.h"
+#include "TestFramework.h"
+
+namespace
+{
+    using rtxdi::ReSTIRDI_ResamplingMode;
+
+    rtxdi::ReSTIRDIStaticParameters MakeStaticParameters()
+    {
+        rtxdi::ReSTIRDIStaticParameters staticParams;
+        staticParams.RenderWidth = 64;
+        staticParams.RenderHeight = 32;
+        return staticParams;
+    }
+
+    // 本帧写入的数组都不能是 temporal 还没读完的上一帧输出
+    void CheckIndices(const ReSTIRDI_BufferIndices& indices, ReSTIRDI_ResamplingMode mode, uint32_t lastFrameOutput, const std::string& label)
+    {
+        const uint32_t arrayCount = GetReSTIRDIMinReservoirBuffers(mode);
+        CHECK_MESSAGE(indices.initialSamplingOutputBufferIndex < arrayCount, label);
+        CHECK_MESSAGE(indices.temporalResamplingOutputBufferIndex < arrayCount, label);
+        CHECK_MESSAGE(indices.spatialResamplingOutputBufferIndex < arrayCount, label);
+        CHECK_MESSAGE(indices.shadingInputBufferIndex < arrayCount, label);
+        if (mode == ReSTIRDI_ResamplingMode::None)
+            return;
+
+        CHECK_MESSAGE(indices.temporalResamplingInputBufferIndex == lastFrameOutput, label);
+        CHECK_MESSAGE(indices.initialSamplingOutputBufferIndex != lastFrameOutput, label);
+        CHECK_MESSAGE(indices.temporalResamplingOutputBufferIndex != lastFrameOutput, label);
+    }
+}
+
+TEST_CASE(ReservoirBufferSizing_DescMatchesMode)
+{
+    rtxdi::ReSTIRDIContext context(MakeStaticParameters());
+    const uint32_t pitch = context.GetReservoirBufferParameters().reservoirArrayPitch;
+
+    const ReservoirBufferDesc none = CalculateReSTIRDIReservoirBufferDesc(context, ReSTIRDI_ResamplingMode::None);
+    CHECK(none.numReservoirBuffers == 1);
+    CHECK(none.reservoirArrayPitch == pitch);
+    CHECK(none.totalReservoirCount == pitch);
+
+    const ReservoirBufferDesc temporalAndSpatial = CalculateReSTIRDIReservoirBufferDesc(context, ReSTIRDI_ResamplingMode::TemporalAndSpatial);
+    CHECK(temporalAndSpatial.numReservoirBuffers == 2);
+    CHECK(temporalAndSpatial.totalReservoirCount == pitch * 2);
+    CHECK(temporalAndSpatial.totalSizeInBytes == uint64_t(pitch) * 2 * sizeof(RTXDI_PackedDIReservoir));
+}
+
+TEST_CASE(ReservoirBufferSizing_PlannerChainsFrames)
+{
+    rtxdi::ReSTIRDIContext context(MakeStaticParameters());
+    ReSTIRDIReservoirPlanner planner;
+
+    const ReSTIRDI_ResamplingMode modes[] = { ReSTIRDI_ResamplingMode::Temporal, ReSTIRDI_ResamplingMode::TemporalAndSpatial,
+        ReSTIRDI_ResamplingMode::TemporalAndSpatial, ReSTIRDI_ResamplingMode::FusedSpatiotemporal, ReSTIRDI_ResamplingMode::Spatial,
+        ReSTIRDI_ResamplingMode::None, ReSTIRDI_ResamplingMode::Temporal, ReSTIRDI_ResamplingMode::TemporalAndSpatial };
+
+    uint32_t lastFrameOutput = 0;
+    for (uint32_t frame = 0; frame < 8; frame++)
+    {
+        context.SetFrameIndex(frame);
+        context.SetResamplingMode(modes[frame]);
+        const ReSTIRDI_BufferIndices indices = planner.Update(context);
+        CheckIndices(indices, modes[frame], lastFrameOutput, "frame " + std::to_string(frame));
+
+        // 同一帧重复调用结果不变
+        const ReSTIRDI_BufferIndices again = planner.Update(context);
+        CHECK(again.shadingInputBufferIndex == indices.shadingInputBufferIndex);
+        CHECK(again.temporalResamplingInputBufferIndex == indices.temporalResamplingInputBufferIndex);
+
+        lastFrameOutput = indices.shadingInputBufferIndex;
+    }
+}
+
+TEST_CASE(ReservoirBufferSizing_PlannerModeSwitchWithinFrame)
+{
+    rtxdi::ReSTIRDIContext context(MakeStaticParameters());
+    ReSTIRDIReservoirPlanner planner;
+
+    context.SetResamplingMode(ReSTIRDI_ResamplingMode::Temporal);
+    context.SetFrameIndex(0);
+    const uint32_t lastFrameOutput = planner.Update(context).shadingInputBufferIndex;
+
+    // 第 1 帧先按 TemporalAndSpatial 取了下标，随后同一帧内切到 Temporal
+    context.SetFrameIndex(1);
+    context.SetResamplingMode(ReSTIRDI_ResamplingMode::TemporalAndSpatial);
+    const ReSTIRDI_BufferIndices spatial = planner.Update(context);
+    CheckIndices(spatial, ReSTIRDI_ResamplingMode::TemporalAndSpatial, lastFrameOutput, "TemporalAndSpatial");
+    CHECK(spatial.shadingInputBufferIndex == lastFrameOutput);
+
+    context.SetResamplingMode(ReSTIRDI_ResamplingMode::Temporal);
+    const ReSTIRDI_BufferIndices temporal = planner.Update(context);
+    CheckIndices(temporal, ReSTIRDI_ResamplingMode::Temporal, lastFrameOutput, "Temporal");
+    CHECK(temporal.shadingInputBufferIndex == temporal.temporalResamplingOutputBufferIndex);
+    CHECK(temporal.shadingInputBufferIndex != lastFrameOutput);
+
+    // 下一帧的 temporal 输入是本帧最终使用的模式的输出
+    context.SetFrameIndex(2);
+    const ReSTIRDI_BufferIndices next = planner.Update(context);
+    CHECK(next.temporalResamplingInputBufferIndex == temporal.shadingInputBufferIndex);
+}
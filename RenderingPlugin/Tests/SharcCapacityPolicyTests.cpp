@@ -0,0 +1,289 @@
+﻿#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "SharcCapacityPolicy.h"
+#include "TestFramework.h"
+
+namespace
+{
+    // 与 SharcCapacityPolicy.cpp 中的默认值一致
+    constexpr uint32_t c_MinCapacity = 1u << 18;
+    constexpr uint32_t c_MaxCapacity = 1u << 23;
+    constexpr float c_GrowOccupancy = 0.5f;
+    constexpr float c_ShrinkOccupancy = 0.125f;
+    constexpr uint32_t c_GrowFrames = 4;
+    constexpr uint32_t c_ShrinkFrames = 300;
+    constexpr uint32_t c_CooldownFrames = 120;
+
+    // 与 SharcCacheInstance::kReadbackSlotCount 一致，统计在提交之后第 3 帧读回
+    constexpr uint32_t c_ReadbackLatency = 3;
+    // bucket 冲突使 hash 表无法装满，超过这个占用率的插入失败
+    constexpr float c_MaxFill = 0.75f;
+
+    // Data/SharcOccupancy_*.csv：每帧场景需要缓存的 voxel 数（workingSetEntries），与 capacity 无关，
+    // 回放时按当前 capacity 得到 liveEntries，形成与运行时相同的闭环
+    std::vector<uint32_t> LoadTrace(const char* fileName)
+    {
+        std::vector<uint32_t> workingSet;
+        std::ifstream file(PluginTests::GetDataPath(fileName));
+        std::string line;
+        std::getline(file, line);
+        while (std::getline(file, line))
+        {
+            const size_t comma = line.find(',');
+            if (comma != std::string::npos)
+                workingSet.push_back(uint32_t(std::stoul(line.substr(comma + 1))));
+        }
+        return workingSet;
+    }
+
+    struct ResizeEvent
+    {
+        uint32_t frame;
+        uint32_t oldCapacity;
+        uint32_t newCapacity;
+    };
+
+    struct ReplayResult
+    {
+        std::vector<ResizeEvent> resizes;
+        std::vector<float> occupancy;   // 每帧 GPU 上的真实占用率
+        uint32_t finalCapacity = 0;
+        uint32_t longestUnservedGrowRun = 0;    // 占用率超过 growOccupancy 且还能扩容的最长连续帧数
+    };
+
+    ReplayResult ReplayTrace(const std::vector<uint32_t>& workingSet, uint32_t initialCapacity)
+    {
+        SharcCapacityPolicy policy(SharcCapacitySettings{}, initialCapacity);
+        ReplayResult result;
+
+        struct InFlight
+        {
+            SharcOccupancyStats stats;
+            uint32_t capacity;
+            uint32_t readyFrame;
+        };
+        std::vector<InFlight> inFlight;
+
+        uint32_t capacity = policy.GetDecision().capacity;
+        uint32_t growRun = 0;
+        for (uint32_t frame = 0; frame < workingSet.size(); frame++)
+        {
+            // 与 SharcCache.Update 相同：上一帧的请求在这一帧开始时重新分配并 rehash
+            const SharcCapacityDecision decision = policy.GetDecision();
+            if (decision.requestedCapacity != decision.capacity)
+            {
+                result.resizes.push_back({ frame, capacity, decision.requestedCapacity });
+                capacity = decision.requestedCapacity;
+                policy.SetCapacity(capacity);
+            }
+
+            SharcOccupancyStats stats = {};
+            stats.liveEntries = std::min(workingSet[frame], uint32_t(capacity * c_MaxFill));
+            stats.sampledEntries = stats.liveEntries / 4;
+            stats.evictedEntries = stats.liveEntries / 64;
+            inFlight.push_back({ stats, capacity, frame + c_ReadbackLatency });
+
+            const float occupancy = float(stats.liveEntries) / float(capacity);
+            result.occupancy.push_back(occupancy);
+            growRun = occupancy > c_GrowOccupancy && capacity < c_MaxCapacity ? growRun + 1 : 0;
+            result.longestUnservedGrowRun = std::max(result.longestUnservedGrowRun, growRun);
+
+            for (auto it = inFlight.begin(); it != inFlight.end();)
+            {
+                if (it->readyFrame > frame)
+                {
+                    ++it;
+                    continue;
+                }
+                policy.AddSample(it->stats, it->capacity);
+                it = inFlight.erase(it);
+            }
+        }
+
+        result.finalCapacity = capacity;
+        return result;
+    }
+
+    bool InBand(float occupancy)
+    {
+        return occupancy >= c_ShrinkOccupancy && occupancy <= c_GrowOccupancy;
+    }
+
+    // 方向相反的两次调整之间至少间隔 cooldownFrames，否则视为来回切换
+    void CheckNoOscillation(const ReplayResult& result)
+    {
+        for (size_t i = 1; i < result.resizes.size(); i++)
+        {
+            const ResizeEvent& a = result.resizes[i - 1];
+            const ResizeEvent& b = result.resizes[i];
+            const bool reversed = (a.newCapacity > a.oldCapacity) != (b.newCapacity > b.oldCapacity);
+            CHECK_MESSAGE(!reversed || b.frame - a.frame >= c_CooldownFrames,
+                "frames " + std::to_string(a.frame) + " and " + std::to_string(b.frame));
+        }
+    }
+
+    SharcOccupancyStats MakeStats(uint32_t capacity, float occupancy)
+    {
+        SharcOccupancyStats stats = {};
+        stats.liveEntries = uint32_t(capacity * occupancy);
+        return stats;
+    }
+}
+
+TEST_CASE(SharcCapacityPolicy_GrowAfterGrowFrames)
+{
+    SharcCapacityPolicy policy(SharcCapacitySettings{}, c_MinCapacity);
+
+    // 连续帧数被中间一帧打断时重新计数
+    for (uint32_t i = 0; i < c_GrowFrames - 1; i++)
+        policy.AddSample(MakeStats(c_MinCapacity, 0.6f), c_MinCapacity);
+    policy.AddSample(MakeStats(c_MinCapacity, 0.3f), c_MinCapacity);
+    for (uint32_t i = 0; i < c_GrowFrames - 1; i++)
+        policy.AddSample(MakeStats(c_MinCapacity, 0.6f), c_MinCapacity);
+    CHECK(policy.GetDecision().requestedCapacity == c_MinCapacity);
+
+    policy.AddSample(MakeStats(c_MinCapacity, 0.6f), c_MinCapacity);
+    const SharcCapacityDecision decision = policy.GetDecision();
+    CHECK(decision.requestedCapacity >= c_MinCapacity * 2);
+    CHECK(decision.requestedCapacity <= c_MaxCapacity);
+    CHECK(InBand(float(MakeStats(c_MinCapacity, 0.6f).liveEntries) / float(decision.requestedCapacity)));
+}
+
+TEST_CASE(SharcCapacityPolicy_DropsStaleSamples)
+{
+    SharcCapacityPolicy policy(SharcCapacitySettings{}, c_MinCapacity * 4);
+    policy.SetCapacity(c_MinCapacity * 8);
+
+    // resize 之前提交的统计对应旧的 capacity，不计入新 capacity 的判断
+    for (uint32_t i = 0; i < c_GrowFrames * 2; i++)
+        policy.AddSample(MakeStats(c_MinCapacity * 4, 0.9f), c_MinCapacity * 4);
+
+    const SharcCapacityDecision decision = policy.GetDecision();
+    CHECK(decision.sampleCount == 0);
+    CHECK(decision.requestedCapacity == c_MinCapacity * 8);
+}
+
+TEST_CASE(SharcCapacityPolicy_ShrinkWaitsForCooldown)
+{
+    SharcCapacitySettings settings = {};
+    settings.shrinkFrames = 10;
+    settings.cooldownFrames = 50;
+    const uint32_t capacity = c_MinCapacity * 16;
+    SharcCapacityPolicy policy(settings, capacity);
+
+    // 持续低占用已经超过 shrinkFrames，但调整之后的样本数不足 cooldownFrames
+    for (uint32_t i = 1; i < settings.cooldownFrames; i++)
+    {
+        policy.AddSample(MakeStats(capacity, 0.02f), capacity);
+        CHECK_MESSAGE(policy.GetDecision().requestedCapacity == capacity, "sample " + std::to_string(i));
+    }
+
+    policy.AddSample(MakeStats(capacity, 0.02f), capacity);
+    const SharcCapacityDecision decision = policy.GetDecision();
+    CHECK(decision.requestedCapacity <= capacity / 2);
+    CHECK(decision.requestedCapacity >= c_MinCapacity);
+
+    // 缩容完成后重新计 cooldown，扩容不受 cooldown 限制
+    policy.SetCapacity(decision.requestedCapacity);
+    for (uint32_t i = 0; i < settings.cooldownFrames - 1; i++)
+        policy.AddSample(MakeStats(decision.requestedCapacity, 0.02f), decision.requestedCapacity);
+    CHECK(policy.GetDecision().requestedCapacity == decision.requestedCapacity);
+
+    policy.SetCapacity(decision.requestedCapacity);
+    for (uint32_t i = 0; i < c_GrowFrames; i++)
+        policy.AddSample(MakeStats(decision.requestedCapacity, 0.7f), decision.requestedCapacity);
+    CHECK(policy.GetDecision().requestedCapacity > decision.requestedCapacity);
+}
+
+TEST_CASE(SharcCapacityPolicy_ShrinkUsesWindowPeak)
+{
+    SharcCapacitySettings settings = {};
+    settings.shrinkFrames = 10;
+    settings.cooldownFrames = 10;
+    const uint32_t capacity = c_MaxCapacity;
+    SharcCapacityPolicy policy(settings, capacity);
+
+    // 低占用期间的峰值决定缩容后的大小，缩容之后峰值也不会超过 growOccupancy
+    for (uint32_t i = 0; i < settings.shrinkFrames; i++)
+        policy.AddSample(MakeStats(capacity, i == 3 ? 0.12f : 0.01f), capacity);
+
+    const SharcCapacityDecision decision = policy.GetDecision();
+    CHECK(decision.requestedCapacity < capacity);
+    CHECK(InBand(float(MakeStats(capacity, 0.12f).liveEntries) / float(decision.requestedCapacity)));
+}
+
+TEST_CASE(SharcCapacityPolicy_TraceRamp)
+{
+    const std::vector<uint32_t> trace = LoadTrace("SharcOccupancy_Ramp.csv");
+    CHECK(trace.size() == 1500);
+    if (trace.empty())
+        return;
+
+    const ReplayResult result = ReplayTrace(trace, c_MinCapacity);
+
+    CHECK(!result.resizes.empty());
+    for (const ResizeEvent& resize : result.resizes)
+    {
+        CHECK_MESSAGE(resize.newCapacity > resize.oldCapacity, "frame " + std::to_string(resize.frame));
+        CHECK(resize.newCapacity <= c_MaxCapacity);
+    }
+
+    // 超过阈值之后 growFrames 帧 + 读回延迟 + 重新分配的一帧之内完成扩容
+    CHECK_MESSAGE(result.longestUnservedGrowRun <= c_GrowFrames + c_ReadbackLatency + 1, std::to_string(result.longestUnservedGrowRun));
+    CHECK(result.finalCapacity == c_MaxCapacity || InBand(result.occupancy.back()));
+    CheckNoOscillation(result);
+}
+
+TEST_CASE(SharcCapacityPolicy_TracePlateau)
+{
+    const std::vector<uint32_t> trace = LoadTrace("SharcOccupancy_Plateau.csv");
+    CHECK(trace.size() == 3000);
+    if (trace.empty())
+        return;
+
+    const ReplayResult result = ReplayTrace(trace, c_MinCapacity);
+
+    // 起步阶段扩容到位之后，带噪声的平稳负载不再触发任何调整
+    CHECK(!result.resizes.empty());
+    for (const ResizeEvent& resize : result.resizes)
+        CHECK_MESSAGE(resize.frame < 100 && resize.newCapacity > resize.oldCapacity, "frame " + std::to_string(resize.frame));
+
+    for (size_t frame = 100; frame < result.occupancy.size(); frame++)
+        CHECK_MESSAGE(InBand(result.occupancy[frame]), "frame " + std::to_string(frame));
+    CheckNoOscillation(result);
+}
+
+TEST_CASE(SharcCapacityPolicy_TraceDropOff)
+{
+    const std::vector<uint32_t> trace = LoadTrace("SharcOccupancy_DropOff.csv");
+    CHECK(trace.size() == 2000);
+    if (trace.empty())
+        return;
+
+    // 工作集在第 600 帧骤降
+    constexpr uint32_t c_DropFrame = 600;
+    const ReplayResult result = ReplayTrace(trace, c_MinCapacity);
+
+    std::vector<ResizeEvent> shrinks;
+    for (const ResizeEvent& resize : result.resizes)
+    {
+        if (resize.newCapacity < resize.oldCapacity)
+            shrinks.push_back(resize);
+        else
+            CHECK_MESSAGE(resize.frame < c_DropFrame, "frame " + std::to_string(resize.frame));
+    }
+
+    // 一次缩到位，且要等满 shrinkFrames 帧的低占用
+    CHECK(shrinks.size() == 1);
+    if (!shrinks.empty())
+    {
+        CHECK(shrinks[0].frame >= c_DropFrame + c_ShrinkFrames);
+        CHECK(shrinks[0].frame <= c_DropFrame + c_ShrinkFrames + c_ReadbackLatency + 2);
+    }
+
+    CHECK(InBand(result.occupancy.back()));
+    CheckNoOscillation(result);
+}
@@ -0,0 +1,97 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "SharcHashGrid.h"
+#include "TestFramework.h"
+
+namespace
+{
+    // 期望值按 HashGridCommon.h 的公式逐步计算（float 精度，HASH_GRID_HASH = HASH_GRID_HASH_XXHASH32，
+    // sceneScale 45，logarithmBase 2，levelBias 0），位置都离 voxel 边界和层级边界足够远
+    struct GoldenSample
+    {
+        float position[3];
+        float normal[3];
+        float cameraPosition[3];
+        HashGridKey key;
+        uint32_t level;
+        uint32_t hash;
+        uint32_t slot4M;    // capacity = 1 << 22
+        uint32_t slot1000;  // capacity = 1000，不是 bucket 大小的整数倍
+    };
+
+    const GoldenSample c_GoldenSamples[] =
+    {
+        { { 1.3f, 0.7f, -2.2f }, { 0.f, 1.f, 0.f }, { 0.f, 1.7f, 0.f }, 0x000FFF38001E001Dull, 1, 0xEB57586Eu, 1529966, 30 },
+        { { 12.5f, -3.25f, 40.1f }, { 0.3f, -0.9f, 0.1f }, { 0.f, 1.7f, 0.f }, 0x402800E3FFF60011ull, 5, 0xA73B24C6u, 3876038, 110 },
+        { { -250.3f, 18.9f, -77.7f }, { -1.f, 0.f, 0.f }, { 10.f, 2.f, -5.f }, 0x2047FFC80007FFD4ull, 8, 0xFE2BCF7Bu, 2871163, 27 },
+        { { 0.05f, 0.02f, 0.01f }, { 0.f, 0.f, -1.f }, { 0.f, 0.f, 0.f }, 0x8008000000000001ull, 1, 0xEC557543u, 1406275, 555 },
+        { { 3000.2f, -40.6f, 1234.5f }, { -0.5f, -0.5f, -0.7f }, { 0.f, 1.7f, 0.f }, 0xE058006FFFFE0041ull, 11, 0xE2DBA259u, 1811033, 761 },
+    };
+
+    HashGridParameters MakeGridParameters(const float cameraPosition[3])
+    {
+        HashGridParameters gridParameters = {};
+        for (uint32_t i = 0; i < 3; i++)
+            gridParameters.cameraPosition[i] = cameraPosition[i];
+        gridParameters.logarithmBase = 2.f;
+        gridParameters.sceneScale = 45.f;
+        gridParameters.levelBias = 0.f;
+        return gridParameters;
+    }
+}
+
+TEST_CASE(SharcHashGrid_MatchesShaderKeys)
+{
+    CHECK(HashGridDefaultHashFunction == HashGridHashFunction_XXHash32);
+
+    for (const GoldenSample& sample : c_GoldenSamples)
+    {
+        const HashGridParameters gridParameters = MakeGridParameters(sample.cameraPosition);
+        const std::string label = "sample at " + std::to_string(sample.position[0]);
+
+        const HashGridKey key = HashGridComputeSpatialHash(sample.position, sample.normal, gridParameters);
+        CHECK_MESSAGE(key == sample.key, label);
+        CHECK_MESSAGE(HashGridGetLevelFromKey(key) == sample.level, label);
+        CHECK_MESSAGE(HashGridGetNormalBitsFromKey(key) == uint32_t(sample.key >> 61), label);
+
+        // 不使用法线时只差法线位
+        const HashGridKey keyWithoutNormal = HashGridComputeSpatialHash(sample.position, nullptr, gridParameters);
+        CHECK_MESSAGE(keyWithoutNormal == (sample.key & ((1ull << 61) - 1)), label);
+
+        CHECK_MESSAGE(HashGridHashXXHash32(key) == sample.hash, label);
+        CHECK_MESSAGE(HashGridHash32(key) == sample.hash, label);
+        CHECK_MESSAGE(HashGridGetBaseSlot(key, 1u << 22) == sample.slot4M, label);
+        CHECK_MESSAGE(HashGridGetBaseSlot(key, 1000) == sample.slot1000, label);
+
+        // voxel 中心到采样点的距离不超过半个 voxel 的对角线
+        float center[3];
+        HashGridGetPositionFromKey(key, gridParameters, center);
+        const float voxelSize = HashGridGetVoxelSize(sample.level, gridParameters);
+        for (uint32_t i = 0; i < 3; i++)
+            CHECK_MESSAGE(std::fabs(center[i] - sample.position[i]) <= voxelSize * 0.5f + 1e-3f, label);
+    }
+}
+
+TEST_CASE(SharcHashGrid_XXHash32MatchesSpec)
+{
+    // 与 xxhash_spec.md 中 8 字节输入、seed 0 的 XXH32 相同，两个 32 位小端字就是 key 的低位和高位
+    CHECK(HashGridHashXXHash32(0x0000000000000000ull) == 0xDEB39513u);
+    CHECK(HashGridHashXXHash32(0x0807060504030201ull) == 0x143A0D68u); // 字节 01 02 ... 08
+    CHECK(HashGridHashXXHash32(0xFFFFFFFFFFFFFFFFull) == 0xC182C6D9u);
+}
+
+TEST_CASE(SharcHashGrid_BaseSlotStaysInsideTable)
+{
+    // slot 与 shader 一样夹到 capacity - bucketSize，整个 bucket 都在表内
+    for (const GoldenSample& sample : c_GoldenSamples)
+    {
+        for (uint32_t capacity : { 16u, 17u, 20u, 1000u })
+        {
+            const uint32_t slot = HashGridGetBaseSlot(sample.key, capacity);
+            CHECK(slot == std::min(sample.hash % capacity, capacity - HashGridDefaultBucketSize));
+            CHECK(slot + HashGridDefaultBucketSize <= capacity);
+        }
+    }
+}
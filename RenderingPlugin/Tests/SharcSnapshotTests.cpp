@@ -0,0 +1,242 @@
+﻿#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SharcSnapshot.h"
+#include "TestFramework.h"
+
+namespace
+{
+    constexpr uint32_t c_Capacity = 1 << 15;
+    constexpr uint32_t c_StaleFrameNumBitOffset = 24;
+
+    struct SnapshotTable
+    {
+        std::vector<uint64_t> hashEntries;
+        std::vector<SharcPackedData> resolved;
+    };
+
+    SharcSnapshotDesc MakeDesc()
+    {
+        SharcSnapshotDesc desc = {};
+        desc.sceneHash = 0x0123456789ABCDEFull;
+        desc.cameraPosition[1] = 1.7f;
+        desc.useNormals = 1;
+        desc.hashFunction = HashGridDefaultHashFunction;
+        desc.capacity = c_Capacity;
+        return desc;
+    }
+
+    // 按 HashMapInsert 的规则插入网格上的 voxel；每 7 个 entry 中有一个没有采样，不会被保存
+    SnapshotTable MakeTable(const SharcSnapshotDesc& desc, uint32_t entryCount)
+    {
+        HashGridParameters gridParameters = {};
+        memcpy(gridParameters.cameraPosition, desc.cameraPosition, sizeof(gridParameters.cameraPosition));
+        gridParameters.sceneScale = 45.f;
+        gridParameters.logarithmBase = 2.f;
+
+        SharcHashMap hashMap(desc.capacity);
+        SnapshotTable table;
+        table.resolved.resize(desc.capacity);
+        for (uint32_t i = 0; i < entryCount; i++)
+        {
+            const float position[3] = { float(i % 37) * 0.5f - 9.f, float(i / 37 % 11) * 0.25f, float(i / 407) * 0.5f - 3.f };
+            const float normal[3] = { 0.f, (i & 1) ? 1.f : -1.f, 0.f };
+
+            uint32_t cacheIndex;
+            CHECK(hashMap.Insert(HashGridComputeSpatialHash(position, normal, gridParameters), cacheIndex));
+
+            SharcPackedData& data = table.resolved[cacheIndex];
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                const float radiance = float(i) + float(c) * 0.25f;
+                memcpy(&data.radianceData[c], &radiance, sizeof(float));
+            }
+            const uint32_t sampleNum = i % 7 == 0 ? 0 : i % 1000 + 1;
+            data.sampleData = sampleNum | (5u << 18) | (3u << c_StaleFrameNumBitOffset);
+        }
+
+        table.hashEntries.resize(desc.capacity);
+        for (uint32_t i = 0; i < desc.capacity; i++)
+            table.hashEntries[i] = hashMap.GetEntry(i);
+        return table;
+    }
+
+    std::string GetSnapshotPath(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<uint8_t> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const std::string& path, const std::vector<uint8_t>& bytes)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+    }
+
+    // 加载失败时输出缓冲保持不变
+    SharcSnapshotResult LoadExpectingUnchanged(const std::string& path, const SharcSnapshotDesc& desc, const std::string& label)
+    {
+        std::vector<uint64_t> hashEntries(desc.capacity, 0xDDDDDDDDDDDDDDDDull);
+        std::vector<SharcPackedData> resolved(desc.capacity, SharcPackedData{ { 1, 2, 3 }, 4 });
+        const SharcSnapshotStats stats = LoadSharcSnapshot(path.c_str(), desc, hashEntries.data(), resolved.data());
+        if (stats.result != SharcSnapshotResult_Ok)
+        {
+            bool unchanged = true;
+            for (uint32_t i = 0; i < desc.capacity; i++)
+                unchanged &= hashEntries[i] == 0xDDDDDDDDDDDDDDDDull && resolved[i].sampleData == 4;
+            CHECK_MESSAGE(unchanged, label);
+        }
+        return stats.result;
+    }
+}
+
+TEST_CASE(SharcSnapshot_RoundTrip)
+{
+    const SharcSnapshotDesc desc = MakeDesc();
+    const SnapshotTable table = MakeTable(desc, 9000);
+    const std::string path = GetSnapshotPath("SharcSnapshotTests_RoundTrip.bin");
+
+    std::unordered_map<uint64_t, SharcPackedData> expected;
+    for (uint32_t i = 0; i < desc.capacity; i++)
+    {
+        if (table.hashEntries[i] != HashGridInvalidHashKey && (table.resolved[i].sampleData & ((1u << 18) - 1)) != 0)
+            expected[table.hashEntries[i]] = table.resolved[i];
+    }
+
+    const SharcSnapshotStats saved = SaveSharcSnapshot(path.c_str(), desc, table.hashEntries.data(), table.resolved.data());
+    CHECK(saved.result == SharcSnapshotResult_Ok);
+    CHECK(saved.entryCount == expected.size());
+    // 只存有采样的 entry，排序后的 key 差分用 varint 编码，平均不到 8 字节
+    CHECK(saved.fileBytes < uint64_t(saved.entryCount) * (sizeof(uint64_t) + sizeof(SharcPackedData)));
+    CHECK(saved.fileBytes < saved.rawBytes / 4);
+
+    std::vector<uint64_t> hashEntries(desc.capacity, 0xDDDDDDDDDDDDDDDDull);
+    std::vector<SharcPackedData> resolved(desc.capacity, SharcPackedData{ { 1, 2, 3 }, 4 });
+    const SharcSnapshotStats loaded = LoadSharcSnapshot(path.c_str(), desc, hashEntries.data(), resolved.data());
+    CHECK(loaded.result == SharcSnapshotResult_Ok);
+    CHECK(loaded.entryCount == expected.size());
+    CHECK(loaded.loadedEntries == expected.size());
+    CHECK(loaded.relevelledEntries == 0);
+    CHECK(loaded.mergedEntries == 0);
+    CHECK(loaded.droppedEntries == 0);
+
+    // 每个 key 都在自己的 bucket 内，payload 除 stale 计数外与保存时相同
+    uint32_t found = 0;
+    for (uint32_t i = 0; i < desc.capacity; i++)
+    {
+        if (hashEntries[i] == HashGridInvalidHashKey)
+        {
+            CHECK(resolved[i].sampleData == 0);
+            continue;
+        }
+
+        const auto it = expected.find(hashEntries[i]);
+        CHECK(it != expected.end());
+        if (it == expected.end())
+            continue;
+
+        const uint32_t baseSlot = HashGridGetBaseSlot(hashEntries[i], desc.capacity);
+        CHECK(i >= baseSlot && i < baseSlot + HashGridDefaultBucketSize);
+        CHECK(memcmp(resolved[i].radianceData, it->second.radianceData, sizeof(it->second.radianceData)) == 0);
+        CHECK(resolved[i].sampleData == (it->second.sampleData & ~(~0u << c_StaleFrameNumBitOffset)));
+        found++;
+    }
+    CHECK(found == expected.size());
+
+    // 压缩后有效 entry 按槽位顺序排在开头
+    std::vector<uint64_t> compactedEntries = hashEntries;
+    std::vector<SharcPackedData> compactedResolved = resolved;
+    const uint32_t compacted = CompactSharcEntries(compactedEntries.data(), compactedResolved.data(), desc.capacity);
+    CHECK(compacted == expected.size());
+    for (uint32_t i = 0, j = 0; i < desc.capacity; i++)
+    {
+        if (hashEntries[i] == HashGridInvalidHashKey)
+            continue;
+        CHECK(compactedEntries[j] == hashEntries[i]);
+        CHECK(memcmp(&compactedResolved[j], &resolved[i], sizeof(SharcPackedData)) == 0);
+        j++;
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(SharcSnapshot_RejectsCorruptFiles)
+{
+    const SharcSnapshotDesc desc = MakeDesc();
+    const SnapshotTable table = MakeTable(desc, 9000);
+    const std::string path = GetSnapshotPath("SharcSnapshotTests_Corrupt.bin");
+    const std::string corruptPath = GetSnapshotPath("SharcSnapshotTests_Corrupt_Modified.bin");
+
+    CHECK(SaveSharcSnapshot(path.c_str(), desc, table.hashEntries.data(), table.resolved.data()).result == SharcSnapshotResult_Ok);
+    const std::vector<uint8_t> original = ReadFile(path);
+    CHECK(original.size() > 4096);
+
+    // header 之后依次是 payload、block 表和 key 差分，各取一个字节修改
+    const size_t offsets[] = { 0, 160, original.size() / 2, original.size() - 1 - 64, original.size() - 1 };
+    for (size_t offset : offsets)
+    {
+        std::vector<uint8_t> bytes = original;
+        bytes[offset] ^= 0x10;
+        WriteFile(corruptPath, bytes);
+        CHECK_MESSAGE(LoadExpectingUnchanged(corruptPath, desc, "byte " + std::to_string(offset)) == SharcSnapshotResult_InvalidFormat,
+            "byte " + std::to_string(offset));
+    }
+
+    for (size_t size : { size_t(0), size_t(16), original.size() / 2, original.size() - 1 })
+    {
+        WriteFile(corruptPath, std::vector<uint8_t>(original.begin(), original.begin() + size));
+        const SharcSnapshotResult result = LoadExpectingUnchanged(corruptPath, desc, "truncated to " + std::to_string(size));
+        CHECK_MESSAGE(result == SharcSnapshotResult_InvalidFormat || (size == 0 && result == SharcSnapshotResult_FileError),
+            "truncated to " + std::to_string(size));
+    }
+
+    // 版本号在 magic 之后
+    std::vector<uint8_t> version = original;
+    version[4] ^= 0x01;
+    WriteFile(corruptPath, version);
+    CHECK(LoadExpectingUnchanged(corruptPath, desc, "version") == SharcSnapshotResult_VersionMismatch);
+
+    SharcSnapshotDesc otherScene = desc;
+    otherScene.sceneHash++;
+    CHECK(LoadExpectingUnchanged(path, otherScene, "scene") == SharcSnapshotResult_SceneMismatch);
+
+    SharcSnapshotDesc otherGrid = desc;
+    otherGrid.sceneScale = 30.f;
+    CHECK(LoadExpectingUnchanged(path, otherGrid, "grid") == SharcSnapshotResult_GridMismatch);
+
+    CHECK(LoadExpectingUnchanged(GetSnapshotPath("SharcSnapshotTests_Missing.bin"), desc, "missing") == SharcSnapshotResult_FileError);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(corruptPath);
+}
+
+TEST_CASE(SharcSnapshot_Benchmark4M)
+{
+    // 填满的 4M 表，每帧最多上传 256K 个 entry（6 MB）
+    const std::string path = GetSnapshotPath("SharcSnapshotTests_Benchmark.bin");
+    const SharcSnapshotBenchmarkResult result = BenchmarkSharcSnapshot(path.c_str(), 1u << 22, 1u << 18);
+    std::printf("  capacity %u, %u live entries: save %.1f ms (%.1f MB file, raw %.1f MB), load %.1f ms, compact %.1f ms; "
+                "upload %.1f MB over %u frames, at most %.1f MB per frame (dense SetData %.1f MB)\n",
+        result.capacity, result.liveEntries, result.save.milliseconds, result.save.fileBytes / 1048576.0, result.save.rawBytes / 1048576.0,
+        result.load.milliseconds, result.compactMilliseconds, result.sparseUploadBytes / 1048576.0, result.uploadFrames,
+        result.maxUploadBytesPerFrame / 1048576.0, result.denseUploadBytes / 1048576.0);
+    std::filesystem::remove(path);
+
+    CHECK(result.save.result == SharcSnapshotResult_Ok);
+    CHECK(result.load.result == SharcSnapshotResult_Ok);
+    CHECK(result.liveEntries > result.capacity / 10 * 9);
+    CHECK(result.load.entryCount == result.liveEntries);
+    CHECK(result.load.loadedEntries + result.load.droppedEntries == result.load.entryCount);
+    CHECK(result.compactedEntries == result.load.loadedEntries);
+    CHECK(result.maxUploadBytesPerFrame <= uint64_t(1u << 18) * (sizeof(uint64_t) + sizeof(SharcPackedData)));
+    CHECK(result.uploadFrames == (result.compactedEntries + (1u << 18) - 1) >> 18);
+}
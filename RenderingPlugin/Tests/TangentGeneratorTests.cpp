@@ -0,0 +1,312 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "PrimitiveDataBuilder.h"
+#include "TangentGenerator.h"
+#include "TestFramework.h"
+
+#if PLUGIN_TESTS_HAS_MIKKTSPACE
+#include <mikktspace.h>
+#endif
+
+namespace
+{
+    constexpr float c_Pi = 3.14159265f;
+
+    struct TestMesh
+    {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> uvs;
+        std::vector<uint32_t> indices;
+
+        void AddVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v)
+        {
+            positions.insert(positions.end(), { x, y, z });
+            normals.insert(normals.end(), { nx, ny, nz });
+            uvs.insert(uvs.end(), { u, v });
+        }
+
+        uint32_t GetVertexCount() const { return uint32_t(positions.size() / 3); }
+
+        PrimitiveBuildDesc GetDesc(uint32_t firstIndex, uint32_t indexCount, uint32_t primitiveOffset) const
+        {
+            PrimitiveBuildDesc desc = {};
+            desc.positions = positions.data();
+            desc.normals = normals.data();
+            desc.uvs = uvs.data();
+            desc.indices = indices.data() + firstIndex;
+            desc.vertexCount = GetVertexCount();
+            desc.indexCount = indexCount;
+            desc.primitiveOffset = primitiveOffset;
+            desc.flags = PrimitiveBuildFlag_GenerateTangents;
+            return desc;
+        }
+    };
+
+    // 2x1 个四边形，右边一个的 u 镜像，中间一列顶点的位置、法线和 uv 都相同
+    TestMesh MakeMirroredPlane()
+    {
+        TestMesh mesh;
+        for (uint32_t y = 0; y < 2; y++)
+        {
+            for (uint32_t x = 0; x < 3; x++)
+                mesh.AddVertex(float(x), float(y), 0.f, 0.f, 0.f, 1.f, x <= 1 ? float(x) : 2.f - float(x), float(y));
+        }
+
+        for (uint32_t x = 0; x < 2; x++)
+            mesh.indices.insert(mesh.indices.end(), { x, x + 1, x + 4, x, x + 4, x + 3 });
+        return mesh;
+    }
+
+    // 经纬球，接缝一列和两极的顶点重复；mirrored 时 u 在 phi = pi 处镜像，phi = 0 和 pi 两条经线都是镜像接缝
+    TestMesh MakeSphere(uint32_t rings, uint32_t segments, bool mirrored)
+    {
+        TestMesh mesh;
+        for (uint32_t i = 0; i <= rings; i++)
+        {
+            const float theta = c_Pi * float(i) / float(rings);
+            for (uint32_t j = 0; j <= segments; j++)
+            {
+                const float phi = 2.f * c_Pi * float(j) / float(segments);
+                const float x = std::sin(theta) * std::cos(phi);
+                const float y = std::cos(theta);
+                const float z = std::sin(theta) * std::sin(phi);
+                const float u = mirrored ? 1.f - std::fabs(2.f * float(j) / float(segments) - 1.f) : float(j) / float(segments);
+                mesh.AddVertex(x, y, z, x, y, z, u, 1.f - float(i) / float(rings));
+            }
+        }
+
+        // 两极处退化的三角形不输出
+        for (uint32_t i = 0; i < rings; i++)
+        {
+            for (uint32_t j = 0; j < segments; j++)
+            {
+                const uint32_t a = i * (segments + 1) + j;
+                const uint32_t b = a + 1;
+                const uint32_t c = a + segments + 1;
+                const uint32_t d = c + 1;
+                if (i > 0)
+                    mesh.indices.insert(mesh.indices.end(), { a, c, b });
+                if (i + 1 < rings)
+                    mesh.indices.insert(mesh.indices.end(), { b, c, d });
+            }
+        }
+        return mesh;
+    }
+
+    float Dot3(const float* a, const float* b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // 生成结果按三角形的角展开，与 MikkTSpace 的输出方式相同
+    std::vector<float> GetCornerTangents(const PrimitiveBuildDesc& desc)
+    {
+        std::vector<float> corners(size_t(desc.indexCount) * 4);
+        for (uint32_t i = 0; i < desc.indexCount; i++)
+        {
+            for (uint32_t k = 0; k < 4; k++)
+                corners[i * 4 + k] = desc.tangents[desc.indices[i] * 4 + k];
+        }
+        return corners;
+    }
+}
+
+TEST_CASE(TangentGenerator_MirroredSeamSplitsVertices)
+{
+    const TestMesh mesh = MakeMirroredPlane();
+
+    // 左右两个四边形分属两个 submesh，共享顶点数组
+    const PrimitiveBuildDesc descs[2] = { mesh.GetDesc(0, 6, 0), mesh.GetDesc(6, 6, 2) };
+    GeneratedTangents generated;
+    const PrimitiveBuildDesc* resolved = generated.Resolve(descs, 2);
+    CHECK(generated.GetMeshCount() == 1);
+    CHECK(generated.GetSplitVertexCount() == 2);
+    CHECK(resolved[0].vertexCount == mesh.GetVertexCount() + 2);
+    CHECK(resolved[0].positions == resolved[1].positions);
+    CHECK(resolved[0].tangents == resolved[1].tangents);
+
+    // 左边切线为 +x，右边 u 沿 -x 增加，切线为 -x 且手性相反
+    for (uint32_t s = 0; s < 2; s++)
+    {
+        const std::vector<float> corners = GetCornerTangents(resolved[s]);
+        const float expectedX = s == 0 ? 1.f : -1.f;
+        const float expectedSign = s == 0 ? 1.f : -1.f;
+        for (uint32_t i = 0; i < resolved[s].indexCount; i++)
+        {
+            const uint32_t vertex = resolved[s].indices[i];
+            CHECK_MESSAGE(std::fabs(corners[i * 4 + 0] - expectedX) < 1e-6f, std::to_string(s) + " corner " + std::to_string(i));
+            CHECK_MESSAGE(corners[i * 4 + 3] == expectedSign, std::to_string(s) + " corner " + std::to_string(i));
+
+            // 拆分出的顶点与原顶点的位置和 uv 相同
+            const uint32_t source = mesh.indices[s * 6 + i];
+            CHECK(memcmp(resolved[s].positions + vertex * 3, mesh.positions.data() + source * 3, sizeof(float) * 3) == 0);
+            CHECK(memcmp(resolved[s].uvs + vertex * 2, mesh.uvs.data() + source * 2, sizeof(float) * 2) == 0);
+        }
+    }
+
+    // 输出的三角形顺序不变，每个三角形的 bitangentSign 取自所在一侧
+    PrimitiveData primitives[4] = {};
+    const PrimitiveBuildStats stats = BuildPrimitiveData(descs, 2, primitives, 4, false);
+    CHECK(stats.primitiveCount == 4);
+    CHECK(stats.tangentMeshCount == 1);
+    CHECK(primitives[0].bitangentSign == 1.f && primitives[1].bitangentSign == 1.f);
+    CHECK(primitives[2].bitangentSign == -1.f && primitives[3].bitangentSign == -1.f);
+    CHECK(primitives[1].t0 != primitives[2].t0);
+}
+
+TEST_CASE(TangentGenerator_SphereMatchesAnalyticTangents)
+{
+    constexpr uint32_t c_Rings = 16;
+    constexpr uint32_t c_Segments = 32;
+
+    for (uint32_t mirrored = 0; mirrored < 2; mirrored++)
+    {
+        const TestMesh mesh = MakeSphere(c_Rings, c_Segments, mirrored != 0);
+        const PrimitiveBuildDesc desc = mesh.GetDesc(0, uint32_t(mesh.indices.size()), 0);
+        GeneratedTangents generated;
+        const PrimitiveBuildDesc* resolved = generated.Resolve(&desc, 1);
+
+        // 不镜像时没有手性不同的顶点，索引保持原样
+        // 镜像时 phi = pi 经线上除两极外的顶点各拆分一次，phi = 0 处两侧本来就是不同的顶点
+        if (mirrored)
+            CHECK(generated.GetSplitVertexCount() == c_Rings - 1);
+        else
+            CHECK(generated.GetSplitVertexCount() == 0 && resolved->indices == desc.indices);
+
+        const std::vector<float> corners = GetCornerTangents(*resolved);
+        float minDot = 1.f;
+        float signs[2] = { 0.f, 0.f };
+        bool consistentSigns = true;
+        for (uint32_t t = 0; t < resolved->indexCount / 3; t++)
+        {
+            // 三角形所在的经度区间决定 u 随 phi 增加还是减少
+            uint32_t column = c_Segments;
+            for (uint32_t k = 0; k < 3; k++)
+                column = std::min(column, mesh.indices[t * 3 + k] % (c_Segments + 1));
+            const uint32_t side = mirrored && column >= c_Segments / 2 ? 1 : 0;
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t source = mesh.indices[t * 3 + k];
+                const uint32_t ring = source / (c_Segments + 1);
+                const float* tangent = corners.data() + (t * 3 + k) * 4;
+
+                if (signs[side] == 0.f)
+                    signs[side] = tangent[3];
+                consistentSigns &= tangent[3] == signs[side];
+
+                if (ring == 0 || ring == c_Rings)
+                    continue;
+
+                const float phi = 2.f * c_Pi * float(source % (c_Segments + 1)) / float(c_Segments);
+                const float direction = side == 0 ? 1.f : -1.f;
+                const float expected[3] = { -std::sin(phi) * direction, 0.f, std::cos(phi) * direction };
+                minDot = std::min(minDot, Dot3(tangent, expected));
+            }
+        }
+
+        CHECK(consistentSigns);
+        if (mirrored)
+            CHECK(signs[0] == -signs[1]);
+        // 接缝上的顶点只有一侧的三角形参与平均，与 MikkTSpace 相同，偏差约 5 度；手性选错时点积接近 -1
+        CHECK_MESSAGE(minDot > 0.99f, std::to_string(minDot));
+    }
+}
+
+#if PLUGIN_TESTS_HAS_MIKKTSPACE
+namespace
+{
+    struct MikkContext
+    {
+        const TestMesh* mesh;
+        std::vector<float> corners;
+    };
+
+    const TestMesh& GetMesh(const SMikkTSpaceContext* context)
+    {
+        return *static_cast<MikkContext*>(context->m_pUserData)->mesh;
+    }
+
+    int MikkGetNumFaces(const SMikkTSpaceContext* context)
+    {
+        return int(GetMesh(context).indices.size() / 3);
+    }
+
+    int MikkGetNumVerticesOfFace(const SMikkTSpaceContext*, const int)
+    {
+        return 3;
+    }
+
+    void MikkGetPosition(const SMikkTSpaceContext* context, float out[], const int face, const int vertex)
+    {
+        const TestMesh& mesh = GetMesh(context);
+        memcpy(out, mesh.positions.data() + mesh.indices[face * 3 + vertex] * 3, sizeof(float) * 3);
+    }
+
+    void MikkGetNormal(const SMikkTSpaceContext* context, float out[], const int face, const int vertex)
+    {
+        const TestMesh& mesh = GetMesh(context);
+        memcpy(out, mesh.normals.data() + mesh.indices[face * 3 + vertex] * 3, sizeof(float) * 3);
+    }
+
+    void MikkGetTexCoord(const SMikkTSpaceContext* context, float out[], const int face, const int vertex)
+    {
+        const TestMesh& mesh = GetMesh(context);
+        memcpy(out, mesh.uvs.data() + mesh.indices[face * 3 + vertex] * 2, sizeof(float) * 2);
+    }
+
+    void MikkSetTSpaceBasic(const SMikkTSpaceContext* context, const float tangent[], const float sign, const int face, const int vertex)
+    {
+        float* out = static_cast<MikkContext*>(context->m_pUserData)->corners.data() + (face * 3 + vertex) * 4;
+        memcpy(out, tangent, sizeof(float) * 3);
+        out[3] = sign;
+    }
+
+    std::vector<float> GenerateMikkTSpaceCorners(const TestMesh& mesh)
+    {
+        SMikkTSpaceInterface mikkInterface = {};
+        mikkInterface.m_getNumFaces = MikkGetNumFaces;
+        mikkInterface.m_getNumVerticesOfFace = MikkGetNumVerticesOfFace;
+        mikkInterface.m_getPosition = MikkGetPosition;
+        mikkInterface.m_getNormal = MikkGetNormal;
+        mikkInterface.m_getTexCoord = MikkGetTexCoord;
+        mikkInterface.m_setTSpaceBasic = MikkSetTSpaceBasic;
+
+        MikkContext userData = { &mesh, std::vector<float>(mesh.indices.size() * 4, 0.f) };
+        SMikkTSpaceContext context = { &mikkInterface, &userData };
+        CHECK(genTangSpaceDefault(&context) != 0);
+        return userData.corners;
+    }
+}
+
+// 与参考实现 mikktspace.c 逐角比较：手性相同，方向夹角小于约 2.5 度
+TEST_CASE(TangentGenerator_MatchesMikkTSpace)
+{
+    const TestMesh meshes[] = { MakeMirroredPlane(), MakeSphere(16, 32, false), MakeSphere(16, 32, true), MakeSphere(5, 7, true) };
+    const char* names[] = { "mirrored plane", "sphere", "mirrored sphere", "coarse mirrored sphere" };
+
+    for (uint32_t m = 0; m < 4; m++)
+    {
+        const TestMesh& mesh = meshes[m];
+        const PrimitiveBuildDesc desc = mesh.GetDesc(0, uint32_t(mesh.indices.size()), 0);
+        GeneratedTangents generated;
+        const std::vector<float> corners = GetCornerTangents(*generated.Resolve(&desc, 1));
+        const std::vector<float> reference = GenerateMikkTSpaceCorners(mesh);
+
+        uint32_t signMismatches = 0;
+        float minDot = 1.f;
+        for (size_t i = 0; i < mesh.indices.size(); i++)
+        {
+            signMismatches += corners[i * 4 + 3] == reference[i * 4 + 3] ? 0 : 1;
+            minDot = std::min(minDot, Dot3(corners.data() + i * 4, reference.data() + i * 4));
+        }
+        CHECK_MESSAGE(signMismatches == 0, std::string(names[m]) + ": " + std::to_string(signMismatches));
+        CHECK_MESSAGE(minDot > 0.999f, std::string(names[m]) + ": " + std::to_string(minDot));
+    }
+}
+#endif
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 不依赖 GPU 和 Unity 的原生模块测试，每个 TEST_CASE 可以单独按名字运行：PluginTests <名字前缀>
+namespace PluginTests
+{
+    struct TestCase
+    {
+        const char* name;
+        void (*function)();
+    };
+
+    inline std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    inline int& GetFailureCount()
+    {
+        static int failureCount = 0;
+        return failureCount;
+    }
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* name, void (*function)())
+        {
+            GetTestCases().push_back({ name, function });
+        }
+    };
+
+    inline void ReportFailure(const char* file, int line, const std::string& message)
+    {
+        GetFailureCount()++;
+        std::printf("  %s(%d): %s\n", file, line, message.c_str());
+    }
+
+    // 测试数据在 Tests/Data 中，工作目录为 Tests
+    inline std::string GetDataPath(const char* fileName)
+    {
+        return std::string("Data/") + fileName;
+    }
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static PluginTests::TestRegistrar name##_registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { if (!(condition)) PluginTests::ReportFailure(__FILE__, __LINE__, #condition); } while (0)
+
+#define CHECK_MESSAGE(condition, message) \
+    do { if (!(condition)) PluginTests::ReportFailure(__FILE__, __LINE__, std::string(#condition) + ": " + (message)); } while (0)
@@ -0,0 +1,31 @@
+﻿#include <chrono>
+#include <cstring>
+
+#include "TestFramework.h"
+
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    int runCount = 0;
+    int failedCount = 0;
+    for (const PluginTests::TestCase& testCase : PluginTests::GetTestCases())
+    {
+        if (filter && strncmp(testCase.name, filter, strlen(filter)) != 0)
+            continue;
+
+        const int failuresBefore = PluginTests::GetFailureCount();
+        const auto start = std::chrono::steady_clock::now();
+        std::printf("[ RUN  ] %s\n", testCase.name);
+        testCase.function();
+        const float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const bool passed = PluginTests::GetFailureCount() == failuresBefore;
+        std::printf("[ %s ] %s (%.1f ms)\n", passed ? " OK " : "FAIL", testCase.name, milliseconds);
+        runCount++;
+        failedCount += passed ? 0 : 1;
+    }
+
+    std::printf("%d tests, %d failed\n", runCount, failedCount);
+    return runCount > 0 && failedCount == 0 ? 0 : 1;
+}
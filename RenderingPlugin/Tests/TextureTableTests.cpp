@@ -0,0 +1,182 @@
+﻿#include <string>
+#include <vector>
+
+#include "TestFramework.h"
+#include "TextureTable.h"
+
+namespace
+{
+    // 四张纹理的 instance ID 由 seed 决定，seed 不同的组内容不同
+    TextureGroupKey MakeKey(int32_t seed)
+    {
+        return { { seed * 10 + 1, seed * 10 + 2, seed * 10 + 3, seed * 10 + 4 } };
+    }
+
+    struct UpdateResult
+    {
+        TextureTableStats stats;
+        std::vector<uint32_t> groupIndices;
+        std::vector<uint32_t> changedGroups;
+    };
+
+    // materials 为 (materialId, key seed)
+    UpdateResult Update(TextureTable& table, const std::vector<std::pair<int32_t, int32_t>>& materials, bool releaseUnlisted)
+    {
+        std::vector<MaterialTextureDesc> descs;
+        for (const auto& material : materials)
+            descs.push_back({ material.first, MakeKey(material.second) });
+
+        UpdateResult result;
+        result.groupIndices.resize(descs.size());
+        result.stats = table.Update(descs.data(), uint32_t(descs.size()), result.groupIndices.data(), releaseUnlisted);
+        result.changedGroups.assign(table.GetChangedGroups(), table.GetChangedGroups() + result.stats.changedGroupCount);
+        return result;
+    }
+
+    std::vector<uint32_t> Release(TextureTable& table, const std::vector<int32_t>& materialIds, TextureTableStats* outStats = nullptr)
+    {
+        const TextureTableStats stats = table.ReleaseMaterials(materialIds.data(), uint32_t(materialIds.size()));
+        if (outStats)
+            *outStats = stats;
+        return std::vector<uint32_t>(table.GetChangedGroups(), table.GetChangedGroups() + stats.changedGroupCount);
+    }
+
+    bool IsFreeGroup(const TextureTable& table, uint32_t groupIndex)
+    {
+        const TextureGroupKey& key = table.GetGroups()[groupIndex];
+        return key.textures[0] == 0 && key.textures[1] == 0 && key.textures[2] == 0 && key.textures[3] == 0;
+    }
+
+    bool HasKey(const TextureTable& table, uint32_t groupIndex, int32_t seed)
+    {
+        const TextureGroupKey expected = MakeKey(seed);
+        const TextureGroupKey& key = table.GetGroups()[groupIndex];
+        for (uint32_t i = 0; i < c_TexturesPerGroup; i++)
+        {
+            if (key.textures[i] != expected.textures[i])
+                return false;
+        }
+        return true;
+    }
+
+    std::string ToString(const std::vector<uint32_t>& values)
+    {
+        std::string text;
+        for (uint32_t value : values)
+            text += std::to_string(value) + " ";
+        return text;
+    }
+}
+
+TEST_CASE(TextureTable_RefCountDeduplicates)
+{
+    TextureTable table;
+
+    // 材质 1、2、4 的纹理相同，只占一组
+    UpdateResult result = Update(table, { { 1, 7 }, { 2, 7 }, { 3, 8 }, { 4, 7 } }, false);
+    CHECK(result.stats.materialCount == 4);
+    CHECK(result.stats.groupCount == 2);
+    CHECK(result.stats.groupCapacity == 2);
+    CHECK(result.stats.addedGroupCount == 2);
+    CHECK(result.groupIndices[0] == result.groupIndices[1]);
+    CHECK(result.groupIndices[0] == result.groupIndices[3]);
+    CHECK(result.groupIndices[0] != result.groupIndices[2]);
+    CHECK(HasKey(table, result.groupIndices[0], 7));
+    CHECK(HasKey(table, result.groupIndices[2], 8));
+    const uint32_t sharedGroup = result.groupIndices[0];
+
+    // 还有材质引用时组保留，组号不变
+    TextureTableStats stats;
+    CHECK(Release(table, { 1, 2 }, &stats).empty());
+    CHECK(stats.releasedMaterialCount == 2);
+    CHECK(stats.freedGroupCount == 0);
+    CHECK(stats.groupCount == 2);
+    CHECK(table.GetGroupIndex(4) == sharedGroup);
+    CHECK(table.GetGroupIndex(1) == ~0u);
+
+    // 最后一个引用释放后组清零
+    const std::vector<uint32_t> changed = Release(table, { 4, 99 }, &stats);
+    CHECK_MESSAGE(changed == std::vector<uint32_t>{ sharedGroup }, ToString(changed));
+    CHECK(stats.releasedMaterialCount == 1);
+    CHECK(stats.freedGroupCount == 1);
+    CHECK(stats.groupCount == 1);
+    CHECK(stats.groupCapacity == 2);
+    CHECK(IsFreeGroup(table, sharedGroup));
+
+    // 同一次调用中新增的材质复用已有的组
+    result = Update(table, { { 5, 8 }, { 6, 8 } }, false);
+    CHECK(result.stats.addedGroupCount == 0);
+    CHECK(result.changedGroups.empty());
+    CHECK(result.groupIndices[0] == table.GetGroupIndex(3));
+    CHECK(result.groupIndices[1] == table.GetGroupIndex(3));
+}
+
+TEST_CASE(TextureTable_FreeListReusesLowestSlot)
+{
+    TextureTable table;
+    UpdateResult result = Update(table, { { 10, 0 }, { 11, 1 }, { 12, 2 }, { 13, 3 }, { 14, 4 } }, false);
+    CHECK_MESSAGE(result.groupIndices == std::vector<uint32_t>({ 0, 1, 2, 3, 4 }), ToString(result.groupIndices));
+
+    Release(table, { 13, 11 });
+    CHECK(IsFreeGroup(table, 1) && IsFreeGroup(table, 3));
+
+    // 空闲的组从小到大复用，表不变长
+    result = Update(table, { { 20, 20 } }, false);
+    CHECK(result.groupIndices[0] == 1);
+    CHECK(result.stats.reusedGroupCount == 1);
+    result = Update(table, { { 21, 21 }, { 22, 22 } }, false);
+    CHECK_MESSAGE(result.groupIndices == std::vector<uint32_t>({ 3, 5 }), ToString(result.groupIndices));
+    CHECK(result.stats.reusedGroupCount == 1);
+    CHECK(result.stats.groupCapacity == 6);
+
+    // 场景重建：不在列表中的材质先释放，空出的组在同一次调用中给新材质
+    result = Update(table, { { 10, 0 }, { 14, 4 }, { 30, 30 }, { 20, 20 } }, true);
+    CHECK(result.stats.releasedMaterialCount == 3);
+    CHECK(result.stats.freedGroupCount == 3);
+    CHECK(result.stats.addedGroupCount == 1);
+    CHECK(result.stats.reusedGroupCount == 1);
+    CHECK_MESSAGE(result.groupIndices == std::vector<uint32_t>({ 0, 4, 2, 1 }), ToString(result.groupIndices));
+    CHECK(result.stats.groupCapacity == 6);
+    CHECK(IsFreeGroup(table, 3) && IsFreeGroup(table, 5));
+}
+
+TEST_CASE(TextureTable_ReportsChangedGroups)
+{
+    TextureTable table;
+    UpdateResult result = Update(table, { { 1, 1 }, { 2, 2 }, { 3, 3 }, { 4, 3 } }, true);
+    CHECK_MESSAGE(result.changedGroups == std::vector<uint32_t>({ 0, 1, 2 }), ToString(result.changedGroups));
+
+    // 重建时内容不变：组号保持，没有变化的组
+    result = Update(table, { { 4, 3 }, { 3, 3 }, { 2, 2 }, { 1, 1 } }, true);
+    CHECK(result.changedGroups.empty());
+    CHECK(result.stats.changedGroupCount == 0);
+    CHECK_MESSAGE(result.groupIndices == std::vector<uint32_t>({ 2, 2, 1, 0 }), ToString(result.groupIndices));
+
+    // 材质 3 换纹理：旧组仍被材质 4 引用，只有新组变化
+    result = Update(table, { { 1, 1 }, { 2, 2 }, { 3, 5 }, { 4, 3 } }, true);
+    CHECK_MESSAGE(result.changedGroups == std::vector<uint32_t>({ 3 }), ToString(result.changedGroups));
+    CHECK(result.groupIndices[2] == 3 && result.groupIndices[3] == 2);
+
+    // 材质 4 换成已有的纹理组：旧组释放，目标组不变
+    result = Update(table, { { 1, 1 }, { 2, 2 }, { 3, 5 }, { 4, 1 } }, true);
+    CHECK_MESSAGE(result.changedGroups == std::vector<uint32_t>({ 2 }), ToString(result.changedGroups));
+    CHECK(result.groupIndices[3] == 0);
+    CHECK(IsFreeGroup(table, 2));
+
+    // 材质 2 换新纹理：新组先分配（不会占用自己刚释放的组），旧组随后释放
+    result = Update(table, { { 1, 1 }, { 2, 6 }, { 3, 5 }, { 4, 1 } }, true);
+    CHECK_MESSAGE(result.changedGroups == std::vector<uint32_t>({ 1, 2 }), ToString(result.changedGroups));
+    CHECK(result.groupIndices[1] == 2);
+    CHECK(HasKey(table, 2, 6));
+    CHECK(IsFreeGroup(table, 1));
+
+    // 材质 2 卸载释放组 2，组 1 和组 2 分给两个新材质；释放后又在同一次调用中复用的组 2 只报告一次
+    result = Update(table, { { 1, 1 }, { 3, 5 }, { 4, 1 }, { 7, 7 }, { 8, 8 } }, true);
+    CHECK_MESSAGE(result.changedGroups == std::vector<uint32_t>({ 1, 2 }), ToString(result.changedGroups));
+    CHECK(result.stats.freedGroupCount == 1 && result.stats.addedGroupCount == 2);
+    CHECK(result.groupIndices[3] == 1 && result.groupIndices[4] == 2);
+
+    table.Clear();
+    CHECK(table.GetStats().changedGroupCount == 0);
+    CHECK(table.GetStats().groupCapacity == 0);
+}
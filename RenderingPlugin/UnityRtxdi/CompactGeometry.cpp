@@ -0,0 +1,227 @@
+﻿#include "CompactGeometry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "ParallelFor.h"
+#include "TangentGenerator.h"
+
+namespace
+{
+    constexpr uint32_t c_Max16BitVertexCount = 1u << 16;
+    constexpr uint32_t c_InvalidIndex = ~0u;
+    constexpr float c_MinArea = 1e-9f;
+
+    // 连续的 submesh 中 positions 相同的一段
+    struct MeshGroup
+    {
+        uint32_t firstDesc;
+        uint32_t descCount;
+        bool use32BitIndices;
+        uint32_t vertexOffset;
+        std::vector<CompactVertex> vertices;    // 合并后的顶点，按第一次被引用的顺序
+        std::vector<uint32_t> remap;            // 输入顶点 -> vertices 中的下标
+    };
+
+    bool operator==(const CompactVertex& a, const CompactVertex& b)
+    {
+        return a.uv == b.uv && a.normal == b.normal && a.tangent == b.tangent;
+    }
+
+    uint32_t HashVertex(const CompactVertex& v)
+    {
+        uint32_t hash = v.uv * 0x9E3779B1u;
+        hash = (hash ^ (hash >> 15) ^ v.normal) * 0x85EBCA77u;
+        hash = (hash ^ (hash >> 13) ^ v.tangent) * 0xC2B2AE3Du;
+        return hash ^ (hash >> 16);
+    }
+
+    CompactVertex QuantizeVertex(const PrimitiveBuildDesc& desc, uint32_t index)
+    {
+        CompactVertex vertex = {};
+        if (desc.uvs)
+            vertex.uv = PackHalf2(desc.uvs[index * 2 + 0], desc.uvs[index * 2 + 1]);
+        if (desc.normals)
+            vertex.normal = EncodeUnitVector(desc.normals + index * 3);
+        if (desc.tangents)
+            vertex.tangent = EncodeUnitVector(desc.tangents + index * 4);
+        return vertex;
+    }
+
+    // 量化后属性完全相同的顶点在着色时没有区别，合并为一个；未被引用的顶点不输出
+    void WeldMesh(const PrimitiveBuildDesc* descs, const uint8_t* validDescs, MeshGroup& group)
+    {
+        const PrimitiveBuildDesc& mesh = descs[group.firstDesc];
+        group.remap.assign(mesh.vertexCount, c_InvalidIndex);
+
+        // 开放寻址，存 vertices 下标 + 1
+        uint32_t slotCount = 16;
+        while (slotCount < mesh.vertexCount * 2)
+            slotCount <<= 1;
+        std::vector<uint32_t> slots(slotCount, 0);
+
+        for (uint32_t d = 0; d < group.descCount; d++)
+        {
+            const PrimitiveBuildDesc& desc = descs[group.firstDesc + d];
+            if (!validDescs[group.firstDesc + d])
+                continue;
+
+            const uint32_t indexCount = desc.indexCount / 3 * 3;
+            for (uint32_t i = 0; i < indexCount; i++)
+            {
+                const uint32_t source = desc.indices[i];
+                if (group.remap[source] != c_InvalidIndex)
+                    continue;
+
+                const CompactVertex vertex = QuantizeVertex(desc, source);
+                uint32_t slot = HashVertex(vertex) & (slotCount - 1);
+                while (slots[slot] != 0 && !(group.vertices[slots[slot] - 1] == vertex))
+                    slot = (slot + 1) & (slotCount - 1);
+
+                if (slots[slot] == 0)
+                {
+                    group.vertices.push_back(vertex);
+                    slots[slot] = uint32_t(group.vertices.size());
+                }
+                group.remap[source] = slots[slot] - 1;
+            }
+        }
+
+        // 只有无效 submesh 的 mesh 也保留一个顶点，零索引不会越界
+        if (group.vertices.empty())
+            group.vertices.push_back({});
+
+        group.use32BitIndices = group.vertices.size() > c_Max16BitVertexCount;
+    }
+
+    uint32_t GetIndexBytes(uint32_t triangleCount, bool use32BitIndices)
+    {
+        const uint32_t bytes = triangleCount * 3 * (use32BitIndices ? 4 : 2);
+        return (bytes + 3) & ~3u;
+    }
+}
+
+CompactGeometryReport CompactGeometryBuilder::Build(const PrimitiveBuildDesc* descs, uint32_t descCount, uint32_t triangleCapacity)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    m_vertices.clear();
+    m_indices.clear();
+    m_submeshes.clear();
+    m_triangles.assign(triangleCapacity, { c_MinArea, c_MinArea });
+
+    CompactGeometryReport report = {};
+    if (!descs)
+        return report;
+
+    GeneratedTangents generatedTangents;
+    descs = generatedTangents.Resolve(descs, descCount);
+
+    std::vector<uint8_t> validDescs(descCount, 0);
+    std::vector<MeshGroup> groups;
+    for (uint32_t i = 0; i < descCount; i++)
+    {
+        validDescs[i] = IsValidPrimitiveBuildDesc(descs[i], triangleCapacity) ? 1 : 0;
+        report.invalidSubmeshCount += validDescs[i] ? 0 : 1;
+
+        if (groups.empty() || descs[i].positions != descs[i - 1].positions || descs[i].vertexCount != descs[i - 1].vertexCount)
+        {
+            groups.emplace_back();
+            groups.back().firstDesc = i;
+            groups.back().descCount = 0;
+            report.sourceVertexCount += descs[i].vertexCount;
+        }
+        groups.back().descCount++;
+    }
+
+    ParallelFor(uint32_t(groups.size()), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t g = begin; g < end; g++)
+            WeldMesh(descs, validDescs.data(), groups[g]);
+    });
+
+    // 顶点和索引的偏移按 mesh 顺序排列
+    m_submeshes.resize(descCount);
+    uint32_t vertexOffset = 0;
+    uint32_t indexBytes = 0;
+    for (MeshGroup& group : groups)
+    {
+        group.vertexOffset = vertexOffset;
+        vertexOffset += uint32_t(group.vertices.size());
+
+        for (uint32_t d = 0; d < group.descCount; d++)
+        {
+            const uint32_t descIndex = group.firstDesc + d;
+            const PrimitiveBuildDesc& desc = descs[descIndex];
+            const uint32_t triangleCount = desc.indexCount / 3;
+
+            CompactSubmesh& submesh = m_submeshes[descIndex];
+            submesh.vertexOffset = group.vertexOffset;
+            submesh.indexOffset = indexBytes | (group.use32BitIndices ? c_CompactIndex32Bit : 0);
+            submesh.triangleOffset = desc.primitiveOffset;
+            submesh.triangleCount = triangleCount;
+            indexBytes += GetIndexBytes(triangleCount, group.use32BitIndices);
+
+            report.triangleCount += validDescs[descIndex] ? triangleCount : 0;
+            (group.use32BitIndices ? report.index32SubmeshCount : report.index16SubmeshCount)++;
+        }
+    }
+
+    m_vertices.resize(vertexOffset);
+    // 空场景也保留一个 word，ByteAddressBuffer 不能为空
+    m_indices.assign(std::max(indexBytes / 4, 1u), 0);
+
+    ParallelFor(uint32_t(groups.size()), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t g = begin; g < end; g++)
+        {
+            const MeshGroup& group = groups[g];
+            std::copy(group.vertices.begin(), group.vertices.end(), m_vertices.begin() + group.vertexOffset);
+
+            for (uint32_t d = 0; d < group.descCount; d++)
+            {
+                const uint32_t descIndex = group.firstDesc + d;
+                if (!validDescs[descIndex])
+                    continue;
+
+                const PrimitiveBuildDesc& desc = descs[descIndex];
+                const CompactSubmesh& submesh = m_submeshes[descIndex];
+                const uint32_t indexCount = submesh.triangleCount * 3;
+                uint8_t* indexData = reinterpret_cast<uint8_t*>(m_indices.data()) + (submesh.indexOffset & ~c_CompactIndex32Bit);
+                if (group.use32BitIndices)
+                {
+                    uint32_t* out = reinterpret_cast<uint32_t*>(indexData);
+                    for (uint32_t i = 0; i < indexCount; i++)
+                        out[i] = group.remap[desc.indices[i]];
+                }
+                else
+                {
+                    uint16_t* out = reinterpret_cast<uint16_t*>(indexData);
+                    for (uint32_t i = 0; i < indexCount; i++)
+                        out[i] = uint16_t(group.remap[desc.indices[i]]);
+                }
+
+                CompactTriangle* triangles = m_triangles.data() + desc.primitiveOffset;
+                for (uint32_t t = 0; t < submesh.triangleCount; t++)
+                {
+                    float uvArea;
+                    ComputeTriangleAreas(desc, t, triangles[t].worldArea, uvArea);
+                    const bool negativeSign = desc.tangents && desc.tangents[desc.indices[t * 3] * 4 + 3] < 0.0f;
+                    triangles[t].signedUvArea = negativeSign ? -uvArea : uvArea;
+                }
+            }
+        }
+    });
+
+    report.meshCount = uint32_t(groups.size());
+    report.submeshCount = descCount;
+    report.vertexCount = uint32_t(m_vertices.size());
+    report.vertexBytes = uint64_t(m_vertices.size()) * sizeof(CompactVertex);
+    report.indexBytes = uint64_t(m_indices.size()) * sizeof(uint32_t);
+    report.triangleBytes = uint64_t(m_triangles.size()) * sizeof(CompactTriangle);
+    report.compactBytes = report.vertexBytes + report.indexBytes + report.triangleBytes;
+    report.primitiveDataBytes = uint64_t(triangleCapacity) * sizeof(PrimitiveData);
+    report.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PrimitiveDataBuilder.h"
+
+// 与 LitWithRayTracing.shader 中的 CompactVertex 一致，half2 按 x | y << 16 打包
+// 位置由 RTAS 提供，命中着色只需要这三项；同一 mesh 的所有 submesh 共享
+struct CompactVertex
+{
+    uint32_t uv;
+    uint32_t normal;        // 八面体编码，与 PrimitiveData.n0 相同
+    uint32_t tangent;       // 八面体编码，与 PrimitiveData.t0 相同
+};
+
+// 按三角形存放的只有面积项，下标与 PrimitiveData 相同（instance.primitiveOffset + PrimitiveIndex()）
+struct CompactTriangle
+{
+    float worldArea;
+    float signedUvArea;     // 符号为 bitangentSign（第一个顶点 tangent.w 的符号）
+};
+
+// 写入 InstanceData.compactIndexOffset 的最高位，表示该 submesh 使用 32 位索引
+constexpr uint32_t c_CompactIndex32Bit = 0x80000000u;
+
+// 每个输入 desc 一项
+struct CompactSubmesh
+{
+    uint32_t vertexOffset;      // mesh 第一个顶点在顶点流中的位置
+    uint32_t indexOffset;       // 在索引缓冲中的字节偏移（4 字节对齐），32 位索引时或上 c_CompactIndex32Bit
+    uint32_t triangleOffset;    // 与 desc.primitiveOffset 相同
+    uint32_t triangleCount;
+};
+
+struct CompactGeometryReport
+{
+    uint32_t meshCount;
+    uint32_t submeshCount;
+    uint32_t triangleCount;
+    uint32_t sourceVertexCount;     // 输入 mesh 的顶点数之和
+    uint32_t vertexCount;           // 量化后合并相同顶点、去掉未引用顶点后的顶点数
+    uint32_t index16SubmeshCount;
+    uint32_t index32SubmeshCount;
+    uint32_t invalidSubmeshCount;   // 与 PrimitiveBuildStats 相同，这些 submesh 的三角形写为零面积
+    uint64_t vertexBytes;
+    uint64_t indexBytes;
+    uint64_t triangleBytes;
+    uint64_t compactBytes;          // 以上三项之和
+    uint64_t primitiveDataBytes;    // 同样的三角形数使用 PrimitiveData 时的大小
+    float milliseconds;
+    uint32_t pad1;
+};
+
+// PrimitiveData 的替代格式：共享的量化顶点流 + 16 / 32 位索引 + 每个三角形 8 字节的面积项
+// PrimitiveData 每个三角形 48 字节，把每个顶点的属性按相邻三角形数重复存放
+class CompactGeometryBuilder
+{
+public:
+    // descs 与 BuildPrimitiveData 相同，包括 PrimitiveBuildFlag_GenerateTangents；positions 相同的连续 submesh 视为同一个 mesh，共享顶点
+    // 合并后顶点数不超过 65536 的 mesh 使用 16 位索引
+    CompactGeometryReport Build(const PrimitiveBuildDesc* descs, uint32_t descCount, uint32_t triangleCapacity);
+
+    const CompactVertex* GetVertices() const { return m_vertices.data(); }
+    uint32_t GetVertexCount() const { return uint32_t(m_vertices.size()); }
+
+    // 按 uint32 存放，作为 ByteAddressBuffer 上传
+    const uint32_t* GetIndices() const { return m_indices.data(); }
+    uint32_t GetIndexWordCount() const { return uint32_t(m_indices.size()); }
+
+    // triangleCapacity 个
+    const CompactTriangle* GetTriangles() const { return m_triangles.data(); }
+    uint32_t GetTriangleCount() const { return uint32_t(m_triangles.size()); }
+
+    // 与 descs 一一对应
+    const CompactSubmesh* GetSubmeshes() const { return m_submeshes.data(); }
+    uint32_t GetSubmeshCount() const { return uint32_t(m_submeshes.size()); }
+
+private:
+    std::vector<CompactVertex> m_vertices;
+    std::vector<uint32_t> m_indices;
+    std::vector<CompactTriangle> m_triangles;
+    std::vector<CompactSubmesh> m_submeshes;
+};
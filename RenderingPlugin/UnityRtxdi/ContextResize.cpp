@@ -0,0 +1,98 @@
+﻿#include "ContextResize.h"
+
+#include <cassert>
+
+namespace
+{
+    // ReSTIR GI 最多使用两个 reservoir 缓冲，见 ReSTIRGIContext::UpdateBufferIndices
+    constexpr uint32_t c_NumReSTIRGIReservoirBuffers = 2;
+
+    uint32_t GetReservoirWidth(uint32_t renderWidth, rtxdi::CheckerboardMode checkerboardMode)
+    {
+        return (checkerboardMode == rtxdi::CheckerboardMode::Off) ? renderWidth : (renderWidth + 1) / 2;
+    }
+
+    ReservoirRemapParameters GetRemapParameters(const RTXDI_ReservoirBufferParameters& oldParams, uint32_t oldWidth, uint32_t oldHeight,
+                                                const RTXDI_ReservoirBufferParameters& newParams, uint32_t newWidth, uint32_t newHeight,
+                                                rtxdi::CheckerboardMode checkerboardMode, uint32_t numReservoirBuffers)
+    {
+        ReservoirRemapParameters remap = {};
+        remap.oldReservoirBufferParams = oldParams;
+        remap.newReservoirBufferParams = newParams;
+        remap.oldReservoirWidth = GetReservoirWidth(oldWidth, checkerboardMode);
+        remap.oldReservoirHeight = oldHeight;
+        remap.newReservoirWidth = GetReservoirWidth(newWidth, checkerboardMode);
+        remap.newReservoirHeight = newHeight;
+        remap.numReservoirBuffers = numReservoirBuffers;
+        remap.oldBufferSizeInReservoirs = oldParams.reservoirArrayPitch * numReservoirBuffers;
+        remap.newBufferSizeInReservoirs = newParams.reservoirArrayPitch * numReservoirBuffers;
+        return remap;
+    }
+}
+
+ReservoirRemapParameters ResizeReSTIRDI(rtxdi::ReSTIRDIContext& context, uint32_t renderWidth, uint32_t renderHeight)
+{
+    rtxdi::ReSTIRDIStaticParameters staticParams = context.GetStaticParameters();
+    const uint32_t oldWidth = staticParams.RenderWidth;
+    const uint32_t oldHeight = staticParams.RenderHeight;
+    staticParams.RenderWidth = renderWidth;
+    staticParams.RenderHeight = renderHeight;
+
+    rtxdi::ReSTIRDIContext resized(staticParams);
+    resized.SetInitialSamplingParameters(context.GetInitialSamplingParameters());
+    resized.SetTemporalResamplingParameters(context.GetTemporalResamplingParameters());
+    resized.SetSpatialResamplingParameters(context.GetSpatialResamplingParameters());
+    resized.SetShadingParameters(context.GetShadingParameters());
+
+    // 上一帧输出的 reservoir 只能通过 SetFrameIndex 推进。TemporalAndSpatial 模式下 shading 输出就是上一帧的缓冲，
+    // 推进时下标不会轮转，所以先用 Temporal 模式推进（每次轮转 2，周期为 NumReservoirBuffers），对齐后再切回原来的模式
+    const uint32_t lastFrameOutputReservoir = context.GetBufferIndices().temporalResamplingInputBufferIndex;
+    resized.SetResamplingMode(rtxdi::ReSTIRDI_ResamplingMode::Temporal);
+    resized.SetFrameIndex(context.GetFrameIndex());
+    for (uint32_t i = 0; i < rtxdi::ReSTIRDIContext::NumReservoirBuffers; i++)
+    {
+        if (resized.GetBufferIndices().temporalResamplingInputBufferIndex == lastFrameOutputReservoir)
+            break;
+
+        resized.SetFrameIndex(context.GetFrameIndex());
+    }
+    resized.SetResamplingMode(context.GetResamplingMode());
+
+    // 切回原模式只重新计算本帧的下标，不改变上一帧的输出
+    const bool aligned = resized.GetBufferIndices().temporalResamplingInputBufferIndex == lastFrameOutputReservoir;
+    assert(aligned && "ResizeReSTIRDI failed to realign the reservoir buffers");
+    (void)aligned;
+
+    const ReservoirRemapParameters remap = GetRemapParameters(
+        context.GetReservoirBufferParameters(), oldWidth, oldHeight,
+        resized.GetReservoirBufferParameters(), renderWidth, renderHeight,
+        staticParams.CheckerboardSamplingMode, rtxdi::ReSTIRDIContext::NumReservoirBuffers);
+
+    context = resized;
+    return remap;
+}
+
+ReservoirRemapParameters ResizeReSTIRGI(rtxdi::ReSTIRGIContext& context, uint32_t renderWidth, uint32_t renderHeight)
+{
+    rtxdi::ReSTIRGIStaticParameters staticParams = context.GetStaticParams();
+    const uint32_t oldWidth = staticParams.RenderWidth;
+    const uint32_t oldHeight = staticParams.RenderHeight;
+    staticParams.RenderWidth = renderWidth;
+    staticParams.RenderHeight = renderHeight;
+
+    // GI 的缓冲下标只由帧序号和模式决定，设置一次帧序号即可
+    rtxdi::ReSTIRGIContext resized(staticParams);
+    resized.SetResamplingMode(context.GetResamplingMode());
+    resized.SetTemporalResamplingParameters(context.GetTemporalResamplingParameters());
+    resized.SetSpatialResamplingParameters(context.GetSpatialResamplingParameters());
+    resized.SetFinalShadingParameters(context.GetFinalShadingParameters());
+    resized.SetFrameIndex(context.GetFrameIndex());
+
+    const ReservoirRemapParameters remap = GetRemapParameters(
+        context.GetReservoirBufferParameters(), oldWidth, oldHeight,
+        resized.GetReservoirBufferParameters(), renderWidth, renderHeight,
+        staticParams.CheckerboardSamplingMode, c_NumReSTIRGIReservoirBuffers);
+
+    context = resized;
+    return remap;
+}
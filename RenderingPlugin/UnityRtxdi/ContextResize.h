@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include <Rtxdi/DI/ReSTIRDI.h>
+#include <Rtxdi/GI/ReSTIRGI.h>
+
+// 分辨率变化前后的 reservoir 布局，GPU 端据此把旧 reservoir 搬到新缓冲（见 Shaders/Include/ReservoirRemap.hlsl）
+// reservoir 宽高在棋盘模式下为半宽；布局与 cbuffer 对齐，64 字节
+struct ReservoirRemapParameters
+{
+    RTXDI_ReservoirBufferParameters oldReservoirBufferParams;
+    RTXDI_ReservoirBufferParameters newReservoirBufferParams;
+
+    uint32_t oldReservoirWidth;
+    uint32_t oldReservoirHeight;
+    uint32_t newReservoirWidth;
+    uint32_t newReservoirHeight;
+
+    uint32_t numReservoirBuffers;
+    uint32_t oldBufferSizeInReservoirs;
+    uint32_t newBufferSizeInReservoirs;
+    uint32_t pad1;
+};
+
+static_assert(sizeof(ReservoirRemapParameters) == 64, "ReservoirRemapParameters must match the HLSL layout");
+
+// 原地修改分辨率：重新计算 reservoir pitch，保留所有参数、resampling 模式、帧序号和缓冲轮转位置
+// 对 ImportanceSamplingContext 持有的 context 同样适用
+ReservoirRemapParameters ResizeReSTIRDI(rtxdi::ReSTIRDIContext& context, uint32_t renderWidth, uint32_t renderHeight);
+ReservoirRemapParameters ResizeReSTIRGI(rtxdi::ReSTIRGIContext& context, uint32_t renderWidth, uint32_t renderHeight);
@@ -0,0 +1,356 @@
+﻿#include "InstanceTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+#include <Rtxdi/RtxdiUtils.h>
+
+namespace
+{
+    constexpr uint32_t c_InvalidRow = ~0u;
+
+    // xorshift32，与 SharcHashGrid 中的相同
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return float(NextRandom(state) >> 8) * (1.f / 16777216.f);
+    }
+
+    // 比较并复制 [offset, offset + size) 这段字段，返回是否有变化
+    bool CopyField(InstanceData& dst, const InstanceData& src, size_t offset, size_t size)
+    {
+        uint8_t* dstBytes = reinterpret_cast<uint8_t*>(&dst) + offset;
+        const uint8_t* srcBytes = reinterpret_cast<const uint8_t*>(&src) + offset;
+        if (memcmp(dstBytes, srcBytes, size) == 0)
+            return false;
+
+        memcpy(dstBytes, srcBytes, size);
+        return true;
+    }
+
+    bool CopyFields(InstanceData& dst, const InstanceData& src, uint32_t fieldMask)
+    {
+        bool changed = false;
+        if (fieldMask & InstanceField_Transform)
+        {
+            changed |= CopyField(dst, src, offsetof(InstanceData, overloadedMatrix), sizeof(InstanceData::overloadedMatrix));
+            changed |= CopyField(dst, src, offsetof(InstanceData, scale), sizeof(InstanceData::scale));
+        }
+        if (fieldMask & InstanceField_Material)
+        {
+            // 两个 half4 和 normalUvScale、textureOffsetAndFlags 是连续的
+            changed |= CopyField(dst, src, offsetof(InstanceData, baseColorAndMetalnessScale),
+                offsetof(InstanceData, primitiveOffset) - offsetof(InstanceData, baseColorAndMetalnessScale));
+        }
+        if (fieldMask & InstanceField_Geometry)
+        {
+            changed |= CopyField(dst, src, offsetof(InstanceData, primitiveOffset), sizeof(InstanceData::primitiveOffset));
+            // morphPrimitiveOffset、compactVertexOffset、compactIndexOffset 是连续的
+            changed |= CopyField(dst, src, offsetof(InstanceData, morphPrimitiveOffset),
+                offsetof(InstanceData, unused3) - offsetof(InstanceData, morphPrimitiveOffset));
+        }
+        return changed;
+    }
+}
+
+uint32_t InstanceTable::AllocateRows(uint32_t count)
+{
+    // first fit，renderer 的行必须连续
+    for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it)
+    {
+        if (it->rowCount < count)
+            continue;
+
+        const uint32_t firstRow = it->firstRow;
+        it->firstRow += count;
+        it->rowCount -= count;
+        if (it->rowCount == 0)
+            m_freeRanges.erase(it);
+        return firstRow;
+    }
+
+    const uint32_t firstRow = uint32_t(m_rows.size());
+    m_rows.resize(firstRow + count, InstanceData{});
+    m_dirtyBits.resize((m_rows.size() + 63) / 64, 0);
+    return firstRow;
+}
+
+void InstanceTable::FreeRows(uint32_t firstRow, uint32_t count)
+{
+    // 释放的行清零后上传，GPU 上不会留下已删除 renderer 的数据
+    for (uint32_t row = firstRow; row < firstRow + count; row++)
+    {
+        m_rows[row] = InstanceData{};
+        MarkDirty(row);
+    }
+
+    auto it = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), firstRow,
+        [](const InstanceRowRange& range, uint32_t row) { return range.firstRow < row; });
+    it = m_freeRanges.insert(it, { firstRow, count });
+
+    // 与后一个、前一个相邻区间合并
+    if (it + 1 != m_freeRanges.end() && it->firstRow + it->rowCount == (it + 1)->firstRow)
+    {
+        it->rowCount += (it + 1)->rowCount;
+        m_freeRanges.erase(it + 1);
+    }
+    if (it != m_freeRanges.begin() && (it - 1)->firstRow + (it - 1)->rowCount == it->firstRow)
+    {
+        (it - 1)->rowCount += it->rowCount;
+        m_freeRanges.erase(it);
+    }
+}
+
+uint32_t InstanceTable::AddRenderer(int32_t rendererId, uint32_t submeshCount, const InstanceData* rows)
+{
+    auto it = m_renderers.find(rendererId);
+    if (it != m_renderers.end() && it->second.rowCount != submeshCount)
+    {
+        RemoveRenderer(rendererId);
+        it = m_renderers.end();
+    }
+
+    if (it == m_renderers.end())
+    {
+        if (submeshCount == 0)
+            return c_InvalidRow;
+
+        it = m_renderers.emplace(rendererId, RendererRows{ AllocateRows(submeshCount), submeshCount }).first;
+        m_liveRowCount += submeshCount;
+    }
+
+    const uint32_t firstRow = it->second.firstRow;
+    if (rows)
+    {
+        for (uint32_t i = 0; i < submeshCount; i++)
+        {
+            if (CopyFields(m_rows[firstRow + i], rows[i], InstanceField_All))
+                MarkDirty(firstRow + i);
+        }
+    }
+    return firstRow;
+}
+
+void InstanceTable::RemoveRenderer(int32_t rendererId)
+{
+    auto it = m_renderers.find(rendererId);
+    if (it == m_renderers.end())
+        return;
+
+    FreeRows(it->second.firstRow, it->second.rowCount);
+    m_liveRowCount -= it->second.rowCount;
+    m_renderers.erase(it);
+}
+
+uint32_t InstanceTable::GetFirstRow(int32_t rendererId) const
+{
+    auto it = m_renderers.find(rendererId);
+    return it != m_renderers.end() ? it->second.firstRow : c_InvalidRow;
+}
+
+uint32_t InstanceTable::UpdateRows(const uint32_t* rowIndices, const InstanceData* rows, uint32_t count, uint32_t fieldMask)
+{
+    if (!rowIndices || !rows)
+        return 0;
+
+    uint32_t changed = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint32_t row = rowIndices[i];
+        if (row >= m_rows.size())
+            continue;
+
+        if (CopyFields(m_rows[row], rows[i], fieldMask))
+        {
+            MarkDirty(row);
+            changed++;
+        }
+    }
+    return changed;
+}
+
+uint32_t InstanceTable::CollectDirtyRanges(InstanceRowRange* outRanges, uint32_t maxRanges, uint32_t mergeGap)
+{
+    if (!outRanges || maxRanges == 0)
+        return 0;
+
+    uint32_t rangeCount = 0;
+    InstanceRowRange current = { 0, 0 };
+
+    for (uint32_t word = 0; word < uint32_t(m_dirtyBits.size()); word++)
+    {
+        uint64_t bits = m_dirtyBits[word];
+        if (bits == 0)
+            continue;
+        m_dirtyBits[word] = 0;
+
+        while (bits != 0)
+        {
+            // 取出一段连续的 1
+            uint32_t bit = 0;
+            while (((bits >> bit) & 1) == 0) bit++;
+            uint32_t runEnd = bit;
+            while (runEnd < 64 && ((bits >> runEnd) & 1) != 0) runEnd++;
+            bits &= runEnd < 64 ? ~((1ull << runEnd) - 1) : 0;
+
+            const uint32_t first = word * 64 + bit;
+            const uint32_t end = word * 64 + runEnd;
+
+            const bool canMerge = current.rowCount > 0 &&
+                (first <= current.firstRow + current.rowCount + mergeGap || rangeCount + 1 >= maxRanges);
+            if (canMerge)
+            {
+                current.rowCount = end - current.firstRow;
+                continue;
+            }
+
+            if (current.rowCount > 0)
+                outRanges[rangeCount++] = current;
+            current = { first, end - first };
+        }
+    }
+
+    if (current.rowCount > 0)
+        outRanges[rangeCount++] = current;
+    return rangeCount;
+}
+
+void InstanceTable::MarkAllDirty()
+{
+    std::fill(m_dirtyBits.begin(), m_dirtyBits.end(), 0);
+    for (uint32_t row = 0; row < uint32_t(m_rows.size()); row++)
+        MarkDirty(row);
+}
+
+void InstanceTable::Clear()
+{
+    m_rows.clear();
+    m_dirtyBits.clear();
+    m_freeRanges.clear();
+    m_renderers.clear();
+    m_liveRowCount = 0;
+}
+
+InstanceTableStats InstanceTable::GetStats() const
+{
+    InstanceTableStats stats = {};
+    stats.rowCount = uint32_t(m_rows.size());
+    stats.liveRowCount = m_liveRowCount;
+    stats.rendererCount = uint32_t(m_renderers.size());
+    for (uint64_t bits : m_dirtyBits)
+    {
+        for (; bits != 0; bits &= bits - 1)
+            stats.dirtyRowCount++;
+    }
+    return stats;
+}
+
+InstanceTableBenchmarkResult BenchmarkInstanceTableUpdates(uint32_t instanceCount, float movingFraction, uint32_t frameCount, uint32_t mergeGap,
+    uint32_t maxRanges)
+{
+    InstanceTableBenchmarkResult result = {};
+    result.instanceCount = instanceCount;
+    result.frameCount = frameCount;
+    result.mergeGap = mergeGap;
+    result.maxRanges = maxRanges;
+    result.fullUploadBytes = float(uint64_t(instanceCount) * sizeof(InstanceData));
+    if (instanceCount == 0 || frameCount == 0)
+        return result;
+
+    InstanceTable table;
+    uint32_t random = rtxdi::JenkinsHash(instanceCount) | 1u;
+
+    // 场景加载：renderer 依次加入，每个 1 ~ 4 个 submesh
+    std::vector<uint32_t> rendererFirstRows;
+    std::vector<uint32_t> rendererRowCounts;
+    InstanceData rows[4] = {};
+    for (uint32_t row = 0; row < instanceCount;)
+    {
+        const uint32_t submeshCount = std::min(1u + NextRandom(random) % 4u, instanceCount - row);
+        for (uint32_t i = 0; i < submeshCount; i++)
+        {
+            rows[i].overloadedMatrix[0] = rows[i].overloadedMatrix[5] = rows[i].overloadedMatrix[10] = 1.f;
+            rows[i].overloadedMatrix[3] = float(row);
+            rows[i].primitiveOffset = row + i;
+            rows[i].scale = 1.f;
+        }
+        rendererFirstRows.push_back(table.AddRenderer(int32_t(rendererFirstRows.size()), submeshCount, rows));
+        rendererRowCounts.push_back(submeshCount);
+        row += submeshCount;
+    }
+
+    std::vector<InstanceRowRange> ranges(instanceCount);
+    table.CollectDirtyRanges(ranges.data(), uint32_t(ranges.size()), mergeGap);
+
+    // 固定的一部分 renderer 每帧移动，直到覆盖 movingFraction 的行
+    std::vector<uint32_t> movingRenderers;
+    const uint32_t movingTarget = uint32_t(float(instanceCount) * std::clamp(movingFraction, 0.f, 1.f));
+    std::vector<uint8_t> picked(rendererFirstRows.size(), 0);
+    while (result.movingRowsPerFrame < movingTarget)
+    {
+        const uint32_t renderer = NextRandom(random) % uint32_t(rendererFirstRows.size());
+        if (picked[renderer])
+            continue;
+        picked[renderer] = 1;
+        movingRenderers.push_back(renderer);
+        result.movingRowsPerFrame += rendererRowCounts[renderer];
+    }
+
+    std::vector<uint32_t> updateRows;
+    std::vector<InstanceData> updateData;
+    double updateSeconds = 0.0;
+    double collectSeconds = 0.0;
+    uint64_t totalRanges = 0;
+    uint64_t totalUploadedRows = 0;
+
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        // 与 C# 端一样，每个移动的 renderer 的所有 submesh 都重新提交
+        updateRows.clear();
+        updateData.clear();
+        for (uint32_t renderer : movingRenderers)
+        {
+            const float offset = NextRandomFloat(random);
+            for (uint32_t i = 0; i < rendererRowCounts[renderer]; i++)
+            {
+                InstanceData data = table.GetRows()[rendererFirstRows[renderer] + i];
+                data.overloadedMatrix[7] = offset;
+                updateRows.push_back(rendererFirstRows[renderer] + i);
+                updateData.push_back(data);
+            }
+        }
+
+        const auto updateStart = std::chrono::steady_clock::now();
+        table.UpdateRows(updateRows.data(), updateData.data(), uint32_t(updateRows.size()), InstanceField_Transform);
+        const auto collectStart = std::chrono::steady_clock::now();
+        // 与 C# 端一样，没有指定上限时按脏行数准备区间数组（每个区间至少一行），不会截断
+        const uint32_t rangeCapacity = maxRanges > 0 ? maxRanges : std::max(table.GetStats().dirtyRowCount, 1u);
+        if (ranges.size() < rangeCapacity)
+            ranges.resize(rangeCapacity);
+        const uint32_t rangeCount = table.CollectDirtyRanges(ranges.data(), rangeCapacity, mergeGap);
+        const auto collectEnd = std::chrono::steady_clock::now();
+
+        updateSeconds += std::chrono::duration<double>(collectStart - updateStart).count();
+        collectSeconds += std::chrono::duration<double>(collectEnd - collectStart).count();
+        totalRanges += rangeCount;
+        result.truncatedFrameCount += maxRanges > 0 && rangeCount >= maxRanges ? 1 : 0;
+        for (uint32_t i = 0; i < rangeCount; i++)
+            totalUploadedRows += ranges[i].rowCount;
+    }
+
+    result.updateMicroseconds = float(updateSeconds * 1e6 / frameCount);
+    result.collectMicroseconds = float(collectSeconds * 1e6 / frameCount);
+    result.rangesPerFrame = float(double(totalRanges) / frameCount);
+    result.uploadedRowsPerFrame = float(double(totalUploadedRows) / frameCount);
+    result.uploadedBytesPerFrame = result.uploadedRowsPerFrame * float(sizeof(InstanceData));
+    return result;
+}
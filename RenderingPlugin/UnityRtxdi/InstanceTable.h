@@ -0,0 +1,110 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 与 PathTracingDataBuilder.cs 中的 InstanceData 一致，half 按 uint16 存放
+struct InstanceData
+{
+    float overloadedMatrix[12];             // mOverloadedMatrix0..2，localToWorld 的前三行
+    uint16_t baseColorAndMetalnessScale[4];
+    uint16_t emissionAndRoughnessScale[4];
+    uint16_t normalUvScale[2];
+    uint32_t textureOffsetAndFlags;
+    uint32_t primitiveOffset;
+    float scale;
+    uint32_t morphPrimitiveOffset;
+    uint32_t compactVertexOffset;   // CompactSubmesh.vertexOffset，只在使用 CompactGeometry 时有效
+    uint32_t compactIndexOffset;    // CompactSubmesh.indexOffset
+    uint32_t unused3;
+};
+
+static_assert(sizeof(InstanceData) == 96, "InstanceData must match the HLSL layout");
+
+// UpdateRows 时比较和复制的字段
+enum InstanceField : uint32_t
+{
+    InstanceField_Transform = 0x1,  // overloadedMatrix、scale
+    InstanceField_Material = 0x2,   // 颜色、normalUvScale、textureOffsetAndFlags
+    InstanceField_Geometry = 0x4,   // primitiveOffset、morphPrimitiveOffset、compactVertexOffset、compactIndexOffset
+    InstanceField_All = 0x7,
+};
+
+// [firstRow, firstRow + rowCount) 需要上传
+struct InstanceRowRange
+{
+    uint32_t firstRow;
+    uint32_t rowCount;
+};
+
+struct InstanceTableStats
+{
+    uint32_t rowCount;          // 已使用的最大行号 + 1，即 GPU 缓冲至少需要的大小
+    uint32_t liveRowCount;
+    uint32_t rendererCount;
+    uint32_t dirtyRowCount;     // 尚未被 CollectDirtyRanges 取走的脏行
+};
+
+// 常驻的 InstanceData 表，每个 renderer 占一段连续的行（第 i 个 submesh 在 firstRow + i），
+// firstRow 就是 RTAS 中的 InstanceID，renderer 存在期间不会改变；行内容变化时记录脏行，每帧只上传变化的区间
+class InstanceTable
+{
+public:
+    // 已存在且 submesh 数相同时保留原来的行，只更新内容；否则释放旧行重新分配
+    uint32_t AddRenderer(int32_t rendererId, uint32_t submeshCount, const InstanceData* rows);
+    void RemoveRenderer(int32_t rendererId);
+    // 不存在时返回 ~0u
+    uint32_t GetFirstRow(int32_t rendererId) const;
+
+    // rows[i] 写到 rowIndices[i]，只比较和复制 fieldMask 中的字段，返回内容实际变化的行数
+    uint32_t UpdateRows(const uint32_t* rowIndices, const InstanceData* rows, uint32_t count, uint32_t fieldMask);
+
+    // 按行号升序输出脏区间并清空脏标记；相隔不超过 mergeGap 行的区间合并，用多传几行换更少的上传调用
+    // 区间数超过 maxRanges 时最后一个区间延伸到最后一个脏行，返回写入的区间数
+    uint32_t CollectDirtyRanges(InstanceRowRange* outRanges, uint32_t maxRanges, uint32_t mergeGap);
+
+    void MarkAllDirty();
+    void Clear();
+
+    const InstanceData* GetRows() const { return m_rows.data(); }
+    InstanceTableStats GetStats() const;
+
+private:
+    struct RendererRows
+    {
+        uint32_t firstRow;
+        uint32_t rowCount;
+    };
+
+    uint32_t AllocateRows(uint32_t count);
+    void FreeRows(uint32_t firstRow, uint32_t count);
+    void MarkDirty(uint32_t row) { m_dirtyBits[row >> 6] |= 1ull << (row & 63); }
+
+    std::vector<InstanceData> m_rows;
+    std::vector<uint64_t> m_dirtyBits;
+    std::vector<InstanceRowRange> m_freeRanges;    // 按 firstRow 升序，相邻的已合并
+    std::unordered_map<int32_t, RendererRows> m_renderers;
+    uint32_t m_liveRowCount = 0;
+};
+
+struct InstanceTableBenchmarkResult
+{
+    uint32_t instanceCount;
+    uint32_t movingRowsPerFrame;
+    uint32_t frameCount;
+    uint32_t mergeGap;
+    uint32_t maxRanges;             // 0 表示与 PathTracingDataBuilder 相同，按脏行数准备区间数组
+    uint32_t truncatedFrameCount;   // 区间数达到 maxRanges、最后一个区间被延伸的帧数
+    float updateMicroseconds;       // 每帧 UpdateRows 的平均耗时
+    float collectMicroseconds;      // 每帧 CollectDirtyRanges 的平均耗时
+    float rangesPerFrame;
+    float uploadedRowsPerFrame;
+    float uploadedBytesPerFrame;
+    float fullUploadBytes;          // 整表重新上传的大小
+};
+
+// instanceCount 行分给 1 ~ 4 个 submesh 的 renderer，其中固定的 movingFraction 部分每帧改变变换
+// maxRanges 和 mergeGap 应与 PathTracingDataBuilder 使用的值相同
+InstanceTableBenchmarkResult BenchmarkInstanceTableUpdates(uint32_t instanceCount, float movingFraction, uint32_t frameCount, uint32_t mergeGap,
+    uint32_t maxRanges);
@@ -0,0 +1,163 @@
+﻿#include "LightIndexMapping.h"
+
+#include <algorithm>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    constexpr uint32_t c_MinLightsPerBatch = 16384;
+    constexpr uint32_t c_MinInstancesPerBatch = 64;
+
+    // m_previousInstanceLookup 中 id 重复的实例
+    constexpr uint32_t c_DuplicateInstance = UINT32_MAX;
+
+    void FillMapping(uint32_t* mapping, uint32_t count, bool identity)
+    {
+        ParallelFor(count, c_MinLightsPerBatch, [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+                mapping[i] = identity ? i : RTXDI_INVALID_LIGHT_INDEX;
+        });
+    }
+}
+
+LightIndexMappingStats LightIndexMapper::Update(const PrepareLightsDesc& desc, const uint64_t* instanceIds, const RTXDI_LightBufferParameters& lightBufferParams,
+                                                uint32_t* currentToPrevious, uint32_t* previousToCurrent)
+{
+    // 按 PrepareLights 的分配规则重建本帧的实例区间
+    m_firstLightIndices.resize(desc.instanceCount);
+    const uint32_t localLightCount = desc.instanceCount > 0 ? AllocateLocalLights(desc, m_firstLightIndices.data()) : 0;
+
+    m_current.instances.clear();
+    for (uint32_t instanceIndex = 0; instanceIndex < desc.instanceCount; instanceIndex++)
+    {
+        const uint32_t firstLightIndex = m_firstLightIndices[instanceIndex];
+        if (firstLightIndex == RTXDI_INVALID_LIGHT_INDEX)
+            continue;
+
+        m_current.instances.push_back({ instanceIds ? instanceIds[instanceIndex] : uint64_t(instanceIndex), firstLightIndex, desc.instances[instanceIndex].triangleCount });
+    }
+    m_current.localLightCount = std::min(localLightCount, lightBufferParams.localLightBufferRegion.numLights);
+    m_current.infiniteLightCount = lightBufferParams.infiniteLightBufferRegion.numLights;
+    m_current.environmentLightPresent = lightBufferParams.environmentLightParams.lightPresent;
+    m_current.totalLightCount = m_current.localLightCount + m_current.infiniteLightCount + (m_current.environmentLightPresent ? 1u : 0u);
+
+    // 光源没有任何增删或重排时映射为恒等，这是绝大多数帧的情况
+    const bool identity = m_hasPrevious &&
+        m_current.instances == m_previous.instances &&
+        m_current.localLightCount == m_previous.localLightCount &&
+        m_current.infiniteLightCount == m_previous.infiniteLightCount &&
+        m_current.environmentLightPresent == m_previous.environmentLightPresent;
+
+    LightIndexMappingStats stats = {};
+    stats.currentLightCount = m_current.totalLightCount;
+    stats.previousLightCount = m_hasPrevious ? m_previous.totalLightCount : 0;
+
+    if (identity)
+    {
+        if (currentToPrevious) FillMapping(currentToPrevious, stats.currentLightCount, true);
+        if (previousToCurrent) FillMapping(previousToCurrent, stats.previousLightCount, true);
+        stats.mappedLightCount = stats.currentLightCount;
+        stats.changed = m_lastWasIdentity ? 0 : 1;
+    }
+    else
+    {
+        if (currentToPrevious) FillMapping(currentToPrevious, stats.currentLightCount, false);
+        if (previousToCurrent) FillMapping(previousToCurrent, stats.previousLightCount, false);
+
+        if (m_hasPrevious)
+        {
+            // 只有 id 相同且三角形数不变的实例才能逐三角形对应
+            // 本帧 id 重复时只有第一个实例能对应上
+            std::vector<std::pair<InstanceRange, InstanceRange>> matches;
+            std::vector<bool> previousMatched(m_previous.instances.size(), false);
+            matches.reserve(m_current.instances.size());
+            for (const InstanceRange& current : m_current.instances)
+            {
+                auto it = m_previousInstanceLookup.find(current.id);
+                if (it == m_previousInstanceLookup.end() || it->second == c_DuplicateInstance || previousMatched[it->second])
+                    continue;
+
+                const InstanceRange& previous = m_previous.instances[it->second];
+                if (previous.lightCount == current.lightCount)
+                {
+                    matches.emplace_back(current, previous);
+                    previousMatched[it->second] = true;
+                }
+            }
+
+            uint32_t mappedLightCount = 0;
+            for (const auto& match : matches)
+                mappedLightCount += match.first.lightCount;
+
+            ParallelFor(uint32_t(matches.size()), c_MinInstancesPerBatch, [&](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t m = begin; m < end; m++)
+                {
+                    const InstanceRange& current = matches[m].first;
+                    const InstanceRange& previous = matches[m].second;
+                    for (uint32_t i = 0; i < current.lightCount; i++)
+                    {
+                        if (currentToPrevious) currentToPrevious[current.firstLightIndex + i] = previous.firstLightIndex + i;
+                        if (previousToCurrent) previousToCurrent[previous.firstLightIndex + i] = current.firstLightIndex + i;
+                    }
+                }
+            });
+
+            // 无限远光源由调用方打包，数量不变时认为顺序不变
+            if (m_current.infiniteLightCount == m_previous.infiniteLightCount)
+            {
+                for (uint32_t i = 0; i < m_current.infiniteLightCount; i++)
+                {
+                    const uint32_t currentIndex = m_current.localLightCount + i;
+                    const uint32_t previousIndex = m_previous.localLightCount + i;
+                    if (currentToPrevious) currentToPrevious[currentIndex] = previousIndex;
+                    if (previousToCurrent) previousToCurrent[previousIndex] = currentIndex;
+                }
+                mappedLightCount += m_current.infiniteLightCount;
+            }
+
+            if (m_current.environmentLightPresent && m_previous.environmentLightPresent)
+            {
+                const uint32_t currentIndex = m_current.totalLightCount - 1;
+                const uint32_t previousIndex = m_previous.totalLightCount - 1;
+                if (currentToPrevious) currentToPrevious[currentIndex] = previousIndex;
+                if (previousToCurrent) previousToCurrent[previousIndex] = currentIndex;
+                mappedLightCount++;
+            }
+
+            stats.mappedLightCount = mappedLightCount;
+        }
+
+        stats.changed = 1;
+    }
+
+    m_lastWasIdentity = identity;
+    m_hasPrevious = true;
+    std::swap(m_previous, m_current);
+
+    if (!identity)
+    {
+        // 上一帧 id 重复的实例无法确定对应关系，全部不参与映射
+        m_previousInstanceLookup.clear();
+        m_previousInstanceLookup.reserve(m_previous.instances.size());
+        for (uint32_t i = 0; i < uint32_t(m_previous.instances.size()); i++)
+        {
+            auto inserted = m_previousInstanceLookup.emplace(m_previous.instances[i].id, i);
+            if (!inserted.second)
+                inserted.first->second = c_DuplicateInstance;
+        }
+    }
+
+    return stats;
+}
+
+void LightIndexMapper::Reset()
+{
+    m_hasPrevious = false;
+    m_lastWasIdentity = false;
+    m_previous = {};
+    m_current = {};
+    m_previousInstanceLookup.clear();
+}
@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "PrepareLights.h"
+
+struct LightIndexMappingStats
+{
+    uint32_t currentLightCount;
+    uint32_t previousLightCount;
+    uint32_t mappedLightCount;  // 在两帧中都存在的光源数
+    uint32_t changed;           // 映射与上一次 Update 输出的不同，需要重新上传
+};
+
+// 跨帧的光源下标映射，供 RAB_TranslateLightIndex 使用，让光源列表重建后 temporal resampling 仍能复用历史
+// 调用方给每个实例一个跨帧不变且唯一的 id（例如 renderer 的 instance id 和 submesh 下标组合），
+// 同一 id 且三角形数不变的实例，其三角形按下标一一对应；无限远光源数量不变时按顺序对应，环境光始终对应
+// 映射数组的值为另一帧的光源下标，没有对应时为 RTXDI_INVALID_LIGHT_INDEX（按 int 读取即为 -1）
+class LightIndexMapper
+{
+public:
+    // 与 PrepareLights 使用同一个 desc，在其之后调用；instanceIds 与 desc.instances 一一对应
+    // currentToPrevious 至少 currentLightCount 项，previousToCurrent 至少上一帧的光源数，通常都按 maxLights 分配
+    LightIndexMappingStats Update(const PrepareLightsDesc& desc, const uint64_t* instanceIds, const RTXDI_LightBufferParameters& lightBufferParams,
+                                  uint32_t* currentToPrevious, uint32_t* previousToCurrent);
+
+    // 场景整体切换、历史失效时调用，下一次 Update 的结果全部为无效
+    void Reset();
+
+private:
+    struct InstanceRange
+    {
+        uint64_t id;
+        uint32_t firstLightIndex;
+        uint32_t lightCount;
+
+        bool operator==(const InstanceRange& other) const
+        {
+            return id == other.id && firstLightIndex == other.firstLightIndex && lightCount == other.lightCount;
+        }
+    };
+
+    struct LightSetLayout
+    {
+        std::vector<InstanceRange> instances;
+        uint32_t localLightCount = 0;
+        uint32_t infiniteLightCount = 0;
+        uint32_t environmentLightPresent = 0;
+        uint32_t totalLightCount = 0;
+    };
+
+    bool m_hasPrevious = false;
+    bool m_lastWasIdentity = false;
+    LightSetLayout m_previous;
+    LightSetLayout m_current;
+    std::unordered_map<uint64_t, uint32_t> m_previousInstanceLookup; // id -> m_previous.instances 下标
+    std::vector<uint32_t> m_firstLightIndices;
+};
@@ -0,0 +1,194 @@
+﻿#include "LocalLightAliasTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <Rtxdi/RtxdiUtils.h>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    constexpr uint32_t c_MinLightsPerBatch = 16384;
+
+    // 负数和 NaN 一律视为 0
+    float SanitizePower(float power)
+    {
+        return power > 0.f ? power : 0.f;
+    }
+
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // 光源功率在几个数量级之间分布
+    float NextRandomPower(uint32_t& state)
+    {
+        return std::exp2(float(NextRandom(state) >> 8) * (12.f / 16777216.f) - 6.f);
+    }
+}
+
+RTXDI_AliasTableParameters LocalLightAliasTable::Build(const float* lightPowers, uint32_t lightCount, RTXDI_AliasTableEntry* entries)
+{
+    RTXDI_AliasTableParameters params = {};
+    if (!lightPowers || !entries || lightCount == 0)
+        return params;
+
+    const uint32_t batchCount = GetParallelBatchCount(lightCount, c_MinLightsPerBatch);
+
+    m_batchSums.assign(batchCount, 0.0);
+    ParallelForBatches(lightCount, batchCount, [&](uint32_t batch, uint32_t begin, uint32_t end)
+    {
+        double sum = 0.0;
+        for (uint32_t i = begin; i < end; i++)
+            sum += SanitizePower(lightPowers[i]);
+        m_batchSums[batch] = sum;
+    });
+
+    double totalPower = 0.0;
+    for (double sum : m_batchSums)
+        totalPower += sum;
+
+    params.entryCount = lightCount;
+    params.totalPower = float(totalPower);
+
+    if (totalPower <= 0.0)
+    {
+        const float uniformPdf = 1.f / float(lightCount);
+        ParallelFor(lightCount, c_MinLightsPerBatch, [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+                entries[i] = { i, 1.f, uniformPdf, uniformPdf };
+        });
+        return params;
+    }
+
+    // 归一化到平均值为 1，并统计每个批次里小于 1 的个数
+    const double invTotalPower = 1.0 / totalPower;
+    const double scale = double(lightCount) * invTotalPower;
+
+    m_scaledProbabilities.resize(lightCount);
+    m_batchSmallCounts.assign(batchCount, 0);
+    ParallelForBatches(lightCount, batchCount, [&](uint32_t batch, uint32_t begin, uint32_t end)
+    {
+        uint32_t smallCount = 0;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const double power = SanitizePower(lightPowers[i]);
+            const float scaled = float(power * scale);
+
+            m_scaledProbabilities[i] = scaled;
+            entries[i] = { i, 1.f, float(power * invTotalPower), 0.f };
+            smallCount += scaled < 1.f ? 1 : 0;
+        }
+        m_batchSmallCounts[batch] = smallCount;
+    });
+
+    // m_worklist 前段是 small 栈，后段是 large 栈，按批次的前缀和并行写入
+    uint32_t numSmall = 0;
+    for (uint32_t& count : m_batchSmallCounts)
+    {
+        const uint32_t offset = numSmall;
+        numSmall += count;
+        count = offset;
+    }
+
+    m_worklist.resize(lightCount);
+    ParallelForBatches(lightCount, batchCount, [&](uint32_t batch, uint32_t begin, uint32_t end)
+    {
+        uint32_t smallOffset = m_batchSmallCounts[batch];
+        uint32_t largeOffset = numSmall + (begin - smallOffset);
+        for (uint32_t i = begin; i < end; i++)
+        {
+            if (m_scaledProbabilities[i] < 1.f)
+                m_worklist[smallOffset++] = i;
+            else
+                m_worklist[largeOffset++] = i;
+        }
+    });
+
+    // Vose 配对：每次取一个 small 用当前 large 补满，large 剩余不足 1 时转入 small 栈
+    // 弹出 small 后空出的槽位正好用来压入新的 small，两段不会重叠
+    uint32_t smallTop = numSmall;
+    uint32_t largeTop = lightCount;
+    while (smallTop > 0 && largeTop > numSmall)
+    {
+        const uint32_t small = m_worklist[--smallTop];
+        const uint32_t large = m_worklist[largeTop - 1];
+
+        entries[small].probability = m_scaledProbabilities[small];
+        entries[small].alias = large;
+
+        float& remaining = m_scaledProbabilities[large];
+        remaining = (remaining + m_scaledProbabilities[small]) - 1.f;
+        if (remaining < 1.f)
+        {
+            largeTop--;
+            m_worklist[smallTop++] = large;
+        }
+    }
+
+    // 剩下的项只会因为浮点误差偏离 1，保持初始化时的 probability = 1、alias = 自身即可
+
+    ParallelFor(lightCount, c_MinLightsPerBatch, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+            entries[i].aliasPdf = entries[entries[i].alias].pdf;
+    });
+
+    return params;
+}
+
+LocalLightAliasTableBenchmarkResult BenchmarkLocalLightAliasTableBuild(uint32_t lightCount, uint32_t buildCount)
+{
+    LocalLightAliasTableBenchmarkResult result = {};
+    result.lightCount = lightCount;
+    result.buildCount = buildCount;
+    if (lightCount == 0 || buildCount == 0)
+        return result;
+
+    uint32_t random = rtxdi::JenkinsHash(lightCount) | 1u;
+    std::vector<float> powers(lightCount);
+    for (float& power : powers)
+        power = NextRandomPower(random);
+
+    LocalLightAliasTable table;
+    std::vector<RTXDI_AliasTableEntry> entries(lightCount);
+
+    // 第一次 Build 分配临时数组，不计入耗时
+    table.Build(powers.data(), lightCount, entries.data());
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < buildCount; i++)
+        table.Build(powers.data(), lightCount, entries.data());
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.buildMilliseconds = float(seconds * 1e3 / buildCount);
+
+    double totalPower = 0.0;
+    for (float power : powers)
+        totalPower += power;
+
+    // 光源 i 被选中的概率 = (probability_i + 所有以 i 为 alias 的项的 1 - probability) / N
+    std::vector<double> selected(lightCount, 0.0);
+    for (uint32_t i = 0; i < lightCount; i++)
+    {
+        const RTXDI_AliasTableEntry& entry = entries[i];
+        selected[i] += entry.probability;
+        selected[entry.alias] += 1.0 - entry.probability;
+    }
+
+    for (uint32_t i = 0; i < lightCount; i++)
+    {
+        const double expected = double(powers[i]) / totalPower;
+        const RTXDI_AliasTableEntry& entry = entries[i];
+        result.maxPdfError = std::max(result.maxPdfError, float(std::fabs(entry.pdf - expected) / expected));
+        result.maxDistributionError = std::max(result.maxDistributionError, float(std::fabs(selected[i] / lightCount - expected) / expected));
+    }
+
+    return result;
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Rtxdi/DI/ReSTIRDIParameters.h>
+
+// RTXDI 自带的 ReSTIRDI_LocalLightSamplingMode 只有 Uniform / Power_RIS / ReGIR_RIS
+// 这里在其后追加一个取值表示按别名表采样局部光源，SDK 内部把它当作普通模式处理
+// 工程中还没有执行局部光源采样的 shader，接入 RTXDI 的初始采样时按下面的方式读取别名表
+constexpr ReSTIRDI_LocalLightSamplingMode ReSTIRDI_LocalLightSamplingMode_AliasTable = static_cast<ReSTIRDI_LocalLightSamplingMode>(3);
+
+// 上传为 GPU 的结构化缓冲，16 字节一项，下标 i 对应 localLightBufferRegion 中的第 i 个光源
+// 采样：i = floor(u * entryCount)，u' < probability 时取 i，否则取 alias
+struct RTXDI_AliasTableEntry
+{
+    uint32_t alias;
+    float probability;
+    float pdf; // 光源 i 的归一化概率
+    float aliasPdf; // 光源 alias 的归一化概率，省掉一次额外的读取
+};
+
+static_assert(sizeof(RTXDI_AliasTableEntry) == 16, "RTXDI_AliasTableEntry must stay 16 bytes for the structured buffer");
+
+// 放在 ResamplingConstants 中，entryCount 为 0 表示没有可用的别名表
+struct RTXDI_AliasTableParameters
+{
+    uint32_t entryCount;
+    float totalPower;
+    uint32_t pad1;
+    uint32_t pad2;
+};
+
+// Vose 别名表构建，求和、归一化和大小分类多线程进行，配对扫描为单线程 O(N)
+// 临时数组在多次 Build 之间复用
+class LocalLightAliasTable
+{
+public:
+    // entries 至少需要 lightCount 项；总功率为 0 时退化为均匀分布
+    RTXDI_AliasTableParameters Build(const float* lightPowers, uint32_t lightCount, RTXDI_AliasTableEntry* entries);
+
+private:
+    std::vector<float> m_scaledProbabilities;
+    std::vector<uint32_t> m_worklist;
+    std::vector<double> m_batchSums;
+    std::vector<uint32_t> m_batchSmallCounts;
+};
+
+struct LocalLightAliasTableBenchmarkResult
+{
+    uint32_t lightCount;
+    uint32_t buildCount;
+    float buildMilliseconds;    // 每次 Build 的平均耗时
+    float maxPdfError;          // entry.pdf 与 power / totalPower 的最大相对误差
+    float maxDistributionError; // 由 probability 和 alias 还原出的选中概率与 pdf 的最大相对误差
+};
+
+// lightCount 个功率跨几个数量级的随机光源，重复 buildCount 次 Build 并校验结果
+LocalLightAliasTableBenchmarkResult BenchmarkLocalLightAliasTableBuild(uint32_t lightCount, uint32_t buildCount);
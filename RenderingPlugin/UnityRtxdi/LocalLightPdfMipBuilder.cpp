@@ -0,0 +1,347 @@
+﻿#include "LocalLightPdfMipBuilder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include <Rtxdi/RtxdiUtils.h>
+
+#include "ParallelFor.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PDF_MIP_USE_SSE 1
+#else
+#define PDF_MIP_USE_SSE 0
+#endif
+
+namespace
+{
+    constexpr uint32_t c_MinLightsPerBatch = 16384;
+    constexpr uint32_t c_MinRowsPerBatch = 16;
+
+    // 取出偶数位，RTXDI_LinearIndexToZCurve 的 CPU 版本
+    uint32_t CompactEvenBits(uint32_t x)
+    {
+        x &= 0x55555555u;
+        x = (x ^ (x >> 1)) & 0x33333333u;
+        x = (x ^ (x >> 2)) & 0x0f0f0f0fu;
+        x = (x ^ (x >> 4)) & 0x00ff00ffu;
+        x = (x ^ (x >> 8)) & 0x0000ffffu;
+        return x;
+    }
+
+    void LinearIndexToZCurve(uint32_t index, uint32_t& x, uint32_t& y)
+    {
+        x = CompactEvenBits(index);
+        y = CompactEvenBits(index >> 1);
+    }
+
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // 光源功率在几个数量级之间分布
+    float NextRandomPower(uint32_t& state)
+    {
+        return std::exp2(float(NextRandom(state) >> 8) * (12.f / 16777216.f) - 6.f);
+    }
+
+    // 把两行源像素 2x2 平均成一行，row1 为空表示源纹理只有一行
+    // 非正方形纹理的最后几级只有一行或一列，此时与硬件 mip 一样只对存在的像素求平均
+    void ReduceRow(const float* row0, const float* row1, uint32_t srcWidth, float* dst, uint32_t dstWidth)
+    {
+        if (srcWidth == 1)
+        {
+            dst[0] = row1 ? 0.5f * (row0[0] + row1[0]) : row0[0];
+            return;
+        }
+
+        uint32_t x = 0;
+
+#if PDF_MIP_USE_SSE
+        if (row1)
+        {
+            const __m128 quarter = _mm_set1_ps(0.25f);
+            for (; x + 4 <= dstWidth; x += 4)
+            {
+                const __m128 s0 = _mm_add_ps(_mm_loadu_ps(row0 + 2 * x), _mm_loadu_ps(row1 + 2 * x));
+                const __m128 s1 = _mm_add_ps(_mm_loadu_ps(row0 + 2 * x + 4), _mm_loadu_ps(row1 + 2 * x + 4));
+                const __m128 even = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m128 odd = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm_storeu_ps(dst + x, _mm_mul_ps(_mm_add_ps(even, odd), quarter));
+            }
+        }
+#endif
+
+        for (; x < dstWidth; x++)
+        {
+            if (row1)
+                dst[x] = 0.25f * (row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1]);
+            else
+                dst[x] = 0.5f * (row0[2 * x] + row0[2 * x + 1]);
+        }
+    }
+}
+
+LocalLightPdfMipBuilder::LocalLightPdfMipBuilder(uint32_t maxLights) :
+    m_maxLights(maxLights)
+{
+    rtxdi::ComputePdfTextureSize(maxLights, m_width, m_height, m_mipLevels);
+
+    uint32_t offset = 0;
+    m_mipLayouts.resize(m_mipLevels);
+    for (uint32_t mipLevel = 0; mipLevel < m_mipLevels; mipLevel++)
+    {
+        PdfMipLayout& layout = m_mipLayouts[mipLevel];
+        layout.offsetInTexels = offset;
+        layout.width = std::max(1u, m_width >> mipLevel);
+        layout.height = std::max(1u, m_height >> mipLevel);
+        layout.rowPitchInTexels = layout.width;
+        offset += layout.width * layout.height;
+    }
+
+    m_texels.assign(offset, 0.f);
+    m_dirtyRows.assign(m_mipLevels, PdfMipDirtyRows{ 0, 0 });
+}
+
+PdfTextureDesc LocalLightPdfMipBuilder::GetTextureDesc() const
+{
+    PdfTextureDesc desc;
+    desc.width = m_width;
+    desc.height = m_height;
+    desc.mipLevels = m_mipLevels;
+    desc.uploadBufferSizeInTexels = uint32_t(m_texels.size());
+    return desc;
+}
+
+void LocalLightPdfMipBuilder::Build(const float* lightPowers, uint32_t lightCount, float* uploadBuffer)
+{
+    const PdfMipLayout& mip0 = m_mipLayouts[0];
+    lightCount = lightPowers ? std::min(lightCount, mip0.width * mip0.height) : 0u;
+
+    float* texels = m_texels.data();
+    memset(texels, 0, sizeof(float) * mip0.width * mip0.height);
+
+    ParallelFor(lightCount, c_MinLightsPerBatch, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t lightIndex = begin; lightIndex < end; lightIndex++)
+        {
+            uint32_t x, y;
+            LinearIndexToZCurve(lightIndex, x, y);
+            texels[y * mip0.rowPitchInTexels + x] = lightPowers[lightIndex];
+        }
+    });
+
+    for (uint32_t mipLevel = 1; mipLevel < m_mipLevels; mipLevel++)
+        BuildMipLevel(mipLevel);
+
+    for (uint32_t mipLevel = 0; mipLevel < m_mipLevels; mipLevel++)
+        m_dirtyRows[mipLevel] = { 0, m_mipLayouts[mipLevel].height };
+
+    if (uploadBuffer)
+        memcpy(uploadBuffer, texels, sizeof(float) * m_texels.size());
+}
+
+void LocalLightPdfMipBuilder::BuildMipLevel(uint32_t mipLevel)
+{
+    const PdfMipLayout& src = m_mipLayouts[mipLevel - 1];
+    const PdfMipLayout& dst = m_mipLayouts[mipLevel];
+    float* texels = m_texels.data();
+
+    ParallelFor(dst.height, c_MinRowsPerBatch, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t y = begin; y < end; y++)
+        {
+            const float* row0 = texels + src.offsetInTexels + (2 * y) * src.rowPitchInTexels;
+            const float* row1 = (src.height > 1) ? row0 + src.rowPitchInTexels : nullptr;
+            ReduceRow(row0, row1, src.width, texels + dst.offsetInTexels + y * dst.rowPitchInTexels, dst.width);
+        }
+    });
+}
+
+uint32_t LocalLightPdfMipBuilder::Update(const uint32_t* lightIndices, const float* lightPowers, uint32_t count, float* uploadBuffer)
+{
+    for (PdfMipDirtyRows& rows : m_dirtyRows)
+        rows = { 0, 0 };
+
+    if (!lightIndices || !lightPowers || count == 0)
+        return 0;
+
+    float* texels = m_texels.data();
+    const PdfMipLayout& mip0 = m_mipLayouts[0];
+    uint32_t texelsWritten = 0;
+
+    m_dirtyTexels.clear();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (lightIndices[i] >= mip0.width * mip0.height)
+            continue;
+
+        uint32_t x, y;
+        LinearIndexToZCurve(lightIndices[i], x, y);
+        const uint32_t texel = y * mip0.rowPitchInTexels + x;
+
+        texels[texel] = lightPowers[i];
+        if (uploadBuffer)
+            uploadBuffer[texel] = lightPowers[i];
+
+        m_dirtyTexels.push_back(texel);
+        MarkDirtyRow(0, y);
+        texelsWritten++;
+    }
+
+    // 逐级向上，只重算被改动像素的父像素
+    for (uint32_t mipLevel = 1; mipLevel < m_mipLevels && !m_dirtyTexels.empty(); mipLevel++)
+    {
+        const PdfMipLayout& src = m_mipLayouts[mipLevel - 1];
+        const PdfMipLayout& dst = m_mipLayouts[mipLevel];
+
+        m_parentTexels.clear();
+        for (uint32_t texel : m_dirtyTexels)
+        {
+            const uint32_t x = texel % src.rowPitchInTexels;
+            const uint32_t y = texel / src.rowPitchInTexels;
+            m_parentTexels.push_back((y >> 1) * dst.rowPitchInTexels + (x >> 1));
+        }
+
+        std::sort(m_parentTexels.begin(), m_parentTexels.end());
+        m_parentTexels.erase(std::unique(m_parentTexels.begin(), m_parentTexels.end()), m_parentTexels.end());
+
+        for (uint32_t texel : m_parentTexels)
+        {
+            const uint32_t x = texel % dst.rowPitchInTexels;
+            const uint32_t y = texel / dst.rowPitchInTexels;
+
+            const uint32_t srcX0 = std::min(2 * x, src.width - 1);
+            const uint32_t srcY0 = std::min(2 * y, src.height - 1);
+            const float* row0 = texels + src.offsetInTexels + srcY0 * src.rowPitchInTexels;
+
+            float sum = row0[srcX0];
+            float weight = 1.f;
+            if (src.width > 1)
+            {
+                sum += row0[srcX0 + 1];
+                weight *= 0.5f;
+            }
+            if (src.height > 1)
+            {
+                const float* row1 = row0 + src.rowPitchInTexels;
+                sum += row1[srcX0];
+                if (src.width > 1)
+                    sum += row1[srcX0 + 1];
+                weight *= 0.5f;
+            }
+
+            const float value = weight * sum;
+            texels[dst.offsetInTexels + texel] = value;
+            if (uploadBuffer)
+                uploadBuffer[dst.offsetInTexels + texel] = value;
+
+            MarkDirtyRow(mipLevel, y);
+            texelsWritten++;
+        }
+
+        m_dirtyTexels.swap(m_parentTexels);
+    }
+
+    return texelsWritten;
+}
+
+void LocalLightPdfMipBuilder::MarkDirtyRow(uint32_t mipLevel, uint32_t row)
+{
+    PdfMipDirtyRows& rows = m_dirtyRows[mipLevel];
+    if (rows.rowCount == 0)
+    {
+        rows = { row, 1 };
+        return;
+    }
+
+    const uint32_t first = std::min(rows.firstRow, row);
+    const uint32_t last = std::max(rows.firstRow + rows.rowCount - 1, row);
+    rows = { first, last - first + 1 };
+}
+
+LocalLightPdfBenchmarkResult BenchmarkLocalLightPdfUpdates(uint32_t lightCount, float changedFraction, uint32_t frameCount)
+{
+    LocalLightPdfBenchmarkResult result = {};
+    result.lightCount = lightCount;
+    result.frameCount = frameCount;
+    if (lightCount == 0 || frameCount == 0)
+        return result;
+
+    LocalLightPdfMipBuilder builder(lightCount);
+    const PdfTextureDesc desc = builder.GetTextureDesc();
+    result.mipLevels = desc.mipLevels;
+    result.fullUploadBytes = float(uint64_t(desc.uploadBufferSizeInTexels) * sizeof(float));
+    result.changedLightsPerFrame = std::max(1u, uint32_t(float(lightCount) * std::clamp(changedFraction, 0.f, 1.f)));
+
+    uint32_t random = rtxdi::JenkinsHash(lightCount) | 1u;
+    std::vector<float> powers(lightCount);
+    for (float& power : powers)
+        power = NextRandomPower(random);
+
+    std::vector<float> uploadBuffer(desc.uploadBufferSizeInTexels);
+    builder.Build(powers.data(), lightCount, uploadBuffer.data());
+
+    // 与 PrepareLightsPass 一样，每帧提交的光源序号不重复
+    std::vector<uint32_t> changedIndices;
+    std::vector<float> changedPowers;
+    std::vector<uint32_t> lastChanged(lightCount, ~0u);
+    double updateSeconds = 0.0;
+    uint64_t totalTexelsWritten = 0;
+    uint64_t totalUploadedTexels = 0;
+
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        changedIndices.clear();
+        changedPowers.clear();
+        while (changedIndices.size() < result.changedLightsPerFrame)
+        {
+            const uint32_t lightIndex = NextRandom(random) % lightCount;
+            if (lastChanged[lightIndex] == frame)
+                continue;
+            lastChanged[lightIndex] = frame;
+
+            powers[lightIndex] = NextRandomPower(random);
+            changedIndices.push_back(lightIndex);
+            changedPowers.push_back(powers[lightIndex]);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        totalTexelsWritten += builder.Update(changedIndices.data(), changedPowers.data(), uint32_t(changedIndices.size()), uploadBuffer.data());
+        updateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const std::vector<PdfMipLayout>& layouts = builder.GetMipLayouts();
+        const std::vector<PdfMipDirtyRows>& dirtyRows = builder.GetDirtyRows();
+        for (uint32_t mipLevel = 0; mipLevel < desc.mipLevels; mipLevel++)
+            totalUploadedTexels += uint64_t(dirtyRows[mipLevel].rowCount) * layouts[mipLevel].rowPitchInTexels;
+    }
+
+    // 全量重建的耗时取几次的平均，最后一次的结果用来校验增量更新
+    constexpr uint32_t c_BuildCount = 4;
+    LocalLightPdfMipBuilder reference(lightCount);
+    std::vector<float> referenceBuffer(desc.uploadBufferSizeInTexels);
+    const auto buildStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < c_BuildCount; i++)
+        reference.Build(powers.data(), lightCount, referenceBuffer.data());
+    const double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+
+    for (uint32_t i = 0; i < desc.uploadBufferSizeInTexels; i++)
+    {
+        const float expected = referenceBuffer[i];
+        const float error = std::fabs(uploadBuffer[i] - expected);
+        result.maxRelativeError = std::max(result.maxRelativeError, expected != 0.f ? error / std::fabs(expected) : error);
+    }
+
+    result.buildMilliseconds = float(buildSeconds * 1e3 / c_BuildCount);
+    result.updateMilliseconds = float(updateSeconds * 1e3 / frameCount);
+    result.texelsWrittenPerFrame = float(double(totalTexelsWritten) / frameCount);
+    result.uploadedBytesPerFrame = float(double(totalUploadedTexels) * sizeof(float) / frameCount);
+    return result;
+}
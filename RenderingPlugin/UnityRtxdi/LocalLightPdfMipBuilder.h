@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 单个 mip 在上传缓冲中的位置，所有 mip 紧密排列，R32_FLOAT，一个像素一个 float
+struct PdfMipLayout
+{
+    uint32_t offsetInTexels;
+    uint32_t width;
+    uint32_t height;
+    uint32_t rowPitchInTexels;
+};
+
+// 最近一次 Build / Update 中被改写的行区间，rowCount 为 0 表示该 mip 没有变化
+struct PdfMipDirtyRows
+{
+    uint32_t firstRow;
+    uint32_t rowCount;
+};
+
+struct PdfTextureDesc
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevels;
+    uint32_t uploadBufferSizeInTexels;
+};
+
+// 在 CPU 上生成 local light PDF 纹理及其 mip 链（对应 RTXDI 的 PrepareLights + GenerateMips）
+// mip0 中光源 i 位于 RTXDI_LinearIndexToZCurve(i)，上层 mip 为下层 2x2 的平均值（与 GenerateMips 一致）
+// 内部保留一份完整的 mip 链，增量更新时只重算改动光源及其各级祖先像素
+class LocalLightPdfMipBuilder
+{
+public:
+    explicit LocalLightPdfMipBuilder(uint32_t maxLights);
+
+    PdfTextureDesc GetTextureDesc() const;
+    const std::vector<PdfMipLayout>& GetMipLayouts() const { return m_mipLayouts; }
+    const std::vector<PdfMipDirtyRows>& GetDirtyRows() const { return m_dirtyRows; }
+
+    // 全量重建，lightCount 之后的像素清零，uploadBuffer 需要容纳 uploadBufferSizeInTexels 个 float
+    void Build(const float* lightPowers, uint32_t lightCount, float* uploadBuffer);
+
+    // 增量更新，只改写变化的光源及其祖先像素，uploadBuffer 应为上一次 Build / Update 用过的同一块内存
+    // 返回实际写入的像素数
+    uint32_t Update(const uint32_t* lightIndices, const float* lightPowers, uint32_t count, float* uploadBuffer);
+
+private:
+    void BuildMipLevel(uint32_t mipLevel);
+    void MarkDirtyRow(uint32_t mipLevel, uint32_t row);
+
+    uint32_t m_maxLights = 0;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_mipLevels = 0;
+
+    std::vector<PdfMipLayout> m_mipLayouts;
+    std::vector<PdfMipDirtyRows> m_dirtyRows;
+    std::vector<float> m_texels;
+
+    // 增量更新时复用的临时数组
+    std::vector<uint32_t> m_dirtyTexels;
+    std::vector<uint32_t> m_parentTexels;
+};
+
+struct LocalLightPdfBenchmarkResult
+{
+    uint32_t lightCount;
+    uint32_t changedLightsPerFrame;
+    uint32_t frameCount;
+    uint32_t mipLevels;
+    float buildMilliseconds;        // 每次全量 Build 的平均耗时
+    float updateMilliseconds;       // 每帧增量 Update 的平均耗时
+    float texelsWrittenPerFrame;
+    float uploadedBytesPerFrame;    // 按脏行区间上传各级 mip 的字节数
+    float fullUploadBytes;          // 整条 mip 链的字节数
+    float maxRelativeError;         // 增量更新的结果与最后一帧全量重建的最大相对误差，只来自浮点求和顺序
+};
+
+// lightCount 个光源中随机的 changedFraction 部分每帧改变功率，与每帧全量重建比较
+LocalLightPdfBenchmarkResult BenchmarkLocalLightPdfUpdates(uint32_t lightCount, float changedFraction, uint32_t frameCount);
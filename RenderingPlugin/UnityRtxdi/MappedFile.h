@@ -0,0 +1,27 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// 只读内存映射，析构时解除映射；打开失败或文件为空时 GetData 返回 nullptr
+class MappedFile
+{
+public:
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* GetData() const { return m_data; }
+    uint64_t GetSize() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    void* m_file = nullptr;     // HANDLE，不在头文件里包含 windows.h
+    void* m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+    const uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+};
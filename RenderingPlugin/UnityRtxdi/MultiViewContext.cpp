@@ -0,0 +1,137 @@
+﻿#include "MultiViewContext.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <Rtxdi/LightSampling/RISBufferSegmentAllocator.h>
+
+MultiViewImportanceSamplingContext::MultiViewImportanceSamplingContext(const rtxdi::ImportanceSamplingContext_StaticParameters& params) :
+    m_sharedContext(std::make_unique<rtxdi::ImportanceSamplingContext>(params))
+{
+    View primaryView;
+    primaryView.restirDI = &m_sharedContext->GetReSTIRDIContext();
+    primaryView.restirGI = &m_sharedContext->GetReSTIRGIContext();
+    m_views.push_back(std::move(primaryView));
+}
+
+uint32_t MultiViewImportanceSamplingContext::AddView(uint32_t renderWidth, uint32_t renderHeight, rtxdi::CheckerboardMode checkerboardMode)
+{
+    rtxdi::ReSTIRDIStaticParameters restirDIStaticParams;
+    restirDIStaticParams.CheckerboardSamplingMode = checkerboardMode;
+    restirDIStaticParams.NeighborOffsetCount = m_sharedContext->GetNeighborOffsetCount();
+    restirDIStaticParams.RenderWidth = renderWidth;
+    restirDIStaticParams.RenderHeight = renderHeight;
+
+    rtxdi::ReSTIRGIStaticParameters restirGIStaticParams;
+    restirGIStaticParams.CheckerboardSamplingMode = checkerboardMode;
+    restirGIStaticParams.RenderWidth = renderWidth;
+    restirGIStaticParams.RenderHeight = renderHeight;
+
+    View view;
+    view.ownedReSTIRDI = std::make_unique<rtxdi::ReSTIRDIContext>(restirDIStaticParams);
+    view.ownedReSTIRGI = std::make_unique<rtxdi::ReSTIRGIContext>(restirGIStaticParams);
+    view.restirDI = view.ownedReSTIRDI.get();
+    view.restirGI = view.ownedReSTIRGI.get();
+
+    for (uint32_t viewIndex = 1; viewIndex < uint32_t(m_views.size()); viewIndex++)
+    {
+        if (!m_views[viewIndex].restirDI)
+        {
+            m_views[viewIndex] = std::move(view);
+            return viewIndex;
+        }
+    }
+
+    m_views.push_back(std::move(view));
+    return uint32_t(m_views.size()) - 1;
+}
+
+bool MultiViewImportanceSamplingContext::RemoveView(uint32_t viewIndex)
+{
+    if (viewIndex == 0 || !IsValidView(viewIndex))
+        return false;
+
+    m_views[viewIndex] = View();
+
+    // 末尾的空槽位直接去掉，缩小共享缓冲
+    while (m_views.size() > 1 && !m_views.back().restirDI)
+        m_views.pop_back();
+
+    return true;
+}
+
+bool MultiViewImportanceSamplingContext::IsValidView(uint32_t viewIndex) const
+{
+    return viewIndex < m_views.size() && m_views[viewIndex].restirDI != nullptr;
+}
+
+rtxdi::ReSTIRDIContext* MultiViewImportanceSamplingContext::GetReSTIRDIContext(uint32_t viewIndex)
+{
+    return IsValidView(viewIndex) ? m_views[viewIndex].restirDI : nullptr;
+}
+
+rtxdi::ReSTIRGIContext* MultiViewImportanceSamplingContext::GetReSTIRGIContext(uint32_t viewIndex)
+{
+    return IsValidView(viewIndex) ? m_views[viewIndex].restirGI : nullptr;
+}
+
+MultiViewBufferSizes MultiViewImportanceSamplingContext::GetBufferSizes(const RISBufferLayout* risBufferLayout) const
+{
+    MultiViewBufferSizes sizes = {};
+    sizes.viewSlotCount = uint32_t(m_views.size());
+    sizes.neighborOffsetCount = m_sharedContext->GetNeighborOffsetCount();
+    sizes.risAllocatorSizeInElements = m_sharedContext->GetRISBufferSegmentAllocator().getTotalSizeInElements();
+    sizes.risBufferSizeInElements = risBufferLayout ? risBufferLayout->totalSizeInElements : sizes.risAllocatorSizeInElements;
+
+    for (const View& view : m_views)
+    {
+        if (!view.restirDI)
+            continue;
+
+        sizes.diReservoirArrayPitch = std::max(sizes.diReservoirArrayPitch, view.restirDI->GetReservoirBufferParameters().reservoirArrayPitch);
+        sizes.giReservoirArrayPitch = std::max(sizes.giReservoirArrayPitch, view.restirGI->GetReservoirBufferParameters().reservoirArrayPitch);
+    }
+
+    sizes.diReservoirArrayCount = sizes.viewSlotCount * NumDIReservoirArraysPerView;
+    sizes.diReservoirBufferSizeInElements = sizes.diReservoirArrayPitch * sizes.diReservoirArrayCount;
+    sizes.giReservoirArrayCount = sizes.viewSlotCount * NumGIReservoirArraysPerView;
+    sizes.giReservoirBufferSizeInElements = sizes.giReservoirArrayPitch * sizes.giReservoirArrayCount;
+    return sizes;
+}
+
+bool MultiViewImportanceSamplingContext::UpdateViewResamplingConstants(uint32_t viewIndex, ResamplingConstants& inOutConstants,
+                                                                      const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout)
+{
+    if (!IsValidView(viewIndex))
+        return false;
+
+    const View& view = m_views[viewIndex];
+    const MultiViewBufferSizes sizes = GetBufferSizes(risBufferLayout);
+
+    ResamplingConstants constants;
+    memset(&constants, 0, sizeof(constants));
+    FillResamplingConstants(constants, *m_sharedContext, *view.restirDI, *view.restirGI, aliasTableParams, risBufferLayout);
+
+    // 行间距保持视图自己的，数组间距统一为共享缓冲的最大值，下标整体偏移到该视图的数组
+    const uint32_t diBase = viewIndex * NumDIReservoirArraysPerView;
+    constants.restirDI.reservoirBufferParams.reservoirArrayPitch = sizes.diReservoirArrayPitch;
+    ReSTIRDI_BufferIndices& diIndices = constants.restirDI.bufferIndices;
+    diIndices.initialSamplingOutputBufferIndex += diBase;
+    diIndices.temporalResamplingInputBufferIndex += diBase;
+    diIndices.temporalResamplingOutputBufferIndex += diBase;
+    diIndices.spatialResamplingInputBufferIndex += diBase;
+    diIndices.spatialResamplingOutputBufferIndex += diBase;
+    diIndices.shadingInputBufferIndex += diBase;
+
+    const uint32_t giBase = viewIndex * NumGIReservoirArraysPerView;
+    constants.restirGI.reservoirBufferParams.reservoirArrayPitch = sizes.giReservoirArrayPitch;
+    ReSTIRGI_BufferIndices& giIndices = constants.restirGI.bufferIndices;
+    giIndices.secondarySurfaceReSTIRDIOutputBufferIndex += giBase;
+    giIndices.temporalResamplingInputBufferIndex += giBase;
+    giIndices.temporalResamplingOutputBufferIndex += giBase;
+    giIndices.spatialResamplingInputBufferIndex += giBase;
+    giIndices.spatialResamplingOutputBufferIndex += giBase;
+    giIndices.finalShadingInputBufferIndex += giBase;
+
+    return CommitResamplingConstants(inOutConstants, constants);
+}
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Rtxdi/ImportanceSamplingContext.h>
+
+#include "ResamplingConstants.h"
+
+// 多视图共用一个 reservoir 缓冲时的尺寸，视图 v 的 DI reservoir 数组为 [v * 3, v * 3 + 3)，GI 为 [v * 2, v * 2 + 2)
+// 数组间距取所有视图中最大的 reservoirArrayPitch，分辨率变化后需要重新查询
+struct MultiViewBufferSizes
+{
+    uint32_t viewSlotCount; // 包括已移除视图留下的空槽位
+    uint32_t neighborOffsetCount;
+    uint32_t risBufferSizeInElements;       // 需要分配的 RIS 缓冲大小，使用 ReconfigurableRISBuffer 时为它的容量
+    uint32_t risAllocatorSizeInElements;    // 共享 context 中 RISBufferSegmentAllocator 当前的用量
+
+    uint32_t diReservoirArrayPitch;
+    uint32_t diReservoirArrayCount;
+    uint32_t diReservoirBufferSizeInElements;
+    uint32_t pad2;
+
+    uint32_t giReservoirArrayPitch;
+    uint32_t giReservoirArrayCount;
+    uint32_t giReservoirBufferSizeInElements;
+    uint32_t pad3;
+};
+
+// 一套光源缓冲 / PDF 纹理 / RIS / ReGIR 数据供多个视图（主相机、平面反射、XR 双眼）共用，每个视图有独立的 DI / GI reservoir
+// 视图 0 就是共享 ImportanceSamplingContext 自带的 DI / GI context，RIS 预采样等依赖 DI 设置的逻辑以它为准
+// 每个视图的帧序号和缓冲轮转互相独立
+class MultiViewImportanceSamplingContext
+{
+public:
+    static const uint32_t NumDIReservoirArraysPerView = 3;
+    static const uint32_t NumGIReservoirArraysPerView = 2;
+
+    explicit MultiViewImportanceSamplingContext(const rtxdi::ImportanceSamplingContext_StaticParameters& params);
+
+    rtxdi::ImportanceSamplingContext& GetSharedContext() { return *m_sharedContext; }
+
+    // 返回视图下标，会优先复用已移除视图的槽位；NeighborOffsetCount 与共享 context 一致
+    uint32_t AddView(uint32_t renderWidth, uint32_t renderHeight, rtxdi::CheckerboardMode checkerboardMode);
+    // 视图 0 不能移除
+    bool RemoveView(uint32_t viewIndex);
+    bool IsValidView(uint32_t viewIndex) const;
+
+    // 视图不存在时返回空
+    rtxdi::ReSTIRDIContext* GetReSTIRDIContext(uint32_t viewIndex);
+    rtxdi::ReSTIRGIContext* GetReSTIRGIContext(uint32_t viewIndex);
+
+    // risBufferLayout 为空时 RIS 缓冲大小取共享 context 自己的分配总量
+    MultiViewBufferSizes GetBufferSizes(const RISBufferLayout* risBufferLayout) const;
+
+    // 与 UpdateResamplingConstants 相同，额外把该视图的缓冲下标偏移到共享 reservoir 缓冲中对应的数组
+    bool UpdateViewResamplingConstants(uint32_t viewIndex, ResamplingConstants& inOutConstants,
+                                       const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout);
+
+private:
+    struct View
+    {
+        // 视图 0 指向共享 context 内部的对象，owned 为空
+        rtxdi::ReSTIRDIContext* restirDI = nullptr;
+        rtxdi::ReSTIRGIContext* restirGI = nullptr;
+        std::unique_ptr<rtxdi::ReSTIRDIContext> ownedReSTIRDI;
+        std::unique_ptr<rtxdi::ReSTIRGIContext> ownedReSTIRGI;
+    };
+
+    std::unique_ptr<rtxdi::ImportanceSamplingContext> m_sharedContext;
+    std::vector<View> m_views;
+};
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 计算把 count 个元素按至少 minBatchSize 一组切分时实际使用的批次数（不超过硬件线程数）
+inline uint32_t GetParallelBatchCount(uint32_t count, uint32_t minBatchSize)
+{
+    if (count == 0)
+        return 0;
+
+    const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t maxBatches = (count + std::max(1u, minBatchSize) - 1) / std::max(1u, minBatchSize);
+    return std::max(1u, std::min(hardwareThreads, maxBatches));
+}
+
+// 把 [0, count) 平均切成 batchCount 段，func(batchIndex, begin, end) 在各自线程上执行
+// 第 0 段在调用线程上执行，函数返回时所有段都已完成
+template <typename Func>
+void ParallelForBatches(uint32_t count, uint32_t batchCount, Func&& func)
+{
+    if (count == 0 || batchCount == 0)
+        return;
+
+    const uint32_t batchSize = (count + batchCount - 1) / batchCount;
+
+    std::vector<std::thread> workers;
+    workers.reserve(batchCount - 1);
+
+    for (uint32_t batch = 1; batch < batchCount; batch++)
+    {
+        const uint32_t begin = batch * batchSize;
+        const uint32_t end = std::min(count, begin + batchSize);
+        if (begin >= end)
+            break;
+
+        workers.emplace_back([&func, batch, begin, end]() { func(batch, begin, end); });
+    }
+
+    func(0u, 0u, std::min(count, batchSize));
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+// 数据量小于 minBatchSize 时直接在当前线程执行，避免起线程的开销
+template <typename Func>
+void ParallelFor(uint32_t count, uint32_t minBatchSize, Func&& func)
+{
+    ParallelForBatches(count, GetParallelBatchCount(count, minBatchSize),
+        [&func](uint32_t, uint32_t begin, uint32_t end) { func(begin, end); });
+}
@@ -0,0 +1,264 @@
+﻿#include "PrepareLights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    // 每个线程至少处理的三角形数量
+    constexpr uint32_t c_MinTrianglesPerBatch = 4096;
+
+    struct float3
+    {
+        float x, y, z;
+    };
+
+    float3 operator+(const float3& a, const float3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    float3 operator-(const float3& a, const float3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    float3 operator*(const float3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+
+    float Length(const float3& v)
+    {
+        return sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+    }
+
+    float3 TransformPoint(const float* m, const float* p)
+    {
+        return {
+            m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3],
+            m[4] * p[0] + m[5] * p[1] + m[6] * p[2] + m[7],
+            m[8] * p[0] + m[9] * p[1] + m[10] * p[2] + m[11]
+        };
+    }
+
+    // 与 HLSL f32tof16 一致：就近舍入到偶数，溢出为 inf
+    uint32_t FloatToHalf(float value)
+    {
+        uint32_t f;
+        memcpy(&f, &value, sizeof(f));
+
+        const uint32_t sign = (f >> 16) & 0x8000u;
+        const uint32_t exponent = (f >> 23) & 0xffu;
+        uint32_t mantissa = f & 0x7fffffu;
+
+        if (exponent == 0xffu)
+            return sign | 0x7c00u | (mantissa ? 0x200u : 0u);
+
+        const int32_t halfExponent = int32_t(exponent) - 127 + 15;
+        if (halfExponent >= 31)
+            return sign | 0x7c00u;
+
+        if (halfExponent <= 0)
+        {
+            if (halfExponent < -10)
+                return sign;
+
+            mantissa |= 0x800000u;
+            const uint32_t shift = uint32_t(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            const uint32_t halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (half & 1u)))
+                half++;
+            return sign | half;
+        }
+
+        uint32_t half = sign | (uint32_t(halfExponent) << 10) | (mantissa >> 13);
+        const uint32_t remainder = mantissa & 0x1fffu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+            half++;
+        return half;
+    }
+
+    // ndirToOctUnorm32
+    uint32_t EncodeDirectionOct(const float3& n)
+    {
+        const float invL1 = 1.f / (fabsf(n.x) + fabsf(n.y) + fabsf(n.z));
+        float px = n.x * invL1;
+        float py = n.y * invL1;
+        if (n.z < 0.f)
+        {
+            const float wx = (1.f - fabsf(py)) * (px >= 0.f ? 1.f : -1.f);
+            const float wy = (1.f - fabsf(px)) * (py >= 0.f ? 1.f : -1.f);
+            px = wx;
+            py = wy;
+        }
+
+        px = std::min(std::max(px * 0.5f + 0.5f, 0.f), 1.f);
+        py = std::min(std::max(py * 0.5f + 0.5f, 0.f), 1.f);
+        return uint32_t(px * 0xfffe) | (uint32_t(py * 0xfffe) << 16);
+    }
+
+    // TriangleLight::Store
+    RAB_LightInfo PackTriangleLight(const float3& p0, const float3& p1, const float3& p2, const float* radiance)
+    {
+        const float3 edge1 = p1 - p0;
+        const float3 edge2 = p2 - p0;
+        const float length1 = Length(edge1);
+        const float length2 = Length(edge2);
+
+        // 退化三角形仍然占一个槽位，保证实例内三角形下标与光源下标一一对应
+        const float3 fallbackDirection = { 0.f, 0.f, 1.f };
+        const float3 direction1 = length1 > 0.f ? edge1 * (1.f / length1) : fallbackDirection;
+        const float3 direction2 = length2 > 0.f ? edge2 * (1.f / length2) : fallbackDirection;
+
+        const float3 center = p0 + (edge1 + edge2) * (1.f / 3.f);
+
+        RAB_LightInfo lightInfo = {};
+        lightInfo.center[0] = center.x;
+        lightInfo.center[1] = center.y;
+        lightInfo.center[2] = center.z;
+        lightInfo.scalars = FloatToHalf(length1) | (FloatToHalf(length2) << 16);
+        lightInfo.radiance[0] = FloatToHalf(radiance[0]) | (FloatToHalf(radiance[1]) << 16);
+        lightInfo.radiance[1] = FloatToHalf(radiance[2]);
+        lightInfo.direction1 = EncodeDirectionOct(direction1);
+        lightInfo.direction2 = EncodeDirectionOct(direction2);
+        return lightInfo;
+    }
+
+    // 无限远光源和环境光优先占位，剩下的空间留给局部光源
+    struct LightBudget
+    {
+        bool environmentLightPresent;
+        uint32_t numInfiniteLights;
+        uint32_t maxLocalLights;
+    };
+
+    LightBudget GetLightBudget(const PrepareLightsDesc& desc)
+    {
+        LightBudget budget;
+        budget.environmentLightPresent = desc.environmentLightPresent && desc.maxLights > 0;
+        const uint32_t maxInfiniteLights = desc.maxLights - (budget.environmentLightPresent ? 1u : 0u);
+        budget.numInfiniteLights = desc.infiniteLights ? std::min(desc.infiniteLightCount, maxInfiniteLights) : 0u;
+        budget.maxLocalLights = maxInfiniteLights - budget.numInfiniteLights;
+        return budget;
+    }
+
+    bool IsEmissiveInstance(const PrepareLightsInstance& instance)
+    {
+        if (instance.triangleCount == 0 || instance.vertexCount == 0 || !instance.positions || !instance.indices)
+            return false;
+
+        return instance.emissiveRadiance[0] > 0.f || instance.emissiveRadiance[1] > 0.f || instance.emissiveRadiance[2] > 0.f;
+    }
+}
+
+uint32_t AllocateLocalLights(const PrepareLightsDesc& desc, uint32_t* outFirstLightIndices)
+{
+    const uint32_t maxLocalLights = GetLightBudget(desc).maxLocalLights;
+
+    // 按实例顺序分配光源缓冲区间，放不下的实例跳过
+    uint32_t lightBufferOffset = 0;
+    for (uint32_t instanceIndex = 0; instanceIndex < desc.instanceCount; instanceIndex++)
+    {
+        const PrepareLightsInstance& instance = desc.instances[instanceIndex];
+        outFirstLightIndices[instanceIndex] = RTXDI_INVALID_LIGHT_INDEX;
+
+        if (!IsEmissiveInstance(instance) || lightBufferOffset + instance.triangleCount > maxLocalLights)
+            continue;
+
+        outFirstLightIndices[instanceIndex] = lightBufferOffset;
+        lightBufferOffset += instance.triangleCount;
+    }
+
+    return lightBufferOffset;
+}
+
+RTXDI_LightBufferParameters PrepareLights(const PrepareLightsDesc& desc)
+{
+    RTXDI_LightBufferParameters outLightBufferParams = {};
+
+    if (desc.geometryInstanceToLight)
+        std::fill_n(desc.geometryInstanceToLight, desc.geometryInstanceCount, RTXDI_INVALID_LIGHT_INDEX);
+
+    if (!desc.lightBuffer)
+        return outLightBufferParams;
+
+    const LightBudget budget = GetLightBudget(desc);
+    const bool environmentLightPresent = budget.environmentLightPresent;
+    const uint32_t numInfiniteLights = budget.numInfiniteLights;
+
+    std::vector<uint32_t> firstLightIndices(desc.instanceCount);
+    const uint32_t numLocalLights = AllocateLocalLights(desc, firstLightIndices.data());
+
+    std::vector<uint32_t> taskInstances;
+    std::vector<uint32_t> taskOffsets;
+    taskInstances.reserve(desc.instanceCount);
+    taskOffsets.reserve(desc.instanceCount + 1);
+
+    for (uint32_t instanceIndex = 0; instanceIndex < desc.instanceCount; instanceIndex++)
+    {
+        const uint32_t firstLightIndex = firstLightIndices[instanceIndex];
+        if (firstLightIndex == RTXDI_INVALID_LIGHT_INDEX)
+            continue;
+
+        const PrepareLightsInstance& instance = desc.instances[instanceIndex];
+        if (desc.geometryInstanceToLight && instance.geometryInstanceIndex < desc.geometryInstanceCount)
+            desc.geometryInstanceToLight[instance.geometryInstanceIndex] = firstLightIndex;
+
+        taskInstances.push_back(instanceIndex);
+        taskOffsets.push_back(firstLightIndex);
+    }
+    taskOffsets.push_back(numLocalLights);
+
+    // 按三角形而不是按实例切分，单个巨大网格也能摊到所有线程上
+    ParallelFor(numLocalLights, c_MinTrianglesPerBatch, [&](uint32_t begin, uint32_t end)
+    {
+        size_t task = size_t(std::upper_bound(taskOffsets.begin(), taskOffsets.end(), begin) - taskOffsets.begin()) - 1;
+
+        uint32_t lightIndex = begin;
+        while (lightIndex < end)
+        {
+            const PrepareLightsInstance& instance = desc.instances[taskInstances[task]];
+            const uint32_t taskBegin = taskOffsets[task];
+            const uint32_t taskEnd = std::min(taskOffsets[task + 1], end);
+
+            for (; lightIndex < taskEnd; lightIndex++)
+            {
+                const uint32_t* triangle = instance.indices + size_t(lightIndex - taskBegin) * 3;
+                // 索引来自托管端，越界时仍然占住槽位但不发光，不读 positions 之外的内存
+                if (triangle[0] >= instance.vertexCount || triangle[1] >= instance.vertexCount || triangle[2] >= instance.vertexCount)
+                {
+                    desc.lightBuffer[lightIndex] = {};
+                    continue;
+                }
+
+                const float3 p0 = TransformPoint(instance.objectToWorld, instance.positions + size_t(triangle[0]) * 3);
+                const float3 p1 = TransformPoint(instance.objectToWorld, instance.positions + size_t(triangle[1]) * 3);
+                const float3 p2 = TransformPoint(instance.objectToWorld, instance.positions + size_t(triangle[2]) * 3);
+
+                desc.lightBuffer[lightIndex] = PackTriangleLight(p0, p1, p2, instance.emissiveRadiance);
+            }
+
+            task++;
+        }
+    });
+
+    outLightBufferParams.localLightBufferRegion.firstLightIndex = 0;
+    outLightBufferParams.localLightBufferRegion.numLights = numLocalLights;
+
+    if (numInfiniteLights > 0)
+        memcpy(desc.lightBuffer + numLocalLights, desc.infiniteLights, sizeof(RAB_LightInfo) * numInfiniteLights);
+
+    outLightBufferParams.infiniteLightBufferRegion.firstLightIndex = numLocalLights;
+    outLightBufferParams.infiniteLightBufferRegion.numLights = numInfiniteLights;
+
+    if (environmentLightPresent)
+    {
+        const uint32_t environmentLightIndex = numLocalLights + numInfiniteLights;
+        desc.lightBuffer[environmentLightIndex] = {};
+        outLightBufferParams.environmentLightParams.lightPresent = 1;
+        outLightBufferParams.environmentLightParams.lightIndex = environmentLightIndex;
+    }
+    else
+    {
+        outLightBufferParams.environmentLightParams.lightPresent = 0;
+        outLightBufferParams.environmentLightParams.lightIndex = RTXDI_INVALID_LIGHT_INDEX;
+    }
+
+    return outLightBufferParams;
+}
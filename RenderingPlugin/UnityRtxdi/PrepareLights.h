@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include <Rtxdi/ImportanceSamplingContext.h>
+
+// 与 HLSL / C# 端 RAB_LightInfo 一致，编码方式见 TriangleLight.hlsli
+struct RAB_LightInfo
+{
+    // uint4[0]
+    float center[3];
+    uint32_t scalars; // 2x float16
+
+    // uint4[1]
+    uint32_t radiance[2]; // fp16x4
+    uint32_t direction1; // oct-encoded
+    uint32_t direction2; // oct-encoded
+};
+
+static_assert(sizeof(RAB_LightInfo) == 32, "RAB_LightInfo must match the HLSL layout");
+
+// 一个自发光几何实例（renderer 的一个 submesh），每个三角形生成一个局部光源
+struct PrepareLightsInstance
+{
+    float objectToWorld[12]; // 3x4，行主序
+    float emissiveRadiance[3];
+    uint32_t geometryInstanceIndex; // GeometryInstanceToLight 中的下标
+
+    const float* positions; // 物体空间 float3 顶点
+    const uint32_t* indices; // 每个三角形 3 个索引
+    uint32_t triangleCount;
+    uint32_t vertexCount; // positions 中的顶点数，索引越界的三角形生成零辐射度的光源
+};
+
+struct PrepareLightsDesc
+{
+    const PrepareLightsInstance* instances;
+    uint32_t instanceCount;
+
+    // 方向光等无限远光源由调用方预先打包好，按顺序放在局部光源之后
+    const RAB_LightInfo* infiniteLights;
+    uint32_t infiniteLightCount;
+
+    // 环境光占用光源缓冲的最后一个槽位
+    uint32_t environmentLightPresent;
+
+    RAB_LightInfo* lightBuffer;
+    uint32_t maxLights;
+
+    uint32_t* geometryInstanceToLight;
+    uint32_t geometryInstanceCount;
+};
+
+// 生成打包好的光源缓冲和 GeometryInstanceToLight 映射，返回各类光源在缓冲中的区间
+// 光源缓冲放不下的实例会被整体跳过，其映射保持 RTXDI_INVALID_LIGHT_INDEX
+RTXDI_LightBufferParameters PrepareLights(const PrepareLightsDesc& desc);
+
+// PrepareLights 使用的局部光源分配，outFirstLightIndices 至少 instanceCount 项
+// 第 i 项为实例 i 第一个三角形的光源下标，被跳过的实例为 RTXDI_INVALID_LIGHT_INDEX，返回局部光源总数
+uint32_t AllocateLocalLights(const PrepareLightsDesc& desc, uint32_t* outFirstLightIndices);
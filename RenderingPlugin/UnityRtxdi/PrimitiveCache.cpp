@@ -0,0 +1,588 @@
+﻿#include "PrimitiveCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    constexpr uint32_t c_CacheMagic = 0x434D5250; // "PRMC"
+    constexpr uint32_t c_CacheVersion = 1;
+    constexpr uint64_t c_DataAlignment = 16;
+
+    constexpr uint64_t c_ContentSeed = 0x5052494D49544956ull;
+    constexpr uint64_t c_ChecksumSeed = 0x434845434B53554Dull;
+
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t primitiveDataVersion;  // c_PrimitiveDataVersion
+        uint32_t primitiveDataSize;     // sizeof(PrimitiveData)
+        uint32_t entryCount;
+        uint64_t entryTableOffset;      // entryCount 个 CacheEntry
+        uint64_t fileBytes;
+        uint64_t entryTableChecksum;    // 每个 entry 的数据在命中时单独校验
+    };
+
+    struct CacheEntry
+    {
+        uint64_t contentHash;
+        uint64_t dataOffset;
+        uint64_t dataBytes;
+        uint64_t checksum;
+        uint32_t submeshCount;
+        uint32_t primitiveCount;
+        uint32_t vertexCount;
+        uint32_t pad1;
+    };
+
+    // 连续的 submesh 中 positions 相同的一段
+    struct MeshGroup
+    {
+        uint32_t firstDesc;
+        uint32_t descCount;
+        uint64_t contentHash;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // 三角形数表按 16 字节对齐，之后是 PrimitiveData
+    uint64_t GetTriangleTableBytes(uint32_t submeshCount)
+    {
+        return AlignUp(uint64_t(submeshCount) * sizeof(uint32_t), c_DataAlignment);
+    }
+
+    uint64_t GetEntryDataBytes(uint32_t submeshCount, uint32_t primitiveCount)
+    {
+        return GetTriangleTableBytes(submeshCount) + uint64_t(primitiveCount) * sizeof(PrimitiveData);
+    }
+
+    constexpr uint64_t c_Prime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t c_Prime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t c_Prime3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t c_Prime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t c_Prime5 = 0x27D4EB2F165667C5ull;
+
+    uint64_t Rotl(uint64_t x, uint32_t r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    uint64_t Read64(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t XXHash64Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * c_Prime2;
+        return Rotl(acc, 31) * c_Prime1;
+    }
+
+    uint64_t XXHash64Merge(uint64_t hash, uint64_t acc)
+    {
+        hash ^= XXHash64Round(0, acc);
+        return hash * c_Prime1 + c_Prime4;
+    }
+
+    // xxHash64，4 路累加每周期可以处理接近 8 字节，顶点数据的 hash 远快于重新生成 PrimitiveData
+    uint64_t XXHash64(const void* data, uint64_t size, uint64_t seed)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        const uint8_t* end = p + size;
+
+        uint64_t hash;
+        if (size >= 32)
+        {
+            uint64_t v1 = seed + c_Prime1 + c_Prime2;
+            uint64_t v2 = seed + c_Prime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - c_Prime1;
+            for (; p + 32 <= end; p += 32)
+            {
+                v1 = XXHash64Round(v1, Read64(p));
+                v2 = XXHash64Round(v2, Read64(p + 8));
+                v3 = XXHash64Round(v3, Read64(p + 16));
+                v4 = XXHash64Round(v4, Read64(p + 24));
+            }
+            hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            hash = XXHash64Merge(hash, v1);
+            hash = XXHash64Merge(hash, v2);
+            hash = XXHash64Merge(hash, v3);
+            hash = XXHash64Merge(hash, v4);
+        }
+        else
+        {
+            hash = seed + c_Prime5;
+        }
+
+        hash += size;
+        for (; p + 8 <= end; p += 8)
+        {
+            hash ^= XXHash64Round(0, Read64(p));
+            hash = Rotl(hash, 27) * c_Prime1 + c_Prime4;
+        }
+        if (p + 4 <= end)
+        {
+            hash ^= uint64_t(Read32(p)) * c_Prime1;
+            hash = Rotl(hash, 23) * c_Prime2 + c_Prime3;
+            p += 4;
+        }
+        for (; p < end; p++)
+        {
+            hash ^= *p * c_Prime5;
+            hash = Rotl(hash, 11) * c_Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= c_Prime2;
+        hash ^= hash >> 29;
+        hash *= c_Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // 依次 hash 顶点数、submesh 数、哪些属性存在（包括是否生成切线）、各顶点属性和每个 submesh 的索引，上一步的结果作为下一步的种子
+    uint64_t HashMesh(const PrimitiveBuildDesc* descs, uint32_t descCount)
+    {
+        const PrimitiveBuildDesc& mesh = descs[0];
+        const uint32_t layout[4] = {
+            mesh.vertexCount,
+            descCount,
+            (mesh.normals ? 1u : 0u) | (mesh.tangents ? 2u : 0u) | (mesh.uvs ? 4u : 0u) |
+                (!mesh.tangents && (mesh.flags & PrimitiveBuildFlag_GenerateTangents) ? 8u : 0u),
+            c_PrimitiveDataVersion,
+        };
+
+        const uint64_t vertexCount = mesh.vertexCount;
+        uint64_t hash = XXHash64(layout, sizeof(layout), c_ContentSeed);
+        hash = XXHash64(mesh.positions, vertexCount * 3 * sizeof(float), hash);
+        if (mesh.normals) hash = XXHash64(mesh.normals, vertexCount * 3 * sizeof(float), hash);
+        if (mesh.tangents) hash = XXHash64(mesh.tangents, vertexCount * 4 * sizeof(float), hash);
+        if (mesh.uvs) hash = XXHash64(mesh.uvs, vertexCount * 2 * sizeof(float), hash);
+
+        for (uint32_t i = 0; i < descCount; i++)
+        {
+            hash = XXHash64(&descs[i].indexCount, sizeof(uint32_t), hash);
+            if (descs[i].indices)
+                hash = XXHash64(descs[i].indices, uint64_t(descs[i].indexCount) * sizeof(uint32_t), hash);
+        }
+        return hash;
+    }
+
+    float ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+PrimitiveCache::PrimitiveCache(const char* path)
+    : m_path(path ? path : "")
+{
+    Load();
+}
+
+void PrimitiveCache::Load()
+{
+    m_file.reset();
+    m_entries.clear();
+    m_fileOrder.clear();
+    m_pendingOrder.clear();
+    m_pendingData.clear();
+    m_loadResult = PrimitiveCacheResult_Ok;
+
+    if (m_path.empty())
+    {
+        m_loadResult = PrimitiveCacheResult_InvalidArgument;
+        return;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::exists(m_path, error))
+        return;
+
+    auto file = std::make_unique<MappedFile>(m_path.c_str());
+    if (!file->GetData())
+    {
+        m_loadResult = PrimitiveCacheResult_FileError;
+        return;
+    }
+
+    const uint8_t* data = file->GetData();
+    const uint64_t fileBytes = file->GetSize();
+    if (fileBytes < sizeof(CacheHeader))
+    {
+        m_loadResult = PrimitiveCacheResult_InvalidFormat;
+        return;
+    }
+
+    CacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != c_CacheMagic || header.headerSize != sizeof(CacheHeader))
+    {
+        m_loadResult = PrimitiveCacheResult_InvalidFormat;
+        return;
+    }
+    if (header.version != c_CacheVersion || header.primitiveDataVersion != c_PrimitiveDataVersion ||
+        header.primitiveDataSize != sizeof(PrimitiveData))
+    {
+        m_loadResult = PrimitiveCacheResult_VersionMismatch;
+        return;
+    }
+
+    const uint64_t tableBytes = uint64_t(header.entryCount) * sizeof(CacheEntry);
+    if (header.fileBytes != fileBytes || header.entryTableOffset < sizeof(CacheHeader) ||
+        header.entryTableOffset + tableBytes > fileBytes ||
+        XXHash64(data + header.entryTableOffset, tableBytes, c_ChecksumSeed) != header.entryTableChecksum)
+    {
+        m_loadResult = PrimitiveCacheResult_InvalidFormat;
+        return;
+    }
+
+    const CacheEntry* entries = reinterpret_cast<const CacheEntry*>(data + header.entryTableOffset);
+    m_fileOrder.reserve(header.entryCount);
+    for (uint32_t i = 0; i < header.entryCount; i++)
+    {
+        CacheEntry fileEntry;
+        memcpy(&fileEntry, &entries[i], sizeof(fileEntry));
+        if (fileEntry.dataOffset % c_DataAlignment != 0 || fileEntry.dataOffset > fileBytes ||
+            fileEntry.dataBytes > fileBytes - fileEntry.dataOffset ||
+            fileEntry.dataBytes != GetEntryDataBytes(fileEntry.submeshCount, fileEntry.primitiveCount))
+        {
+            m_loadResult = PrimitiveCacheResult_InvalidFormat;
+            m_entries.clear();
+            m_fileOrder.clear();
+            return;
+        }
+
+        Entry entry = {};
+        entry.submeshCount = fileEntry.submeshCount;
+        entry.primitiveCount = fileEntry.primitiveCount;
+        entry.vertexCount = fileEntry.vertexCount;
+        entry.data = data + fileEntry.dataOffset;
+        entry.dataBytes = fileEntry.dataBytes;
+        entry.checksum = fileEntry.checksum;
+        if (m_entries.emplace(fileEntry.contentHash, entry).second)
+            m_fileOrder.push_back(fileEntry.contentHash);
+    }
+
+    m_file = std::move(file);
+}
+
+PrimitiveCacheBuildStats PrimitiveCache::Build(const PrimitiveBuildDesc* descs, uint32_t descCount, PrimitiveData* outPrimitives,
+    uint32_t primitiveCapacity, bool allowSimd)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    PrimitiveCacheBuildStats stats = {};
+    if (!descs || !outPrimitives)
+        return stats;
+
+    std::vector<MeshGroup> groups;
+    for (uint32_t i = 0; i < descCount; i++)
+    {
+        if (groups.empty() || descs[i].positions != descs[i - 1].positions || descs[i].vertexCount != descs[i - 1].vertexCount)
+            groups.push_back({ i, 0, 0 });
+        groups.back().descCount++;
+    }
+    stats.meshCount = uint32_t(groups.size());
+
+    // 没有 positions 的 submesh 无法 hash，交给 BuildPrimitiveData 按越界处理
+    ParallelFor(uint32_t(groups.size()), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t g = begin; g < end; g++)
+        {
+            if (descs[groups[g].firstDesc].positions)
+                groups[g].contentHash = HashMesh(descs + groups[g].firstDesc, groups[g].descCount);
+        }
+    });
+    stats.hashMilliseconds = ElapsedMilliseconds(start);
+
+    // 命中需要 submesh 数、顶点数和每个 submesh 的三角形数都一致，输出范围也要在 primitiveCapacity 之内
+    std::vector<uint32_t> hitGroups;
+    std::vector<uint32_t> missGroups;
+    for (uint32_t g = 0; g < groups.size(); g++)
+    {
+        const MeshGroup& group = groups[g];
+        auto it = descs[group.firstDesc].positions ? m_entries.find(group.contentHash) : m_entries.end();
+        bool hit = it != m_entries.end() && it->second.submeshCount == group.descCount &&
+            it->second.vertexCount == descs[group.firstDesc].vertexCount;
+        for (uint32_t i = 0; hit && i < group.descCount; i++)
+        {
+            const PrimitiveBuildDesc& desc = descs[group.firstDesc + i];
+            uint32_t triangleCount;
+            memcpy(&triangleCount, it->second.data + i * sizeof(uint32_t), sizeof(triangleCount));
+            hit = triangleCount == desc.indexCount / 3 && desc.primitiveOffset <= primitiveCapacity &&
+                triangleCount <= primitiveCapacity - desc.primitiveOffset;
+        }
+        (hit ? hitGroups : missGroups).push_back(g);
+    }
+
+    // 命中的 mesh 先校验再从映射拷贝，校验和不对的重新生成并从缓存中移除
+    std::vector<uint8_t> corrupt(hitGroups.size(), 0);
+    ParallelFor(uint32_t(hitGroups.size()), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t h = begin; h < end; h++)
+        {
+            const MeshGroup& group = groups[hitGroups[h]];
+            const Entry& entry = m_entries.find(group.contentHash)->second;
+            if (!entry.pending && XXHash64(entry.data, entry.dataBytes, c_ChecksumSeed) != entry.checksum)
+            {
+                corrupt[h] = 1;
+                continue;
+            }
+
+            const PrimitiveData* source = reinterpret_cast<const PrimitiveData*>(entry.data + GetTriangleTableBytes(entry.submeshCount));
+            for (uint32_t i = 0; i < group.descCount; i++)
+            {
+                const PrimitiveBuildDesc& desc = descs[group.firstDesc + i];
+                const uint32_t triangleCount = desc.indexCount / 3;
+                memcpy(outPrimitives + desc.primitiveOffset, source, triangleCount * sizeof(PrimitiveData));
+                source += triangleCount;
+            }
+        }
+    });
+
+    for (uint32_t h = 0; h < hitGroups.size(); h++)
+    {
+        const MeshGroup& group = groups[hitGroups[h]];
+        if (corrupt[h])
+        {
+            m_entries.erase(group.contentHash);
+            missGroups.push_back(hitGroups[h]);
+            stats.corruptMeshCount++;
+            continue;
+        }
+
+        Entry& entry = m_entries.find(group.contentHash)->second;
+        entry.used = true;
+        stats.hitMeshCount++;
+        stats.hitPrimitiveCount += entry.primitiveCount;
+    }
+
+    std::vector<PrimitiveBuildDesc> missDescs;
+    for (uint32_t g : missGroups)
+        missDescs.insert(missDescs.end(), descs + groups[g].firstDesc, descs + groups[g].firstDesc + groups[g].descCount);
+
+    const PrimitiveBuildStats buildStats = BuildPrimitiveData(missDescs.data(), uint32_t(missDescs.size()), outPrimitives, primitiveCapacity, allowSimd);
+    stats.primitiveCount = stats.hitPrimitiveCount + buildStats.primitiveCount;
+    stats.invalidSubmeshCount = buildStats.invalidSubmeshCount;
+    stats.path = buildStats.path;
+    stats.tangentMeshCount = buildStats.tangentMeshCount;
+    stats.tangentMilliseconds = buildStats.tangentMilliseconds;
+    stats.builtMeshCount = uint32_t(missGroups.size());
+
+    // 新生成的 mesh 从输出中拷贝一份，同一内容出现多次时只记录一次
+    for (uint32_t g : missGroups)
+    {
+        const MeshGroup& group = groups[g];
+        const PrimitiveBuildDesc* groupDescs = descs + group.firstDesc;
+        if (!groupDescs[0].positions || m_entries.count(group.contentHash))
+            continue;
+
+        bool valid = true;
+        uint32_t primitiveCount = 0;
+        for (uint32_t i = 0; valid && i < group.descCount; i++)
+        {
+            valid = IsValidPrimitiveBuildDesc(groupDescs[i], primitiveCapacity);
+            primitiveCount += groupDescs[i].indexCount / 3;
+        }
+        if (!valid)
+            continue;
+
+        Entry entry = {};
+        entry.submeshCount = group.descCount;
+        entry.primitiveCount = primitiveCount;
+        entry.vertexCount = groupDescs[0].vertexCount;
+        entry.dataBytes = GetEntryDataBytes(group.descCount, primitiveCount);
+        entry.used = true;
+        entry.pending = true;
+
+        auto blob = std::make_unique<uint8_t[]>(size_t(entry.dataBytes));
+        memset(blob.get(), 0, size_t(GetTriangleTableBytes(group.descCount)));
+        PrimitiveData* target = reinterpret_cast<PrimitiveData*>(blob.get() + GetTriangleTableBytes(group.descCount));
+        for (uint32_t i = 0; i < group.descCount; i++)
+        {
+            const uint32_t triangleCount = groupDescs[i].indexCount / 3;
+            memcpy(blob.get() + i * sizeof(uint32_t), &triangleCount, sizeof(triangleCount));
+            memcpy(target, outPrimitives + groupDescs[i].primitiveOffset, triangleCount * sizeof(PrimitiveData));
+            target += triangleCount;
+        }
+
+        entry.data = blob.get();
+        entry.checksum = XXHash64(entry.data, entry.dataBytes, c_ChecksumSeed);
+        m_entries.emplace(group.contentHash, entry);
+        m_pendingOrder.push_back(group.contentHash);
+        m_pendingData.push_back(std::move(blob));
+    }
+
+    stats.milliseconds = ElapsedMilliseconds(start);
+    return stats;
+}
+
+PrimitiveCacheSaveStats PrimitiveCache::Save(uint64_t maxBytes)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    PrimitiveCacheSaveStats stats = {};
+    if (m_path.empty())
+    {
+        stats.result = PrimitiveCacheResult_InvalidArgument;
+        return stats;
+    }
+
+    // 没有新增的 mesh 时文件已经是最新的
+    if (m_pendingOrder.empty())
+    {
+        stats.result = PrimitiveCacheResult_Ok;
+        stats.entryCount = uint32_t(m_entries.size());
+        stats.fileBytes = m_file ? m_file->GetSize() : 0;
+        stats.milliseconds = ElapsedMilliseconds(start);
+        return stats;
+    }
+
+    // 本次用到的在前，未用到的旧 entry 在剩余空间内按原顺序保留
+    // 校验失败后重新生成的 entry 仍在 m_fileOrder 中，但已经是 pending，只按 pending 写一次
+    std::vector<uint64_t> order;
+    order.reserve(m_entries.size());
+    uint64_t dataBytes = 0;
+    for (uint64_t hash : m_fileOrder)
+    {
+        auto it = m_entries.find(hash);
+        if (it != m_entries.end() && it->second.used && !it->second.pending)
+        {
+            order.push_back(hash);
+            dataBytes += AlignUp(it->second.dataBytes, c_DataAlignment);
+        }
+    }
+    for (uint64_t hash : m_pendingOrder)
+    {
+        order.push_back(hash);
+        dataBytes += AlignUp(m_entries.find(hash)->second.dataBytes, c_DataAlignment);
+    }
+    for (uint64_t hash : m_fileOrder)
+    {
+        auto it = m_entries.find(hash);
+        if (it == m_entries.end() || it->second.used || it->second.pending)
+            continue;
+
+        const uint64_t entryBytes = AlignUp(it->second.dataBytes, c_DataAlignment);
+        if (maxBytes != 0 && sizeof(CacheHeader) + dataBytes + entryBytes + (order.size() + 1) * sizeof(CacheEntry) > maxBytes)
+        {
+            stats.evictedEntryCount++;
+            continue;
+        }
+        order.push_back(hash);
+        dataBytes += entryBytes;
+    }
+
+    CacheHeader header = {};
+    header.magic = c_CacheMagic;
+    header.version = c_CacheVersion;
+    header.headerSize = sizeof(CacheHeader);
+    header.primitiveDataVersion = c_PrimitiveDataVersion;
+    header.primitiveDataSize = sizeof(PrimitiveData);
+    header.entryCount = uint32_t(order.size());
+    header.entryTableOffset = AlignUp(sizeof(CacheHeader), c_DataAlignment);
+
+    std::vector<CacheEntry> table(order.size());
+    uint64_t dataOffset = AlignUp(header.entryTableOffset + table.size() * sizeof(CacheEntry), c_DataAlignment);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const Entry& entry = m_entries.find(order[i])->second;
+        CacheEntry& fileEntry = table[i];
+        fileEntry.contentHash = order[i];
+        fileEntry.dataOffset = dataOffset;
+        fileEntry.dataBytes = entry.dataBytes;
+        fileEntry.checksum = entry.checksum;
+        fileEntry.submeshCount = entry.submeshCount;
+        fileEntry.primitiveCount = entry.primitiveCount;
+        fileEntry.vertexCount = entry.vertexCount;
+        dataOffset += AlignUp(entry.dataBytes, c_DataAlignment);
+    }
+    header.fileBytes = dataOffset;
+    header.entryTableChecksum = XXHash64(table.data(), table.size() * sizeof(CacheEntry), c_ChecksumSeed);
+
+    // 旧 entry 的数据直接从映射写出，写完之前不能解除映射
+    const std::string tempPath = m_path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            stats.result = PrimitiveCacheResult_FileError;
+            return stats;
+        }
+
+        const uint8_t padding[c_DataAlignment] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(padding), std::streamsize(header.entryTableOffset - sizeof(header)));
+        file.write(reinterpret_cast<const char*>(table.data()), std::streamsize(table.size() * sizeof(CacheEntry)));
+        uint64_t written = header.entryTableOffset + table.size() * sizeof(CacheEntry);
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const Entry& entry = m_entries.find(order[i])->second;
+            file.write(reinterpret_cast<const char*>(padding), std::streamsize(table[i].dataOffset - written));
+            file.write(reinterpret_cast<const char*>(entry.data), std::streamsize(entry.dataBytes));
+            written = table[i].dataOffset + entry.dataBytes;
+        }
+        file.write(reinterpret_cast<const char*>(padding), std::streamsize(header.fileBytes - written));
+
+        if (!file)
+        {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            stats.result = PrimitiveCacheResult_FileError;
+            return stats;
+        }
+    }
+
+    // 映射中的文件在 Windows 上不能被替换，先解除映射，替换后重新映射新文件
+    m_file.reset();
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    if (error)
+        std::filesystem::remove(tempPath, error);
+
+    const bool renamed = !error;
+    Load();
+
+    stats.result = renamed ? PrimitiveCacheResult_Ok : PrimitiveCacheResult_FileError;
+    stats.entryCount = renamed ? header.entryCount : 0;
+    stats.fileBytes = renamed ? header.fileBytes : 0;
+    stats.milliseconds = ElapsedMilliseconds(start);
+    return stats;
+}
+
+PrimitiveCacheInfo PrimitiveCache::GetInfo() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PrimitiveCacheInfo info = {};
+    info.loadResult = m_loadResult;
+    info.entryCount = uint32_t(m_entries.size());
+    info.pendingEntryCount = uint32_t(m_pendingOrder.size());
+    info.fileBytes = m_file ? m_file->GetSize() : 0;
+    for (uint64_t hash : m_pendingOrder)
+        info.pendingBytes += m_entries.find(hash)->second.dataBytes;
+    return info;
+}
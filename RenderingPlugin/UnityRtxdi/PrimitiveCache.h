@@ -0,0 +1,101 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+#include "PrimitiveDataBuilder.h"
+
+enum PrimitiveCacheResult : uint32_t
+{
+    PrimitiveCacheResult_Ok = 0,
+    PrimitiveCacheResult_InvalidArgument = 1,
+    PrimitiveCacheResult_FileError = 2,
+    PrimitiveCacheResult_InvalidFormat = 3,     // magic、大小或 entry 表不对
+    PrimitiveCacheResult_VersionMismatch = 4,   // 文件格式或 c_PrimitiveDataVersion 变了，整个文件作废
+};
+
+struct PrimitiveCacheInfo
+{
+    PrimitiveCacheResult loadResult;    // 打开文件时的结果，文件不存在也是 Ok
+    uint32_t entryCount;                // 文件中和本次新增的 mesh 数
+    uint32_t pendingEntryCount;         // 尚未保存的 mesh 数
+    uint32_t pad1;
+    uint64_t fileBytes;
+    uint64_t pendingBytes;
+};
+
+struct PrimitiveCacheBuildStats
+{
+    uint32_t meshCount;
+    uint32_t hitMeshCount;              // 从文件直接拷贝的 mesh 数
+    uint32_t builtMeshCount;            // 重新生成的 mesh 数，生成后加入缓存
+    uint32_t corruptMeshCount;          // 命中但校验和不对，已重新生成
+    uint32_t primitiveCount;
+    uint32_t hitPrimitiveCount;
+    uint32_t invalidSubmeshCount;       // 与 PrimitiveBuildStats 相同，这些 mesh 不会写入缓存
+    PrimitiveBuildPath path;
+    float hashMilliseconds;             // 计算内容 hash 的耗时
+    float milliseconds;
+    uint32_t tangentMeshCount;          // 未命中的 mesh 中生成了切线的数量，命中的 mesh 不需要生成
+    float tangentMilliseconds;
+};
+
+struct PrimitiveCacheSaveStats
+{
+    PrimitiveCacheResult result;
+    uint32_t entryCount;                // 写入文件的 mesh 数
+    uint32_t evictedEntryCount;         // 超出 maxBytes 被丢弃的 mesh 数
+    uint32_t pad1;
+    uint64_t fileBytes;
+    float milliseconds;
+    uint32_t pad2;
+};
+
+// 按 mesh 内容 hash 缓存生成好的 PrimitiveData，文件以只读内存映射打开，命中的 mesh 直接从映射拷贝到输出，不再解码或重新生成
+// 文件头记录 c_PrimitiveDataVersion 和 sizeof(PrimitiveData)，任何一个不同都会丢弃整个文件
+// Save 可以在后台线程上调用，Build、Save 和 GetInfo 互斥，保存期间调用 Build 会等到保存结束
+class PrimitiveCache
+{
+public:
+    explicit PrimitiveCache(const char* path);
+
+    // descs 中 positions 相同的连续 submesh 视为同一个 mesh（PathTracingDataBuilder 按 mesh 顺序添加）
+    // mesh 的 hash 覆盖所有顶点属性和各 submesh 的索引，未命中的 mesh 由 BuildPrimitiveData 生成并记录下来
+    PrimitiveCacheBuildStats Build(const PrimitiveBuildDesc* descs, uint32_t descCount, PrimitiveData* outPrimitives, uint32_t primitiveCapacity,
+        bool allowSimd = true);
+
+    // 有新增的 mesh 时重写文件：本次用到的 mesh 在前，其余旧 mesh 按原顺序保留到 maxBytes 为止
+    // 写入临时文件后再替换，保存期间原文件的映射仍然有效；maxBytes 为 0 时不限制大小
+    PrimitiveCacheSaveStats Save(uint64_t maxBytes);
+
+    PrimitiveCacheInfo GetInfo() const;
+
+private:
+    struct Entry
+    {
+        uint32_t submeshCount;
+        uint32_t primitiveCount;
+        uint32_t vertexCount;
+        bool used;                      // 本次 Build 中命中或新增
+        const uint8_t* data;            // 指向映射或 m_pendingData 中的数据：submeshCount 个三角形数，对齐后接 PrimitiveData
+        uint64_t dataBytes;
+        uint64_t checksum;
+        bool pending;                   // 本次新增，尚未保存
+    };
+
+    void Load();
+
+    mutable std::mutex m_mutex;
+    std::string m_path;
+    std::unique_ptr<MappedFile> m_file;
+    PrimitiveCacheResult m_loadResult = PrimitiveCacheResult_Ok;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::vector<uint64_t> m_fileOrder;                      // 文件中 entry 的顺序
+    std::vector<uint64_t> m_pendingOrder;                   // 新增 entry 的顺序
+    std::vector<std::unique_ptr<uint8_t[]>> m_pendingData;
+};
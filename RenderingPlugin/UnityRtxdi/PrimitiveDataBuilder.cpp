@@ -0,0 +1,274 @@
+﻿#include "PrimitiveDataBuilder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#include "ParallelFor.h"
+#include "TangentGenerator.h"
+
+namespace
+{
+    constexpr uint32_t c_MinTrianglesPerBatch = 16384;
+    constexpr float c_MinArea = 1e-9f;
+
+    // 与 Unity.Mathematics.half 相同的舍入（round to nearest even）
+    uint16_t FloatToHalf(float value)
+    {
+        uint32_t x;
+        memcpy(&x, &value, sizeof(x));
+        const uint32_t sign = (x >> 16) & 0x8000u;
+        x &= 0x7FFFFFFFu;
+
+        if (x >= 0x7F800000u)
+            return uint16_t(sign | (x > 0x7F800000u ? 0x7E00u : 0x7C00u));
+        if (x >= 0x47800000u)
+            return uint16_t(sign | 0x7C00u);
+
+        if (x < 0x38800000u)
+        {
+            // 结果为 half 的非规格化数
+            if (x < 0x33000000u)
+                return uint16_t(sign);
+            const uint32_t shift = 126u - (x >> 23);
+            const uint32_t mantissa = (x & 0x7FFFFFu) | 0x800000u;
+            uint32_t result = mantissa >> shift;
+            const uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (result & 1)))
+                result++;
+            return uint16_t(sign | result);
+        }
+
+        // 尾数进位可以直接进到指数，最大值之上进位为 inf
+        uint32_t result = ((x >> 23) - 112u) << 10 | ((x >> 13) & 0x3FFu);
+        const uint32_t remainder = x & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1)))
+            result++;
+        return uint16_t(sign | result);
+    }
+
+    float SafeSign(float x)
+    {
+        return x >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    bool IsAvx2Supported()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool f16c = (info[2] & (1 << 29)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || !f16c)
+            return false;
+
+        // 系统需要保存 YMM 寄存器
+        if ((_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#else
+        return false;
+#endif
+    }
+}
+
+uint32_t PackHalf2(float x, float y)
+{
+    return uint32_t(FloatToHalf(x)) | uint32_t(FloatToHalf(y)) << 16;
+}
+
+uint32_t EncodeUnitVector(const float* v)
+{
+    const float sum = std::fabs(v[0]) + std::fabs(v[1]) + std::fabs(v[2]);
+    if (!(sum > 0.0f))
+        return 0;
+
+    float x = v[0] / sum;
+    float y = v[1] / sum;
+    const float z = v[2] / sum;
+    if (!(z >= 0.0f))
+    {
+        const float wrapX = (1.0f - std::fabs(y)) * SafeSign(x);
+        const float wrapY = (1.0f - std::fabs(x)) * SafeSign(y);
+        x = wrapX;
+        y = wrapY;
+    }
+    return PackHalf2(x, y);
+}
+
+void ComputeTriangleAreas(const PrimitiveBuildDesc& desc, uint32_t triangle, float& outWorldArea, float& outUvArea)
+{
+    const uint32_t i0 = desc.indices[triangle * 3 + 0];
+    const uint32_t i1 = desc.indices[triangle * 3 + 1];
+    const uint32_t i2 = desc.indices[triangle * 3 + 2];
+
+    if (desc.uvs)
+    {
+        const float* uv0 = desc.uvs + i0 * 2;
+        const float* uv1 = desc.uvs + i1 * 2;
+        const float* uv2 = desc.uvs + i2 * 2;
+
+        // 二维叉积只有 z 分量
+        const float cross = (uv2[0] - uv0[0]) * (uv1[1] - uv0[1]) - (uv2[1] - uv0[1]) * (uv1[0] - uv0[0]);
+        outUvArea = std::max(std::sqrt(cross * cross) * 0.5f, c_MinArea);
+    }
+    else
+    {
+        outUvArea = c_MinArea;
+    }
+
+    const float* p0 = desc.positions + i0 * 3;
+    const float* p1 = desc.positions + i1 * 3;
+    const float* p2 = desc.positions + i2 * 3;
+    const float e20[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+    const float e10[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    const float cx = e20[1] * e10[2] - e20[2] * e10[1];
+    const float cy = e20[2] * e10[0] - e20[0] * e10[2];
+    const float cz = e20[0] * e10[1] - e20[1] * e10[0];
+    outWorldArea = std::max(std::sqrt(cx * cx + cy * cy + cz * cz) * 0.5f, c_MinArea);
+}
+
+bool IsValidPrimitiveBuildDesc(const PrimitiveBuildDesc& desc, uint32_t primitiveCapacity)
+{
+    const uint32_t triangleCount = desc.indexCount / 3;
+    if (!desc.positions || (triangleCount > 0 && !desc.indices) || desc.primitiveOffset > primitiveCapacity ||
+        triangleCount > primitiveCapacity - desc.primitiveOffset)
+        return false;
+
+    // 越界的索引在向量路径里会 gather 到数组之外
+    uint32_t maxIndex = 0;
+    for (uint32_t i = 0; i < triangleCount * 3; i++)
+        maxIndex = std::max(maxIndex, desc.indices[i]);
+    return triangleCount == 0 || maxIndex < desc.vertexCount;
+}
+
+void BuildPrimitive(const PrimitiveBuildDesc& desc, uint32_t triangle, PrimitiveData& outPrimitive)
+{
+    const uint32_t i0 = desc.indices[triangle * 3 + 0];
+    const uint32_t i1 = desc.indices[triangle * 3 + 1];
+    const uint32_t i2 = desc.indices[triangle * 3 + 2];
+
+    PrimitiveData prim = {};
+
+    if (desc.normals)
+    {
+        prim.n0 = EncodeUnitVector(desc.normals + i0 * 3);
+        prim.n1 = EncodeUnitVector(desc.normals + i1 * 3);
+        prim.n2 = EncodeUnitVector(desc.normals + i2 * 3);
+    }
+
+    if (desc.uvs)
+    {
+        const float* uv0 = desc.uvs + i0 * 2;
+        const float* uv1 = desc.uvs + i1 * 2;
+        const float* uv2 = desc.uvs + i2 * 2;
+        prim.uv0 = PackHalf2(uv0[0], uv0[1]);
+        prim.uv1 = PackHalf2(uv1[0], uv1[1]);
+        prim.uv2 = PackHalf2(uv2[0], uv2[1]);
+    }
+
+    ComputeTriangleAreas(desc, triangle, prim.worldArea, prim.uvArea);
+
+    if (desc.tangents)
+    {
+        prim.t0 = EncodeUnitVector(desc.tangents + i0 * 4);
+        prim.t1 = EncodeUnitVector(desc.tangents + i1 * 4);
+        prim.t2 = EncodeUnitVector(desc.tangents + i2 * 4);
+        prim.bitangentSign = desc.tangents[i0 * 4 + 3];
+    }
+    else
+    {
+        prim.bitangentSign = 1.0f;
+    }
+
+    outPrimitive = prim;
+}
+
+PrimitiveBuildStats BuildPrimitiveData(const PrimitiveBuildDesc* descs, uint32_t descCount, PrimitiveData* outPrimitives, uint32_t primitiveCapacity,
+    bool allowSimd)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    PrimitiveBuildStats stats = {};
+    if (!descs || !outPrimitives)
+        return stats;
+
+    GeneratedTangents generatedTangents;
+    descs = generatedTangents.Resolve(descs, descCount);
+    stats.tangentMeshCount = generatedTangents.GetMeshCount();
+    stats.tangentMilliseconds = generatedTangents.GetMilliseconds();
+
+    const bool useAvx2 = allowSimd && IsAvx2Supported();
+    stats.path = useAvx2 ? PrimitiveBuildPath_Avx2 : PrimitiveBuildPath_Scalar;
+
+    // 三角形前缀和，批次按全局三角形下标切分
+    std::vector<uint32_t> firstTriangles(descCount + 1, 0);
+    std::vector<uint8_t> validSubmeshes(descCount, 0);
+    for (uint32_t i = 0; i < descCount; i++)
+    {
+        validSubmeshes[i] = IsValidPrimitiveBuildDesc(descs[i], primitiveCapacity) ? 1 : 0;
+        stats.invalidSubmeshCount += validSubmeshes[i] ? 0 : 1;
+        firstTriangles[i + 1] = firstTriangles[i] + (validSubmeshes[i] ? descs[i].indexCount / 3 : 0);
+    }
+
+    // 越界的 submesh 在输出范围内的部分写为零面积三角形，不留下未初始化的数据
+    for (uint32_t i = 0; i < descCount; i++)
+    {
+        const PrimitiveBuildDesc& desc = descs[i];
+        if (validSubmeshes[i] || desc.primitiveOffset >= primitiveCapacity)
+            continue;
+
+        const uint32_t count = std::min(desc.indexCount / 3, primitiveCapacity - desc.primitiveOffset);
+        PrimitiveData empty = {};
+        empty.worldArea = c_MinArea;
+        empty.uvArea = c_MinArea;
+        empty.bitangentSign = 1.0f;
+        std::fill(outPrimitives + desc.primitiveOffset, outPrimitives + desc.primitiveOffset + count, empty);
+    }
+
+    const uint32_t totalTriangles = firstTriangles[descCount];
+    ParallelFor(totalTriangles, c_MinTrianglesPerBatch, [&](uint32_t begin, uint32_t end)
+    {
+        uint32_t descIndex = uint32_t(std::upper_bound(firstTriangles.begin(), firstTriangles.end(), begin) - firstTriangles.begin()) - 1;
+        uint32_t triangle = begin;
+        while (triangle < end)
+        {
+            // 跳过没有三角形的 submesh
+            while (firstTriangles[descIndex + 1] <= triangle)
+                descIndex++;
+
+            const PrimitiveBuildDesc& desc = descs[descIndex];
+            const uint32_t localBegin = triangle - firstTriangles[descIndex];
+            const uint32_t localEnd = std::min(end, firstTriangles[descIndex + 1]) - firstTriangles[descIndex];
+            PrimitiveData* out = outPrimitives + desc.primitiveOffset;
+
+            uint32_t local = localBegin;
+            if (useAvx2)
+                local += BuildPrimitivesAvx2(desc, localBegin, localEnd - localBegin, out + localBegin);
+            for (; local < localEnd; local++)
+                BuildPrimitive(desc, local, out[local]);
+
+            triangle = firstTriangles[descIndex] + localEnd;
+        }
+    });
+
+    stats.primitiveCount = totalTriangles;
+    stats.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
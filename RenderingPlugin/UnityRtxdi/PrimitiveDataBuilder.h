@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// PrimitiveData 的内容或编码方式变化时加一，PrimitiveCache 中旧版本的数据会被丢弃
+constexpr uint32_t c_PrimitiveDataVersion = 2;
+
+// 与 PathTracingDataBuilder.cs 中的 PrimitiveData 一致，half2 按 x | y << 16 打包
+struct PrimitiveData
+{
+    uint32_t uv0;
+    uint32_t uv1;
+    uint32_t uv2;
+    float worldArea;
+
+    uint32_t n0;
+    uint32_t n1;
+    uint32_t n2;
+    float uvArea;
+
+    uint32_t t0;
+    uint32_t t1;
+    uint32_t t2;
+    float bitangentSign;
+};
+
+// 一个 submesh 的输入，顶点属性为 Mesh.vertices / normals / tangents / uv 的连续数组
+struct PrimitiveBuildDesc
+{
+    const float* positions;     // float3，模型空间
+    const float* normals;       // float3，可以为空，此时编码为 0
+    const float* tangents;      // float4，可以为空，此时编码为 0，bitangentSign 为 1
+    const float* uvs;           // float2，可以为空，此时 uv 为 0，uvArea 为 1e-9
+    const uint32_t* indices;    // 三个一组，与 Mesh.GetTriangles 相同
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t primitiveOffset;   // 第一个三角形写到 outPrimitives 的位置
+    uint32_t flags;             // PrimitiveBuildFlags
+};
+
+enum PrimitiveBuildFlags : uint32_t
+{
+    // tangents 为空时由 normals 和 uvs 生成（TangentGenerator.h），同一 mesh 的所有 submesh 都需要设置
+    PrimitiveBuildFlag_GenerateTangents = 0x1,
+};
+
+enum PrimitiveBuildPath : uint32_t
+{
+    PrimitiveBuildPath_Scalar = 0,
+    PrimitiveBuildPath_Avx2 = 1,    // AVX2 gather + F16C，8 个三角形一组
+};
+
+struct PrimitiveBuildStats
+{
+    uint32_t primitiveCount;        // 写入的三角形数
+    uint32_t invalidSubmeshCount;   // 索引越界或超出 outPrimitives 的 submesh 数，越界的三角形写为零面积
+    PrimitiveBuildPath path;
+    float milliseconds;             // 包含生成切线的耗时
+    uint32_t tangentMeshCount;      // 生成了切线的 mesh 数
+    float tangentMilliseconds;
+};
+
+// 按三角形总数均分到各线程，一个批次可以跨越多个 submesh
+// 运行时检测 CPU，支持 AVX2 / F16C 时使用向量路径，结果与标量路径逐位相同
+// 带 PrimitiveBuildFlag_GenerateTangents 的 mesh 先生成切线，每个 mesh 一次
+PrimitiveBuildStats BuildPrimitiveData(const PrimitiveBuildDesc* descs, uint32_t descCount, PrimitiveData* outPrimitives, uint32_t primitiveCapacity,
+    bool allowSimd = true);
+
+// 顶点数组存在、索引不越界且输出范围在 primitiveCapacity 之内
+bool IsValidPrimitiveBuildDesc(const PrimitiveBuildDesc& desc, uint32_t primitiveCapacity);
+
+// x | y << 16，与 Unity.Mathematics.half 的舍入相同
+uint32_t PackHalf2(float x, float y);
+
+// 八面体编码为 half2，与 PathTracingDataBuilder.EncodeUnitVector(v, true) 相同，零向量编码为 0
+uint32_t EncodeUnitVector(const float* v);
+
+// PrimitiveData 中的 worldArea（模型空间）和 uvArea，均不小于 1e-9
+void ComputeTriangleAreas(const PrimitiveBuildDesc& desc, uint32_t triangle, float& outWorldArea, float& outUvArea);
+
+// 单个三角形的标量实现，向量路径处理不足 8 个的尾部时也使用它
+void BuildPrimitive(const PrimitiveBuildDesc& desc, uint32_t triangle, PrimitiveData& outPrimitive);
+
+// 由 PrimitiveDataBuilderAvx2.cpp 提供，返回处理的三角形数（8 的倍数），未以 AVX2 编译时返回 0
+uint32_t BuildPrimitivesAvx2(const PrimitiveBuildDesc& desc, uint32_t firstTriangle, uint32_t triangleCount, PrimitiveData* outPrimitives);
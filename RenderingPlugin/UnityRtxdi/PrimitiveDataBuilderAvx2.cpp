@@ -0,0 +1,186 @@
+﻿#include "PrimitiveDataBuilder.h"
+
+// 这个文件单独以 /arch:AVX2 编译，只有 BuildPrimitiveData 检测到 CPU 支持 AVX2 / F16C 时才会调用
+// 不要在这里包含带 inline 函数的标准库头文件，否则链接器可能选中 AVX2 版本给其它文件使用
+#if defined(__AVX2__) && (defined(_MSC_VER) || defined(__F16C__))
+#include <immintrin.h>
+
+namespace
+{
+    constexpr uint32_t c_Lanes = 8;
+
+    struct Float3x8
+    {
+        __m256 x;
+        __m256 y;
+        __m256 z;
+    };
+
+    // index * stride + component，stride 为 2 / 3 / 4
+    __m256 GatherComponent(const float* base, __m256i scaledIndex, uint32_t component)
+    {
+        return _mm256_i32gather_ps(base + component, scaledIndex, 4);
+    }
+
+    __m256i ScaleIndex(__m256i index, uint32_t stride)
+    {
+        switch (stride)
+        {
+        case 2: return _mm256_slli_epi32(index, 1);
+        case 4: return _mm256_slli_epi32(index, 2);
+        default: return _mm256_add_epi32(_mm256_slli_epi32(index, 1), index);
+        }
+    }
+
+    Float3x8 Gather3(const float* base, __m256i index, uint32_t stride)
+    {
+        const __m256i scaled = ScaleIndex(index, stride);
+        return { GatherComponent(base, scaled, 0), GatherComponent(base, scaled, 1), GatherComponent(base, scaled, 2) };
+    }
+
+    __m256 Abs(__m256 v)
+    {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    }
+
+    // x >= 0 ? 1 : -1，与 SafeSign 相同（-0 和 NaN 的处理也一致）
+    __m256 SafeSign(__m256 v)
+    {
+        return _mm256_blendv_ps(_mm256_set1_ps(-1.0f), _mm256_set1_ps(1.0f), _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+
+    // 8 个 float 对转为 8 个打包的 half2
+    __m256i PackHalf2(__m256 x, __m256 y)
+    {
+        const __m128i hx = _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT);
+        const __m128i hy = _mm256_cvtps_ph(y, _MM_FROUND_TO_NEAREST_INT);
+        return _mm256_set_m128i(_mm_unpackhi_epi16(hx, hy), _mm_unpacklo_epi16(hx, hy));
+    }
+
+    // 与标量 EncodeUnitVector 相同，零向量编码为 0
+    __m256i EncodeUnitVector(const Float3x8& v)
+    {
+        const __m256 sum = _mm256_add_ps(_mm256_add_ps(Abs(v.x), Abs(v.y)), Abs(v.z));
+        const __m256 valid = _mm256_cmp_ps(sum, _mm256_setzero_ps(), _CMP_GT_OQ);
+
+        const __m256 x = _mm256_div_ps(v.x, sum);
+        const __m256 y = _mm256_div_ps(v.y, sum);
+        const __m256 z = _mm256_div_ps(v.z, sum);
+
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 wrapX = _mm256_mul_ps(_mm256_sub_ps(one, Abs(y)), SafeSign(x));
+        const __m256 wrapY = _mm256_mul_ps(_mm256_sub_ps(one, Abs(x)), SafeSign(y));
+        const __m256 upper = _mm256_cmp_ps(z, _mm256_setzero_ps(), _CMP_GE_OQ);
+
+        const __m256i packed = PackHalf2(_mm256_blendv_ps(wrapX, x, upper), _mm256_blendv_ps(wrapY, y, upper));
+        return _mm256_and_si256(packed, _mm256_castps_si256(valid));
+    }
+
+    __m256 Length(__m256 x, __m256 y, __m256 z)
+    {
+        return _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+    }
+
+    __m256 HalfArea(__m256 length)
+    {
+        return _mm256_max_ps(_mm256_mul_ps(length, _mm256_set1_ps(0.5f)), _mm256_set1_ps(1e-9f));
+    }
+}
+
+uint32_t BuildPrimitivesAvx2(const PrimitiveBuildDesc& desc, uint32_t firstTriangle, uint32_t triangleCount, PrimitiveData* outPrimitives)
+{
+    const uint32_t vectorCount = triangleCount / c_Lanes * c_Lanes;
+    const __m256i indexOffsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    // 每个 PrimitiveData 的 12 个 dword，按字段存 8 个三角形，最后转置写出
+    alignas(32) uint32_t fields[12][c_Lanes];
+
+    for (uint32_t t = 0; t < vectorCount; t += c_Lanes)
+    {
+        const int* indices = reinterpret_cast<const int*>(desc.indices + (firstTriangle + t) * 3);
+        const __m256i i0 = _mm256_i32gather_epi32(indices + 0, indexOffsets, 4);
+        const __m256i i1 = _mm256_i32gather_epi32(indices + 1, indexOffsets, 4);
+        const __m256i i2 = _mm256_i32gather_epi32(indices + 2, indexOffsets, 4);
+
+        if (desc.uvs)
+        {
+            const __m256i s0 = ScaleIndex(i0, 2), s1 = ScaleIndex(i1, 2), s2 = ScaleIndex(i2, 2);
+            const __m256 u0 = GatherComponent(desc.uvs, s0, 0), v0 = GatherComponent(desc.uvs, s0, 1);
+            const __m256 u1 = GatherComponent(desc.uvs, s1, 0), v1 = GatherComponent(desc.uvs, s1, 1);
+            const __m256 u2 = GatherComponent(desc.uvs, s2, 0), v2 = GatherComponent(desc.uvs, s2, 1);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[0]), PackHalf2(u0, v0));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[1]), PackHalf2(u1, v1));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[2]), PackHalf2(u2, v2));
+
+            const __m256 cross = _mm256_sub_ps(_mm256_mul_ps(_mm256_sub_ps(u2, u0), _mm256_sub_ps(v1, v0)),
+                _mm256_mul_ps(_mm256_sub_ps(v2, v0), _mm256_sub_ps(u1, u0)));
+            _mm256_store_ps(reinterpret_cast<float*>(fields[7]), HalfArea(_mm256_sqrt_ps(_mm256_mul_ps(cross, cross))));
+        }
+        else
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[0]), zero);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[1]), zero);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[2]), zero);
+            _mm256_store_ps(reinterpret_cast<float*>(fields[7]), _mm256_set1_ps(1e-9f));
+        }
+
+        {
+            const Float3x8 p0 = Gather3(desc.positions, i0, 3);
+            const Float3x8 p1 = Gather3(desc.positions, i1, 3);
+            const Float3x8 p2 = Gather3(desc.positions, i2, 3);
+            const Float3x8 e20 = { _mm256_sub_ps(p2.x, p0.x), _mm256_sub_ps(p2.y, p0.y), _mm256_sub_ps(p2.z, p0.z) };
+            const Float3x8 e10 = { _mm256_sub_ps(p1.x, p0.x), _mm256_sub_ps(p1.y, p0.y), _mm256_sub_ps(p1.z, p0.z) };
+            const __m256 cx = _mm256_sub_ps(_mm256_mul_ps(e20.y, e10.z), _mm256_mul_ps(e20.z, e10.y));
+            const __m256 cy = _mm256_sub_ps(_mm256_mul_ps(e20.z, e10.x), _mm256_mul_ps(e20.x, e10.z));
+            const __m256 cz = _mm256_sub_ps(_mm256_mul_ps(e20.x, e10.y), _mm256_mul_ps(e20.y, e10.x));
+            _mm256_store_ps(reinterpret_cast<float*>(fields[3]), HalfArea(Length(cx, cy, cz)));
+        }
+
+        if (desc.normals)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[4]), EncodeUnitVector(Gather3(desc.normals, i0, 3)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[5]), EncodeUnitVector(Gather3(desc.normals, i1, 3)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[6]), EncodeUnitVector(Gather3(desc.normals, i2, 3)));
+        }
+        else
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[4]), zero);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[5]), zero);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[6]), zero);
+        }
+
+        if (desc.tangents)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[8]), EncodeUnitVector(Gather3(desc.tangents, i0, 4)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[9]), EncodeUnitVector(Gather3(desc.tangents, i1, 4)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[10]), EncodeUnitVector(Gather3(desc.tangents, i2, 4)));
+            _mm256_store_ps(reinterpret_cast<float*>(fields[11]), GatherComponent(desc.tangents, ScaleIndex(i0, 4), 3));
+        }
+        else
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[8]), zero);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[9]), zero);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(fields[10]), zero);
+            _mm256_store_ps(reinterpret_cast<float*>(fields[11]), _mm256_set1_ps(1.0f));
+        }
+
+        // 48 字节一个 PrimitiveData，按 dword 转置写出
+        uint32_t* out = reinterpret_cast<uint32_t*>(outPrimitives + t);
+        for (uint32_t lane = 0; lane < c_Lanes; lane++)
+        {
+            for (uint32_t field = 0; field < 12; field++)
+                out[lane * 12 + field] = fields[field][lane];
+        }
+    }
+
+    return vectorCount;
+}
+#else
+uint32_t BuildPrimitivesAvx2(const PrimitiveBuildDesc&, uint32_t, uint32_t, PrimitiveData*)
+{
+    return 0;
+}
+#endif
@@ -0,0 +1,270 @@
+﻿#include "RISBufferSegmentPool.h"
+
+#include <algorithm>
+
+#include <Rtxdi/LightSampling/RISBufferSegmentAllocator.h>
+
+RISBufferSegmentPool::RISBufferSegmentPool(uint32_t capacityInElements) :
+    m_capacityInElements(capacityInElements)
+{
+}
+
+bool RISBufferSegmentPool::FindSegment(uint32_t name, uint32_t& outOffset, uint32_t& outSizeInElements) const
+{
+    for (const Segment& segment : m_segments)
+    {
+        if (segment.name == name)
+        {
+            outOffset = segment.offset;
+            outSizeInElements = segment.sizeInElements;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RISBufferSegmentPool::FindFreeRange(uint32_t sizeInElements, uint32_t& outOffset) const
+{
+    uint32_t cursor = 0;
+    for (const Segment& segment : m_segments)
+    {
+        if (segment.offset - cursor >= sizeInElements)
+        {
+            outOffset = cursor;
+            return true;
+        }
+        cursor = std::max(cursor, segment.offset + segment.sizeInElements);
+    }
+
+    if (m_capacityInElements - cursor >= sizeInElements)
+    {
+        outOffset = cursor;
+        return true;
+    }
+    return false;
+}
+
+void RISBufferSegmentPool::Insert(const Segment& segment)
+{
+    auto it = std::lower_bound(m_segments.begin(), m_segments.end(), segment.offset,
+        [](const Segment& s, uint32_t offset) { return s.offset < offset; });
+    m_segments.insert(it, segment);
+}
+
+void RISBufferSegmentPool::RecordRelocation(uint32_t name, uint32_t oldOffset, uint32_t newOffset, uint32_t sizeInElements)
+{
+    for (auto it = m_relocations.begin(); it != m_relocations.end(); ++it)
+    {
+        if (it->name != name)
+            continue;
+
+        it->newOffset = newOffset;
+        it->sizeInElements = std::min(it->sizeInElements, sizeInElements);
+        if (it->newOffset == it->oldOffset)
+            m_relocations.erase(it);
+        return;
+    }
+
+    if (oldOffset != newOffset)
+        m_relocations.push_back({ name, oldOffset, newOffset, sizeInElements });
+}
+
+bool RISBufferSegmentPool::Allocate(uint32_t name, uint32_t sizeInElements)
+{
+    uint32_t offset, size;
+    if (FindSegment(name, offset, size))
+        return false;
+
+    if (!FindFreeRange(sizeInElements, offset))
+    {
+        uint64_t usedInElements = 0;
+        for (const Segment& segment : m_segments)
+            usedInElements += segment.sizeInElements;
+
+        if (usedInElements + sizeInElements > m_capacityInElements)
+            return false;
+
+        Compact();
+        FindFreeRange(sizeInElements, offset);
+    }
+
+    Insert({ name, offset, sizeInElements });
+    return true;
+}
+
+void RISBufferSegmentPool::Free(uint32_t name)
+{
+    m_segments.erase(std::remove_if(m_segments.begin(), m_segments.end(),
+        [name](const Segment& s) { return s.name == name; }), m_segments.end());
+
+    m_relocations.erase(std::remove_if(m_relocations.begin(), m_relocations.end(),
+        [name](const RISSegmentRelocation& r) { return r.name == name; }), m_relocations.end());
+}
+
+bool RISBufferSegmentPool::Resize(uint32_t name, uint32_t sizeInElements)
+{
+    auto it = std::find_if(m_segments.begin(), m_segments.end(), [name](const Segment& s) { return s.name == name; });
+    if (it == m_segments.end())
+        return false;
+
+    const uint32_t rangeEnd = (it + 1 != m_segments.end()) ? (it + 1)->offset : m_capacityInElements;
+    if (sizeInElements <= it->sizeInElements || it->offset + sizeInElements <= rangeEnd)
+    {
+        it->sizeInElements = sizeInElements;
+        return true;
+    }
+
+    uint64_t usedInElements = 0;
+    for (const Segment& segment : m_segments)
+        usedInElements += segment.sizeInElements;
+
+    if (usedInElements - it->sizeInElements + sizeInElements > m_capacityInElements)
+        return false;
+
+    const Segment oldSegment = *it;
+    m_segments.erase(it);
+
+    uint32_t offset;
+    if (!FindFreeRange(sizeInElements, offset))
+    {
+        Compact();
+        FindFreeRange(sizeInElements, offset);
+    }
+
+    Insert({ name, offset, sizeInElements });
+    RecordRelocation(name, oldSegment.offset, offset, oldSegment.sizeInElements);
+    return true;
+}
+
+void RISBufferSegmentPool::Compact()
+{
+    uint32_t cursor = 0;
+    for (Segment& segment : m_segments)
+    {
+        if (segment.offset != cursor)
+        {
+            RecordRelocation(segment.name, segment.offset, cursor, segment.sizeInElements);
+            segment.offset = cursor;
+        }
+        cursor += segment.sizeInElements;
+    }
+}
+
+namespace
+{
+    bool IsNonzeroPowerOf2(uint32_t i)
+    {
+        return ((i & (i - 1)) == 0) && (i > 0);
+    }
+
+    uint32_t GetSegmentSize(const rtxdi::RISBufferSegmentParameters& params)
+    {
+        return params.tileSize * params.tileCount;
+    }
+
+    // 先减后增，尽量利用缩小后空出来的空间
+    bool ApplySegmentSize(RISBufferSegmentPool& pool, uint32_t name, uint32_t sizeInElements, bool growPass)
+    {
+        uint32_t offset, currentSize;
+        const bool exists = pool.FindSegment(name, offset, currentSize);
+
+        if (!growPass)
+        {
+            if (exists && sizeInElements == 0)
+                pool.Free(name);
+            else if (exists && sizeInElements < currentSize)
+                pool.Resize(name, sizeInElements);
+            return true;
+        }
+
+        if (sizeInElements == 0)
+            return true;
+        if (!exists)
+            return pool.Allocate(name, sizeInElements);
+        if (sizeInElements > currentSize)
+            return pool.Resize(name, sizeInElements);
+        return true;
+    }
+
+    uint32_t GetReGIRLightSlotCount(const rtxdi::ReGIRStaticParameters& params)
+    {
+        rtxdi::RISBufferSegmentAllocator allocator;
+        rtxdi::ReGIRContext regirContext(params, allocator);
+        return regirContext.GetReGIRLightSlotCount();
+    }
+}
+
+ReconfigurableRISBuffer::ReconfigurableRISBuffer(const rtxdi::ImportanceSamplingContext& context, uint32_t capacityInElements) :
+    m_pool(std::max(capacityInElements, context.GetRISBufferSegmentAllocator().getTotalSizeInElements()))
+{
+    const RTXDI_RISBufferSegmentParameters& localParams = context.GetLocalLightRISBufferSegmentParams();
+    const RTXDI_RISBufferSegmentParameters& environmentParams = context.GetEnvironmentLightRISBufferSegmentParams();
+    const rtxdi::ReGIRContext& regirContext = context.GetReGIRContext();
+
+    // 按 ImportanceSamplingContext 的分配顺序登记现有分段，偏移与原来一致
+    m_pool.Allocate(RISSegmentName_LocalLights, localParams.tileSize * localParams.tileCount);
+    m_pool.Allocate(RISSegmentName_EnvironmentLight, environmentParams.tileSize * environmentParams.tileCount);
+    if (regirContext.GetReGIRLightSlotCount() > 0)
+        m_pool.Allocate(RISSegmentName_ReGIR, regirContext.GetReGIRLightSlotCount());
+
+    UpdateLayout({ localParams.tileSize, localParams.tileCount }, { environmentParams.tileSize, environmentParams.tileCount }, regirContext);
+}
+
+bool ReconfigurableRISBuffer::Reconfigure(rtxdi::ImportanceSamplingContext& context, const RISBufferReconfigureDesc& desc)
+{
+    // 与 ImportanceSamplingContext 构造时的检查一致
+    if (!IsNonzeroPowerOf2(desc.localLightRISBufferParams.tileSize) || !IsNonzeroPowerOf2(desc.localLightRISBufferParams.tileCount) ||
+        !IsNonzeroPowerOf2(desc.environmentLightRISBufferParams.tileSize) || !IsNonzeroPowerOf2(desc.environmentLightRISBufferParams.tileCount))
+        return false;
+
+    const uint32_t localSize = GetSegmentSize(desc.localLightRISBufferParams);
+    const uint32_t environmentSize = GetSegmentSize(desc.environmentLightRISBufferParams);
+    const uint32_t regirSize = GetReGIRLightSlotCount(desc.regirStaticParams);
+
+    RISBufferSegmentPool pool = m_pool;
+    for (bool growPass : { false, true })
+    {
+        if (!ApplySegmentSize(pool, RISSegmentName_LocalLights, localSize, growPass) ||
+            !ApplySegmentSize(pool, RISSegmentName_EnvironmentLight, environmentSize, growPass) ||
+            !ApplySegmentSize(pool, RISSegmentName_ReGIR, regirSize, growPass))
+            return false;
+    }
+
+    // 先占掉 ReGIR 分段之前的空间，让 ReGIRContext 的 bump 分配正好落在池里选好的位置
+    uint32_t regirOffset = 0, regirSlotCount = 0;
+    pool.FindSegment(RISSegmentName_ReGIR, regirOffset, regirSlotCount);
+
+    rtxdi::RISBufferSegmentAllocator allocator;
+    allocator.allocateSegment(regirOffset);
+    rtxdi::ReGIRContext regirContext(desc.regirStaticParams, allocator);
+    regirContext.SetDynamicParameters(context.GetReGIRContext().GetReGIRDynamicParameters());
+
+    context.GetReGIRContext() = regirContext;
+    m_pool = pool;
+
+    UpdateLayout(desc.localLightRISBufferParams, desc.environmentLightRISBufferParams, context.GetReGIRContext());
+    return true;
+}
+
+void ReconfigurableRISBuffer::UpdateLayout(const rtxdi::RISBufferSegmentParameters& localLightRISBufferParams,
+                                           const rtxdi::RISBufferSegmentParameters& environmentLightRISBufferParams,
+                                           const rtxdi::ReGIRContext& regirContext)
+{
+    uint32_t offset = 0, size = 0;
+
+    m_layout.localLightsRISBufferSegmentParams = {};
+    if (m_pool.FindSegment(RISSegmentName_LocalLights, offset, size))
+        m_layout.localLightsRISBufferSegmentParams.bufferOffset = offset;
+    m_layout.localLightsRISBufferSegmentParams.tileSize = localLightRISBufferParams.tileSize;
+    m_layout.localLightsRISBufferSegmentParams.tileCount = localLightRISBufferParams.tileCount;
+
+    m_layout.environmentLightRISBufferSegmentParams = {};
+    if (m_pool.FindSegment(RISSegmentName_EnvironmentLight, offset, size))
+        m_layout.environmentLightRISBufferSegmentParams.bufferOffset = offset;
+    m_layout.environmentLightRISBufferSegmentParams.tileSize = environmentLightRISBufferParams.tileSize;
+    m_layout.environmentLightRISBufferSegmentParams.tileCount = environmentLightRISBufferParams.tileCount;
+
+    m_layout.regirCellOffset = regirContext.GetReGIRCellOffset();
+    m_layout.regirLightSlotCount = regirContext.GetReGIRLightSlotCount();
+    m_layout.totalSizeInElements = m_pool.GetCapacityInElements();
+}
@@ -0,0 +1,105 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Rtxdi/ImportanceSamplingContext.h>
+
+// RTXDI 的 RISBufferSegmentAllocator 只能追加分配，这里提供可释放、可调整大小、可整理的具名分段
+// 总容量固定，重新配置时不需要重建 RIS 缓冲
+enum RISSegmentName : uint32_t
+{
+    RISSegmentName_LocalLights = 0,
+    RISSegmentName_EnvironmentLight = 1,
+    RISSegmentName_ReGIR = 2,
+};
+
+// 分段 name 从 oldOffset 移到了 newOffset，sizeInElements 为需要保留的元素数
+// RIS 和 ReGIR 的内容每帧都会重新生成，大多数情况下只需要使用新的偏移
+struct RISSegmentRelocation
+{
+    uint32_t name;
+    uint32_t oldOffset;
+    uint32_t newOffset;
+    uint32_t sizeInElements;
+};
+
+class RISBufferSegmentPool
+{
+public:
+    explicit RISBufferSegmentPool(uint32_t capacityInElements);
+
+    uint32_t GetCapacityInElements() const { return m_capacityInElements; }
+    bool FindSegment(uint32_t name, uint32_t& outOffset, uint32_t& outSizeInElements) const;
+
+    // 先找能放下的空隙，找不到时整理后再试，仍然放不下返回 false 且不改变任何状态
+    bool Allocate(uint32_t name, uint32_t sizeInElements);
+    void Free(uint32_t name);
+
+    // 缩小或后面的空隙足够时原地调整，否则移动到新位置
+    bool Resize(uint32_t name, uint32_t sizeInElements);
+
+    // 把所有分段按当前顺序紧密排到缓冲开头
+    void Compact();
+
+    // 自上次 ClearRelocations 以来移动过的分段，同一分段多次移动会合并成一条
+    const std::vector<RISSegmentRelocation>& GetRelocations() const { return m_relocations; }
+    void ClearRelocations() { m_relocations.clear(); }
+
+private:
+    struct Segment
+    {
+        uint32_t name;
+        uint32_t offset;
+        uint32_t sizeInElements;
+    };
+
+    bool FindFreeRange(uint32_t sizeInElements, uint32_t& outOffset) const;
+    void Insert(const Segment& segment);
+    void RecordRelocation(uint32_t name, uint32_t oldOffset, uint32_t newOffset, uint32_t sizeInElements);
+
+    uint32_t m_capacityInElements = 0;
+    std::vector<Segment> m_segments; // 按 offset 排序
+    std::vector<RISSegmentRelocation> m_relocations;
+};
+
+// 与 ResamplingConstants 中对应字段一致，覆盖 ImportanceSamplingContext 创建时固定的分段
+struct RISBufferLayout
+{
+    RTXDI_RISBufferSegmentParameters localLightsRISBufferSegmentParams;
+    RTXDI_RISBufferSegmentParameters environmentLightRISBufferSegmentParams;
+    uint32_t regirCellOffset;
+    uint32_t regirLightSlotCount;
+    uint32_t totalSizeInElements;
+    uint32_t pad1;
+};
+
+struct RISBufferReconfigureDesc
+{
+    rtxdi::RISBufferSegmentParameters localLightRISBufferParams;
+    rtxdi::RISBufferSegmentParameters environmentLightRISBufferParams;
+    rtxdi::ReGIRStaticParameters regirStaticParams;
+};
+
+// 接管 ImportanceSamplingContext 的 RIS 缓冲布局，运行时切换 ReGIR 模式、LightsPerCell 或 RIS tile 数时
+// 只重新摆放分段并替换 ReGIRContext，RIS 缓冲总大小保持为 capacity 不变
+class ReconfigurableRISBuffer
+{
+public:
+    // capacityInElements 小于 context 当前用量时按当前用量处理
+    ReconfigurableRISBuffer(const rtxdi::ImportanceSamplingContext& context, uint32_t capacityInElements);
+
+    // 放不下时返回 false，context 和布局都保持不变
+    bool Reconfigure(rtxdi::ImportanceSamplingContext& context, const RISBufferReconfigureDesc& desc);
+
+    const RISBufferLayout& GetLayout() const { return m_layout; }
+    RISBufferSegmentPool& GetPool() { return m_pool; }
+
+private:
+    void UpdateLayout(const rtxdi::RISBufferSegmentParameters& localLightRISBufferParams,
+                      const rtxdi::RISBufferSegmentParameters& environmentLightRISBufferParams,
+                      const rtxdi::ReGIRContext& regirContext);
+
+    RISBufferSegmentPool m_pool;
+    RISBufferLayout m_layout = {};
+};
@@ -1,12 +1,39 @@
-﻿#include <memory>
+﻿#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 
 #include "IUnityLog.h"
 #include "IUnityGraphics.h"
 
 #include <Rtxdi/DI/ReSTIRDI.h>
+#include <Rtxdi/GI/ReSTIRGI.h>
+#include <Rtxdi/ImportanceSamplingContext.h>
+
+#include "CompactGeometry.h"
+#include "ContextResize.h"
+#include "InstanceTable.h"
+#include "LightIndexMapping.h"
+#include "LocalLightAliasTable.h"
+#include "LocalLightPdfMipBuilder.h"
+#include "MultiViewContext.h"
+#include "PrepareLights.h"
+#include "PrimitiveCache.h"
+#include "PrimitiveDataBuilder.h"
+#include "RISBufferSegmentPool.h"
+#include "ReGIRAutoSizing.h"
+#include "ReSTIRDIGovernor.h"
+#include "ReSTIRDIReference.h"
+#include "ResamplingConstants.h"
+#include "ReservoirBufferSizing.h"
+#include "SamplingTables.h"
+#include "SharcHashGrid.h"
+#include "SharcSnapshot.h"
+#include "TextureTable.h"
 
 
 #define LOG(msg) UNITY_LOG(s_Logger, msg)
+#define LOG_ERROR(msg) do { if (s_Logger) UNITY_LOG_ERROR(s_Logger, msg); } while (0)
 
 namespace
 {
@@ -18,6 +45,62 @@ namespace
     void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType eventType)
     {
     }
+
+    bool IsNonzeroPowerOf2(uint32_t i)
+    {
+        return ((i & (i - 1)) == 0) && (i > 0);
+    }
+
+    // 以下校验返回 nullptr 表示参数合法，否则返回错误信息
+    // SDK 里只有 debug 下的 assert，release 下非法参数会直接算出错误的缓冲大小或掩码
+    const char* ValidateRenderSize(uint32_t renderWidth, uint32_t renderHeight, rtxdi::CheckerboardMode checkerboardMode, uint32_t numReservoirBuffers)
+    {
+        if (renderWidth == 0 || renderHeight == 0)
+            return "RenderWidth and RenderHeight must be non-zero.";
+
+        if (checkerboardMode != rtxdi::CheckerboardMode::Off &&
+            checkerboardMode != rtxdi::CheckerboardMode::Black &&
+            checkerboardMode != rtxdi::CheckerboardMode::White)
+            return "CheckerboardSamplingMode is not a valid CheckerboardMode.";
+
+        const RTXDI_ReservoirBufferParameters reservoirParams = rtxdi::CalculateReservoirBufferParameters(renderWidth, renderHeight, checkerboardMode);
+        if (uint64_t(reservoirParams.reservoirArrayPitch) * numReservoirBuffers > UINT32_MAX)
+            return "Render size is too large, reservoir buffer would exceed 2^32 elements.";
+
+        return nullptr;
+    }
+
+    const char* ValidateReSTIRDIStaticParameters(const rtxdi::ReSTIRDIStaticParameters& params)
+    {
+        // neighborOffsetMask = NeighborOffsetCount - 1
+        if (!IsNonzeroPowerOf2(params.NeighborOffsetCount))
+            return "NeighborOffsetCount must be a non-zero power of two.";
+
+        return ValidateRenderSize(params.RenderWidth, params.RenderHeight, params.CheckerboardSamplingMode, rtxdi::ReSTIRDIContext::NumReservoirBuffers);
+    }
+
+    const char* ValidateReSTIRGIStaticParameters(const rtxdi::ReSTIRGIStaticParameters& params)
+    {
+        return ValidateRenderSize(params.RenderWidth, params.RenderHeight, params.CheckerboardSamplingMode, 2);
+    }
+
+    const char* ValidateImportanceSamplingParameters(const rtxdi::ImportanceSamplingContext_StaticParameters& params)
+    {
+        if (!IsNonzeroPowerOf2(params.NeighborOffsetCount))
+            return "NeighborOffsetCount must be a non-zero power of two.";
+
+        if (!IsNonzeroPowerOf2(params.localLightRISBufferParams.tileSize) || !IsNonzeroPowerOf2(params.localLightRISBufferParams.tileCount) ||
+            !IsNonzeroPowerOf2(params.environmentLightRISBufferParams.tileSize) || !IsNonzeroPowerOf2(params.environmentLightRISBufferParams.tileCount))
+            return "RIS buffer tileSize and tileCount must be non-zero powers of two.";
+
+        const rtxdi::ReGIRStaticParameters& regir = params.regirStaticParams;
+        if (regir.Mode != rtxdi::ReGIRMode::Disabled && regir.Mode != rtxdi::ReGIRMode::Grid && regir.Mode != rtxdi::ReGIRMode::Onion)
+            return "regirStaticParams.Mode is not a valid ReGIRMode.";
+        if (regir.Mode != rtxdi::ReGIRMode::Disabled && regir.LightsPerCell == 0)
+            return "regirStaticParams.LightsPerCell must be non-zero when ReGIR is enabled.";
+
+        return ValidateRenderSize(params.renderWidth, params.renderHeight, params.CheckerboardSamplingMode, rtxdi::ReSTIRDIContext::NumReservoirBuffers);
+    }
 }
 
 extern "C" {
@@ -52,6 +135,28 @@ UNITY_INTERFACE_EXPORT rtxdi::ReSTIRDIContext* UNITY_INTERFACE_API CreateReSTIRD
     return new rtxdi::ReSTIRDIContext(contextParams);
 }
 
+// 原地修改分辨率，帧序号和 reservoir 缓冲轮转保持不变，outRemap 可为空
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResizeReSTIRDIContext(rtxdi::ReSTIRDIContext* context, int width, int height, ReservoirRemapParameters* outRemap)
+{
+    if (!context) return;
+    ReservoirRemapParameters remap = ResizeReSTIRDI(*context, width, height);
+    if (outRemap) *outRemap = remap;
+}
+
+// 完整的静态参数版本，可以开启棋盘采样并指定 NeighborOffsetCount，参数非法时打印错误并返回空
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRDIContext* UNITY_INTERFACE_API CreateReSTIRDIContextWithParams(const rtxdi::ReSTIRDIStaticParameters* params)
+{
+    if (!params) return nullptr;
+
+    if (const char* error = ValidateReSTIRDIStaticParameters(*params))
+    {
+        LOG_ERROR(error);
+        return nullptr;
+    }
+
+    return new rtxdi::ReSTIRDIContext(*params);
+}
+
 UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReSTIRDIContext(rtxdi::ReSTIRDIContext* context)
 {
     if (context)
@@ -60,6 +165,27 @@ UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReSTIRDIContext(rtxdi::Re
     }
 }
 
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRGIContext* UNITY_INTERFACE_API CreateReSTIRGIContext(const rtxdi::ReSTIRGIStaticParameters* params)
+{
+    if (!params) return nullptr;
+
+    if (const char* error = ValidateReSTIRGIStaticParameters(*params))
+    {
+        LOG_ERROR(error);
+        return nullptr;
+    }
+
+    return new rtxdi::ReSTIRGIContext(*params);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReSTIRGIContext(rtxdi::ReSTIRGIContext* context)
+{
+    if (context)
+    {
+        delete context;
+    }
+}
+
 UNITY_INTERFACE_EXPORT const rtxdi::ReSTIRDIStaticParameters* UNITY_INTERFACE_API GetStaticParameters(rtxdi::ReSTIRDIContext* context)
 {
     if (!context) return nullptr;
@@ -150,9 +276,893 @@ UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetShadingParameters(rtxdi::ReST
     if (context) context->SetShadingParameters(params);
 }
 
+// 指定模式下 DI reservoir 缓冲最少需要的数组数和大小，配合 ReSTIRDIReservoirPlanner 的索引使用
+UNITY_INTERFACE_EXPORT ReservoirBufferDesc UNITY_INTERFACE_API GetReSTIRDIReservoirBufferDesc(rtxdi::ReSTIRDIContext* context, rtxdi::ReSTIRDI_ResamplingMode mode)
+{
+    if (!context) return {};
+    return CalculateReSTIRDIReservoirBufferDesc(*context, mode);
+}
+
+UNITY_INTERFACE_EXPORT ReSTIRDIReservoirPlanner* UNITY_INTERFACE_API CreateReSTIRDIReservoirPlanner()
+{
+    return new ReSTIRDIReservoirPlanner();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReSTIRDIReservoirPlanner(ReSTIRDIReservoirPlanner* planner)
+{
+    if (planner)
+    {
+        delete planner;
+    }
+}
+
+// 每帧 SetFrameIndex 之后调用，结果写进 ResamplingConstants.restirDI.bufferIndices 代替 GetBufferIndices
+UNITY_INTERFACE_EXPORT ReSTIRDI_BufferIndices UNITY_INTERFACE_API UpdateReSTIRDIReservoirPlanner(ReSTIRDIReservoirPlanner* planner, rtxdi::ReSTIRDIContext* context)
+{
+    if (!planner || !context) return {};
+    return planner->Update(*context);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResetReSTIRDIReservoirPlanner(ReSTIRDIReservoirPlanner* planner)
+{
+    if (planner) planner->Reset();
+}
+
+// 以 context 当前的采样配置为最高档
+UNITY_INTERFACE_EXPORT ReSTIRDIBudgetGovernor* UNITY_INTERFACE_API CreateReSTIRDIGovernor(rtxdi::ReSTIRDIContext* context, const ReSTIRDIGovernorSettings* settings)
+{
+    if (!context || !settings) return nullptr;
+    return new ReSTIRDIBudgetGovernor(ReSTIRDIBudgetGovernor::GetContextLevel(*context), *settings);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReSTIRDIGovernor(ReSTIRDIBudgetGovernor* governor)
+{
+    if (governor)
+    {
+        delete governor;
+    }
+}
+
+// 传入上一帧读回的各 pass 耗时，决策写回 context，之后照常 FillResamplingConstants
+UNITY_INTERFACE_EXPORT ReSTIRDIGovernorDecision UNITY_INTERFACE_API UpdateReSTIRDIGovernor(ReSTIRDIBudgetGovernor* governor, rtxdi::ReSTIRDIContext* context, const ReSTIRDIPassTimings* timings)
+{
+    if (!governor || !context || !timings) return {};
+    ReSTIRDIGovernorDecision decision = governor->Update(*timings);
+    governor->Apply(*context);
+    return decision;
+}
+
+// 外部修改了采样数或模式后调用，以 context 的新配置为最高档重新开始
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResetReSTIRDIGovernor(ReSTIRDIBudgetGovernor* governor, rtxdi::ReSTIRDIContext* context)
+{
+    if (governor && context) governor->Reset(ReSTIRDIBudgetGovernor::GetContextLevel(*context));
+}
+
+
+// --------------------------------------------------------------------------
+// ReSTIR GI，与上面 DI 的函数一一对应，名字加 ReSTIRGI 前缀
+// --------------------------------------------------------------------------
+
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRGIStaticParameters UNITY_INTERFACE_API GetReSTIRGIStaticParameters(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return {};
+    return context->GetStaticParams();
+}
+
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API GetReSTIRGIFrameIndex(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return 0;
+    return context->GetFrameIndex();
+}
+
+UNITY_INTERFACE_EXPORT RTXDI_ReservoirBufferParameters UNITY_INTERFACE_API GetReSTIRGIReservoirBufferParameters(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return {};
+    return context->GetReservoirBufferParameters();
+}
+
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRGI_ResamplingMode UNITY_INTERFACE_API GetReSTIRGIResamplingMode(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return rtxdi::ReSTIRGI_ResamplingMode::None;
+    return context->GetResamplingMode();
+}
+
+UNITY_INTERFACE_EXPORT ReSTIRGI_BufferIndices UNITY_INTERFACE_API GetReSTIRGIBufferIndices(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return {};
+    return context->GetBufferIndices();
+}
+
+UNITY_INTERFACE_EXPORT ReSTIRGI_TemporalResamplingParameters UNITY_INTERFACE_API GetReSTIRGITemporalResamplingParameters(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return {};
+    return context->GetTemporalResamplingParameters();
+}
+
+UNITY_INTERFACE_EXPORT ReSTIRGI_SpatialResamplingParameters UNITY_INTERFACE_API GetReSTIRGISpatialResamplingParameters(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return {};
+    return context->GetSpatialResamplingParameters();
+}
+
+UNITY_INTERFACE_EXPORT ReSTIRGI_FinalShadingParameters UNITY_INTERFACE_API GetReSTIRGIFinalShadingParameters(rtxdi::ReSTIRGIContext* context)
+{
+    if (!context) return {};
+    return context->GetFinalShadingParameters();
+}
+
+// 帧序号和模式变化时 context 会重新计算缓冲下标
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetReSTIRGIFrameIndex(rtxdi::ReSTIRGIContext* context, uint32_t frameIndex)
+{
+    if (context) context->SetFrameIndex(frameIndex);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetReSTIRGIResamplingMode(rtxdi::ReSTIRGIContext* context, rtxdi::ReSTIRGI_ResamplingMode mode)
+{
+    if (context) context->SetResamplingMode(mode);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetReSTIRGITemporalResamplingParameters(rtxdi::ReSTIRGIContext* context, ReSTIRGI_TemporalResamplingParameters params)
+{
+    if (context) context->SetTemporalResamplingParameters(params);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetReSTIRGISpatialResamplingParameters(rtxdi::ReSTIRGIContext* context, ReSTIRGI_SpatialResamplingParameters params)
+{
+    if (context) context->SetSpatialResamplingParameters(params);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetReSTIRGIFinalShadingParameters(rtxdi::ReSTIRGIContext* context, ReSTIRGI_FinalShadingParameters params)
+{
+    if (context) context->SetFinalShadingParameters(params);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResizeReSTIRGIContext(rtxdi::ReSTIRGIContext* context, int width, int height, ReservoirRemapParameters* outRemap)
+{
+    if (!context) return;
+    ReservoirRemapParameters remap = ResizeReSTIRGI(*context, width, height);
+    if (outRemap) *outRemap = remap;
+}
+
+// 指定模式下 GI reservoir 缓冲需要的数组数和大小，RTXDI_PackedGIReservoir 为 32 字节
+UNITY_INTERFACE_EXPORT ReservoirBufferDesc UNITY_INTERFACE_API GetReSTIRGIReservoirBufferDesc(rtxdi::ReSTIRGIContext* context, rtxdi::ReSTIRGI_ResamplingMode mode)
+{
+    if (!context) return {};
+    return CalculateReSTIRGIReservoirBufferDesc(*context, mode);
+}
+
+
+// --------------------------------------------------------------------------
+// ImportanceSamplingContext
+// --------------------------------------------------------------------------
+
+UNITY_INTERFACE_EXPORT rtxdi::ImportanceSamplingContext* UNITY_INTERFACE_API CreateImportanceSamplingContext(const rtxdi::ImportanceSamplingContext_StaticParameters* params)
+{
+    if (!params) return nullptr;
+
+    if (const char* error = ValidateImportanceSamplingParameters(*params))
+    {
+        LOG_ERROR(error);
+        return nullptr;
+    }
+
+    return new rtxdi::ImportanceSamplingContext(*params);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyImportanceSamplingContext(rtxdi::ImportanceSamplingContext* context)
+{
+    if (context)
+    {
+        delete context;
+    }
+}
+
+// 同时调整其中的 ReSTIR DI 和 GI context，RIS 与 ReGIR 与分辨率无关，不受影响
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResizeImportanceSamplingContext(rtxdi::ImportanceSamplingContext* context, int width, int height,
+    ReservoirRemapParameters* outDIRemap, ReservoirRemapParameters* outGIRemap)
+{
+    if (!context) return;
+    ReservoirRemapParameters diRemap = ResizeReSTIRDI(context->GetReSTIRDIContext(), width, height);
+    ReservoirRemapParameters giRemap = ResizeReSTIRGI(context->GetReSTIRGIContext(), width, height);
+    if (outDIRemap) *outDIRemap = diRemap;
+    if (outGIRemap) *outGIRemap = giRemap;
+}
+
+// 返回的指针由 ImportanceSamplingContext 持有，可以直接传给上面的 ReSTIR DI 函数，但不能 Destroy
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRDIContext* UNITY_INTERFACE_API GetImportanceSamplingReSTIRDIContext(rtxdi::ImportanceSamplingContext* context)
+{
+    if (!context) return nullptr;
+    return &context->GetReSTIRDIContext();
+}
+
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRGIContext* UNITY_INTERFACE_API GetImportanceSamplingReSTIRGIContext(rtxdi::ImportanceSamplingContext* context)
+{
+    if (!context) return nullptr;
+    return &context->GetReSTIRGIContext();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SetReGIRDynamicParameters(rtxdi::ImportanceSamplingContext* context, rtxdi::ReGIRDynamicParameters params)
+{
+    if (context) context->GetReGIRContext().SetDynamicParameters(params);
+}
+
+// 按光源分布、相机位置和内存预算挑选 ReGIR 参数，staticParams 用于创建 ImportanceSamplingContext
+UNITY_INTERFACE_EXPORT ReGIRAutoSizeResult UNITY_INTERFACE_API AutoSizeReGIRParameters(const ReGIRAutoSizeDesc* desc)
+{
+    if (!desc) return {};
+    return AutoSizeReGIR(*desc);
+}
+
+// 静态参数沿用 context 的，只按当前相机重新选择 cellSize 和中心，其余动态参数保持 context 当前的值
+// 结果通过 SetReGIRDynamicParameters 生效
+UNITY_INTERFACE_EXPORT ReGIRAutoSizeResult UNITY_INTERFACE_API FitReGIRDynamicParameters(rtxdi::ImportanceSamplingContext* context, const ReGIRAutoSizeDesc* desc)
+{
+    if (!context || !desc) return {};
+
+    const rtxdi::ReGIRContext& regirContext = context->GetReGIRContext();
+    ReGIRAutoSizeResult result = FitReGIRCellSize(*desc, regirContext.GetReGIRStaticParameters());
+
+    rtxdi::ReGIRDynamicParameters dynamicParams = regirContext.GetReGIRDynamicParameters();
+    dynamicParams.regirCellSize = result.dynamicParams.regirCellSize;
+    dynamicParams.center = result.dynamicParams.center;
+    result.dynamicParams = dynamicParams;
+    return result;
+}
+
+// 用 context 当前的静态和动态参数统计每个 cell 的光源数
+UNITY_INTERFACE_EXPORT ReGIROccupancyStats UNITY_INTERFACE_API SimulateReGIRCellOccupancy(rtxdi::ImportanceSamplingContext* context, const ReGIRAutoSizeDesc* desc)
+{
+    if (!context || !desc) return {};
+
+    const rtxdi::ReGIRContext& regirContext = context->GetReGIRContext();
+    return SimulateReGIROccupancy(*desc, regirContext.GetReGIRStaticParameters(), regirContext.GetReGIRDynamicParameters());
+}
+
+// 一次调用填满整个 ResamplingConstants，替代逐个结构体的 Get 调用
+// constants 需要由 C# 跨帧持有，返回值表示内容相对缓冲中上一帧的数据是否有变化
+// aliasTableParams 为空表示不使用别名表采样，risBuffer 为空表示沿用 context 创建时的 RIS 分段
+// planner 不为空时 DI 缓冲下标取自它，reservoir 缓冲按 GetReSTIRDIReservoirBufferDesc 的数组数分配
+UNITY_INTERFACE_EXPORT bool UNITY_INTERFACE_API FillResamplingConstants(rtxdi::ImportanceSamplingContext* context, ResamplingConstants* constants,
+    const RTXDI_AliasTableParameters* aliasTableParams, const ReconfigurableRISBuffer* risBuffer, ReSTIRDIReservoirPlanner* planner)
+{
+    if (!context || !constants) return false;
+
+    ReSTIRDI_BufferIndices diBufferIndices = {};
+    if (planner)
+        diBufferIndices = planner->Update(context->GetReSTIRDIContext());
+
+    return UpdateResamplingConstants(*constants, *context, aliasTableParams ? *aliasTableParams : RTXDI_AliasTableParameters{},
+        risBuffer ? &risBuffer->GetLayout() : nullptr, planner ? &diBufferIndices : nullptr);
+}
+
+// 接管 context 的 RIS 缓冲布局，之后 RIS 缓冲按 layout.totalSizeInElements 分配，不再随配置变化
+UNITY_INTERFACE_EXPORT ReconfigurableRISBuffer* UNITY_INTERFACE_API CreateReconfigurableRISBuffer(rtxdi::ImportanceSamplingContext* context, uint32_t capacityInElements)
+{
+    if (!context) return nullptr;
+    return new ReconfigurableRISBuffer(*context, capacityInElements);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReconfigurableRISBuffer(ReconfigurableRISBuffer* risBuffer)
+{
+    if (risBuffer)
+    {
+        delete risBuffer;
+    }
+}
+
+// 运行时切换 ReGIR 模式 / LightsPerCell / RIS tile 数，放不下时返回 false 且不做任何修改
+UNITY_INTERFACE_EXPORT bool UNITY_INTERFACE_API ReconfigureRISBuffer(ReconfigurableRISBuffer* risBuffer, rtxdi::ImportanceSamplingContext* context, const RISBufferReconfigureDesc* desc)
+{
+    if (!risBuffer || !context || !desc) return false;
+    return risBuffer->Reconfigure(*context, *desc);
+}
+
+UNITY_INTERFACE_EXPORT RISBufferLayout UNITY_INTERFACE_API GetRISBufferLayout(ReconfigurableRISBuffer* risBuffer)
+{
+    if (!risBuffer) return {};
+    return risBuffer->GetLayout();
+}
+
+// 返回累计的重定位条数，最多写出 maxCount 条，clear 为 true 时读完清空
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API GetRISSegmentRelocations(ReconfigurableRISBuffer* risBuffer, RISSegmentRelocation* outRelocations, uint32_t maxCount, bool clear)
+{
+    if (!risBuffer) return 0;
+
+    RISBufferSegmentPool& pool = risBuffer->GetPool();
+    const std::vector<RISSegmentRelocation>& relocations = pool.GetRelocations();
+    const uint32_t count = uint32_t(relocations.size());
+    if (outRelocations)
+        std::copy(relocations.begin(), relocations.begin() + std::min(count, maxCount), outRelocations);
+
+    if (clear)
+        pool.ClearRelocations();
+    return count;
+}
+
+// ================= 多视图 =================
+// 共享的 ImportanceSamplingContext 通过 GetMultiViewSharedContext 取出后，可以直接使用上面的 PrepareLightBuffer / FillResamplingConstants 等函数
+UNITY_INTERFACE_EXPORT MultiViewImportanceSamplingContext* UNITY_INTERFACE_API CreateMultiViewImportanceSamplingContext(const rtxdi::ImportanceSamplingContext_StaticParameters* params)
+{
+    if (!params) return nullptr;
+
+    if (const char* error = ValidateImportanceSamplingParameters(*params))
+    {
+        LOG_ERROR(error);
+        return nullptr;
+    }
+
+    return new MultiViewImportanceSamplingContext(*params);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyMultiViewImportanceSamplingContext(MultiViewImportanceSamplingContext* context)
+{
+    if (context)
+    {
+        delete context;
+    }
+}
+
+UNITY_INTERFACE_EXPORT rtxdi::ImportanceSamplingContext* UNITY_INTERFACE_API GetMultiViewSharedContext(MultiViewImportanceSamplingContext* context)
+{
+    if (!context) return nullptr;
+    return &context->GetSharedContext();
+}
+
+// 返回新视图的下标，参数非法时返回 -1
+UNITY_INTERFACE_EXPORT int UNITY_INTERFACE_API AddMultiViewView(MultiViewImportanceSamplingContext* context, int width, int height, rtxdi::CheckerboardMode checkerboardMode)
+{
+    if (!context || width <= 0 || height <= 0) return -1;
+
+    if (const char* error = ValidateRenderSize(width, height, checkerboardMode, rtxdi::ReSTIRDIContext::NumReservoirBuffers))
+    {
+        LOG_ERROR(error);
+        return -1;
+    }
+
+    return int(context->AddView(width, height, checkerboardMode));
+}
+
+UNITY_INTERFACE_EXPORT bool UNITY_INTERFACE_API RemoveMultiViewView(MultiViewImportanceSamplingContext* context, int viewIndex)
+{
+    if (!context || viewIndex < 0) return false;
+    return context->RemoveView(uint32_t(viewIndex));
+}
+
+// 返回的 context 归多视图对象所有，可以直接传给 ReSTIR DI 的 Get / Set / Resize 函数，但不能 Destroy
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRDIContext* UNITY_INTERFACE_API GetMultiViewReSTIRDIContext(MultiViewImportanceSamplingContext* context, int viewIndex)
+{
+    if (!context || viewIndex < 0) return nullptr;
+    return context->GetReSTIRDIContext(uint32_t(viewIndex));
+}
+
+UNITY_INTERFACE_EXPORT rtxdi::ReSTIRGIContext* UNITY_INTERFACE_API GetMultiViewReSTIRGIContext(MultiViewImportanceSamplingContext* context, int viewIndex)
+{
+    if (!context || viewIndex < 0) return nullptr;
+    return context->GetReSTIRGIContext(uint32_t(viewIndex));
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResizeMultiViewView(MultiViewImportanceSamplingContext* context, int viewIndex, int width, int height,
+    ReservoirRemapParameters* outDIRemap, ReservoirRemapParameters* outGIRemap)
+{
+    if (!context || viewIndex < 0 || !context->IsValidView(uint32_t(viewIndex))) return;
+    ReservoirRemapParameters diRemap = ResizeReSTIRDI(*context->GetReSTIRDIContext(uint32_t(viewIndex)), width, height);
+    ReservoirRemapParameters giRemap = ResizeReSTIRGI(*context->GetReSTIRGIContext(uint32_t(viewIndex)), width, height);
+    if (outDIRemap) *outDIRemap = diRemap;
+    if (outGIRemap) *outGIRemap = giRemap;
+}
+
+// 所有视图共用的 RIS 缓冲和 reservoir 缓冲的尺寸，增删视图或修改分辨率后需要重新查询
+// risBuffer 不为空时 RIS 缓冲大小为它的容量
+UNITY_INTERFACE_EXPORT MultiViewBufferSizes UNITY_INTERFACE_API GetMultiViewBufferSizes(MultiViewImportanceSamplingContext* context, const ReconfigurableRISBuffer* risBuffer)
+{
+    if (!context) return {};
+    return context->GetBufferSizes(risBuffer ? &risBuffer->GetLayout() : nullptr);
+}
+
+// 每个视图各自持有一份 constants，缓冲下标已经偏移到共享 reservoir 缓冲中该视图的数组
+UNITY_INTERFACE_EXPORT bool UNITY_INTERFACE_API FillMultiViewResamplingConstants(MultiViewImportanceSamplingContext* context, int viewIndex, ResamplingConstants* constants,
+    const RTXDI_AliasTableParameters* aliasTableParams, const ReconfigurableRISBuffer* risBuffer)
+{
+    if (!context || !constants || viewIndex < 0) return false;
+    return context->UpdateViewResamplingConstants(uint32_t(viewIndex), *constants, aliasTableParams ? *aliasTableParams : RTXDI_AliasTableParameters{},
+        risBuffer ? &risBuffer->GetLayout() : nullptr);
+}
+
+// 在 CPU 上多线程生成光源缓冲和 GeometryInstanceToLight，结果同时写回 ImportanceSamplingContext
+UNITY_INTERFACE_EXPORT RTXDI_LightBufferParameters UNITY_INTERFACE_API PrepareLightBuffer(rtxdi::ImportanceSamplingContext* context, const PrepareLightsDesc* desc)
+{
+    if (!desc) return {};
+
+    RTXDI_LightBufferParameters lightBufferParams = PrepareLights(*desc);
+    if (context) context->SetLightBufferParams(lightBufferParams);
+    return lightBufferParams;
+}
+
+UNITY_INTERFACE_EXPORT LightIndexMapper* UNITY_INTERFACE_API CreateLightIndexMapper()
+{
+    return new LightIndexMapper();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyLightIndexMapper(LightIndexMapper* mapper)
+{
+    if (mapper)
+    {
+        delete mapper;
+    }
+}
+
+// 在 PrepareLightBuffer 之后用同一个 desc 调用，lightBufferParams 为其返回值
+// 两个映射数组都可以为空，只需要其中一个方向时可以省掉另一个的填充
+UNITY_INTERFACE_EXPORT LightIndexMappingStats UNITY_INTERFACE_API UpdateLightIndexMapping(LightIndexMapper* mapper, const PrepareLightsDesc* desc, const uint64_t* instanceIds,
+    RTXDI_LightBufferParameters lightBufferParams, uint32_t* currentToPrevious, uint32_t* previousToCurrent)
+{
+    if (!mapper || !desc) return {};
+    return mapper->Update(*desc, instanceIds, lightBufferParams, currentToPrevious, previousToCurrent);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ResetLightIndexMapper(LightIndexMapper* mapper)
+{
+    if (mapper) mapper->Reset();
+}
+
+
+UNITY_INTERFACE_EXPORT LocalLightPdfMipBuilder* UNITY_INTERFACE_API CreateLocalLightPdfMipBuilder(uint32_t maxLights)
+{
+    return new LocalLightPdfMipBuilder(maxLights);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyLocalLightPdfMipBuilder(LocalLightPdfMipBuilder* builder)
+{
+    if (builder)
+    {
+        delete builder;
+    }
+}
+
+UNITY_INTERFACE_EXPORT PdfTextureDesc UNITY_INTERFACE_API GetLocalLightPdfTextureDesc(LocalLightPdfMipBuilder* builder)
+{
+    if (!builder) return {};
+    return builder->GetTextureDesc();
+}
+
+// outLayouts 至少需要 mipLevels 个元素
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API GetLocalLightPdfMipLayouts(LocalLightPdfMipBuilder* builder, PdfMipLayout* outLayouts)
+{
+    if (!builder || !outLayouts) return;
+    const std::vector<PdfMipLayout>& layouts = builder->GetMipLayouts();
+    std::copy(layouts.begin(), layouts.end(), outLayouts);
+}
+
+// outDirtyRows 至少需要 mipLevels 个元素，反映最近一次 Build / Update 改写的行
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API GetLocalLightPdfDirtyRows(LocalLightPdfMipBuilder* builder, PdfMipDirtyRows* outDirtyRows)
+{
+    if (!builder || !outDirtyRows) return;
+    const std::vector<PdfMipDirtyRows>& dirtyRows = builder->GetDirtyRows();
+    std::copy(dirtyRows.begin(), dirtyRows.end(), outDirtyRows);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API BuildLocalLightPdf(LocalLightPdfMipBuilder* builder, const float* lightPowers, uint32_t lightCount, float* uploadBuffer)
+{
+    if (builder) builder->Build(lightPowers, lightCount, uploadBuffer);
+}
+
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API UpdateLocalLightPdf(LocalLightPdfMipBuilder* builder, const uint32_t* lightIndices, const float* lightPowers, uint32_t count, float* uploadBuffer)
+{
+    if (!builder) return 0;
+    return builder->Update(lightIndices, lightPowers, count, uploadBuffer);
+}
+
+// Build 与运行时一样使用 ParallelFor，例如 1M 光源、changedFraction 为 0.01 时比较增量更新与全量重建的耗时和上传量
+UNITY_INTERFACE_EXPORT LocalLightPdfBenchmarkResult UNITY_INTERFACE_API BenchmarkLocalLightPdf(uint32_t lightCount, float changedFraction, uint32_t frameCount)
+{
+    return BenchmarkLocalLightPdfUpdates(lightCount, changedFraction, frameCount);
+}
+
+
+UNITY_INTERFACE_EXPORT LocalLightAliasTable* UNITY_INTERFACE_API CreateLocalLightAliasTable()
+{
+    return new LocalLightAliasTable();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyLocalLightAliasTable(LocalLightAliasTable* table)
+{
+    if (table)
+    {
+        delete table;
+    }
+}
+
+// entries 至少 lightCount 项，上传到 shader 的 LocalLightAliasTable 缓冲，返回值写进 ResamplingConstants
+UNITY_INTERFACE_EXPORT RTXDI_AliasTableParameters UNITY_INTERFACE_API BuildLocalLightAliasTable(LocalLightAliasTable* table, const float* lightPowers, uint32_t lightCount, RTXDI_AliasTableEntry* entries)
+{
+    if (!table) return {};
+    return table->Build(lightPowers, lightCount, entries);
+}
+
+// 重复 buildCount 次 Build 取平均耗时，并用 probability 和 alias 还原选中概率与输入功率比较
+UNITY_INTERFACE_EXPORT LocalLightAliasTableBenchmarkResult UNITY_INTERFACE_API BenchmarkLocalLightAliasTable(uint32_t lightCount, uint32_t buildCount)
+{
+    return BenchmarkLocalLightAliasTableBuild(lightCount, buildCount);
+}
+
 
+// 结果与 rtxdi::FillNeighborOffsetBuffer 相同，从共享缓存中拷贝，重复调用不会重新生成
 UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API FillNeighborOffsetBuffer(uint8_t* buffer, uint32_t neighborOffsetCount)
 {
-    return rtxdi::FillNeighborOffsetBuffer(buffer, neighborOffsetCount);
+    if (!buffer) return;
+
+    // 缓存只接受 2 的幂，其他数量保持原来的行为
+    const uint8_t* offsets = SamplingTableCache::Get().GetNeighborOffsets(neighborOffsetCount, 250, NeighborOffsetDistribution_Uniform);
+    if (offsets)
+        memcpy(buffer, offsets, neighborOffsetCount * 2);
+    else
+        rtxdi::FillNeighborOffsetBuffer(buffer, neighborOffsetCount);
+}
+
+// ================= 采样查找表 =================
+// 返回的指针由插件持有，插件卸载前一直有效，参数非法时打印错误并返回空
+
+// neighborOffsetCount * 2 个字节
+UNITY_INTERFACE_EXPORT const uint8_t* UNITY_INTERFACE_API GetNeighborOffsetTable(uint32_t neighborOffsetCount, uint32_t radius, NeighborOffsetDistribution distribution)
+{
+    const uint8_t* offsets = SamplingTableCache::Get().GetNeighborOffsets(neighborOffsetCount, radius, distribution);
+    if (!offsets)
+        LOG_ERROR("Neighbor offset table requires a power-of-two count and a radius in [1, 254].");
+    return offsets;
+}
+
+// size * size 个 float
+UNITY_INTERFACE_EXPORT const float* UNITY_INTERFACE_API GetBlueNoiseTile(uint32_t size, uint32_t seed)
+{
+    const float* tile = SamplingTableCache::Get().GetBlueNoiseTile(size, seed);
+    if (!tile)
+        LOG_ERROR("Blue noise tile size must be a power of two in [4, 128].");
+    return tile;
+}
+
+// count 个 uint32
+UNITY_INTERFACE_EXPORT const uint32_t* UNITY_INTERFACE_API GetFrameSeedTable(uint32_t count)
+{
+    const uint32_t* seeds = SamplingTableCache::Get().GetFrameSeeds(count);
+    if (!seeds)
+        LOG_ERROR("Frame seed table count must be non-zero.");
+    return seeds;
+}
+
+// ================= CPU 参考实现 =================
+// 创建时生成合成场景并计算每个像素的真值，光源多、分辨率高时会比较慢
+UNITY_INTERFACE_EXPORT ReSTIRDIReference* UNITY_INTERFACE_API CreateReSTIRDIReference(const ReSTIRDIReferenceSceneDesc* desc)
+{
+    if (!desc) return nullptr;
+    return new ReSTIRDIReference(*desc);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyReSTIRDIReference(ReSTIRDIReference* reference)
+{
+    if (reference)
+    {
+        delete reference;
+    }
+}
+
+// 使用 context 当前的 resampling 模式和参数运行 frameCount 帧，不会修改 context
+UNITY_INTERFACE_EXPORT ReSTIRDIReferenceStats UNITY_INTERFACE_API RunReSTIRDIReference(ReSTIRDIReference* reference, rtxdi::ReSTIRDIContext* context, uint32_t frameCount)
+{
+    if (!reference || !context) return {};
+    return reference->Run(ReSTIRDIReferenceParameters::FromContext(*context), frameCount);
+}
+
+// ================= Sharc 容量模拟 =================
+// 对每组 capacity / bucket 大小分别从空的 hash 表回放整个序列，结果按 settings 的顺序写入 outStats
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SimulateSharcCapacities(const SharcTraceDesc* trace, const SharcSimulationSettings* settings,
+    uint32_t settingsCount, SharcSimulationStats* outStats)
+{
+    if (!trace || !settings || !outStats) return;
+
+    for (uint32_t i = 0; i < settingsCount; i++)
+        outStats[i] = SimulateSharcHashGrid(*trace, settings[i]);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API SimulateSharcSyntheticCapacities(const SharcSyntheticTraceDesc* desc, const SharcSimulationSettings* settings,
+    uint32_t settingsCount, SharcSimulationStats* outStats)
+{
+    if (!desc || !settings || !outStats) return;
+
+    for (uint32_t i = 0; i < settingsCount; i++)
+        outStats[i] = SimulateSharcSyntheticTrace(*desc, settings[i]);
+}
+
+// 同一个序列分别用每个 hash 函数回放，outResults 需要 HashGridHashFunction_Count 个元素，下标即 HASH_GRID_HASH 的取值
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API BenchmarkSharcHashes(const SharcTraceDesc* trace, const SharcSimulationSettings* settings,
+    SharcHashBenchmarkResult* outResults)
+{
+    if (!trace || !settings || !outResults) return 0;
+
+    BenchmarkSharcHashFunctions(*trace, *settings, outResults);
+    return HashGridHashFunction_Count;
+}
+
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API BenchmarkSharcSyntheticHashes(const SharcSyntheticTraceDesc* desc, const SharcSimulationSettings* settings,
+    SharcHashBenchmarkResult* outResults)
+{
+    if (!desc || !settings || !outResults) return 0;
+
+    BenchmarkSharcSyntheticHashFunctions(*desc, *settings, outResults);
+    return HashGridHashFunction_Count;
+}
+
+// ================= Sharc 快照 =================
+// hashEntries / resolved 为读回的 GPU 缓冲内容，元素个数为 desc->capacity
+UNITY_INTERFACE_EXPORT SharcSnapshotStats UNITY_INTERFACE_API SaveSharcSnapshotFile(const char* path, const SharcSnapshotDesc* desc,
+    const uint64_t* hashEntries, const SharcPackedData* resolved)
+{
+    if (!desc) return {};
+
+    SharcSnapshotStats stats = SaveSharcSnapshot(path, *desc, hashEntries, resolved);
+    if (stats.result != SharcSnapshotResult_Ok)
+        LOG_ERROR("[Sharc Snapshot] Save failed.");
+    return stats;
+}
+
+// 加载失败时 hashEntries / resolved 的内容未定义，调用方应按空缓冲处理
+UNITY_INTERFACE_EXPORT SharcSnapshotStats UNITY_INTERFACE_API LoadSharcSnapshotFile(const char* path, const SharcSnapshotDesc* desc,
+    uint64_t* hashEntries, SharcPackedData* resolved)
+{
+    if (!desc) return {};
+
+    return LoadSharcSnapshot(path, *desc, hashEntries, resolved);
+}
+
+// 加载成功后在同一个后台线程调用，有效 entry 移到开头，返回个数
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API CompactSharcSnapshotEntries(uint64_t* hashEntries, SharcPackedData* resolved, uint32_t capacity)
+{
+    return CompactSharcEntries(hashEntries, resolved, capacity);
+}
+
+// ================= 场景几何 =================
+// 每个 submesh 一个 desc，outPrimitives 为 primitiveCapacity 个 PrimitiveData，由调用方分配
+UNITY_INTERFACE_EXPORT PrimitiveBuildStats UNITY_INTERFACE_API BuildScenePrimitiveData(const PrimitiveBuildDesc* descs, uint32_t descCount,
+    PrimitiveData* outPrimitives, uint32_t primitiveCapacity)
+{
+    if (!descs || !outPrimitives) return {};
+
+    PrimitiveBuildStats stats = BuildPrimitiveData(descs, descCount, outPrimitives, primitiveCapacity);
+    if (stats.invalidSubmeshCount > 0)
+        LOG_ERROR("[PrimitiveData] Some submeshes have out of range indices or offsets.");
+    return stats;
+}
+
+// path 指向的文件不存在时创建空缓存，格式或 PrimitiveData 版本不同时丢弃旧文件，下次保存时覆盖
+UNITY_INTERFACE_EXPORT PrimitiveCache* UNITY_INTERFACE_API CreatePrimitiveCache(const char* path)
+{
+    if (!path) return nullptr;
+
+    PrimitiveCache* cache = new PrimitiveCache(path);
+    const PrimitiveCacheResult result = cache->GetInfo().loadResult;
+    if (result == PrimitiveCacheResult_InvalidFormat || result == PrimitiveCacheResult_FileError)
+        LOG_ERROR("[PrimitiveCache] Failed to read the cache file, starting with an empty cache.");
+    return cache;
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyPrimitiveCache(PrimitiveCache* cache)
+{
+    if (cache)
+    {
+        delete cache;
+    }
+}
+
+// 与 BuildScenePrimitiveData 相同，内容未变的 mesh 直接从缓存文件拷贝
+UNITY_INTERFACE_EXPORT PrimitiveCacheBuildStats UNITY_INTERFACE_API BuildScenePrimitiveDataCached(PrimitiveCache* cache, const PrimitiveBuildDesc* descs,
+    uint32_t descCount, PrimitiveData* outPrimitives, uint32_t primitiveCapacity)
+{
+    if (!cache || !descs || !outPrimitives) return {};
+
+    PrimitiveCacheBuildStats stats = cache->Build(descs, descCount, outPrimitives, primitiveCapacity);
+    if (stats.invalidSubmeshCount > 0)
+        LOG_ERROR("[PrimitiveData] Some submeshes have out of range indices or offsets.");
+    return stats;
+}
+
+// 没有新增的 mesh 时不写文件；maxBytes 为 0 时不限制大小，可以在后台线程上调用
+UNITY_INTERFACE_EXPORT PrimitiveCacheSaveStats UNITY_INTERFACE_API SavePrimitiveCache(PrimitiveCache* cache, uint64_t maxBytes)
+{
+    if (!cache) return {};
+
+    PrimitiveCacheSaveStats stats = cache->Save(maxBytes);
+    if (stats.result != PrimitiveCacheResult_Ok)
+        LOG_ERROR("[PrimitiveCache] Save failed.");
+    return stats;
+}
+
+UNITY_INTERFACE_EXPORT PrimitiveCacheInfo UNITY_INTERFACE_API GetPrimitiveCacheInfo(PrimitiveCache* cache)
+{
+    if (!cache) return {};
+
+    return cache->GetInfo();
+}
+
+UNITY_INTERFACE_EXPORT CompactGeometryBuilder* UNITY_INTERFACE_API CreateCompactGeometryBuilder()
+{
+    return new CompactGeometryBuilder();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyCompactGeometryBuilder(CompactGeometryBuilder* builder)
+{
+    if (builder)
+    {
+        delete builder;
+    }
+}
+
+// descs 与 BuildScenePrimitiveData 相同；结果保存在 builder 中，由下面的函数取出后上传
+UNITY_INTERFACE_EXPORT CompactGeometryReport UNITY_INTERFACE_API BuildCompactGeometry(CompactGeometryBuilder* builder, const PrimitiveBuildDesc* descs,
+    uint32_t descCount, uint32_t triangleCapacity)
+{
+    if (!builder || !descs) return {};
+
+    CompactGeometryReport report = builder->Build(descs, descCount, triangleCapacity);
+    if (report.invalidSubmeshCount > 0)
+        LOG_ERROR("[CompactGeometry] Some submeshes have out of range indices or offsets.");
+    return report;
+}
+
+// report.vertexCount 个 CompactVertex
+UNITY_INTERFACE_EXPORT const CompactVertex* UNITY_INTERFACE_API GetCompactGeometryVertices(CompactGeometryBuilder* builder)
+{
+    if (!builder) return nullptr;
+
+    return builder->GetVertices();
+}
+
+// report.indexBytes 字节
+UNITY_INTERFACE_EXPORT const uint32_t* UNITY_INTERFACE_API GetCompactGeometryIndices(CompactGeometryBuilder* builder)
+{
+    if (!builder) return nullptr;
+
+    return builder->GetIndices();
+}
+
+// triangleCapacity 个 CompactTriangle
+UNITY_INTERFACE_EXPORT const CompactTriangle* UNITY_INTERFACE_API GetCompactGeometryTriangles(CompactGeometryBuilder* builder)
+{
+    if (!builder) return nullptr;
+
+    return builder->GetTriangles();
+}
+
+// 与 descs 一一对应
+UNITY_INTERFACE_EXPORT const CompactSubmesh* UNITY_INTERFACE_API GetCompactGeometrySubmeshes(CompactGeometryBuilder* builder)
+{
+    if (!builder) return nullptr;
+
+    return builder->GetSubmeshes();
+}
+
+// ================= InstanceTable =================
+UNITY_INTERFACE_EXPORT InstanceTable* UNITY_INTERFACE_API CreateInstanceTable()
+{
+    return new InstanceTable();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyInstanceTable(InstanceTable* table)
+{
+    if (table)
+    {
+        delete table;
+    }
+}
+
+// 返回 renderer 的第一行，即 RTAS 中的 InstanceID；submeshCount 为 0 时返回 0xFFFFFFFF
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API AddInstanceTableRenderer(InstanceTable* table, int32_t rendererId, uint32_t submeshCount, const InstanceData* rows)
+{
+    if (!table) return ~0u;
+    return table->AddRenderer(rendererId, submeshCount, rows);
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API RemoveInstanceTableRenderer(InstanceTable* table, int32_t rendererId)
+{
+    if (table) table->RemoveRenderer(rendererId);
+}
+
+// fieldMask 为 InstanceField 的组合，返回内容实际变化的行数
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API UpdateInstanceTableRows(InstanceTable* table, const uint32_t* rowIndices, const InstanceData* rows,
+    uint32_t count, uint32_t fieldMask)
+{
+    if (!table) return 0;
+    return table->UpdateRows(rowIndices, rows, count, fieldMask);
+}
+
+// 每帧上传前调用，之后按区间从 GetInstanceTableRows 拷贝到 GPU 缓冲
+UNITY_INTERFACE_EXPORT uint32_t UNITY_INTERFACE_API CollectInstanceTableDirtyRanges(InstanceTable* table, InstanceRowRange* outRanges, uint32_t maxRanges,
+    uint32_t mergeGap)
+{
+    if (!table) return 0;
+    return table->CollectDirtyRanges(outRanges, maxRanges, mergeGap);
+}
+
+// 在下一次 AddInstanceTableRenderer 之前有效，行数见 GetInstanceTableStats
+UNITY_INTERFACE_EXPORT const InstanceData* UNITY_INTERFACE_API GetInstanceTableRows(InstanceTable* table)
+{
+    if (!table) return nullptr;
+    return table->GetRows();
+}
+
+UNITY_INTERFACE_EXPORT InstanceTableStats UNITY_INTERFACE_API GetInstanceTableStats(InstanceTable* table)
+{
+    if (!table) return {};
+    return table->GetStats();
+}
+
+// GPU 缓冲重新分配后调用，下一次 Collect 返回整表
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API MarkInstanceTableDirty(InstanceTable* table)
+{
+    if (table) table->MarkAllDirty();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ClearInstanceTable(InstanceTable* table)
+{
+    if (table) table->Clear();
+}
+
+// 单线程模拟 instanceCount 行、movingFraction 的行每帧移动时 Update + Collect 的耗时和上传量
+// maxRanges 为 0 时与 PathTracingDataBuilder 相同，按脏行数准备区间数组
+UNITY_INTERFACE_EXPORT InstanceTableBenchmarkResult UNITY_INTERFACE_API BenchmarkInstanceTable(uint32_t instanceCount, float movingFraction,
+    uint32_t frameCount, uint32_t mergeGap, uint32_t maxRanges)
+{
+    return BenchmarkInstanceTableUpdates(instanceCount, movingFraction, frameCount, mergeGap, maxRanges);
+}
+
+// ================= TextureTable =================
+UNITY_INTERFACE_EXPORT TextureTable* UNITY_INTERFACE_API CreateTextureTable()
+{
+    return new TextureTable();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API DestroyTextureTable(TextureTable* table)
+{
+    if (table)
+    {
+        delete table;
+    }
+}
+
+// 一次登记场景中的全部材质，outGroupIndices 为 count 个组号；releaseUnlisted 非 0 时释放本次未列出的材质
+UNITY_INTERFACE_EXPORT TextureTableStats UNITY_INTERFACE_API UpdateTextureTable(TextureTable* table, const MaterialTextureDesc* materials, uint32_t count,
+    uint32_t* outGroupIndices, uint32_t releaseUnlisted)
+{
+    if (!table || (count > 0 && !materials)) return {};
+    return table->Update(materials, count, outGroupIndices, releaseUnlisted != 0);
+}
+
+UNITY_INTERFACE_EXPORT TextureTableStats UNITY_INTERFACE_API ReleaseTextureTableMaterials(TextureTable* table, const int32_t* materialIds, uint32_t count)
+{
+    if (!table || (count > 0 && !materialIds)) return {};
+    return table->ReleaseMaterials(materialIds, count);
+}
+
+// groupCapacity 个 TextureGroupKey，在下一次 Update 之前有效
+UNITY_INTERFACE_EXPORT const TextureGroupKey* UNITY_INTERFACE_API GetTextureTableGroups(TextureTable* table)
+{
+    if (!table) return nullptr;
+    return table->GetGroups();
+}
+
+// 最近一次 Update / ReleaseMaterials 中内容变化的 changedGroupCount 个组号，在下一次调用之前有效
+UNITY_INTERFACE_EXPORT const uint32_t* UNITY_INTERFACE_API GetTextureTableChangedGroups(TextureTable* table)
+{
+    if (!table) return nullptr;
+    return table->GetChangedGroups();
+}
+
+UNITY_INTERFACE_EXPORT TextureTableStats UNITY_INTERFACE_API GetTextureTableStats(TextureTable* table)
+{
+    if (!table) return {};
+    return table->GetStats();
+}
+
+UNITY_INTERFACE_EXPORT void UNITY_INTERFACE_API ClearTextureTable(TextureTable* table)
+{
+    if (table) table->Clear();
 }
 }
@@ -0,0 +1,529 @@
+﻿#include "ReGIRAutoSizing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <Rtxdi/LightSampling/RISBufferSegmentAllocator.h>
+
+#include "ParallelFor.h"
+#include "ResamplingConstants.h"
+
+namespace
+{
+    // 光源更多时等间隔抽样，计数按比例放大
+    constexpr uint32_t c_MaxSimulatedLights = 65536;
+    constexpr uint32_t c_MaxGridCellsPerAxis = 256;
+    constexpr uint32_t c_MaxOnionCoverageLayers = 64;
+    constexpr uint32_t c_LightsPerCellGranularity = 16;
+
+    // cellSize 按 2 的 1/4 次方递减扫描
+    constexpr uint32_t c_CellSizeStepsPerOctave = 4;
+    constexpr uint32_t c_GridCellSizeOctaves = 8; // 从一个 cell 覆盖全部光源到每轴 256 个 cell
+    constexpr uint32_t c_OnionCellSizeOctaves = 10;
+
+    constexpr float c_pi = 3.1415926535f;
+
+    struct ResolvedDesc
+    {
+        uint32_t bytesPerLightSlot;
+        uint32_t minLightsPerCell;
+        uint32_t maxLightsPerCell;
+        float occupancyPercentile;
+        float minSlotUtilization;
+    };
+
+    ResolvedDesc Resolve(const ReGIRAutoSizeDesc& desc)
+    {
+        ResolvedDesc resolved;
+        resolved.bytesPerLightSlot = desc.bytesPerLightSlot ? desc.bytesPerLightSlot : 8u;
+        resolved.minLightsPerCell = desc.minLightsPerCell ? desc.minLightsPerCell : 32u;
+        resolved.maxLightsPerCell = std::max(resolved.minLightsPerCell, desc.maxLightsPerCell ? desc.maxLightsPerCell : 1024u);
+        resolved.occupancyPercentile = desc.occupancyPercentile > 0.f ? std::min(desc.occupancyPercentile, 1.f) : 0.9f;
+        resolved.minSlotUtilization = desc.minSlotUtilization > 0.f ? std::min(desc.minSlotUtilization, 1.f) : 0.25f;
+        return resolved;
+    }
+
+    // 参与统计的光源，坐标相对 ReGIR 中心，SoA
+    struct SimulatedLights
+    {
+        std::vector<float> x, y, z;
+        float weight = 1.f; // 每个样本代表的光源数
+        uint32_t relevantLightCount = 0;
+        float maxOffset[3] = {}; // 各轴到中心的最大距离
+        float maxDistance = 0.f;
+    };
+
+    // viewDistance 以相机为准，坐标以 origin 为准，两者在 SimulateReGIROccupancy 中可以不同
+    SimulatedLights GatherLights(const ReGIRAutoSizeDesc& desc, const float* origin)
+    {
+        SimulatedLights lights;
+        if (!desc.lightPositions || desc.lightCount == 0)
+            return lights;
+
+        const uint32_t stride = desc.lightPositionStride ? desc.lightPositionStride : uint32_t(sizeof(float) * 3);
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(desc.lightPositions);
+        const float maxDistanceSq = desc.viewDistance * desc.viewDistance;
+
+        auto loadPosition = [&](uint32_t lightIndex, float* position)
+        {
+            memcpy(position, base + size_t(lightIndex) * stride, sizeof(float) * 3);
+            if (desc.viewDistance <= 0.f)
+                return true;
+
+            const float dx = position[0] - desc.cameraPosition[0];
+            const float dy = position[1] - desc.cameraPosition[1];
+            const float dz = position[2] - desc.cameraPosition[2];
+            return dx * dx + dy * dy + dz * dz <= maxDistanceSq;
+        };
+
+        float position[3];
+        for (uint32_t lightIndex = 0; lightIndex < desc.lightCount; lightIndex++)
+        {
+            if (!loadPosition(lightIndex, position))
+                continue;
+
+            const float dx = position[0] - origin[0];
+            const float dy = position[1] - origin[1];
+            const float dz = position[2] - origin[2];
+            lights.maxOffset[0] = std::max(lights.maxOffset[0], fabsf(dx));
+            lights.maxOffset[1] = std::max(lights.maxOffset[1], fabsf(dy));
+            lights.maxOffset[2] = std::max(lights.maxOffset[2], fabsf(dz));
+            lights.maxDistance = std::max(lights.maxDistance, sqrtf(dx * dx + dy * dy + dz * dz));
+            lights.relevantLightCount++;
+        }
+
+        if (lights.relevantLightCount == 0)
+            return lights;
+
+        const uint32_t step = (lights.relevantLightCount + c_MaxSimulatedLights - 1) / c_MaxSimulatedLights;
+        const uint32_t sampleCount = (lights.relevantLightCount + step - 1) / step;
+        lights.x.reserve(sampleCount);
+        lights.y.reserve(sampleCount);
+        lights.z.reserve(sampleCount);
+
+        uint32_t relevantIndex = 0;
+        for (uint32_t lightIndex = 0; lightIndex < desc.lightCount; lightIndex++)
+        {
+            if (!loadPosition(lightIndex, position))
+                continue;
+
+            if (relevantIndex++ % step != 0)
+                continue;
+
+            lights.x.push_back(position[0] - origin[0]);
+            lights.y.push_back(position[1] - origin[1]);
+            lights.z.push_back(position[2] - origin[2]);
+        }
+
+        lights.weight = float(lights.relevantLightCount) / float(lights.x.size());
+        return lights;
+    }
+
+    // 按 GPU 实际拿到的常量计算，onion 的半径已经乘过 cellSize
+    struct ReGIRLayout
+    {
+        ReGIR_Parameters params;
+        uint32_t cellCount;
+        uint32_t lightSlotCount;
+    };
+
+    ReGIRLayout BuildLayout(const rtxdi::ReGIRStaticParameters& staticParams, const rtxdi::ReGIRDynamicParameters& dynamicParams)
+    {
+        rtxdi::RISBufferSegmentAllocator allocator;
+        rtxdi::ReGIRContext context(staticParams, allocator);
+        context.SetDynamicParameters(dynamicParams);
+
+        ReGIRLayout layout;
+        memset(&layout.params, 0, sizeof(layout.params));
+        FillReGIRConstants(layout.params, context);
+        layout.cellCount = (staticParams.Mode == rtxdi::ReGIRMode::Grid)
+            ? staticParams.gridParameters.GridSize.x * staticParams.gridParameters.GridSize.y * staticParams.gridParameters.GridSize.z
+            : context.GetReGIROnionCalculatedParameters().regirOnionCells;
+        layout.lightSlotCount = context.GetReGIRLightSlotCount();
+        return layout;
+    }
+
+    // 与 ReGIR shader 相同的 cell 划分，(x, y, z) 相对中心，返回 -1 表示在 grid / onion 之外
+    int32_t GetCellIndex(rtxdi::ReGIRMode mode, const ReGIR_Parameters& params, float x, float y, float z)
+    {
+        if (mode == rtxdi::ReGIRMode::Grid)
+        {
+            const float invCellSize = 1.f / params.commonParams.cellSize;
+            const float gx = floorf(x * invCellSize + float(params.gridParams.cellsX) * 0.5f);
+            const float gy = floorf(y * invCellSize + float(params.gridParams.cellsY) * 0.5f);
+            const float gz = floorf(z * invCellSize + float(params.gridParams.cellsZ) * 0.5f);
+            if (gx < 0.f || gy < 0.f || gz < 0.f ||
+                gx >= float(params.gridParams.cellsX) || gy >= float(params.gridParams.cellsY) || gz >= float(params.gridParams.cellsZ))
+                return -1;
+
+            return int32_t(gx) + int32_t(gy) * int32_t(params.gridParams.cellsX) +
+                int32_t(gz) * int32_t(params.gridParams.cellsX * params.gridParams.cellsY);
+        }
+
+        const ReGIR_OnionParameters& onion = params.onionParams;
+        const float radius = sqrtf(x * x + y * y + z * z);
+        if (onion.numLayerGroups == 0 || radius < onion.layers[0].innerRadius)
+            return 0;
+
+        uint32_t groupIndex = 0;
+        while (groupIndex < onion.numLayerGroups && radius >= onion.layers[groupIndex].outerRadius)
+            groupIndex++;
+        if (groupIndex == onion.numLayerGroups)
+            return -1;
+
+        const ReGIR_OnionLayerGroup& group = onion.layers[groupIndex];
+        const int32_t layerIndex = std::min(std::max(int32_t(floorf(logf(radius / group.innerRadius) * group.invLogLayerScale)), 0), group.layerCount - 1);
+
+        const float elevation = asinf(std::min(std::max(y / radius, -1.f), 1.f));
+        const int32_t ringIndex = std::min(int32_t(floorf(fabsf(elevation) * group.invEquatorialCellAngle + 0.5f)), group.ringCount - 1);
+        const ReGIR_OnionRing& ring = onion.rings[group.ringOffset + ringIndex];
+
+        float azimuth = atan2f(z, x);
+        if (azimuth < 0.f)
+            azimuth += 2.f * c_pi;
+        int32_t cellIndex = std::min(int32_t(floorf(azimuth * ring.invCellAngle)), ring.cellCount - 1);
+        if (ringIndex > 0 && elevation < 0.f)
+            cellIndex += ring.cellCount;
+
+        return group.layerCellOffset + group.cellsPerLayer * layerIndex + ring.cellOffset + cellIndex;
+    }
+
+    // 非空 cell 的光源数（已乘抽样权重），升序
+    struct OccupancyScratch
+    {
+        std::vector<int32_t> cellIndices;
+        std::vector<float> occupancies;
+        uint32_t samplesOutside = 0;
+    };
+
+    void CountOccupancy(rtxdi::ReGIRMode mode, const ReGIR_Parameters& params, const SimulatedLights& lights, OccupancyScratch& scratch)
+    {
+        scratch.cellIndices.clear();
+        scratch.occupancies.clear();
+        scratch.samplesOutside = 0;
+
+        for (size_t i = 0; i < lights.x.size(); i++)
+        {
+            const int32_t cellIndex = GetCellIndex(mode, params, lights.x[i], lights.y[i], lights.z[i]);
+            if (cellIndex < 0)
+                scratch.samplesOutside++;
+            else
+                scratch.cellIndices.push_back(cellIndex);
+        }
+
+        std::sort(scratch.cellIndices.begin(), scratch.cellIndices.end());
+        for (size_t begin = 0; begin < scratch.cellIndices.size();)
+        {
+            size_t end = begin + 1;
+            while (end < scratch.cellIndices.size() && scratch.cellIndices[end] == scratch.cellIndices[begin])
+                end++;
+
+            scratch.occupancies.push_back(float(end - begin) * lights.weight);
+            begin = end;
+        }
+        std::sort(scratch.occupancies.begin(), scratch.occupancies.end());
+    }
+
+    ReGIROccupancyStats Summarize(const OccupancyScratch& scratch, const SimulatedLights& lights, uint32_t cellCount, uint32_t lightsPerCell)
+    {
+        ReGIROccupancyStats stats = {};
+        stats.cellCount = cellCount;
+        stats.occupiedCellCount = uint32_t(scratch.occupancies.size());
+        stats.lightsOutside = std::min(lights.relevantLightCount, uint32_t(lroundf(float(scratch.samplesOutside) * lights.weight)));
+        stats.lightsInside = lights.relevantLightCount - stats.lightsOutside;
+
+        double occupancySum = 0.0;
+        double usedSlots = 0.0;
+        for (float occupancy : scratch.occupancies)
+        {
+            occupancySum += occupancy;
+            usedSlots += std::min(occupancy, float(lightsPerCell));
+            if (occupancy > float(lightsPerCell))
+                stats.overloadedCellCount++;
+        }
+
+        if (!scratch.occupancies.empty())
+        {
+            stats.maxCellOccupancy = uint32_t(lroundf(scratch.occupancies.back()));
+            stats.meanOccupancy = float(occupancySum / double(scratch.occupancies.size()));
+        }
+
+        const double slotCount = double(cellCount) * double(lightsPerCell);
+        stats.slotUtilization = slotCount > 0.0 ? float(usedSlots / slotCount) : 0.f;
+        return stats;
+    }
+
+    // 取非空 cell 光源数的分位数，按 16 向上取整
+    uint32_t ChooseLightsPerCell(const OccupancyScratch& scratch, const ResolvedDesc& resolved)
+    {
+        if (scratch.occupancies.empty())
+            return resolved.minLightsPerCell;
+
+        const size_t index = size_t(resolved.occupancyPercentile * float(scratch.occupancies.size() - 1));
+        const uint32_t occupancy = uint32_t(ceilf(scratch.occupancies[index]));
+        const uint32_t lightsPerCell = (occupancy + c_LightsPerCellGranularity - 1) / c_LightsPerCellGranularity * c_LightsPerCellGranularity;
+        return std::min(std::max(lightsPerCell, resolved.minLightsPerCell), resolved.maxLightsPerCell);
+    }
+
+    struct Candidate
+    {
+        rtxdi::ReGIRStaticParameters staticParams;
+        rtxdi::ReGIRDynamicParameters dynamicParams;
+        bool feasible = false;
+        ReGIROccupancyStats occupancy = {};
+    };
+
+    float OverloadedFraction(const ReGIROccupancyStats& stats)
+    {
+        return stats.occupiedCellCount ? float(stats.overloadedCellCount) / float(stats.occupiedCellCount) : 0.f;
+    }
+
+    float OutsideFraction(const ReGIROccupancyStats& stats)
+    {
+        const uint32_t total = stats.lightsInside + stats.lightsOutside;
+        return total ? float(stats.lightsOutside) / float(total) : 0.f;
+    }
+
+    // cell 既不过载（超过 LightsPerCell 的非空 cell 不多于 1 - percentile），也不太空（槽位利用率不低于下限）
+    bool IsGoodCandidate(const Candidate& candidate, const ResolvedDesc& resolved)
+    {
+        const float tolerance = 1.f - resolved.occupancyPercentile + 1e-4f;
+        return candidate.feasible &&
+            OverloadedFraction(candidate.occupancy) <= tolerance &&
+            OutsideFraction(candidate.occupancy) <= tolerance &&
+            candidate.occupancy.slotUtilization >= resolved.minSlotUtilization;
+    }
+
+    float GetCandidateScore(const Candidate& candidate, const ResolvedDesc& resolved)
+    {
+        return (1.f - OverloadedFraction(candidate.occupancy)) * (1.f - OutsideFraction(candidate.occupancy)) *
+            std::min(1.f, candidate.occupancy.slotUtilization / resolved.minSlotUtilization);
+    }
+
+    // 满足条件的候选里取 cellSize 最小、其次槽位最少的，空间分辨率最高；都不满足时取得分最高的
+    const Candidate* SelectCandidate(const std::vector<Candidate>& candidates, const ResolvedDesc& resolved)
+    {
+        const Candidate* best = nullptr;
+        for (const Candidate& candidate : candidates)
+        {
+            if (!IsGoodCandidate(candidate, resolved))
+                continue;
+
+            if (!best || candidate.dynamicParams.regirCellSize < best->dynamicParams.regirCellSize ||
+                (candidate.dynamicParams.regirCellSize == best->dynamicParams.regirCellSize &&
+                 uint64_t(candidate.occupancy.cellCount) * candidate.staticParams.LightsPerCell < uint64_t(best->occupancy.cellCount) * best->staticParams.LightsPerCell))
+                best = &candidate;
+        }
+        if (best)
+            return best;
+
+        float bestScore = -1.f;
+        for (const Candidate& candidate : candidates)
+        {
+            if (!candidate.feasible)
+                continue;
+
+            const float score = GetCandidateScore(candidate, resolved);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = &candidate;
+            }
+        }
+        return best;
+    }
+
+    rtxdi::ReGIRDynamicParameters MakeDynamicParameters(float cellSize, const float* center)
+    {
+        rtxdi::ReGIRDynamicParameters dynamicParams;
+        dynamicParams.regirCellSize = cellSize;
+        dynamicParams.center = { center[0], center[1], center[2] };
+        return dynamicParams;
+    }
+
+    // 最后一组的外半径覆盖 range 所需的 coverage 层数
+    uint32_t GetOnionCoverageLayers(uint32_t detailLayers, float cellSize, float range)
+    {
+        rtxdi::ReGIRStaticParameters staticParams;
+        staticParams.Mode = rtxdi::ReGIRMode::Onion;
+        staticParams.LightsPerCell = 1;
+        staticParams.onionParameters.OnionDetailLayers = detailLayers;
+        staticParams.onionParameters.OnionCoverageLayers = 0;
+
+        rtxdi::RISBufferSegmentAllocator allocator;
+        rtxdi::ReGIRContext context(staticParams, allocator);
+        const rtxdi::ReGIROnionCalculatedParameters onion = context.GetReGIROnionCalculatedParameters();
+        if (onion.regirOnionLayers.empty())
+            return 0;
+
+        // FillReGIRConstants 把半径乘以 cellSize * 0.5
+        const ReGIR_OnionLayerGroup& lastGroup = onion.regirOnionLayers.back();
+        const float innerRadius = lastGroup.innerRadius * cellSize * 0.5f;
+        if (range <= innerRadius * lastGroup.layerScale)
+            return 0;
+
+        const float layers = ceilf(logf(range / innerRadius) / logf(lastGroup.layerScale));
+        return std::min(uint32_t(std::max(layers - 1.f, 0.f)), c_MaxOnionCoverageLayers);
+    }
+
+    void EvaluateCandidates(std::vector<Candidate>& candidates, const SimulatedLights& lights, const ResolvedDesc& resolved,
+                            uint64_t budgetSlots, bool chooseLightsPerCell)
+    {
+        ParallelFor(uint32_t(candidates.size()), 1, [&](uint32_t begin, uint32_t end)
+        {
+            OccupancyScratch scratch;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                Candidate& candidate = candidates[i];
+                const ReGIRLayout layout = BuildLayout(candidate.staticParams, candidate.dynamicParams);
+                CountOccupancy(candidate.staticParams.Mode, layout.params, lights, scratch);
+
+                if (chooseLightsPerCell)
+                {
+                    const uint64_t budgetLightsPerCell = layout.cellCount ? budgetSlots / layout.cellCount : 0;
+                    const uint32_t lightsPerCell = ChooseLightsPerCell(scratch, resolved);
+                    candidate.staticParams.LightsPerCell = uint32_t(std::min<uint64_t>(lightsPerCell, budgetLightsPerCell));
+                    candidate.feasible = budgetLightsPerCell >= resolved.minLightsPerCell &&
+                        uint64_t(layout.cellCount) * candidate.staticParams.LightsPerCell <= UINT32_MAX;
+                }
+                else
+                {
+                    candidate.feasible = true;
+                }
+
+                candidate.occupancy = Summarize(scratch, lights, layout.cellCount, std::max(candidate.staticParams.LightsPerCell, 1u));
+            }
+        });
+    }
+
+    ReGIRAutoSizeResult MakeResult(const Candidate* candidate, const ResolvedDesc& resolved, rtxdi::ReGIRMode mode)
+    {
+        ReGIRAutoSizeResult result = {};
+        result.staticParams.Mode = mode;
+        if (!candidate)
+            return result;
+
+        result.staticParams = candidate->staticParams;
+        result.dynamicParams = candidate->dynamicParams;
+        result.lightSlotCount = BuildLayout(candidate->staticParams, candidate->dynamicParams).lightSlotCount;
+        result.valid = candidate->feasible ? 1u : 0u;
+        result.sizeInBytes = uint64_t(result.lightSlotCount) * resolved.bytesPerLightSlot;
+        result.occupancy = candidate->occupancy;
+        return result;
+    }
+}
+
+ReGIRAutoSizeResult AutoSizeReGIR(const ReGIRAutoSizeDesc& desc)
+{
+    const ResolvedDesc resolved = Resolve(desc);
+    if (desc.mode != rtxdi::ReGIRMode::Grid && desc.mode != rtxdi::ReGIRMode::Onion)
+        return MakeResult(nullptr, resolved, desc.mode);
+
+    const SimulatedLights lights = GatherLights(desc, desc.cameraPosition);
+    const uint64_t budgetSlots = desc.memoryBudgetInBytes / resolved.bytesPerLightSlot;
+
+    std::vector<Candidate> candidates;
+    if (desc.mode == rtxdi::ReGIRMode::Grid)
+    {
+        // 略微放大，保证最远的光源落在 grid 内
+        const float extent = std::max(std::max(lights.maxOffset[0], lights.maxOffset[1]), lights.maxOffset[2]) * 1.001f;
+        const float coverExtent = extent > 0.f ? extent : 1.f;
+
+        for (uint32_t step = 0; step <= c_GridCellSizeOctaves * c_CellSizeStepsPerOctave; step++)
+        {
+            const float cellSize = 2.f * coverExtent * exp2f(-float(step) / float(c_CellSizeStepsPerOctave));
+
+            Candidate candidate;
+            candidate.staticParams.Mode = rtxdi::ReGIRMode::Grid;
+            candidate.staticParams.LightsPerCell = 1;
+            uint32_t* gridSize[3] = { &candidate.staticParams.gridParameters.GridSize.x,
+                &candidate.staticParams.gridParameters.GridSize.y, &candidate.staticParams.gridParameters.GridSize.z };
+            for (int axis = 0; axis < 3; axis++)
+            {
+                const float cells = ceilf(2.f * lights.maxOffset[axis] * 1.001f / cellSize);
+                *gridSize[axis] = std::min(std::max(uint32_t(cells), 1u), c_MaxGridCellsPerAxis);
+            }
+            candidate.dynamicParams = MakeDynamicParameters(cellSize, desc.cameraPosition);
+            candidates.push_back(candidate);
+        }
+    }
+    else
+    {
+        const float range = lights.maxDistance > 0.f ? lights.maxDistance * 1.001f : 1.f;
+
+        for (uint32_t detailLayers = 1; detailLayers <= RTXDI_ONION_MAX_LAYER_GROUPS; detailLayers++)
+        {
+            for (uint32_t step = 0; step <= c_OnionCellSizeOctaves * c_CellSizeStepsPerOctave; step++)
+            {
+                // 最大的 cellSize 让中心 cell 覆盖全部光源
+                const float cellSize = 2.f * range * exp2f(-float(step) / float(c_CellSizeStepsPerOctave));
+
+                Candidate candidate;
+                candidate.staticParams.Mode = rtxdi::ReGIRMode::Onion;
+                candidate.staticParams.LightsPerCell = 1;
+                candidate.staticParams.onionParameters.OnionDetailLayers = detailLayers;
+                candidate.staticParams.onionParameters.OnionCoverageLayers = GetOnionCoverageLayers(detailLayers, cellSize, range);
+                candidate.dynamicParams = MakeDynamicParameters(cellSize, desc.cameraPosition);
+                candidates.push_back(candidate);
+            }
+        }
+    }
+
+    EvaluateCandidates(candidates, lights, resolved, budgetSlots, true);
+    return MakeResult(SelectCandidate(candidates, resolved), resolved, desc.mode);
+}
+
+ReGIRAutoSizeResult FitReGIRCellSize(const ReGIRAutoSizeDesc& desc, const rtxdi::ReGIRStaticParameters& staticParams)
+{
+    const ResolvedDesc resolved = Resolve(desc);
+    if (staticParams.Mode != rtxdi::ReGIRMode::Grid && staticParams.Mode != rtxdi::ReGIRMode::Onion)
+        return MakeResult(nullptr, resolved, staticParams.Mode);
+
+    const SimulatedLights lights = GatherLights(desc, desc.cameraPosition);
+
+    // 从最小的一维刚好覆盖全部光源开始缩小，grid 的维数和 onion 的层数都不变
+    float maxCellSize;
+    uint32_t octaves;
+    if (staticParams.Mode == rtxdi::ReGIRMode::Grid)
+    {
+        const rtxdi::uint3& gridSize = staticParams.gridParameters.GridSize;
+        const float extent = std::max(std::max(lights.maxOffset[0], lights.maxOffset[1]), lights.maxOffset[2]) * 1.001f;
+        const uint32_t minGridSize = std::max(std::min(std::min(gridSize.x, gridSize.y), gridSize.z), 1u);
+        maxCellSize = 2.f * (extent > 0.f ? extent : 1.f) / float(minGridSize);
+        octaves = c_GridCellSizeOctaves;
+    }
+    else
+    {
+        maxCellSize = 2.f * (lights.maxDistance > 0.f ? lights.maxDistance * 1.001f : 1.f);
+        octaves = c_OnionCellSizeOctaves;
+    }
+
+    std::vector<Candidate> candidates;
+    for (uint32_t step = 0; step <= octaves * c_CellSizeStepsPerOctave; step++)
+    {
+        Candidate candidate;
+        candidate.staticParams = staticParams;
+        candidate.dynamicParams = MakeDynamicParameters(maxCellSize * exp2f(-float(step) / float(c_CellSizeStepsPerOctave)), desc.cameraPosition);
+        candidates.push_back(candidate);
+    }
+
+    EvaluateCandidates(candidates, lights, resolved, 0, false);
+    return MakeResult(SelectCandidate(candidates, resolved), resolved, staticParams.Mode);
+}
+
+ReGIROccupancyStats SimulateReGIROccupancy(const ReGIRAutoSizeDesc& desc, const rtxdi::ReGIRStaticParameters& staticParams,
+                                           const rtxdi::ReGIRDynamicParameters& dynamicParams)
+{
+    if (staticParams.Mode != rtxdi::ReGIRMode::Grid && staticParams.Mode != rtxdi::ReGIRMode::Onion)
+        return {};
+
+    const float center[3] = { dynamicParams.center.x, dynamicParams.center.y, dynamicParams.center.z };
+    const SimulatedLights lights = GatherLights(desc, center);
+    const ReGIRLayout layout = BuildLayout(staticParams, dynamicParams);
+
+    OccupancyScratch scratch;
+    CountOccupancy(staticParams.Mode, layout.params, lights, scratch);
+    return Summarize(scratch, lights, layout.cellCount, std::max(staticParams.LightsPerCell, 1u));
+}
@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include <Rtxdi/ReGIR/ReGIR.h>
+
+// ReGIR 的 grid / onion 尺寸原本在创建时写死，场景大、光源分布不均时 cell 要么几乎是空的，要么远远装不下
+// 这里按光源位置、相机位置和内存预算在 CPU 上模拟每个 cell 的光源数，挑选 GridSize / onion 层数、cellSize 和 LightsPerCell
+struct ReGIRAutoSizeDesc
+{
+    const float* lightPositions;    // 世界空间 float3
+    uint32_t lightCount;
+    uint32_t lightPositionStride;   // 字节，0 表示紧密排列；传 sizeof(RAB_LightInfo) 可以直接用光源缓冲的 center
+    float cameraPosition[3];        // 作为 ReGIR 的中心
+    float viewDistance;             // 只统计这个距离内的光源，0 表示全部
+
+    uint64_t memoryBudgetInBytes;   // RIS 缓冲中 ReGIR 部分的上限
+    rtxdi::ReGIRMode mode;          // Grid 或 Onion
+    uint32_t bytesPerLightSlot;     // 0 表示 8（RIS 缓冲的 uint2），同时使用压缩光源数据时再加 32
+    uint32_t minLightsPerCell;      // 0 表示 32
+    uint32_t maxLightsPerCell;      // 0 表示 1024
+    float occupancyPercentile;      // LightsPerCell 至少装下这个比例的非空 cell，0 表示 0.9
+    float minSlotUtilization;       // 低于这个比例认为 cell 太空，0 表示 0.25
+};
+
+struct ReGIROccupancyStats
+{
+    uint32_t cellCount;
+    uint32_t occupiedCellCount;
+    uint32_t overloadedCellCount;   // 光源数超过 LightsPerCell 的 cell
+    uint32_t maxCellOccupancy;
+    uint32_t lightsInside;
+    uint32_t lightsOutside;         // 在 grid / onion 之外，只能走 fallback 采样
+    float meanOccupancy;            // 非空 cell 的平均光源数
+    float slotUtilization;          // sum(min(光源数, LightsPerCell)) / lightSlotCount
+};
+
+struct ReGIRAutoSizeResult
+{
+    rtxdi::ReGIRStaticParameters staticParams;
+    rtxdi::ReGIRDynamicParameters dynamicParams; // 只设置 regirCellSize 和 center，其余为默认值
+    uint32_t lightSlotCount;        // 与 ReGIRContext::GetReGIRLightSlotCount 一致，即 RIS 缓冲需要的槽位数
+    uint32_t valid;                 // 0 表示预算内找不到可用的配置
+    uint64_t sizeInBytes;
+    ReGIROccupancyStats occupancy;
+};
+
+// 选择静态参数和 cellSize，用于创建 ImportanceSamplingContext
+ReGIRAutoSizeResult AutoSizeReGIR(const ReGIRAutoSizeDesc& desc);
+
+// 静态参数不变，只按当前相机位置重新选择 cellSize，结果通过 SetReGIRDynamicParameters 生效
+// desc 中的预算和 LightsPerCell 范围不起作用；相机移动较大距离或光源变化较多时调用，不需要每帧调用
+ReGIRAutoSizeResult FitReGIRCellSize(const ReGIRAutoSizeDesc& desc, const rtxdi::ReGIRStaticParameters& staticParams);
+
+// 统计给定参数下每个 cell 的光源数，cell 的划分方式与 ReGIR shader 相同
+ReGIROccupancyStats SimulateReGIROccupancy(const ReGIRAutoSizeDesc& desc, const rtxdi::ReGIRStaticParameters& staticParams,
+                                           const rtxdi::ReGIRDynamicParameters& dynamicParams);
@@ -0,0 +1,280 @@
+﻿#include "ReSTIRDIGovernor.h"
+
+#include <algorithm>
+
+namespace
+{
+    bool UsesTemporalPass(rtxdi::ReSTIRDI_ResamplingMode mode)
+    {
+        return mode == rtxdi::ReSTIRDI_ResamplingMode::Temporal ||
+            mode == rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial ||
+            mode == rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal;
+    }
+
+    bool UsesSpatialSamples(rtxdi::ReSTIRDI_ResamplingMode mode)
+    {
+        return mode == rtxdi::ReSTIRDI_ResamplingMode::Spatial ||
+            mode == rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial ||
+            mode == rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal;
+    }
+
+    uint32_t GetInitialSampleCount(const ReSTIRDIGovernorLevel& level)
+    {
+        return level.numPrimaryLocalLightSamples + level.numPrimaryInfiniteLightSamples +
+            level.numPrimaryEnvironmentSamples + level.numPrimaryBrdfSamples;
+    }
+
+    uint32_t Halve(uint32_t value, uint32_t minValue)
+    {
+        return std::max(value / 2, std::min(value, minValue));
+    }
+
+    // 开销依次递减的 resampling 模式，None 不在其中：没有任何复用时画面质量下降太多
+    rtxdi::ReSTIRDI_ResamplingMode GetCheaperMode(rtxdi::ReSTIRDI_ResamplingMode mode)
+    {
+        switch (mode)
+        {
+        case rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial:
+            return rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal;
+        case rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal:
+            return rtxdi::ReSTIRDI_ResamplingMode::Temporal;
+        default:
+            return mode;
+        }
+    }
+
+    bool operator==(const ReSTIRDIGovernorLevel& a, const ReSTIRDIGovernorLevel& b)
+    {
+        return a.resamplingMode == b.resamplingMode &&
+            a.numPrimaryLocalLightSamples == b.numPrimaryLocalLightSamples &&
+            a.numPrimaryInfiniteLightSamples == b.numPrimaryInfiniteLightSamples &&
+            a.numPrimaryEnvironmentSamples == b.numPrimaryEnvironmentSamples &&
+            a.numPrimaryBrdfSamples == b.numPrimaryBrdfSamples &&
+            a.numSpatialSamples == b.numSpatialSamples &&
+            a.numDisocclusionBoostSamples == b.numDisocclusionBoostSamples;
+    }
+
+    // 先交替减半空间采样和局部光源采样，再减半其余初始采样，最后降级模式
+    std::vector<ReSTIRDIGovernorLevel> BuildLevels(const ReSTIRDIGovernorLevel& baseLevel, bool allowModeChanges)
+    {
+        std::vector<ReSTIRDIGovernorLevel> levels = { baseLevel };
+
+        auto push = [&levels](const ReSTIRDIGovernorLevel& level)
+        {
+            if (!(level == levels.back()))
+                levels.push_back(level);
+        };
+
+        ReSTIRDIGovernorLevel level = baseLevel;
+        while (true)
+        {
+            const ReSTIRDIGovernorLevel before = level;
+
+            if (UsesSpatialSamples(level.resamplingMode) && level.numSpatialSamples > 1)
+            {
+                level.numSpatialSamples = Halve(level.numSpatialSamples, 1);
+                level.numDisocclusionBoostSamples = Halve(level.numDisocclusionBoostSamples, 1);
+                push(level);
+            }
+
+            if (level.numPrimaryLocalLightSamples > 1)
+            {
+                level.numPrimaryLocalLightSamples = Halve(level.numPrimaryLocalLightSamples, 1);
+                push(level);
+            }
+
+            if (level == before)
+                break;
+        }
+
+        while (level.numPrimaryBrdfSamples > 0 || level.numPrimaryInfiniteLightSamples > 1 || level.numPrimaryEnvironmentSamples > 1)
+        {
+            level.numPrimaryBrdfSamples = level.numPrimaryBrdfSamples > 1 ? level.numPrimaryBrdfSamples / 2 : 0;
+            level.numPrimaryInfiniteLightSamples = Halve(level.numPrimaryInfiniteLightSamples, 1);
+            level.numPrimaryEnvironmentSamples = Halve(level.numPrimaryEnvironmentSamples, 1);
+            push(level);
+        }
+
+        if (allowModeChanges)
+        {
+            for (rtxdi::ReSTIRDI_ResamplingMode mode = GetCheaperMode(level.resamplingMode); mode != level.resamplingMode; mode = GetCheaperMode(mode))
+            {
+                level.resamplingMode = mode;
+                push(level);
+            }
+        }
+
+        return levels;
+    }
+
+    ReSTIRDIGovernorSettings ResolveSettings(const ReSTIRDIGovernorSettings& settings)
+    {
+        ReSTIRDIGovernorSettings resolved = settings;
+        if (resolved.upperTolerance <= 0.f) resolved.upperTolerance = 0.05f;
+        if (resolved.lowerTolerance <= 0.f) resolved.lowerTolerance = 0.2f;
+        if (resolved.smoothing <= 0.f || resolved.smoothing > 1.f) resolved.smoothing = 0.2f;
+        if (resolved.downFrames == 0) resolved.downFrames = 3;
+        if (resolved.upFrames == 0) resolved.upFrames = 30;
+        return resolved;
+    }
+}
+
+ReSTIRDIBudgetGovernor::ReSTIRDIBudgetGovernor(const ReSTIRDIGovernorLevel& baseLevel, const ReSTIRDIGovernorSettings& settings) :
+    m_settings(ResolveSettings(settings))
+{
+    Reset(baseLevel);
+}
+
+ReSTIRDIGovernorLevel ReSTIRDIBudgetGovernor::GetContextLevel(const rtxdi::ReSTIRDIContext& context)
+{
+    const ReSTIRDI_InitialSamplingParameters initialParams = context.GetInitialSamplingParameters();
+    const ReSTIRDI_SpatialResamplingParameters spatialParams = context.GetSpatialResamplingParameters();
+
+    ReSTIRDIGovernorLevel level = {};
+    level.resamplingMode = context.GetResamplingMode();
+    level.numPrimaryLocalLightSamples = initialParams.numPrimaryLocalLightSamples;
+    level.numPrimaryInfiniteLightSamples = initialParams.numPrimaryInfiniteLightSamples;
+    level.numPrimaryEnvironmentSamples = initialParams.numPrimaryEnvironmentSamples;
+    level.numPrimaryBrdfSamples = initialParams.numPrimaryBrdfSamples;
+    level.numSpatialSamples = spatialParams.numSpatialSamples;
+    level.numDisocclusionBoostSamples = spatialParams.numDisocclusionBoostSamples;
+    return level;
+}
+
+void ReSTIRDIBudgetGovernor::Reset(const ReSTIRDIGovernorLevel& baseLevel)
+{
+    m_levels = BuildLevels(baseLevel, m_settings.allowModeChanges != 0);
+    m_level = 0;
+    m_hasTimings = false;
+    m_smoothedMs = 0.f;
+    m_overBudgetFrames = 0;
+    m_headroomFrames = 0;
+    m_initialMsPerSample = 0.f;
+    m_temporalMs = 0.f;
+    m_spatialMsPerSample = 0.f;
+    m_shadingMs = 0.f;
+}
+
+float ReSTIRDIBudgetGovernor::PredictMs(const ReSTIRDIGovernorLevel& level) const
+{
+    float ms = m_initialMsPerSample * float(GetInitialSampleCount(level)) + m_shadingMs;
+    if (UsesTemporalPass(level.resamplingMode))
+        ms += m_temporalMs;
+    // Fused 的空间部分在合并 pass 里，按独立 pass 的单价估算偏保守，只会让升档更谨慎
+    if (UsesSpatialSamples(level.resamplingMode))
+        ms += m_spatialMsPerSample * float(level.numSpatialSamples);
+    return ms;
+}
+
+ReSTIRDIGovernorDecision ReSTIRDIBudgetGovernor::Update(const ReSTIRDIPassTimings& timings)
+{
+    const ReSTIRDIGovernorLevel& current = m_levels[m_level];
+    const float measuredMs = timings.initialSamplingMs + timings.temporalResamplingMs + timings.spatialResamplingMs + timings.shadingMs;
+
+    ReSTIRDIGovernorDecision decision = {};
+    decision.levelCount = uint32_t(m_levels.size());
+    decision.measuredMs = measuredMs;
+    decision.targetMs = m_settings.targetMs;
+
+    if (measuredMs <= 0.f || m_settings.targetMs <= 0.f)
+    {
+        decision.level = m_level;
+        decision.reason = ReSTIRDIGovernorReason_Warmup;
+        decision.smoothedMs = m_smoothedMs;
+        decision.predictedMs = m_smoothedMs;
+        decision.config = current;
+        return decision;
+    }
+
+    // 单位开销也做平滑，只在对应 pass 运行时更新，切到不用该 pass 的档位后保留最后的估计
+    const float alpha = m_hasTimings ? m_settings.smoothing : 1.f;
+    auto blend = [alpha](float& value, float sample) { value += (sample - value) * alpha; };
+
+    blend(m_smoothedMs, measuredMs);
+    blend(m_initialMsPerSample, timings.initialSamplingMs / float(std::max(GetInitialSampleCount(current), 1u)));
+    blend(m_shadingMs, timings.shadingMs);
+    if (UsesTemporalPass(current.resamplingMode))
+        blend(m_temporalMs, timings.temporalResamplingMs);
+    if (UsesSpatialSamples(current.resamplingMode) && current.resamplingMode != rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal)
+        blend(m_spatialMsPerSample, timings.spatialResamplingMs / float(std::max(current.numSpatialSamples, 1u)));
+    m_hasTimings = true;
+
+    const float upperMs = m_settings.targetMs * (1.f + m_settings.upperTolerance);
+    const float lowerMs = m_settings.targetMs * (1.f - m_settings.lowerTolerance);
+
+    m_overBudgetFrames = m_smoothedMs > upperMs ? m_overBudgetFrames + 1 : 0;
+    m_headroomFrames = m_smoothedMs < lowerMs ? m_headroomFrames + 1 : 0;
+
+    const uint32_t previousLevel = m_level;
+    decision.reason = ReSTIRDIGovernorReason_Hold;
+    decision.predictedMs = m_smoothedMs;
+
+    if (m_overBudgetFrames >= m_settings.downFrames)
+    {
+        if (m_level + 1 < m_levels.size())
+        {
+            // 直接跳到预计能满足预算的档位，至少降一档
+            uint32_t level = m_level + 1;
+            while (level + 1 < m_levels.size() && PredictMs(m_levels[level]) > m_settings.targetMs)
+                level++;
+
+            m_level = level;
+            decision.reason = ReSTIRDIGovernorReason_OverBudget;
+        }
+        else
+        {
+            decision.reason = ReSTIRDIGovernorReason_AtLimit;
+        }
+    }
+    else if (m_headroomFrames >= m_settings.upFrames)
+    {
+        if (m_level > 0)
+        {
+            // 升档后预计仍在预算内才升，否则保持，避免在两档之间来回切换
+            if (PredictMs(m_levels[m_level - 1]) <= m_settings.targetMs)
+            {
+                m_level--;
+                decision.reason = ReSTIRDIGovernorReason_Headroom;
+            }
+        }
+        else
+        {
+            decision.reason = ReSTIRDIGovernorReason_AtLimit;
+        }
+    }
+
+    if (m_level != previousLevel)
+    {
+        m_overBudgetFrames = 0;
+        m_headroomFrames = 0;
+        decision.predictedMs = PredictMs(m_levels[m_level]);
+        // 新档位的实际耗时还没测到，先用估计值，避免旧的平均值立刻触发下一次调整
+        m_smoothedMs = decision.predictedMs;
+    }
+
+    decision.level = m_level;
+    decision.levelChange = int32_t(m_level) - int32_t(previousLevel);
+    decision.smoothedMs = m_smoothedMs;
+    decision.config = m_levels[m_level];
+    return decision;
+}
+
+void ReSTIRDIBudgetGovernor::Apply(rtxdi::ReSTIRDIContext& context) const
+{
+    const ReSTIRDIGovernorLevel& level = m_levels[m_level];
+
+    ReSTIRDI_InitialSamplingParameters initialParams = context.GetInitialSamplingParameters();
+    initialParams.numPrimaryLocalLightSamples = level.numPrimaryLocalLightSamples;
+    initialParams.numPrimaryInfiniteLightSamples = level.numPrimaryInfiniteLightSamples;
+    initialParams.numPrimaryEnvironmentSamples = level.numPrimaryEnvironmentSamples;
+    initialParams.numPrimaryBrdfSamples = level.numPrimaryBrdfSamples;
+    context.SetInitialSamplingParameters(initialParams);
+
+    ReSTIRDI_SpatialResamplingParameters spatialParams = context.GetSpatialResamplingParameters();
+    spatialParams.numSpatialSamples = level.numSpatialSamples;
+    spatialParams.numDisocclusionBoostSamples = level.numDisocclusionBoostSamples;
+    context.SetSpatialResamplingParameters(spatialParams);
+
+    if (context.GetResamplingMode() != level.resamplingMode)
+        context.SetResamplingMode(level.resamplingMode);
+}
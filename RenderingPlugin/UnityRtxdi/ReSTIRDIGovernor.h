@@ -0,0 +1,105 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Rtxdi/DI/ReSTIRDI.h>
+
+// 每帧 GPU 上测得的 ReSTIR DI 各 pass 耗时，没有运行的 pass 填 0
+// FusedSpatiotemporal 模式下合并 pass 的耗时填在 temporalResamplingMs
+struct ReSTIRDIPassTimings
+{
+    float initialSamplingMs;
+    float temporalResamplingMs;
+    float spatialResamplingMs;
+    float shadingMs;
+};
+
+// 数值为 0 时使用默认值
+struct ReSTIRDIGovernorSettings
+{
+    float targetMs;                 // DI 各 pass 总耗时的目标
+    float upperTolerance;           // 超过 target * (1 + upper) 视为超预算，默认 0.05
+    float lowerTolerance;           // 低于 target * (1 - lower) 才考虑升档，默认 0.2
+    float smoothing;                // 耗时的指数平均系数，默认 0.2
+    uint32_t downFrames;            // 连续超预算这么多帧才降档，默认 3
+    uint32_t upFrames;              // 连续有余量这么多帧才升档，默认 30
+    uint32_t allowModeChanges;      // 采样数降到最低后继续降级 resampling 模式
+    uint32_t pad1;
+};
+
+// 一档的采样配置，第 0 档是创建时 context 的配置，档位越高开销越低
+struct ReSTIRDIGovernorLevel
+{
+    rtxdi::ReSTIRDI_ResamplingMode resamplingMode;
+    uint32_t numPrimaryLocalLightSamples;
+    uint32_t numPrimaryInfiniteLightSamples;
+    uint32_t numPrimaryEnvironmentSamples;
+    uint32_t numPrimaryBrdfSamples;
+    uint32_t numSpatialSamples;
+    uint32_t numDisocclusionBoostSamples;
+    uint32_t pad1;
+};
+
+enum ReSTIRDIGovernorReason : uint32_t
+{
+    ReSTIRDIGovernorReason_Hold = 0,
+    ReSTIRDIGovernorReason_Warmup = 1,      // 还没有耗时数据
+    ReSTIRDIGovernorReason_OverBudget = 2,  // 降档
+    ReSTIRDIGovernorReason_Headroom = 3,    // 升档
+    ReSTIRDIGovernorReason_AtLimit = 4,     // 需要调整但已经是最高或最低档
+};
+
+// 每帧的决策，可以直接写日志
+struct ReSTIRDIGovernorDecision
+{
+    uint32_t level;
+    uint32_t levelCount;
+    int32_t levelChange;
+    ReSTIRDIGovernorReason reason;
+    float measuredMs;
+    float smoothedMs;
+    float predictedMs;              // 按当前单位开销估算的新档位耗时
+    float targetMs;
+    ReSTIRDIGovernorLevel config;
+};
+
+// 按帧耗时在预先排好的档位间移动，降档可以一次跨多档，升档每次一档，两个方向的阈值和等待帧数不同以避免来回跳
+// 控制逻辑只依赖传入的耗时，可以用合成的耗时序列离线测试；Apply 把当前档位写回 context
+class ReSTIRDIBudgetGovernor
+{
+public:
+    ReSTIRDIBudgetGovernor(const ReSTIRDIGovernorLevel& baseLevel, const ReSTIRDIGovernorSettings& settings);
+
+    static ReSTIRDIGovernorLevel GetContextLevel(const rtxdi::ReSTIRDIContext& context);
+
+    ReSTIRDIGovernorDecision Update(const ReSTIRDIPassTimings& timings);
+
+    // 只改动采样数和 resampling 模式，其余参数保持 context 当前的值
+    void Apply(rtxdi::ReSTIRDIContext& context) const;
+
+    // 以新的配置为第 0 档重新开始，例如用户在设置里改了采样数
+    void Reset(const ReSTIRDIGovernorLevel& baseLevel);
+
+    const ReSTIRDIGovernorLevel& GetCurrentLevel() const { return m_levels[m_level]; }
+    uint32_t GetLevelIndex() const { return m_level; }
+    uint32_t GetLevelCount() const { return uint32_t(m_levels.size()); }
+
+private:
+    float PredictMs(const ReSTIRDIGovernorLevel& level) const;
+
+    ReSTIRDIGovernorSettings m_settings;
+    std::vector<ReSTIRDIGovernorLevel> m_levels;
+    uint32_t m_level = 0;
+
+    bool m_hasTimings = false;
+    float m_smoothedMs = 0.f;
+    uint32_t m_overBudgetFrames = 0;
+    uint32_t m_headroomFrames = 0;
+
+    // 单位开销，由各 pass 的耗时除以当前档位的采样数得到，切换档位后用来估算新档位
+    float m_initialMsPerSample = 0.f;
+    float m_temporalMs = 0.f;
+    float m_spatialMsPerSample = 0.f;
+    float m_shadingMs = 0.f;
+};
@@ -0,0 +1,702 @@
+﻿#include "ReSTIRDIReference.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <Rtxdi/RtxdiUtils.h>
+
+#include "ParallelFor.h"
+#include "SamplingTables.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RESTIR_REFERENCE_USE_SSE 1
+#else
+#define RESTIR_REFERENCE_USE_SSE 0
+#endif
+
+namespace
+{
+    constexpr uint32_t c_MinRowsPerBatch = 8;
+    constexpr uint32_t c_BoilingFilterGroupSize = 8;
+    constexpr float c_CameraHeight = 15.f;
+    constexpr float c_SceneHalfWidth = 10.f;
+
+    // xorshift32，SIMD 版本与标量版本逐位一致
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return float(NextRandom(state) >> 8) * (1.f / 16777216.f);
+    }
+
+    uint32_t InitRandom(uint32_t pixel, uint32_t passSeed)
+    {
+        return rtxdi::JenkinsHash(pixel + passSeed) | 1u;
+    }
+
+    uint32_t GetPassSeed(uint32_t frameIndex, uint32_t pass)
+    {
+        return rtxdi::JenkinsHash(frameIndex * 4 + pass);
+    }
+
+    bool UsesPowerSampling(ReSTIRDI_LocalLightSamplingMode mode)
+    {
+        return mode != ReSTIRDI_LocalLightSamplingMode::Uniform;
+    }
+
+    bool IsTemporalMode(rtxdi::ReSTIRDI_ResamplingMode mode)
+    {
+        return mode == rtxdi::ReSTIRDI_ResamplingMode::Temporal ||
+               mode == rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial ||
+               mode == rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal;
+    }
+
+    bool IsSpatialMode(rtxdi::ReSTIRDI_ResamplingMode mode)
+    {
+        return mode == rtxdi::ReSTIRDI_ResamplingMode::Spatial ||
+               mode == rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial ||
+               mode == rtxdi::ReSTIRDI_ResamplingMode::FusedSpatiotemporal;
+    }
+
+    // Uniform 模式均匀采样，其余模式都按功率采样（GPU 上是 RIS 预采样或别名表，分布相同）
+    uint32_t SampleLight(const std::vector<RTXDI_AliasTableEntry>& aliasTable, bool powerSampling, float u0, float u1, float& outInvSourcePdf)
+    {
+        const uint32_t lightCount = uint32_t(aliasTable.size());
+        const uint32_t index = std::min(uint32_t(u0 * float(lightCount)), lightCount - 1);
+        if (!powerSampling)
+        {
+            outInvSourcePdf = float(lightCount);
+            return index;
+        }
+
+        const RTXDI_AliasTableEntry& entry = aliasTable[index];
+        if (u1 < entry.probability)
+        {
+            outInvSourcePdf = 1.f / entry.pdf;
+            return index;
+        }
+        outInvSourcePdf = 1.f / entry.aliasPdf;
+        return entry.alias;
+    }
+
+    // 与 RTXDI_StreamSample / RTXDI_CombineDIReservoirs / RTXDI_FinalizeResampling 相同
+    template <typename Reservoir>
+    bool StreamSample(Reservoir& state, uint32_t lightIndex, float targetPdf, float risWeight, uint32_t M, float random)
+    {
+        state.M += M;
+        state.weightSum += risWeight;
+        if (random * state.weightSum < risWeight)
+        {
+            state.lightIndex = lightIndex;
+            state.targetPdf = targetPdf;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Reservoir>
+    void FinalizeResampling(Reservoir& state, float normalizationNumerator, float normalizationDenominator)
+    {
+        const float denominator = state.targetPdf * normalizationDenominator;
+        state.weightSum = (denominator == 0.f) ? 0.f : (state.weightSum * normalizationNumerator) / denominator;
+    }
+
+    // 两个采样域之间的 balance heuristic，返回 neighbor 一侧的权重
+    float PairwiseMisWeight(float neighborConfidence, float neighborPdf, float canonicalConfidence, float canonicalPdf)
+    {
+        const float neighbor = neighborConfidence * neighborPdf;
+        const float denominator = neighbor + canonicalConfidence * canonicalPdf;
+        return denominator > 0.f ? neighbor / denominator : 0.f;
+    }
+}
+
+ReSTIRDIReferenceParameters ReSTIRDIReferenceParameters::FromContext(const rtxdi::ReSTIRDIContext& context)
+{
+    ReSTIRDIReferenceParameters params;
+    params.resamplingMode = context.GetResamplingMode();
+    params.neighborOffsetCount = context.GetStaticParameters().NeighborOffsetCount;
+    params.initialSamplingParams = context.GetInitialSamplingParameters();
+    params.temporalResamplingParams = context.GetTemporalResamplingParameters();
+    params.spatialResamplingParams = context.GetSpatialResamplingParameters();
+    return params;
+}
+
+ReSTIRDIReference::ReSTIRDIReference(const ReSTIRDIReferenceSceneDesc& desc) :
+    m_desc(desc)
+{
+    m_desc.width = std::max(1u, desc.width);
+    m_desc.height = std::max(1u, desc.height);
+    m_desc.lightCount = std::max(1u, desc.lightCount);
+
+    m_pixelCount = m_desc.width * m_desc.height;
+    m_paddedPixelCount = (m_pixelCount + 3) & ~3u;
+
+    for (std::vector<float>* channel : { &m_positionX, &m_positionY, &m_positionZ, &m_normalX, &m_normalY, &m_normalZ, &m_depth })
+        channel->assign(m_paddedPixelCount, 0.f);
+    std::fill(m_normalY.begin(), m_normalY.end(), 1.f);
+
+    // 正交相机从 y = c_CameraHeight 向下看，x 覆盖 [-10, 10]，z 按宽高比缩放
+    const float halfDepth = c_SceneHalfWidth * float(m_desc.height) / float(m_desc.width);
+    for (uint32_t pixel = 0; pixel < m_pixelCount; pixel++)
+    {
+        const float x = ((float(pixel % m_desc.width) + 0.5f) / float(m_desc.width) * 2.f - 1.f) * c_SceneHalfWidth;
+        const float z = ((float(pixel / m_desc.width) + 0.5f) / float(m_desc.height) * 2.f - 1.f) * halfDepth;
+
+        float height = 0.4f * sinf(0.7f * x) * cosf(0.5f * z);
+        float dhdx = 0.28f * cosf(0.7f * x) * cosf(0.5f * z);
+        float dhdz = -0.2f * sinf(0.7f * x) * sinf(0.5f * z);
+        if (fabsf(x) < 3.f && fabsf(z) < 3.f)
+        {
+            height = 2.f;
+            dhdx = dhdz = 0.f;
+        }
+
+        const float invLength = 1.f / sqrtf(dhdx * dhdx + 1.f + dhdz * dhdz);
+        m_positionX[pixel] = x;
+        m_positionY[pixel] = height;
+        m_positionZ[pixel] = z;
+        m_normalX[pixel] = -dhdx * invLength;
+        m_normalY[pixel] = invLength;
+        m_normalZ[pixel] = -dhdz * invLength;
+        m_depth[pixel] = c_CameraHeight - height;
+    }
+
+    uint32_t random = InitRandom(0, rtxdi::JenkinsHash(m_desc.seed));
+    std::vector<float> powers(m_desc.lightCount);
+    for (std::vector<float>* channel : { &m_lightX, &m_lightY, &m_lightZ, &m_lightPower })
+        channel->resize(m_desc.lightCount);
+    for (uint32_t light = 0; light < m_desc.lightCount; light++)
+    {
+        m_lightX[light] = (NextRandomFloat(random) * 2.f - 1.f) * (c_SceneHalfWidth + 1.f);
+        m_lightY[light] = 0.5f + 3.f * NextRandomFloat(random);
+        m_lightZ[light] = (NextRandomFloat(random) * 2.f - 1.f) * (halfDepth + 1.f);
+        m_lightPower[light] = expf(m_desc.lightPowerSpread * (NextRandomFloat(random) * 2.f - 1.f));
+        powers[light] = m_lightPower[light];
+    }
+
+    m_aliasTable.resize(m_desc.lightCount);
+    LocalLightAliasTable aliasTable;
+    aliasTable.Build(powers.data(), m_desc.lightCount, m_aliasTable.data());
+
+    m_groundTruth.assign(m_pixelCount, 0.0);
+    ParallelFor(m_pixelCount, 1024, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t pixel = begin; pixel < end; pixel++)
+        {
+            double sum = 0.0;
+            for (uint32_t light = 0; light < m_desc.lightCount; light++)
+                sum += TargetPdf(pixel, light);
+            m_groundTruth[pixel] = sum;
+        }
+    });
+
+    m_initialReservoirs.resize(m_pixelCount);
+    m_temporalReservoirs.resize(m_pixelCount);
+    m_spatialReservoirs.resize(m_pixelCount);
+}
+
+// 无遮挡的点光源贡献 power * cos / d^2，同时作为 target pdf 和着色结果
+float ReSTIRDIReference::TargetPdf(uint32_t pixel, uint32_t lightIndex) const
+{
+    if (lightIndex >= m_desc.lightCount)
+        return 0.f;
+
+    const float lx = m_lightX[lightIndex] - m_positionX[pixel];
+    const float ly = m_lightY[lightIndex] - m_positionY[pixel];
+    const float lz = m_lightZ[lightIndex] - m_positionZ[pixel];
+    const float distanceSq = std::max(lx * lx + ly * ly + lz * lz, 1e-4f);
+    const float cosTheta = (m_normalX[pixel] * lx + m_normalY[pixel] * ly + m_normalZ[pixel] * lz) / sqrtf(distanceSq);
+    return m_lightPower[lightIndex] * std::max(cosTheta, 0.f) / distanceSq;
+}
+
+// 与 RTXDI_IsValidNeighbor 相同
+bool ReSTIRDIReference::IsValidNeighbor(uint32_t pixel, uint32_t neighbor, float depthThreshold, float normalThreshold) const
+{
+    const float normalDot = m_normalX[pixel] * m_normalX[neighbor] + m_normalY[pixel] * m_normalY[neighbor] + m_normalZ[pixel] * m_normalZ[neighbor];
+    const float depth = m_depth[pixel];
+    const float neighborDepth = m_depth[neighbor];
+    return normalDot >= normalThreshold && fabsf(depth - neighborDepth) <= depthThreshold * std::max(depth, neighborDepth);
+}
+
+uint64_t ReSTIRDIReference::InitialSampling(const ReSTIRDIReferenceParameters& params, uint32_t frameIndex)
+{
+    const uint32_t numSamples = params.initialSamplingParams.numPrimaryLocalLightSamples;
+    const bool powerSampling = UsesPowerSampling(params.initialSamplingParams.localLightSamplingMode);
+    const uint32_t passSeed = GetPassSeed(frameIndex, 0);
+
+    const auto finalize = [&](uint32_t pixel, uint32_t lightIndex, float weightSum, float targetPdf)
+    {
+        // RTXDI_FinalizeResampling(state, 1, state.M) 之后把 M 置为 1
+        Reservoir& reservoir = m_initialReservoirs[pixel];
+        reservoir.lightIndex = lightIndex;
+        reservoir.targetPdf = targetPdf;
+        reservoir.weightSum = (targetPdf > 0.f) ? weightSum / (targetPdf * float(numSamples)) : 0.f;
+        reservoir.M = 1;
+    };
+
+#if !RESTIR_REFERENCE_USE_SSE
+    const auto samplePixelScalar = [&](uint32_t pixel)
+    {
+        uint32_t random = InitRandom(pixel, passSeed);
+        uint32_t selectedLight = RTXDI_INVALID_LIGHT_INDEX;
+        float selectedTargetPdf = 0.f;
+        float weightSum = 0.f;
+
+        for (uint32_t sample = 0; sample < numSamples; sample++)
+        {
+            const float u0 = NextRandomFloat(random);
+            const float u1 = NextRandomFloat(random);
+            const float u2 = NextRandomFloat(random);
+
+            float invSourcePdf;
+            const uint32_t light = SampleLight(m_aliasTable, powerSampling, u0, u1, invSourcePdf);
+            const float targetPdf = TargetPdf(pixel, light);
+            const float risWeight = targetPdf * invSourcePdf;
+
+            weightSum += risWeight;
+            if (u2 * weightSum < risWeight)
+            {
+                selectedLight = light;
+                selectedTargetPdf = targetPdf;
+            }
+        }
+
+        finalize(pixel, selectedLight, weightSum, selectedTargetPdf);
+    };
+#endif
+
+    const uint32_t groupCount = m_paddedPixelCount / 4;
+    ParallelFor(groupCount, 256, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t group = begin; group < end; group++)
+        {
+            const uint32_t basePixel = group * 4;
+
+#if RESTIR_REFERENCE_USE_SSE
+            // 4 个像素各自的随机数序列与标量版本一致，光源数据按 lane 收集
+            __m128i random = _mm_setr_epi32(int(InitRandom(basePixel, passSeed)), int(InitRandom(basePixel + 1, passSeed)),
+                                            int(InitRandom(basePixel + 2, passSeed)), int(InitRandom(basePixel + 3, passSeed)));
+            const auto nextFloat = [&random]()
+            {
+                random = _mm_xor_si128(random, _mm_slli_epi32(random, 13));
+                random = _mm_xor_si128(random, _mm_srli_epi32(random, 17));
+                random = _mm_xor_si128(random, _mm_slli_epi32(random, 5));
+                return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(random, 8)), _mm_set1_ps(1.f / 16777216.f));
+            };
+
+            const __m128 positionX = _mm_loadu_ps(m_positionX.data() + basePixel);
+            const __m128 positionY = _mm_loadu_ps(m_positionY.data() + basePixel);
+            const __m128 positionZ = _mm_loadu_ps(m_positionZ.data() + basePixel);
+            const __m128 normalX = _mm_loadu_ps(m_normalX.data() + basePixel);
+            const __m128 normalY = _mm_loadu_ps(m_normalY.data() + basePixel);
+            const __m128 normalZ = _mm_loadu_ps(m_normalZ.data() + basePixel);
+            const __m128 zero = _mm_setzero_ps();
+
+            __m128 weightSum = zero;
+            __m128 selectedTargetPdf = zero;
+            __m128i selectedLight = _mm_set1_epi32(int(RTXDI_INVALID_LIGHT_INDEX));
+
+            for (uint32_t sample = 0; sample < numSamples; sample++)
+            {
+                alignas(16) float u0[4], u1[4];
+                _mm_store_ps(u0, nextFloat());
+                _mm_store_ps(u1, nextFloat());
+                const __m128 u2 = nextFloat();
+
+                alignas(16) uint32_t light[4];
+                alignas(16) float invSourcePdf[4], lightX[4], lightY[4], lightZ[4], lightPower[4];
+                for (uint32_t lane = 0; lane < 4; lane++)
+                {
+                    light[lane] = SampleLight(m_aliasTable, powerSampling, u0[lane], u1[lane], invSourcePdf[lane]);
+                    lightX[lane] = m_lightX[light[lane]];
+                    lightY[lane] = m_lightY[light[lane]];
+                    lightZ[lane] = m_lightZ[light[lane]];
+                    lightPower[lane] = m_lightPower[light[lane]];
+                }
+
+                const __m128 lx = _mm_sub_ps(_mm_load_ps(lightX), positionX);
+                const __m128 ly = _mm_sub_ps(_mm_load_ps(lightY), positionY);
+                const __m128 lz = _mm_sub_ps(_mm_load_ps(lightZ), positionZ);
+                const __m128 distanceSq = _mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(lz, lz)), _mm_set1_ps(1e-4f));
+                const __m128 normalDotL = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, lx), _mm_mul_ps(normalY, ly)), _mm_mul_ps(normalZ, lz));
+                const __m128 cosTheta = _mm_max_ps(_mm_div_ps(normalDotL, _mm_sqrt_ps(distanceSq)), zero);
+                const __m128 targetPdf = _mm_div_ps(_mm_mul_ps(_mm_load_ps(lightPower), cosTheta), distanceSq);
+                const __m128 risWeight = _mm_mul_ps(targetPdf, _mm_load_ps(invSourcePdf));
+
+                weightSum = _mm_add_ps(weightSum, risWeight);
+                const __m128 selected = _mm_cmplt_ps(_mm_mul_ps(u2, weightSum), risWeight);
+                selectedTargetPdf = _mm_or_ps(_mm_and_ps(selected, targetPdf), _mm_andnot_ps(selected, selectedTargetPdf));
+                const __m128i selectedMask = _mm_castps_si128(selected);
+                selectedLight = _mm_or_si128(_mm_and_si128(selectedMask, _mm_load_si128(reinterpret_cast<const __m128i*>(light))),
+                                             _mm_andnot_si128(selectedMask, selectedLight));
+            }
+
+            alignas(16) float weightSums[4], targetPdfs[4];
+            alignas(16) uint32_t lights[4];
+            _mm_store_ps(weightSums, weightSum);
+            _mm_store_ps(targetPdfs, selectedTargetPdf);
+            _mm_store_si128(reinterpret_cast<__m128i*>(lights), selectedLight);
+            for (uint32_t lane = 0; lane < 4 && basePixel + lane < m_pixelCount; lane++)
+                finalize(basePixel + lane, lights[lane], weightSums[lane], targetPdfs[lane]);
+#else
+            for (uint32_t pixel = basePixel; pixel < std::min(basePixel + 4, m_pixelCount); pixel++)
+                samplePixelScalar(pixel);
+#endif
+        }
+    });
+
+    return uint64_t(numSamples) * m_pixelCount;
+}
+
+uint64_t ReSTIRDIReference::TemporalResampling(const ReSTIRDIReferenceParameters& params, uint32_t frameIndex, const std::vector<Reservoir>& history)
+{
+    const ReSTIRDI_TemporalResamplingParameters& tparams = params.temporalResamplingParams;
+    const uint32_t passSeed = GetPassSeed(frameIndex, 1);
+    const uint32_t uniformRandomNumber = rtxdi::JenkinsHash(frameIndex);
+    const uint32_t width = m_desc.width;
+    const uint32_t height = m_desc.height;
+
+    const uint32_t batchCount = GetParallelBatchCount(height, c_MinRowsPerBatch);
+    std::vector<uint64_t> batchEvaluations(batchCount, 0);
+    ParallelForBatches(height, batchCount, [&](uint32_t batch, uint32_t beginRow, uint32_t endRow)
+    {
+        uint64_t evaluations = 0;
+        for (uint32_t pixel = beginRow * width; pixel < endRow * width; pixel++)
+        {
+            const Reservoir& curSample = m_initialReservoirs[pixel];
+            Reservoir& state = m_temporalReservoirs[pixel];
+
+            if (history.empty())
+            {
+                state = curSample;
+                continue;
+            }
+
+            // 静态场景，上一帧的对应像素就是自己；开启 permutation sampling 时与 RTXDI 一样按帧随机翻转低两位
+            uint32_t prevPixel = pixel;
+            if (tparams.enablePermutationSampling)
+            {
+                const uint32_t x = (pixel % width) ^ (uniformRandomNumber & 3);
+                const uint32_t y = (pixel / width) ^ ((uniformRandomNumber >> 2) & 3);
+                if (x < width && y < height && IsValidNeighbor(pixel, y * width + x, tparams.temporalDepthThreshold, tparams.temporalNormalThreshold))
+                    prevPixel = y * width + x;
+            }
+
+            Reservoir prevSample = history[prevPixel];
+            prevSample.M = std::min(prevSample.M, tparams.maxHistoryLength * curSample.M);
+
+            uint32_t random = InitRandom(pixel, passSeed);
+
+            if (tparams.temporalBiasCorrection == ReSTIRDI_TemporalBiasCorrectionMode::Pairwise)
+            {
+                const float canonicalPdfAtNeighbor = TargetPdf(pixel, prevSample.lightIndex);
+                const float neighborPdfAtCanonical = TargetPdf(prevPixel, curSample.lightIndex);
+                evaluations += 2;
+
+                const float neighborWeight = PairwiseMisWeight(float(prevSample.M), prevSample.targetPdf, float(curSample.M), canonicalPdfAtNeighbor);
+                const float canonicalWeight = 1.f - PairwiseMisWeight(float(prevSample.M), neighborPdfAtCanonical, float(curSample.M), curSample.targetPdf);
+
+                state = { RTXDI_INVALID_LIGHT_INDEX, 0.f, 0.f, 0 };
+                StreamSample(state, curSample.lightIndex, curSample.targetPdf, canonicalWeight * curSample.targetPdf * curSample.weightSum, curSample.M, 0.5f);
+                StreamSample(state, prevSample.lightIndex, canonicalPdfAtNeighbor, neighborWeight * canonicalPdfAtNeighbor * prevSample.weightSum, prevSample.M, NextRandomFloat(random));
+                FinalizeResampling(state, 1.f, 1.f);
+                continue;
+            }
+
+            state = { RTXDI_INVALID_LIGHT_INDEX, 0.f, 0.f, 0 };
+            StreamSample(state, curSample.lightIndex, curSample.targetPdf, curSample.targetPdf * curSample.weightSum * float(curSample.M), curSample.M, 0.5f);
+
+            const float prevTargetPdf = TargetPdf(pixel, prevSample.lightIndex);
+            evaluations++;
+            const bool selectedPreviousSample = StreamSample(state, prevSample.lightIndex, prevTargetPdf,
+                prevTargetPdf * prevSample.weightSum * float(prevSample.M), prevSample.M, NextRandomFloat(random));
+
+            if (tparams.temporalBiasCorrection != ReSTIRDI_TemporalBiasCorrectionMode::Off)
+            {
+                // 没有遮挡，Raytraced 与 Basic 相同
+                const float temporalP = TargetPdf(prevPixel, state.lightIndex);
+                evaluations++;
+
+                const float pi = selectedPreviousSample ? temporalP : state.targetPdf;
+                const float piSum = state.targetPdf * float(curSample.M) + temporalP * float(prevSample.M);
+                FinalizeResampling(state, pi, piSum);
+            }
+            else
+            {
+                FinalizeResampling(state, 1.f, float(state.M));
+            }
+        }
+        batchEvaluations[batch] = evaluations;
+    });
+
+    uint64_t evaluations = 0;
+    for (uint64_t count : batchEvaluations)
+        evaluations += count;
+    return evaluations;
+}
+
+// 与 RTXDI_BoilingFilter 相同：8x8 像素内贡献明显高于平均值的 reservoir 直接丢弃
+void ReSTIRDIReference::BoilingFilter(const ReSTIRDIReferenceParameters& params)
+{
+    const float filterStrength = std::min(std::max(params.temporalResamplingParams.boilingFilterStrength, 1e-6f), 1.f);
+    const float boilingFilterMultiplier = 10.f / filterStrength - 9.f;
+    const uint32_t width = m_desc.width;
+    const uint32_t height = m_desc.height;
+    const uint32_t groupsX = (width + c_BoilingFilterGroupSize - 1) / c_BoilingFilterGroupSize;
+    const uint32_t groupsY = (height + c_BoilingFilterGroupSize - 1) / c_BoilingFilterGroupSize;
+
+    ParallelFor(groupsY, 1, [&](uint32_t beginGroupY, uint32_t endGroupY)
+    {
+        for (uint32_t groupY = beginGroupY; groupY < endGroupY; groupY++)
+        {
+            for (uint32_t groupX = 0; groupX < groupsX; groupX++)
+            {
+                const uint32_t x0 = groupX * c_BoilingFilterGroupSize, x1 = std::min(x0 + c_BoilingFilterGroupSize, width);
+                const uint32_t y0 = groupY * c_BoilingFilterGroupSize, y1 = std::min(y0 + c_BoilingFilterGroupSize, height);
+
+                float weightSum = 0.f;
+                uint32_t weightCount = 0;
+                for (uint32_t y = y0; y < y1; y++)
+                {
+                    for (uint32_t x = x0; x < x1; x++)
+                    {
+                        const Reservoir& reservoir = m_temporalReservoirs[y * width + x];
+                        const float weight = reservoir.targetPdf * reservoir.weightSum;
+                        if (weight > 0.f)
+                        {
+                            weightSum += weight;
+                            weightCount++;
+                        }
+                    }
+                }
+
+                if (weightCount == 0)
+                    continue;
+
+                const float averageWeight = weightSum / float(weightCount);
+                for (uint32_t y = y0; y < y1; y++)
+                {
+                    for (uint32_t x = x0; x < x1; x++)
+                    {
+                        Reservoir& reservoir = m_temporalReservoirs[y * width + x];
+                        if (reservoir.targetPdf * reservoir.weightSum > averageWeight * boilingFilterMultiplier)
+                            reservoir = { RTXDI_INVALID_LIGHT_INDEX, 0.f, 0.f, 0 };
+                    }
+                }
+            }
+        }
+    });
+}
+
+uint64_t ReSTIRDIReference::SpatialResampling(const ReSTIRDIReferenceParameters& params, uint32_t frameIndex, const std::vector<Reservoir>& input)
+{
+    const ReSTIRDI_SpatialResamplingParameters& sparams = params.spatialResamplingParams;
+    const uint8_t* neighborOffsets = SamplingTableCache::Get().GetNeighborOffsets(params.neighborOffsetCount, 250, NeighborOffsetDistribution_Uniform);
+    if (!neighborOffsets)
+    {
+        m_spatialReservoirs = input;
+        return 0;
+    }
+
+    const uint32_t neighborOffsetMask = params.neighborOffsetCount - 1;
+    const bool temporalActive = IsTemporalMode(params.resamplingMode);
+    const uint32_t passSeed = GetPassSeed(frameIndex, 2);
+    const int32_t width = int32_t(m_desc.width);
+    const int32_t height = int32_t(m_desc.height);
+
+    const uint32_t batchCount = GetParallelBatchCount(m_desc.height, c_MinRowsPerBatch);
+    std::vector<uint64_t> batchEvaluations(batchCount, 0);
+    ParallelForBatches(m_desc.height, batchCount, [&](uint32_t batch, uint32_t beginRow, uint32_t endRow)
+    {
+        uint64_t evaluations = 0;
+        std::vector<uint32_t> neighbors;
+
+        for (uint32_t pixel = beginRow * m_desc.width; pixel < endRow * m_desc.width; pixel++)
+        {
+            const Reservoir& centerSample = input[pixel];
+            Reservoir& state = m_spatialReservoirs[pixel];
+            uint32_t random = InitRandom(pixel, passSeed);
+
+            // 时域历史不足（刚解除遮挡）时用更多的空间样本
+            uint32_t numSamples = sparams.numSpatialSamples;
+            if (temporalActive && centerSample.M < params.temporalResamplingParams.maxHistoryLength)
+                numSamples = std::max(numSamples, sparams.numDisocclusionBoostSamples);
+
+            const int32_t px = int32_t(pixel % m_desc.width);
+            const int32_t py = int32_t(pixel / m_desc.width);
+            const uint32_t startIndex = NextRandom(random) & neighborOffsetMask;
+
+            neighbors.clear();
+            for (uint32_t i = 0; i < numSamples; i++)
+            {
+                const uint8_t* offset = neighborOffsets + ((startIndex + i) & neighborOffsetMask) * 2;
+                const int32_t x = int32_t(float(px) + float(int8_t(offset[0])) / 127.f * sparams.spatialSamplingRadius);
+                const int32_t y = int32_t(float(py) + float(int8_t(offset[1])) / 127.f * sparams.spatialSamplingRadius);
+                if (x < 0 || y < 0 || x >= width || y >= height || (x == px && y == py))
+                    continue;
+
+                const uint32_t neighbor = uint32_t(y * width + x);
+                if (!IsValidNeighbor(pixel, neighbor, sparams.spatialDepthThreshold, sparams.spatialNormalThreshold))
+                    continue;
+
+                neighbors.push_back(neighbor);
+            }
+
+            state = { RTXDI_INVALID_LIGHT_INDEX, 0.f, 0.f, 0 };
+
+            if (sparams.spatialBiasCorrection == ReSTIRDI_SpatialBiasCorrectionMode::Pairwise)
+            {
+                if (neighbors.empty())
+                {
+                    state = centerSample;
+                    continue;
+                }
+
+                // 每个邻居与中心像素两两做 balance heuristic，中心像素的置信度平分给各个邻居
+                const float invNeighborCount = 1.f / float(neighbors.size());
+                const float canonicalConfidence = float(centerSample.M) * invNeighborCount;
+                float canonicalWeight = 0.f;
+
+                for (uint32_t neighbor : neighbors)
+                {
+                    const Reservoir& neighborSample = input[neighbor];
+                    const float canonicalPdfAtNeighbor = TargetPdf(pixel, neighborSample.lightIndex);
+                    const float neighborPdfAtCanonical = TargetPdf(neighbor, centerSample.lightIndex);
+                    evaluations += 2;
+
+                    const float neighborWeight = PairwiseMisWeight(float(neighborSample.M), neighborSample.targetPdf, canonicalConfidence, canonicalPdfAtNeighbor) * invNeighborCount;
+                    canonicalWeight += 1.f - PairwiseMisWeight(float(neighborSample.M), neighborPdfAtCanonical, canonicalConfidence, centerSample.targetPdf);
+
+                    StreamSample(state, neighborSample.lightIndex, canonicalPdfAtNeighbor,
+                        neighborWeight * canonicalPdfAtNeighbor * neighborSample.weightSum, neighborSample.M, NextRandomFloat(random));
+                }
+
+                canonicalWeight *= invNeighborCount;
+                StreamSample(state, centerSample.lightIndex, centerSample.targetPdf,
+                    canonicalWeight * centerSample.targetPdf * centerSample.weightSum, centerSample.M, NextRandomFloat(random));
+                FinalizeResampling(state, 1.f, 1.f);
+                continue;
+            }
+
+            StreamSample(state, centerSample.lightIndex, centerSample.targetPdf, centerSample.targetPdf * centerSample.weightSum * float(centerSample.M), centerSample.M, 0.5f);
+
+            int32_t selectedNeighbor = -1;
+            for (uint32_t i = 0; i < uint32_t(neighbors.size()); i++)
+            {
+                const Reservoir& neighborSample = input[neighbors[i]];
+                const float targetPdf = TargetPdf(pixel, neighborSample.lightIndex);
+                evaluations++;
+
+                if (StreamSample(state, neighborSample.lightIndex, targetPdf, targetPdf * neighborSample.weightSum * float(neighborSample.M), neighborSample.M, NextRandomFloat(random)))
+                    selectedNeighbor = int32_t(i);
+            }
+
+            if (sparams.spatialBiasCorrection != ReSTIRDI_SpatialBiasCorrectionMode::Off)
+            {
+                float pi = state.targetPdf;
+                float piSum = state.targetPdf * float(centerSample.M);
+                for (uint32_t i = 0; i < uint32_t(neighbors.size()); i++)
+                {
+                    const float ps = TargetPdf(neighbors[i], state.lightIndex);
+                    evaluations++;
+
+                    if (selectedNeighbor == int32_t(i))
+                        pi = ps;
+                    piSum += ps * float(input[neighbors[i]].M);
+                }
+                FinalizeResampling(state, pi, piSum);
+            }
+            else
+            {
+                FinalizeResampling(state, 1.f, float(state.M));
+            }
+        }
+        batchEvaluations[batch] = evaluations;
+    });
+
+    uint64_t evaluations = 0;
+    for (uint64_t count : batchEvaluations)
+        evaluations += count;
+    return evaluations;
+}
+
+ReSTIRDIReferenceStats ReSTIRDIReference::Run(const ReSTIRDIReferenceParameters& params, uint32_t frameCount)
+{
+    ReSTIRDIReferenceStats stats = {};
+    stats.frameCount = frameCount;
+    if (frameCount == 0)
+        return stats;
+
+    const bool temporal = IsTemporalMode(params.resamplingMode);
+    const bool spatial = IsSpatialMode(params.resamplingMode);
+
+    std::vector<Reservoir> history;
+    uint64_t totalEvaluations = 0;
+    double totalMilliseconds = 0.0;
+    double totalRelativeMSE = 0.0;
+    double totalError = 0.0;
+    double totalGroundTruth = 0.0;
+
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; frameIndex++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        totalEvaluations += InitialSampling(params, frameIndex);
+        const std::vector<Reservoir>* output = &m_initialReservoirs;
+
+        if (temporal)
+        {
+            totalEvaluations += TemporalResampling(params, frameIndex, history);
+            if (params.temporalResamplingParams.enableBoilingFilter)
+                BoilingFilter(params);
+            output = &m_temporalReservoirs;
+        }
+
+        if (spatial)
+        {
+            totalEvaluations += SpatialResampling(params, frameIndex, *output);
+            output = &m_spatialReservoirs;
+        }
+
+        totalMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // 着色结果为 f(y) * W，与所有光源贡献之和比较
+        double relativeMSE = 0.0;
+        uint32_t litPixels = 0;
+        for (uint32_t pixel = 0; pixel < m_pixelCount; pixel++)
+        {
+            const double groundTruth = m_groundTruth[pixel];
+            if (groundTruth <= 0.0)
+                continue;
+
+            const Reservoir& reservoir = (*output)[pixel];
+            const double error = double(reservoir.targetPdf) * double(reservoir.weightSum) - groundTruth;
+            relativeMSE += (error * error) / (groundTruth * groundTruth);
+            totalError += error;
+            totalGroundTruth += groundTruth;
+            litPixels++;
+        }
+        relativeMSE = litPixels > 0 ? relativeMSE / double(litPixels) : 0.0;
+
+        totalRelativeMSE += relativeMSE;
+        stats.lastFrameRelativeMSE = float(relativeMSE);
+
+        if (temporal)
+            history = *output;
+    }
+
+    stats.relativeMSE = float(totalRelativeMSE / double(frameCount));
+    stats.relativeBias = totalGroundTruth > 0.0 ? float(totalError / totalGroundTruth) : 0.f;
+    stats.targetPdfEvaluationsPerPixel = float(double(totalEvaluations) / (double(frameCount) * double(m_pixelCount)));
+    stats.millisecondsPerFrame = float(totalMilliseconds / double(frameCount));
+    stats.efficiency = (stats.relativeMSE > 0.f && stats.millisecondsPerFrame > 0.f) ? 1.f / (stats.relativeMSE * stats.millisecondsPerFrame) : 0.f;
+    return stats;
+}
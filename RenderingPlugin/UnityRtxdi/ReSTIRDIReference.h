@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Rtxdi/DI/ReSTIRDI.h>
+
+#include "LocalLightAliasTable.h"
+
+// CPU 上的 ReSTIR DI 参考实现，不依赖 GPU 和 Unity，用来在合成场景上比较不同参数的方差和开销
+// 合成场景：正交相机俯视的起伏地面，中间一块抬高的平台制造深度不连续，加上随机点光源
+// 只有局部光源且没有遮挡，因此 infinite / environment / BRDF 采样、可见性相关的参数不起作用，
+// Raytraced 偏差校正等同于 Basic，FusedSpatiotemporal 按 TemporalAndSpatial 处理
+struct ReSTIRDIReferenceSceneDesc
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t lightCount;
+    uint32_t seed;
+    float lightPowerSpread; // 光源功率为 exp(spread * u)，u 在 [-1, 1] 上均匀分布，0 表示功率全部相同
+    uint32_t pad1;
+    uint32_t pad2;
+    uint32_t pad3;
+};
+
+struct ReSTIRDIReferenceStats
+{
+    uint32_t frameCount;
+    float relativeMSE;          // 所有帧的平均相对均方误差
+    float lastFrameRelativeMSE; // 最后一帧，反映时域累积后的状态
+    float relativeBias;         // 所有帧 (估计值 - 真值) 之和 / 真值之和
+    float targetPdfEvaluationsPerPixel; // 每帧
+    float millisecondsPerFrame;
+    float efficiency;           // 1 / (relativeMSE * millisecondsPerFrame)
+    uint32_t pad1;
+};
+
+// 与 ReSTIRDIContext 使用同一组参数结构
+struct ReSTIRDIReferenceParameters
+{
+    rtxdi::ReSTIRDI_ResamplingMode resamplingMode;
+    uint32_t neighborOffsetCount;
+    ReSTIRDI_InitialSamplingParameters initialSamplingParams;
+    ReSTIRDI_TemporalResamplingParameters temporalResamplingParams;
+    ReSTIRDI_SpatialResamplingParameters spatialResamplingParams;
+
+    static ReSTIRDIReferenceParameters FromContext(const rtxdi::ReSTIRDIContext& context);
+};
+
+// 初始采样用 SSE2 一次处理 4 个像素，所有 pass 按行多线程执行
+class ReSTIRDIReference
+{
+public:
+    explicit ReSTIRDIReference(const ReSTIRDIReferenceSceneDesc& desc);
+
+    // 从空的历史开始连续运行 frameCount 帧
+    ReSTIRDIReferenceStats Run(const ReSTIRDIReferenceParameters& params, uint32_t frameCount);
+
+private:
+    struct Reservoir
+    {
+        uint32_t lightIndex;
+        float weightSum; // 完成 resampling 后为无偏贡献权重 W
+        float targetPdf;
+        uint32_t M;
+    };
+
+    float TargetPdf(uint32_t pixel, uint32_t lightIndex) const;
+    bool IsValidNeighbor(uint32_t pixel, uint32_t neighbor, float depthThreshold, float normalThreshold) const;
+
+    uint64_t InitialSampling(const ReSTIRDIReferenceParameters& params, uint32_t frameIndex);
+    uint64_t TemporalResampling(const ReSTIRDIReferenceParameters& params, uint32_t frameIndex, const std::vector<Reservoir>& history);
+    void BoilingFilter(const ReSTIRDIReferenceParameters& params);
+    uint64_t SpatialResampling(const ReSTIRDIReferenceParameters& params, uint32_t frameIndex, const std::vector<Reservoir>& input);
+
+    ReSTIRDIReferenceSceneDesc m_desc;
+    uint32_t m_pixelCount = 0;
+    uint32_t m_paddedPixelCount = 0; // 4 的倍数，多出来的像素只参与 SIMD 计算
+
+    // G-buffer 和光源都用 SoA 布局
+    std::vector<float> m_positionX, m_positionY, m_positionZ;
+    std::vector<float> m_normalX, m_normalY, m_normalZ;
+    std::vector<float> m_depth;
+    std::vector<float> m_lightX, m_lightY, m_lightZ, m_lightPower;
+    std::vector<RTXDI_AliasTableEntry> m_aliasTable;
+    std::vector<double> m_groundTruth;
+
+    std::vector<Reservoir> m_initialReservoirs;
+    std::vector<Reservoir> m_temporalReservoirs;
+    std::vector<Reservoir> m_spatialReservoirs;
+};
@@ -0,0 +1,118 @@
+﻿#include "ResamplingConstants.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+void FillReSTIRDIConstants(ReSTIRDI_Parameters& params, const rtxdi::ReSTIRDIContext& restirDIContext)
+{
+    params.reservoirBufferParams = restirDIContext.GetReservoirBufferParameters();
+    params.bufferIndices = restirDIContext.GetBufferIndices();
+    params.initialSamplingParams = restirDIContext.GetInitialSamplingParameters();
+    params.temporalResamplingParams = restirDIContext.GetTemporalResamplingParameters();
+    params.spatialResamplingParams = restirDIContext.GetSpatialResamplingParameters();
+    params.shadingParams = restirDIContext.GetShadingParameters();
+}
+
+void FillReGIRConstants(ReGIR_Parameters& params, const rtxdi::ReGIRContext& regirContext)
+{
+    const rtxdi::ReGIRStaticParameters staticParams = regirContext.GetReGIRStaticParameters();
+    const rtxdi::ReGIRDynamicParameters dynamicParams = regirContext.GetReGIRDynamicParameters();
+    const rtxdi::ReGIROnionCalculatedParameters onionParams = regirContext.GetReGIROnionCalculatedParameters();
+
+    params.gridParams.cellsX = staticParams.gridParameters.GridSize.x;
+    params.gridParams.cellsY = staticParams.gridParameters.GridSize.y;
+    params.gridParams.cellsZ = staticParams.gridParameters.GridSize.z;
+
+    params.commonParams.enable = staticParams.Mode != rtxdi::ReGIRMode::Disabled;
+    params.commonParams.numRegirBuildSamples = dynamicParams.regirNumBuildSamples;
+    params.commonParams.risBufferOffset = regirContext.GetReGIRCellOffset();
+    params.commonParams.lightsPerCell = staticParams.LightsPerCell;
+    params.commonParams.centerX = dynamicParams.center.x;
+    params.commonParams.centerY = dynamicParams.center.y;
+    params.commonParams.centerZ = dynamicParams.center.z;
+    // Onion 模式下按半径计算，cell size 取一半
+    params.commonParams.cellSize = (staticParams.Mode == rtxdi::ReGIRMode::Onion)
+        ? dynamicParams.regirCellSize * 0.5f
+        : dynamicParams.regirCellSize;
+    params.commonParams.localLightSamplingFallbackMode = static_cast<uint32_t>(dynamicParams.fallbackSamplingMode);
+    params.commonParams.localLightPresamplingMode = static_cast<uint32_t>(dynamicParams.presamplingMode);
+    params.commonParams.samplingJitter = std::max(0.f, dynamicParams.regirSamplingJitter * 2.f);
+
+    params.onionParams.cubicRootFactor = onionParams.regirOnionCubicRootFactor;
+    params.onionParams.linearFactor = onionParams.regirOnionLinearFactor;
+    params.onionParams.numLayerGroups = uint32_t(onionParams.regirOnionLayers.size());
+
+    assert(onionParams.regirOnionLayers.size() <= RTXDI_ONION_MAX_LAYER_GROUPS);
+    for (size_t group = 0; group < onionParams.regirOnionLayers.size(); group++)
+    {
+        params.onionParams.layers[group] = onionParams.regirOnionLayers[group];
+        params.onionParams.layers[group].innerRadius *= params.commonParams.cellSize;
+        params.onionParams.layers[group].outerRadius *= params.commonParams.cellSize;
+    }
+
+    assert(onionParams.regirOnionRings.size() <= RTXDI_ONION_MAX_RINGS);
+    for (size_t ring = 0; ring < onionParams.regirOnionRings.size(); ring++)
+    {
+        params.onionParams.rings[ring] = onionParams.regirOnionRings[ring];
+    }
+}
+
+void FillReSTIRGIConstants(ReSTIRGI_Parameters& params, const rtxdi::ReSTIRGIContext& restirGIContext)
+{
+    params.reservoirBufferParams = restirGIContext.GetReservoirBufferParameters();
+    params.bufferIndices = restirGIContext.GetBufferIndices();
+    params.temporalResamplingParams = restirGIContext.GetTemporalResamplingParameters();
+    params.spatialResamplingParams = restirGIContext.GetSpatialResamplingParameters();
+    params.finalShadingParams = restirGIContext.GetFinalShadingParameters();
+}
+
+void FillResamplingConstants(ResamplingConstants& constants, const rtxdi::ImportanceSamplingContext& isContext,
+                             const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout)
+{
+    FillResamplingConstants(constants, isContext, isContext.GetReSTIRDIContext(), isContext.GetReSTIRGIContext(), aliasTableParams, risBufferLayout);
+}
+
+void FillResamplingConstants(ResamplingConstants& constants, const rtxdi::ImportanceSamplingContext& isContext,
+                             const rtxdi::ReSTIRDIContext& restirDIContext, const rtxdi::ReSTIRGIContext& restirGIContext,
+                             const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout)
+{
+    constants.runtimeParams = restirDIContext.GetRuntimeParams();
+    constants.lightBufferParams = isContext.GetLightBufferParameters();
+    constants.localLightsRISBufferSegmentParams = isContext.GetLocalLightRISBufferSegmentParams();
+    constants.environmentLightRISBufferSegmentParams = isContext.GetEnvironmentLightRISBufferSegmentParams();
+    constants.localLightAliasTableParams = aliasTableParams;
+    if (risBufferLayout)
+    {
+        constants.localLightsRISBufferSegmentParams = risBufferLayout->localLightsRISBufferSegmentParams;
+        constants.environmentLightRISBufferSegmentParams = risBufferLayout->environmentLightRISBufferSegmentParams;
+    }
+    constants.frameIndex = restirDIContext.GetFrameIndex();
+
+    FillReSTIRDIConstants(constants.restirDI, restirDIContext);
+    FillReGIRConstants(constants.regir, isContext.GetReGIRContext());
+    FillReSTIRGIConstants(constants.restirGI, restirGIContext);
+}
+
+bool UpdateResamplingConstants(ResamplingConstants& inOutConstants, const rtxdi::ImportanceSamplingContext& isContext,
+                               const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout,
+                               const ReSTIRDI_BufferIndices* diBufferIndices)
+{
+    // 先清零再填充，保证 pad 和未使用的 onion 槽位稳定，memcmp 才有意义
+    ResamplingConstants constants;
+    memset(&constants, 0, sizeof(constants));
+    FillResamplingConstants(constants, isContext, aliasTableParams, risBufferLayout);
+    if (diBufferIndices)
+        constants.restirDI.bufferIndices = *diBufferIndices;
+
+    return CommitResamplingConstants(inOutConstants, constants);
+}
+
+bool CommitResamplingConstants(ResamplingConstants& inOutConstants, const ResamplingConstants& constants)
+{
+    if (memcmp(&constants, &inOutConstants, sizeof(constants)) == 0)
+        return false;
+
+    inOutConstants = constants;
+    return true;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <Rtxdi/ImportanceSamplingContext.h>
+#include <Rtxdi/DI/ReSTIRDI.h>
+#include <Rtxdi/GI/ReSTIRGI.h>
+#include <Rtxdi/ReGIR/ReGIR.h>
+
+#include "LocalLightAliasTable.h"
+#include "RISBufferSegmentPool.h"
+
+// 与 HLSL 端 ResamplingConstants 逐字节一致，C# 拿到后可以直接作为常量缓冲上传
+// 所有成员都是 16 字节对齐的块，不要在中间插入零散字段
+struct ResamplingConstants
+{
+    RTXDI_RuntimeParameters runtimeParams;
+    RTXDI_LightBufferParameters lightBufferParams;
+    RTXDI_RISBufferSegmentParameters localLightsRISBufferSegmentParams;
+    RTXDI_RISBufferSegmentParameters environmentLightRISBufferSegmentParams;
+    RTXDI_AliasTableParameters localLightAliasTableParams;
+
+    uint32_t frameIndex;
+    uint32_t pad1;
+    uint32_t pad2;
+    uint32_t pad3;
+
+    ReSTIRDI_Parameters restirDI;
+    ReGIR_Parameters regir;
+    ReSTIRGI_Parameters restirGI;
+};
+
+static_assert(sizeof(ResamplingConstants) % 16 == 0, "ResamplingConstants must be a multiple of 16 bytes");
+
+void FillReSTIRDIConstants(ReSTIRDI_Parameters& params, const rtxdi::ReSTIRDIContext& restirDIContext);
+void FillReGIRConstants(ReGIR_Parameters& params, const rtxdi::ReGIRContext& regirContext);
+void FillReSTIRGIConstants(ReSTIRGI_Parameters& params, const rtxdi::ReSTIRGIContext& restirGIContext);
+
+// 从 ImportanceSamplingContext 收集一帧所需的全部常量
+// 别名表参数不归 ImportanceSamplingContext 管理，由调用方传入
+// risBufferLayout 不为空时用它覆盖 context 创建时固定的 local / environment RIS 分段
+void FillResamplingConstants(ResamplingConstants& constants, const rtxdi::ImportanceSamplingContext& isContext,
+                             const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout);
+
+// 多视图时 DI / GI 来自各视图自己的 context，光源、RIS 和 ReGIR 来自共享的 ImportanceSamplingContext
+void FillResamplingConstants(ResamplingConstants& constants, const rtxdi::ImportanceSamplingContext& isContext,
+                             const rtxdi::ReSTIRDIContext& restirDIContext, const rtxdi::ReSTIRGIContext& restirGIContext,
+                             const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout);
+
+// 把新常量写进调用方的缓冲，返回内容是否与缓冲里上一帧的数据不同
+// diBufferIndices 不为空时替换 context 给出的 DI 缓冲下标，用于 ReSTIRDIReservoirPlanner 的精简布局
+bool UpdateResamplingConstants(ResamplingConstants& inOutConstants, const rtxdi::ImportanceSamplingContext& isContext,
+                               const RTXDI_AliasTableParameters& aliasTableParams, const RISBufferLayout* risBufferLayout,
+                               const ReSTIRDI_BufferIndices* diBufferIndices);
+
+// constants 需要是清零后填充的，内容有变化时写入 inOutConstants 并返回 true
+bool CommitResamplingConstants(ResamplingConstants& inOutConstants, const ResamplingConstants& constants);
@@ -0,0 +1,90 @@
+﻿#include "ReservoirBufferSizing.h"
+
+static_assert(sizeof(RTXDI_PackedDIReservoir) == 24, "RTXDI_PackedDIReservoir must match the HLSL layout");
+static_assert(sizeof(RTXDI_PackedGIReservoir) == 32, "RTXDI_PackedGIReservoir must match the HLSL layout");
+
+uint32_t GetReSTIRGINumReservoirBuffers(rtxdi::ReSTIRGI_ResamplingMode resamplingMode)
+{
+    return (resamplingMode == rtxdi::ReSTIRGI_ResamplingMode::None) ? 1 : 2;
+}
+
+ReservoirBufferDesc CalculateReSTIRGIReservoirBufferDesc(const rtxdi::ReSTIRGIContext& context, rtxdi::ReSTIRGI_ResamplingMode resamplingMode)
+{
+    ReservoirBufferDesc desc = {};
+    desc.numReservoirBuffers = GetReSTIRGINumReservoirBuffers(resamplingMode);
+    desc.reservoirArrayPitch = context.GetReservoirBufferParameters().reservoirArrayPitch;
+    desc.reservoirStride = sizeof(RTXDI_PackedGIReservoir);
+    desc.totalReservoirCount = desc.reservoirArrayPitch * desc.numReservoirBuffers;
+    desc.totalSizeInBytes = uint64_t(desc.totalReservoirCount) * desc.reservoirStride;
+    return desc;
+}
+
+uint32_t GetReSTIRDIMinReservoirBuffers(rtxdi::ReSTIRDI_ResamplingMode resamplingMode)
+{
+    return (resamplingMode == rtxdi::ReSTIRDI_ResamplingMode::None) ? 1 : 2;
+}
+
+ReservoirBufferDesc CalculateReSTIRDIReservoirBufferDesc(const rtxdi::ReSTIRDIContext& context, rtxdi::ReSTIRDI_ResamplingMode resamplingMode)
+{
+    ReservoirBufferDesc desc = {};
+    desc.numReservoirBuffers = GetReSTIRDIMinReservoirBuffers(resamplingMode);
+    desc.reservoirArrayPitch = context.GetReservoirBufferParameters().reservoirArrayPitch;
+    desc.reservoirStride = sizeof(RTXDI_PackedDIReservoir);
+    desc.totalReservoirCount = desc.reservoirArrayPitch * desc.numReservoirBuffers;
+    desc.totalSizeInBytes = uint64_t(desc.totalReservoirCount) * desc.reservoirStride;
+    return desc;
+}
+
+ReSTIRDI_BufferIndices ReSTIRDIReservoirPlanner::Update(const rtxdi::ReSTIRDIContext& context)
+{
+    const uint32_t frameIndex = context.GetFrameIndex();
+    const rtxdi::ReSTIRDI_ResamplingMode mode = context.GetResamplingMode();
+    if (m_hasFrame && frameIndex == m_frameIndex && mode == m_resamplingMode)
+        return m_bufferIndices;
+
+    // 只有进入新的一帧才推进轮转，同一帧内换模式时 last 保持不变
+    if (m_hasFrame && frameIndex != m_frameIndex)
+        m_lastFrameOutputReservoir = m_currentFrameOutputReservoir;
+    m_hasFrame = true;
+    m_frameIndex = frameIndex;
+    m_resamplingMode = mode;
+
+    ReSTIRDI_BufferIndices& indices = m_bufferIndices;
+
+    if (mode == rtxdi::ReSTIRDI_ResamplingMode::None)
+    {
+        indices = {};
+        m_currentFrameOutputReservoir = 0;
+        return indices;
+    }
+
+    // 两个数组：last 是上一帧的输出，work 放本帧的 initial / temporal 结果
+    const uint32_t last = m_lastFrameOutputReservoir;
+    const uint32_t work = 1 - last;
+
+    const bool useSpatialResampling =
+        mode == rtxdi::ReSTIRDI_ResamplingMode::Spatial ||
+        mode == rtxdi::ReSTIRDI_ResamplingMode::TemporalAndSpatial;
+
+    indices.initialSamplingOutputBufferIndex = work;
+    indices.temporalResamplingInputBufferIndex = last;
+    indices.temporalResamplingOutputBufferIndex = work;
+    indices.spatialResamplingInputBufferIndex = work;
+    // temporal 已经读完 last，spatial 的输出可以覆盖它
+    indices.spatialResamplingOutputBufferIndex = last;
+    // Fused 在 initial 的数组上原地输出
+    indices.shadingInputBufferIndex = useSpatialResampling ? last : work;
+
+    m_currentFrameOutputReservoir = indices.shadingInputBufferIndex;
+    return indices;
+}
+
+void ReSTIRDIReservoirPlanner::Reset()
+{
+    m_hasFrame = false;
+    m_frameIndex = 0;
+    m_resamplingMode = rtxdi::ReSTIRDI_ResamplingMode::None;
+    m_lastFrameOutputReservoir = 0;
+    m_currentFrameOutputReservoir = 0;
+    m_bufferIndices = {};
+}
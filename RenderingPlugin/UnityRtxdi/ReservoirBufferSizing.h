@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include <Rtxdi/DI/ReSTIRDI.h>
+#include <Rtxdi/GI/ReSTIRGI.h>
+
+// 一个 reservoir 结构化缓冲的大小，缓冲内按 reservoirArrayPitch 依次存放 numReservoirBuffers 个数组
+struct ReservoirBufferDesc
+{
+    uint32_t numReservoirBuffers;
+    uint32_t reservoirArrayPitch;   // 每个数组的 reservoir 数
+    uint32_t reservoirStride;       // 单个 reservoir 的字节数
+    uint32_t totalReservoirCount;   // 结构化缓冲的元素个数
+    uint64_t totalSizeInBytes;
+};
+
+// None 只用到数组 0，其余模式在两个数组间轮转，见 ReSTIRGIContext::UpdateBufferIndices
+uint32_t GetReSTIRGINumReservoirBuffers(rtxdi::ReSTIRGI_ResamplingMode resamplingMode);
+
+// 按 context 当前分辨率计算，resamplingMode 可以与 context 当前的模式不同，用于提前分配
+ReservoirBufferDesc CalculateReSTIRGIReservoirBufferDesc(const rtxdi::ReSTIRGIContext& context, rtxdi::ReSTIRGI_ResamplingMode resamplingMode);
+
+// ReSTIR DI 各模式同时存活的 reservoir 数组数，SDK 固定按 ReSTIRDIContext::NumReservoirBuffers = 3 轮转
+// None 为 1；其余模式只需要上一帧输出和本帧工作数组两个：
+// initial / temporal 输出在同一像素上原地读写，spatial 在 temporal 结束后才开始，可以覆盖上一帧的输出
+// 如果在 spatial 之后还有 pass 读取上一帧的 reservoir（例如梯度估计），需要按 3 个分配并使用 SDK 的索引
+uint32_t GetReSTIRDIMinReservoirBuffers(rtxdi::ReSTIRDI_ResamplingMode resamplingMode);
+
+// reservoirArrayPitch 取自 context，已经包含棋盘模式的半宽，RTXDI_PackedDIReservoir 为 24 字节
+ReservoirBufferDesc CalculateReSTIRDIReservoirBufferDesc(const rtxdi::ReSTIRDIContext& context, rtxdi::ReSTIRDI_ResamplingMode resamplingMode);
+
+// 与 GetReSTIRDIMinReservoirBuffers 配套的缓冲索引，替换常量里 context 给出的 bufferIndices
+// 轮转状态跨帧保存，切换模式时上一帧的输出仍然作为 temporal 输入
+class ReSTIRDIReservoirPlanner
+{
+public:
+    // 每帧在 SetFrameIndex / SetResamplingMode 之后调用，同一帧同一模式重复调用返回相同结果
+    // 同一帧内切换模式时按新模式重新计算，上一帧的输出仍然作为 temporal 输入
+    ReSTIRDI_BufferIndices Update(const rtxdi::ReSTIRDIContext& context);
+
+    // 缓冲重新分配、历史失效时调用
+    void Reset();
+
+private:
+    bool m_hasFrame = false;
+    uint32_t m_frameIndex = 0;
+    rtxdi::ReSTIRDI_ResamplingMode m_resamplingMode = rtxdi::ReSTIRDI_ResamplingMode::None;
+    uint32_t m_lastFrameOutputReservoir = 0;
+    uint32_t m_currentFrameOutputReservoir = 0;
+    ReSTIRDI_BufferIndices m_bufferIndices = {};
+};
@@ -0,0 +1,319 @@
+﻿#include "SamplingTables.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Rtxdi/RtxdiUtils.h>
+
+#include "ParallelFor.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SAMPLING_TABLES_USE_SSE 1
+#else
+#define SAMPLING_TABLES_USE_SSE 0
+#endif
+
+namespace
+{
+    constexpr uint32_t c_MinSeedsPerBatch = 65536;
+    constexpr uint32_t c_MaxBlueNoiseTileSize = 128;
+    constexpr float c_BlueNoiseSigma = 1.5f;
+    // 高斯核在 8 个像素外小于 1e-6，更新能量时只处理这个范围内的行
+    constexpr uint32_t c_BlueNoiseKernelRadius = 8;
+
+    bool IsNonzeroPowerOf2(uint32_t i)
+    {
+        return ((i & (i - 1)) == 0) && (i > 0);
+    }
+
+    // 与 rtxdi::FillNeighborOffsetBuffer 相同的 R2 序列拒绝采样，只是半径和分布可调
+    void GenerateNeighborOffsets(uint8_t* buffer, uint32_t neighborOffsetCount, uint32_t radius, NeighborOffsetDistribution distribution)
+    {
+        const float phi2 = 1.0f / 1.3247179572447f;
+        uint32_t num = 0;
+        float u = 0.5f;
+        float v = 0.5f;
+        while (num < neighborOffsetCount * 2)
+        {
+            u += phi2;
+            v += phi2 * phi2;
+            if (u >= 1.0f) u -= 1.0f;
+            if (v >= 1.0f) v -= 1.0f;
+
+            float rSq = (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f);
+            if (rSq > 0.25f)
+                continue;
+
+            float scale = float(radius);
+            if (distribution == NeighborOffsetDistribution_CenterWeighted)
+                scale *= 2.0f * sqrtf(rSq);
+
+            buffer[num++] = uint8_t(int32_t((u - 0.5f) * scale));
+            buffer[num++] = uint8_t(int32_t((v - 0.5f) * scale));
+        }
+    }
+
+#if SAMPLING_TABLES_USE_SSE
+    // 4 路并行的 rtxdi::JenkinsHash
+    __m128i JenkinsHash4(__m128i a)
+    {
+        a = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x7ed55d16)), _mm_slli_epi32(a, 12));
+        a = _mm_xor_si128(_mm_xor_si128(a, _mm_set1_epi32(int(0xc761c23c))), _mm_srli_epi32(a, 19));
+        a = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x165667b1)), _mm_slli_epi32(a, 5));
+        a = _mm_xor_si128(_mm_add_epi32(a, _mm_set1_epi32(int(0xd3a2646c))), _mm_slli_epi32(a, 9));
+        a = _mm_add_epi32(_mm_add_epi32(a, _mm_set1_epi32(int(0xfd7046c5))), _mm_slli_epi32(a, 3));
+        a = _mm_xor_si128(_mm_xor_si128(a, _mm_set1_epi32(int(0xb55a4f09))), _mm_srli_epi32(a, 16));
+        return a;
+    }
+#endif
+
+    void GenerateFrameSeeds(uint32_t* seeds, uint32_t begin, uint32_t end)
+    {
+        uint32_t i = begin;
+
+#if SAMPLING_TABLES_USE_SSE
+        __m128i index = _mm_add_epi32(_mm_set1_epi32(int(begin)), _mm_setr_epi32(0, 1, 2, 3));
+        const __m128i step = _mm_set1_epi32(4);
+        for (; i + 4 <= end; i += 4)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(seeds + i), JenkinsHash4(index));
+            index = _mm_add_epi32(index, step);
+        }
+#endif
+
+        for (; i < end; i++)
+            seeds[i] = rtxdi::JenkinsHash(i);
+    }
+
+    // Ulichney 的 void-and-cluster：能量为到所有已放置点的环绕高斯距离之和
+    // 能量场随加点 / 删点增量更新，能量最大的已放置点为最紧的簇，能量最小的空位为最大的空洞
+    class VoidAndCluster
+    {
+    public:
+        explicit VoidAndCluster(uint32_t size) :
+            m_size(size),
+            m_mask(size - 1),
+            m_occupied(size * size, 0.f),
+            m_energy(size * size, 0.f),
+            m_lut(size * size * 2)
+        {
+            // 每行存两遍，以任意点为中心的一行都能连续读出
+            for (uint32_t dy = 0; dy < size; dy++)
+            {
+                const float y = float(std::min(dy, size - dy));
+                for (uint32_t dx = 0; dx < size * 2; dx++)
+                {
+                    const float x = float(std::min(dx & m_mask, size - (dx & m_mask)));
+                    m_lut[dy * size * 2 + dx] = expf(-(x * x + y * y) / (2.f * c_BlueNoiseSigma * c_BlueNoiseSigma));
+                }
+            }
+        }
+
+        void Set(uint32_t index, bool value)
+        {
+            m_occupied[index] = value ? 1.f : 0.f;
+
+            const uint32_t px = index & m_mask;
+            const uint32_t py = index / m_size;
+            const float sign = value ? 1.f : -1.f;
+
+            const uint32_t rowCount = std::min(m_size, 2 * c_BlueNoiseKernelRadius + 1);
+            for (uint32_t row = 0; row < rowCount; row++)
+            {
+                const uint32_t y = (py + row - rowCount / 2) & m_mask;
+                float* energyRow = m_energy.data() + y * m_size;
+                const float* lutRow = m_lut.data() + ((y - py) & m_mask) * m_size * 2 + (m_size - px);
+                uint32_t x = 0;
+
+#if SAMPLING_TABLES_USE_SSE
+                const __m128 sign4 = _mm_set1_ps(sign);
+                for (; x + 4 <= m_size; x += 4)
+                    _mm_storeu_ps(energyRow + x, _mm_add_ps(_mm_loadu_ps(energyRow + x), _mm_mul_ps(_mm_loadu_ps(lutRow + x), sign4)));
+#endif
+
+                for (; x < m_size; x++)
+                    energyRow[x] += sign * lutRow[x];
+            }
+        }
+
+        bool Get(uint32_t index) const { return m_occupied[index] != 0.f; }
+
+        uint32_t FindTightestCluster() const { return FindMaxKey(1.f, -1.f, 1.f); }
+        uint32_t FindLargestVoid() const { return FindMaxKey(-1.f, 1.f, 0.f); }
+
+    private:
+        // key = energySign * energy - (occupiedScale * occupied + occupiedBias) * 1e30，返回 key 最大且下标最小的像素
+        // 最紧的簇只在已放置点里找，最大的空洞只在空位里找，不符合的像素 key 接近负无穷
+        uint32_t FindMaxKey(float energySign, float occupiedScale, float occupiedBias) const
+        {
+            const float penalty = 1e30f;
+            const uint32_t pixelCount = uint32_t(m_energy.size());
+            float bestKey = -INFINITY;
+            uint32_t best = 0;
+            uint32_t i = 0;
+
+#if SAMPLING_TABLES_USE_SSE
+            if (pixelCount >= 4)
+            {
+                const __m128 sign4 = _mm_set1_ps(energySign);
+                const __m128 scale4 = _mm_set1_ps(occupiedScale * penalty);
+                const __m128 bias4 = _mm_set1_ps(occupiedBias * penalty);
+                const __m128 step = _mm_set1_ps(4.f);
+                __m128 index4 = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+                __m128 bestKey4 = _mm_set1_ps(-INFINITY);
+                __m128 bestIndex4 = _mm_setzero_ps();
+
+                for (; i + 4 <= pixelCount; i += 4)
+                {
+                    const __m128 occupied = _mm_loadu_ps(m_occupied.data() + i);
+                    const __m128 key = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(m_energy.data() + i), sign4), _mm_add_ps(_mm_mul_ps(occupied, scale4), bias4));
+                    const __m128 greater = _mm_cmpgt_ps(key, bestKey4);
+                    bestKey4 = _mm_or_ps(_mm_and_ps(greater, key), _mm_andnot_ps(greater, bestKey4));
+                    bestIndex4 = _mm_or_ps(_mm_and_ps(greater, index4), _mm_andnot_ps(greater, bestIndex4));
+                    index4 = _mm_add_ps(index4, step);
+                }
+
+                float keys[4], indices[4];
+                _mm_storeu_ps(keys, bestKey4);
+                _mm_storeu_ps(indices, bestIndex4);
+                for (uint32_t lane = 0; lane < 4; lane++)
+                {
+                    const uint32_t index = uint32_t(indices[lane]);
+                    if (keys[lane] > bestKey || (keys[lane] == bestKey && index < best))
+                    {
+                        bestKey = keys[lane];
+                        best = index;
+                    }
+                }
+            }
+#endif
+
+            for (; i < pixelCount; i++)
+            {
+                const float key = energySign * m_energy[i] - (occupiedScale * m_occupied[i] + occupiedBias) * penalty;
+                if (key > bestKey)
+                {
+                    bestKey = key;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        uint32_t m_size;
+        uint32_t m_mask;
+        std::vector<float> m_occupied; // 1 为已放置，0 为空位
+        std::vector<float> m_energy;
+        std::vector<float> m_lut;
+    };
+
+    void GenerateBlueNoise(float* values, uint32_t size, uint32_t seed)
+    {
+        const uint32_t pixelCount = size * size;
+        const uint32_t initialCount = std::max(1u, pixelCount / 10);
+
+        // 随机初始点集，再反复把最紧的簇移到最大的空洞，直到稳定
+        VoidAndCluster prototype(size);
+        uint32_t state = rtxdi::JenkinsHash(seed);
+        for (uint32_t placed = 0; placed < initialCount;)
+        {
+            state = rtxdi::JenkinsHash(state + placed);
+            const uint32_t index = state & (pixelCount - 1);
+            if (!prototype.Get(index))
+            {
+                prototype.Set(index, true);
+                placed++;
+            }
+        }
+
+        for (uint32_t iteration = 0; iteration < pixelCount; iteration++)
+        {
+            const uint32_t cluster = prototype.FindTightestCluster();
+            prototype.Set(cluster, false);
+            const uint32_t largestVoid = prototype.FindLargestVoid();
+            prototype.Set(largestVoid, true);
+            if (largestVoid == cluster)
+                break;
+        }
+
+        // 初始点集内按移除顺序倒序排名，之后按填入空洞的顺序排名
+        VoidAndCluster pattern = prototype;
+        for (uint32_t rank = initialCount; rank > 0; rank--)
+        {
+            const uint32_t cluster = pattern.FindTightestCluster();
+            pattern.Set(cluster, false);
+            values[cluster] = float(rank - 1);
+        }
+
+        pattern = prototype;
+        for (uint32_t rank = initialCount; rank < pixelCount; rank++)
+        {
+            const uint32_t largestVoid = pattern.FindLargestVoid();
+            pattern.Set(largestVoid, true);
+            values[largestVoid] = float(rank);
+        }
+
+        const float invPixelCount = 1.f / float(pixelCount);
+        for (uint32_t i = 0; i < pixelCount; i++)
+            values[i] = (values[i] + 0.5f) * invPixelCount;
+    }
+}
+
+SamplingTableCache& SamplingTableCache::Get()
+{
+    static SamplingTableCache cache;
+    return cache;
+}
+
+const uint8_t* SamplingTableCache::GetNeighborOffsets(uint32_t neighborOffsetCount, uint32_t radius, NeighborOffsetDistribution distribution)
+{
+    if (!IsNonzeroPowerOf2(neighborOffsetCount) || radius == 0 || radius > 254 ||
+        (distribution != NeighborOffsetDistribution_Uniform && distribution != NeighborOffsetDistribution_CenterWeighted))
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<uint8_t>& table = m_neighborOffsets[std::make_tuple(neighborOffsetCount, radius, uint32_t(distribution))];
+    if (table.empty())
+    {
+        table.resize(neighborOffsetCount * 2);
+        GenerateNeighborOffsets(table.data(), neighborOffsetCount, radius, distribution);
+    }
+    return table.data();
+}
+
+const float* SamplingTableCache::GetBlueNoiseTile(uint32_t size, uint32_t seed)
+{
+    if (!IsNonzeroPowerOf2(size) || size < 4 || size > c_MaxBlueNoiseTileSize)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<float>& tile = m_blueNoiseTiles[std::make_pair(size, seed)];
+    if (tile.empty())
+    {
+        tile.resize(size * size);
+        GenerateBlueNoise(tile.data(), size, seed);
+    }
+    return tile.data();
+}
+
+const uint32_t* SamplingTableCache::GetFrameSeeds(uint32_t count)
+{
+    if (count == 0)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<uint32_t>& seeds = m_frameSeeds[count];
+    if (seeds.empty())
+    {
+        seeds.resize(count);
+        ParallelFor(count, c_MinSeedsPerBatch, [&](uint32_t begin, uint32_t end)
+        {
+            GenerateFrameSeeds(seeds.data(), begin, end);
+        });
+    }
+    return seeds.data();
+}
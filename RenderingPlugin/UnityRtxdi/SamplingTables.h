@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+enum NeighborOffsetDistribution : uint32_t
+{
+    // 单位圆内均匀分布，与 rtxdi::FillNeighborOffsetBuffer 相同
+    NeighborOffsetDistribution_Uniform = 0,
+    // 偏移长度再乘一次到中心的归一化距离，样本更集中在中心附近
+    NeighborOffsetDistribution_CenterWeighted = 1,
+};
+
+// 采样用的查找表按配置生成一次后缓存，所有 DI / GI context 共用
+// 返回的指针在插件卸载前一直有效，参数非法时返回空
+class SamplingTableCache
+{
+public:
+    static SamplingTableCache& Get();
+
+    // neighborOffsetCount 为 2 的幂，radius 为 [1, 254]，每个偏移 2 个 int8
+    // radius = 250 且 Uniform 时与 rtxdi::FillNeighborOffsetBuffer 的结果逐字节相同
+    const uint8_t* GetNeighborOffsets(uint32_t neighborOffsetCount, uint32_t radius, NeighborOffsetDistribution distribution);
+
+    // size x size 的 void-and-cluster 蓝噪声，size 为 [4, 128] 的 2 的幂，值为 (rank + 0.5) / (size * size)
+    const float* GetBlueNoiseTile(uint32_t size, uint32_t seed);
+
+    // 第 i 项为 JenkinsHash(i)，即 ReSTIR DI / GI 在第 i 帧使用的 uniformRandomNumber
+    const uint32_t* GetFrameSeeds(uint32_t count);
+
+private:
+    SamplingTableCache() = default;
+
+    std::mutex m_mutex;
+    // std::map 的节点地址不变，插入后的 vector 不再修改，所以数据指针可以直接交给调用方
+    std::map<std::tuple<uint32_t, uint32_t, uint32_t>, std::vector<uint8_t>> m_neighborOffsets;
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<float>> m_blueNoiseTiles;
+    std::map<uint32_t, std::vector<uint32_t>> m_frameSeeds;
+};
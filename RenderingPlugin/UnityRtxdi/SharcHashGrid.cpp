@@ -0,0 +1,633 @@
+﻿#include "SharcHashGrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include <Rtxdi/RtxdiUtils.h>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    constexpr uint32_t c_MinSamplesPerBatch = 4096;
+    constexpr uint32_t c_MinEntriesPerBatch = 65536;
+    constexpr float c_DefaultSceneScale = 45.f;
+    constexpr float c_DefaultLogarithmBase = 2.f;
+    constexpr uint32_t c_DefaultStaleFrameNumMax = 32;
+    constexpr uint32_t c_StaleFrameNumBitMask = 0xFF;
+    constexpr float c_DefaultRoomSize = 40.f;
+    constexpr float c_CameraHeight = 1.7f;
+
+    uint64_t PackGridPosition(int32_t x, int32_t y, int32_t z, uint32_t level)
+    {
+        return ((uint64_t(uint32_t(x)) & HashGridPositionBitMask) << (HashGridPositionBitNum * 0)) |
+               ((uint64_t(uint32_t(y)) & HashGridPositionBitMask) << (HashGridPositionBitNum * 1)) |
+               ((uint64_t(uint32_t(z)) & HashGridPositionBitMask) << (HashGridPositionBitNum * 2)) |
+               ((uint64_t(level) & HashGridLevelBitMask) << (HashGridPositionBitNum * 3));
+    }
+
+    // xorshift32
+    uint32_t NextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    float NextRandomFloat(uint32_t& state)
+    {
+        return float(NextRandom(state) >> 8) * (1.f / 16777216.f);
+    }
+
+    // 逐帧执行 update（多线程插入）和 resolve（按 stale 帧数清除），统计插入和占用情况
+    class SharcSimulator
+    {
+    public:
+        SharcSimulator(const SharcSimulationSettings& settings, uint32_t staleFrameNumMax) :
+            m_hashMap(settings.capacity, settings.bucketSize ? settings.bucketSize : HashGridDefaultBucketSize,
+                settings.hashFunction < HashGridHashFunction_Count ? HashGridHashFunction(settings.hashFunction) : HashGridDefaultHashFunction),
+            m_staleFrameNumMax(std::clamp(staleFrameNumMax ? staleFrameNumMax : c_DefaultStaleFrameNumMax, 1u, c_StaleFrameNumBitMask)),
+            m_touched(new std::atomic<uint8_t>[m_hashMap.GetCapacity()]),
+            m_staleFrameNum(m_hashMap.GetCapacity(), 0)
+        {
+            for (uint32_t i = 0; i < m_hashMap.GetCapacity(); i++)
+                m_touched[i].store(0, std::memory_order_relaxed);
+        }
+
+        // getSample(index, position, normal) 返回 normal 指针，可以为空
+        template <typename GetSample>
+        void RunFrame(uint32_t sampleCount, GetSample&& getSample)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            std::mutex statsMutex;
+            ParallelFor(sampleCount, c_MinSamplesPerBatch, [&](uint32_t begin, uint32_t end)
+            {
+                uint64_t failures = 0;
+                uint64_t newEntries = 0;
+                uint64_t probeSum = 0;
+                uint32_t maxProbe = 0;
+
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    float position[3];
+                    float normalStorage[3];
+                    const float* normal = getSample(i, position, normalStorage);
+
+                    uint32_t cacheIndex = HashGridInvalidCacheIndex;
+                    uint32_t probeLength = 0;
+                    bool inserted = false;
+                    if (m_hashMap.Insert(ComputeKey(position, normal), cacheIndex, &probeLength, &inserted))
+                    {
+                        if (m_touched[cacheIndex].load(std::memory_order_relaxed) == 0)
+                            m_touched[cacheIndex].store(1, std::memory_order_relaxed);
+                        newEntries += inserted ? 1 : 0;
+                    }
+                    else
+                    {
+                        failures++;
+                    }
+
+                    probeSum += probeLength;
+                    maxProbe = std::max(maxProbe, probeLength);
+                }
+
+                std::lock_guard<std::mutex> lock(statsMutex);
+                m_stats.insertFailures += failures;
+                m_stats.newEntries += newEntries;
+                m_probeSum += probeSum;
+                m_stats.maxProbeLength = std::max(m_stats.maxProbeLength, maxProbe);
+            });
+            m_stats.insertCount += sampleCount;
+
+            Resolve();
+
+            m_frameCount++;
+            m_totalMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        void SetGridParameters(const HashGridParameters& gridParameters)
+        {
+            m_gridParameters = gridParameters;
+        }
+
+        SharcSimulationStats Finish()
+        {
+            SharcSimulationStats stats = m_stats;
+            const uint32_t capacity = m_hashMap.GetCapacity();
+            stats.capacity = capacity;
+            stats.bucketSize = m_hashMap.GetBucketSize();
+            stats.failureRate = stats.insertCount ? float(double(stats.insertFailures) / double(stats.insertCount)) : 0.f;
+            stats.meanProbeLength = stats.insertCount ? float(double(m_probeSum) / double(stats.insertCount)) : 0.f;
+            if (m_frameCount)
+            {
+                stats.meanOccupancy = float(m_occupancySum / m_frameCount);
+                stats.churnPerFrame = float(double(stats.newEntries + stats.evictedEntries) / double(m_frameCount) / double(capacity));
+                stats.millisecondsPerFrame = float(m_totalMilliseconds / m_frameCount);
+            }
+            return stats;
+        }
+
+        std::vector<HashGridKey> GetLiveKeys() const
+        {
+            std::vector<HashGridKey> keys;
+            for (uint32_t i = 0; i < m_hashMap.GetCapacity(); i++)
+            {
+                const HashGridKey hashKey = m_hashMap.GetEntry(i);
+                if (hashKey != HashGridInvalidHashKey)
+                    keys.push_back(hashKey);
+            }
+            return keys;
+        }
+
+        const SharcHashMap& GetHashMap() const { return m_hashMap; }
+
+    private:
+        // 与 SharcResolveEntry 相同：本帧有采样的 entry stale 计数归零，否则加一，达到上限后清除
+        void Resolve()
+        {
+            const uint32_t capacity = m_hashMap.GetCapacity();
+
+            std::mutex statsMutex;
+            uint64_t liveEntries = 0;
+            ParallelFor(capacity, c_MinEntriesPerBatch, [&](uint32_t begin, uint32_t end)
+            {
+                uint64_t live = 0;
+                uint64_t evicted = 0;
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    if (m_hashMap.GetEntry(i) == HashGridInvalidHashKey)
+                        continue;
+
+                    const bool touched = m_touched[i].load(std::memory_order_relaxed) != 0;
+                    m_touched[i].store(0, std::memory_order_relaxed);
+
+                    const uint32_t staleFrameNum = touched ? 0 : m_staleFrameNum[i] + 1;
+                    if (staleFrameNum >= m_staleFrameNumMax)
+                    {
+                        m_hashMap.SetEntry(i, HashGridInvalidHashKey);
+                        m_staleFrameNum[i] = 0;
+                        evicted++;
+                        continue;
+                    }
+
+                    m_staleFrameNum[i] = uint8_t(staleFrameNum);
+                    live++;
+                }
+
+                std::lock_guard<std::mutex> lock(statsMutex);
+                liveEntries += live;
+                m_stats.evictedEntries += evicted;
+            });
+
+            const float occupancy = float(double(liveEntries) / double(capacity));
+            m_occupancySum += occupancy;
+            m_stats.peakOccupancy = std::max(m_stats.peakOccupancy, occupancy);
+            m_stats.finalOccupancy = occupancy;
+        }
+
+        HashGridKey ComputeKey(const float position[3], const float* normal) const
+        {
+            return HashGridComputeSpatialHash(position, normal, m_gridParameters);
+        }
+
+        SharcHashMap m_hashMap;
+        uint32_t m_staleFrameNumMax;
+        std::unique_ptr<std::atomic<uint8_t>[]> m_touched;
+        std::vector<uint8_t> m_staleFrameNum;
+        HashGridParameters m_gridParameters = {};
+
+        SharcSimulationStats m_stats = {};
+        uint64_t m_probeSum = 0;
+        double m_occupancySum = 0.0;
+        double m_totalMilliseconds = 0.0;
+        uint32_t m_frameCount = 0;
+    };
+
+    HashGridParameters MakeGridParameters(const float cameraPosition[3], float sceneScale, float logarithmBase, float levelBias)
+    {
+        HashGridParameters gridParameters;
+        gridParameters.cameraPosition[0] = cameraPosition[0];
+        gridParameters.cameraPosition[1] = cameraPosition[1];
+        gridParameters.cameraPosition[2] = cameraPosition[2];
+        gridParameters.logarithmBase = logarithmBase > 1.f ? logarithmBase : c_DefaultLogarithmBase;
+        gridParameters.sceneScale = sceneScale > 0.f ? sceneScale : c_DefaultSceneScale;
+        gridParameters.levelBias = levelBias;
+        return gridParameters;
+    }
+}
+
+// http://burtleburtle.net/bob/hash/integer.html
+uint32_t HashGridHashJenkins32(uint32_t a)
+{
+    a = (a + 0x7ed55d16) + (a << 12);
+    a = (a ^ 0xc761c23c) ^ (a >> 19);
+    a = (a + 0x165667b1) + (a << 5);
+    a = (a + 0xd3a2646c) ^ (a << 9);
+    a = (a + 0xfd7046c5) + (a << 3);
+    a = (a ^ 0xb55a4f09) ^ (a >> 16);
+
+    return a;
+}
+
+// https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp fmix64
+uint32_t HashGridHashMurmur3(HashGridKey hashKey)
+{
+    hashKey ^= hashKey >> 33;
+    hashKey *= 0xff51afd7ed558ccdull;
+    hashKey ^= hashKey >> 33;
+    hashKey *= 0xc4ceb9fe1a85ec53ull;
+    hashKey ^= hashKey >> 33;
+
+    return uint32_t(hashKey);
+}
+
+// https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md，两个 32 位输入，seed 为 0
+uint32_t HashGridHashXXHash32(HashGridKey hashKey)
+{
+    constexpr uint32_t prime2 = 0x85EBCA77u;
+    constexpr uint32_t prime3 = 0xC2B2AE3Du;
+    constexpr uint32_t prime4 = 0x27D4EB2Fu;
+    constexpr uint32_t prime5 = 0x165667B1u;
+
+    uint32_t h = prime5 + 8u;
+    h += uint32_t(hashKey & 0xFFFFFFFF) * prime3;
+    h = ((h << 17) | (h >> 15)) * prime4;
+    h += uint32_t(hashKey >> 32) * prime3;
+    h = ((h << 17) | (h >> 15)) * prime4;
+
+    h ^= h >> 15;
+    h *= prime2;
+    h ^= h >> 13;
+    h *= prime3;
+    h ^= h >> 16;
+
+    return h;
+}
+
+namespace
+{
+    // https://www.reedbeta.com/blog/hash-functions-for-gpu-rendering/
+    uint32_t HashGridHashPcg32(uint32_t v)
+    {
+        const uint32_t state = v * 747796405u + 2891336453u;
+        const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+}
+
+uint32_t HashGridHashPcg(HashGridKey hashKey)
+{
+    return HashGridHashPcg32(uint32_t(hashKey & 0xFFFFFFFF) + HashGridHashPcg32(uint32_t(hashKey >> 32)));
+}
+
+uint32_t HashGridHash32(HashGridKey hashKey, HashGridHashFunction hashFunction)
+{
+    switch (hashFunction)
+    {
+    case HashGridHashFunction_Murmur3:
+        return HashGridHashMurmur3(hashKey);
+    case HashGridHashFunction_XXHash32:
+        return HashGridHashXXHash32(hashKey);
+    case HashGridHashFunction_Pcg:
+        return HashGridHashPcg(hashKey);
+    default:
+        return HashGridHashJenkins32(uint32_t(hashKey & 0xFFFFFFFF)) ^ HashGridHashJenkins32(uint32_t(hashKey >> 32));
+    }
+}
+
+uint32_t HashGridGetBaseSlot(HashGridKey hashKey, uint32_t capacity, uint32_t bucketSize, HashGridHashFunction hashFunction)
+{
+    const uint32_t slot = HashGridHash32(hashKey, hashFunction) % capacity;
+    return std::min(slot, capacity - bucketSize);
+}
+
+uint32_t HashGridGetLevel(const float samplePosition[3], const HashGridParameters& gridParameters)
+{
+    const float dx = gridParameters.cameraPosition[0] - samplePosition[0];
+    const float dy = gridParameters.cameraPosition[1] - samplePosition[1];
+    const float dz = gridParameters.cameraPosition[2] - samplePosition[2];
+    const float distance2 = dx * dx + dy * dy + dz * dz;
+
+    const float level = 0.5f * (std::log(distance2) / std::log(gridParameters.logarithmBase)) + gridParameters.levelBias;
+    return uint32_t(std::clamp(level, 1.f, float(HashGridLevelBitMask)));
+}
+
+float HashGridGetVoxelSize(uint32_t gridLevel, const HashGridParameters& gridParameters)
+{
+    return std::pow(gridParameters.logarithmBase, float(gridLevel)) /
+        (gridParameters.sceneScale * std::pow(gridParameters.logarithmBase, gridParameters.levelBias));
+}
+
+HashGridKey HashGridComputeSpatialHash(const float samplePosition[3], const float* sampleNormal, const HashGridParameters& gridParameters)
+{
+    const float position[3] = {
+        samplePosition[0] + HashGridPositionBias,
+        samplePosition[1] + HashGridPositionBias,
+        samplePosition[2] + HashGridPositionBias };
+
+    const uint32_t gridLevel = HashGridGetLevel(position, gridParameters);
+    const float voxelSize = HashGridGetVoxelSize(gridLevel, gridParameters);
+
+    HashGridKey hashKey = PackGridPosition(
+        int32_t(std::floor(position[0] / voxelSize)),
+        int32_t(std::floor(position[1] / voxelSize)),
+        int32_t(std::floor(position[2] / voxelSize)),
+        gridLevel);
+
+    if (sampleNormal)
+    {
+        const uint32_t normalBits =
+            (sampleNormal[0] + HashGridNormalBias >= 0 ? 0 : 1) +
+            (sampleNormal[1] + HashGridNormalBias >= 0 ? 0 : 2) +
+            (sampleNormal[2] + HashGridNormalBias >= 0 ? 0 : 4);
+
+        hashKey |= uint64_t(normalBits) << (HashGridPositionBitNum * 3 + HashGridLevelBitNum);
+    }
+
+    return hashKey;
+}
+
+void HashGridGetPositionFromKey(HashGridKey hashKey, const HashGridParameters& gridParameters, float outPosition[3])
+{
+    const float voxelSize = HashGridGetVoxelSize(HashGridGetLevelFromKey(hashKey), gridParameters);
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        // 17 位有符号数
+        int32_t gridPosition = int32_t((hashKey >> (HashGridPositionBitNum * axis)) & HashGridPositionBitMask);
+        if (gridPosition & (1 << (HashGridPositionBitNum - 1)))
+            gridPosition |= ~int32_t(HashGridPositionBitMask);
+
+        outPosition[axis] = (float(gridPosition) + 0.5f) * voxelSize;
+    }
+}
+
+uint32_t HashGridGetLevelFromKey(HashGridKey hashKey)
+{
+    return uint32_t(hashKey >> (HashGridPositionBitNum * 3)) & HashGridLevelBitMask;
+}
+
+uint32_t HashGridGetNormalBitsFromKey(HashGridKey hashKey)
+{
+    return uint32_t(hashKey >> (HashGridPositionBitNum * 3 + HashGridLevelBitNum)) & HashGridNormalBitMask;
+}
+
+SharcHashMap::SharcHashMap(uint32_t capacity, uint32_t bucketSize, HashGridHashFunction hashFunction) :
+    m_capacity(std::max(capacity, bucketSize)),
+    m_bucketSize(bucketSize),
+    m_hashFunction(hashFunction),
+    m_entries(new std::atomic<uint64_t>[m_capacity])
+{
+    Clear();
+}
+
+bool SharcHashMap::Insert(HashGridKey hashKey, uint32_t& cacheIndex, uint32_t* probeLength, bool* inserted)
+{
+    const uint32_t baseSlot = HashGridGetBaseSlot(hashKey, m_capacity, m_bucketSize, m_hashFunction);
+    for (uint32_t bucketOffset = 0; bucketOffset < m_bucketSize; ++bucketOffset)
+    {
+        HashGridKey prevHashKey = HashGridInvalidHashKey;
+        m_entries[baseSlot + bucketOffset].compare_exchange_strong(prevHashKey, hashKey, std::memory_order_relaxed);
+
+        if (prevHashKey == HashGridInvalidHashKey || prevHashKey == hashKey)
+        {
+            cacheIndex = baseSlot + bucketOffset;
+            if (probeLength) *probeLength = bucketOffset + 1;
+            if (inserted) *inserted = prevHashKey == HashGridInvalidHashKey;
+            return true;
+        }
+    }
+
+    cacheIndex = m_capacity - 1;
+    if (probeLength) *probeLength = m_bucketSize;
+    if (inserted) *inserted = false;
+    return false;
+}
+
+bool SharcHashMap::Find(HashGridKey hashKey, uint32_t& cacheIndex, uint32_t& bucketOffset) const
+{
+    const uint32_t baseSlot = HashGridGetBaseSlot(hashKey, m_capacity, m_bucketSize, m_hashFunction);
+    for (bucketOffset = 0; bucketOffset < m_bucketSize; ++bucketOffset)
+    {
+        if (m_entries[baseSlot + bucketOffset].load(std::memory_order_relaxed) == hashKey)
+        {
+            cacheIndex = baseSlot + bucketOffset;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SharcHashMap::Clear()
+{
+    for (uint32_t i = 0; i < m_capacity; i++)
+        m_entries[i].store(HashGridInvalidHashKey, std::memory_order_relaxed);
+}
+
+namespace
+{
+    bool IsValidTrace(const SharcTraceDesc& trace)
+    {
+        return trace.samplePositions && trace.cameraPositions && trace.frameSampleCounts;
+    }
+
+    void ReplayTrace(SharcSimulator& simulator, const SharcTraceDesc& trace)
+    {
+        uint64_t sampleOffset = 0;
+        for (uint32_t frame = 0; frame < trace.frameCount; frame++)
+        {
+            simulator.SetGridParameters(MakeGridParameters(trace.cameraPositions + frame * 3, trace.sceneScale, trace.logarithmBase, trace.levelBias));
+
+            const float* positions = trace.samplePositions + sampleOffset * 3;
+            const float* normals = trace.sampleNormals ? trace.sampleNormals + sampleOffset * 3 : nullptr;
+            simulator.RunFrame(trace.frameSampleCounts[frame], [positions, normals](uint32_t i, float position[3], float*) -> const float*
+            {
+                position[0] = positions[i * 3 + 0];
+                position[1] = positions[i * 3 + 1];
+                position[2] = positions[i * 3 + 2];
+                return normals ? normals + i * 3 : nullptr;
+            });
+
+            sampleOffset += trace.frameSampleCounts[frame];
+        }
+    }
+
+    void ReplaySyntheticTrace(SharcSimulator& simulator, const SharcSyntheticTraceDesc& desc)
+    {
+        const float roomSize = desc.roomSize > 0.f ? desc.roomSize : c_DefaultRoomSize;
+        const float halfSize = roomSize * 0.5f;
+        const float roomHeight = roomSize * 0.25f;
+        const float cameraRadius = roomSize * 0.25f;
+
+        for (uint32_t frame = 0; frame < desc.frameCount; frame++)
+        {
+            // 沿半径为房间 1/4 的圆移动
+            const float angle = desc.cameraSpeed * float(frame) / cameraRadius;
+            const float camera[3] = { cameraRadius * std::cos(angle), std::min(c_CameraHeight, roomHeight * 0.5f), cameraRadius * std::sin(angle) };
+            simulator.SetGridParameters(MakeGridParameters(camera, desc.sceneScale, 0.f, 0.f));
+
+            const uint32_t frameSeed = rtxdi::JenkinsHash(desc.seed * 65537u + frame);
+            simulator.RunFrame(desc.samplesPerFrame, [&](uint32_t i, float position[3], float normal[3]) -> const float*
+            {
+                uint32_t random = rtxdi::JenkinsHash(i ^ frameSeed) | 1u;
+
+                // 球面均匀方向
+                const float z = NextRandomFloat(random) * 2.f - 1.f;
+                const float phi = NextRandomFloat(random) * 6.2831853f;
+                const float r = std::sqrt(std::max(0.f, 1.f - z * z));
+                const float direction[3] = { r * std::cos(phi), z, r * std::sin(phi) };
+
+                const float boundsMin[3] = { -halfSize, 0.f, -halfSize };
+                const float boundsMax[3] = { halfSize, roomHeight, halfSize };
+
+                // 相机在房间内部，射线与最近的墙面相交
+                float hitT = 1e30f;
+                uint32_t hitAxis = 0;
+                for (uint32_t axis = 0; axis < 3; axis++)
+                {
+                    if (std::abs(direction[axis]) < 1e-6f)
+                        continue;
+
+                    const float bound = direction[axis] > 0.f ? boundsMax[axis] : boundsMin[axis];
+                    const float t = (bound - camera[axis]) / direction[axis];
+                    if (t < hitT)
+                    {
+                        hitT = t;
+                        hitAxis = axis;
+                    }
+                }
+
+                for (uint32_t axis = 0; axis < 3; axis++)
+                {
+                    position[axis] = camera[axis] + direction[axis] * hitT;
+                    normal[axis] = axis == hitAxis ? (direction[axis] > 0.f ? -1.f : 1.f) : 0.f;
+                }
+                return normal;
+            });
+        }
+    }
+
+    SharcHashBenchmarkResult AnalyzeHashFunction(const SharcSimulator& simulator, const SharcSimulationStats& stats)
+    {
+        const SharcHashMap& hashMap = simulator.GetHashMap();
+        const HashGridHashFunction hashFunction = hashMap.GetHashFunction();
+        const uint32_t capacity = hashMap.GetCapacity();
+        const uint32_t bucketSize = hashMap.GetBucketSize();
+
+        SharcHashBenchmarkResult result = {};
+        result.hashFunction = hashFunction;
+        result.simulation = stats;
+
+        const std::vector<HashGridKey> keys = simulator.GetLiveKeys();
+        result.keyCount = uint32_t(keys.size());
+        if (keys.empty())
+            return result;
+
+        // 均匀度只看 hash 本身，不受插入顺序和 bucket 溢出的影响
+        const uint32_t bucketCount = std::max(capacity / bucketSize, 1u);
+        std::vector<uint32_t> bucketLoad(bucketCount, 0);
+        std::vector<uint8_t> slotLoad(capacity, 0);
+        for (HashGridKey hashKey : keys)
+        {
+            const uint32_t baseSlot = HashGridGetBaseSlot(hashKey, capacity, bucketSize, hashFunction);
+            bucketLoad[std::min(baseSlot / bucketSize, bucketCount - 1)]++;
+            if (slotLoad[baseSlot] < 255)
+                slotLoad[baseSlot]++;
+        }
+
+        const double expectedLoad = double(keys.size()) / double(bucketCount);
+        double chiSquared = 0.0;
+        for (uint32_t load : bucketLoad)
+            chiSquared += (double(load) - expectedLoad) * (double(load) - expectedLoad) / expectedLoad;
+        result.bucketChiSquared = bucketCount > 1 ? float(chiSquared / double(bucketCount - 1)) : 0.f;
+
+        uint64_t collidingKeys = 0;
+        for (uint8_t load : slotLoad)
+            collidingKeys += load > 1 ? load : 0;
+        result.slotCollisionRate = float(double(collidingKeys) / double(keys.size()));
+        // n 个 key 随机落在 m 个槽位中，某个 key 与其它 key 同槽的概率为 1 - (1 - 1/m)^(n-1)
+        result.expectedSlotCollisionRate = float(1.0 - std::exp(double(keys.size() - 1) * std::log1p(-1.0 / double(capacity))));
+
+        // 反复 hash 同一批 key 直到足够多次，只测 hash，不含取模和探测
+        const uint64_t minHashCount = 1ull << 24;
+        const uint32_t repeatCount = uint32_t((minHashCount + keys.size() - 1) / keys.size());
+        uint32_t sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t repeat = 0; repeat < repeatCount; repeat++)
+        {
+            for (HashGridKey hashKey : keys)
+                sink += HashGridHash32(hashKey ^ repeat, hashFunction);
+        }
+        const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        result.nanosecondsPerHash = float(nanoseconds / (double(repeatCount) * double(keys.size())));
+
+        // 防止编译器把循环优化掉
+        static std::atomic<uint32_t> s_sink{0};
+        s_sink.fetch_xor(sink, std::memory_order_relaxed);
+
+        return result;
+    }
+}
+
+SharcSimulationStats SimulateSharcHashGrid(const SharcTraceDesc& trace, const SharcSimulationSettings& settings)
+{
+    if (!IsValidTrace(trace) || settings.capacity == 0)
+        return {};
+
+    SharcSimulator simulator(settings, trace.staleFrameNumMax);
+    ReplayTrace(simulator, trace);
+    return simulator.Finish();
+}
+
+SharcSimulationStats SimulateSharcSyntheticTrace(const SharcSyntheticTraceDesc& desc, const SharcSimulationSettings& settings)
+{
+    if (settings.capacity == 0)
+        return {};
+
+    SharcSimulator simulator(settings, 0);
+    ReplaySyntheticTrace(simulator, desc);
+    return simulator.Finish();
+}
+
+void BenchmarkSharcHashFunctions(const SharcTraceDesc& trace, const SharcSimulationSettings& settings, SharcHashBenchmarkResult* results)
+{
+    for (uint32_t i = 0; i < HashGridHashFunction_Count; i++)
+    {
+        results[i] = {};
+        results[i].hashFunction = i;
+        if (!IsValidTrace(trace) || settings.capacity == 0)
+            continue;
+
+        SharcSimulationSettings hashSettings = settings;
+        hashSettings.hashFunction = i;
+
+        SharcSimulator simulator(hashSettings, trace.staleFrameNumMax);
+        ReplayTrace(simulator, trace);
+        const SharcSimulationStats stats = simulator.Finish();
+        results[i] = AnalyzeHashFunction(simulator, stats);
+    }
+}
+
+void BenchmarkSharcSyntheticHashFunctions(const SharcSyntheticTraceDesc& desc, const SharcSimulationSettings& settings, SharcHashBenchmarkResult* results)
+{
+    for (uint32_t i = 0; i < HashGridHashFunction_Count; i++)
+    {
+        results[i] = {};
+        results[i].hashFunction = i;
+        if (settings.capacity == 0)
+            continue;
+
+        SharcSimulationSettings hashSettings = settings;
+        hashSettings.hashFunction = i;
+
+        SharcSimulator simulator(hashSettings, 0);
+        ReplaySyntheticTrace(simulator, desc);
+        const SharcSimulationStats stats = simulator.Finish();
+        results[i] = AnalyzeHashFunction(simulator, stats);
+    }
+}
@@ -0,0 +1,159 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Shaders/Sharc/HashGridCommon.h 的 C++ 版本，key 的计算、层级选择和 HashMapInsert / HashMapFind 与 shader 逐位一致
+// 用于在 CPU 上回放采样点，按数据选择 SHARC_CAPACITY 和 HASH_GRID_HASH_MAP_BUCKET_SIZE
+constexpr uint32_t HashGridPositionBitNum = 17;
+constexpr uint32_t HashGridPositionBitMask = (1u << HashGridPositionBitNum) - 1;
+constexpr uint32_t HashGridLevelBitNum = 10;
+constexpr uint32_t HashGridLevelBitMask = (1u << HashGridLevelBitNum) - 1;
+constexpr uint32_t HashGridNormalBitNum = 3;
+constexpr uint32_t HashGridNormalBitMask = (1u << HashGridNormalBitNum) - 1;
+constexpr uint32_t HashGridDefaultBucketSize = 16;
+constexpr uint64_t HashGridInvalidHashKey = 0;
+constexpr uint32_t HashGridInvalidCacheIndex = 0xFFFFFFFF;
+constexpr float HashGridPositionBias = 1e-4f;
+constexpr float HashGridNormalBias = 1e-3f;
+
+typedef uint64_t HashGridKey;
+
+// 与 HashGridCommon.h 中 HASH_GRID_HASH 的取值一致
+enum HashGridHashFunction : uint32_t
+{
+    HashGridHashFunction_Jenkins = 0,   // 高低 32 位各做一次 Jenkins 再异或，HashGridCommon.h 未定义 HASH_GRID_HASH 时的取值
+    HashGridHashFunction_Murmur3 = 1,   // Murmur3 fmix64，GPU 上 64 位乘法需要拆成多条 32 位指令
+    HashGridHashFunction_XXHash32 = 2,  // xxHash32 处理两个 32 位字并做 avalanche
+    HashGridHashFunction_Pcg = 3,       // 两次 PCG 32 位 hash 串联
+    HashGridHashFunction_Count
+};
+
+// 与 Shared.hlsl 中的 HASH_GRID_HASH 一致，修改时两边要同时改
+constexpr HashGridHashFunction HashGridDefaultHashFunction = HashGridHashFunction_XXHash32;
+
+struct HashGridParameters
+{
+    float cameraPosition[3];
+    float logarithmBase;
+    float sceneScale;
+    float levelBias;
+};
+
+uint32_t HashGridHashJenkins32(uint32_t a);
+uint32_t HashGridHashMurmur3(HashGridKey hashKey);
+uint32_t HashGridHashXXHash32(HashGridKey hashKey);
+uint32_t HashGridHashPcg(HashGridKey hashKey);
+uint32_t HashGridHash32(HashGridKey hashKey, HashGridHashFunction hashFunction = HashGridDefaultHashFunction);
+uint32_t HashGridGetBaseSlot(HashGridKey hashKey, uint32_t capacity, uint32_t bucketSize = HashGridDefaultBucketSize,
+    HashGridHashFunction hashFunction = HashGridDefaultHashFunction);
+uint32_t HashGridGetLevel(const float samplePosition[3], const HashGridParameters& gridParameters);
+float HashGridGetVoxelSize(uint32_t gridLevel, const HashGridParameters& gridParameters);
+
+// sampleNormal 为空时等同于 HASH_GRID_USE_NORMALS 0
+HashGridKey HashGridComputeSpatialHash(const float samplePosition[3], const float* sampleNormal, const HashGridParameters& gridParameters);
+
+// 与 HashGridGetPositionFromKey 相同，返回 voxel 中心的世界坐标
+void HashGridGetPositionFromKey(HashGridKey hashKey, const HashGridParameters& gridParameters, float outPosition[3]);
+uint32_t HashGridGetLevelFromKey(HashGridKey hashKey);
+uint32_t HashGridGetNormalBitsFromKey(HashGridKey hashKey);
+
+// hashEntriesBuffer 的 CPU 版本，插入用 64 位 CAS，可以在多个线程上同时调用
+class SharcHashMap
+{
+public:
+    SharcHashMap(uint32_t capacity, uint32_t bucketSize = HashGridDefaultBucketSize, HashGridHashFunction hashFunction = HashGridDefaultHashFunction);
+
+    // 与 shader 相同，失败时 cacheIndex 为 capacity - 1；probeLength 为检查过的槽位数
+    bool Insert(HashGridKey hashKey, uint32_t& cacheIndex, uint32_t* probeLength = nullptr, bool* inserted = nullptr);
+    bool Find(HashGridKey hashKey, uint32_t& cacheIndex, uint32_t& bucketOffset) const;
+
+    HashGridKey GetEntry(uint32_t index) const { return m_entries[index].load(std::memory_order_relaxed); }
+    void SetEntry(uint32_t index, HashGridKey hashKey) { m_entries[index].store(hashKey, std::memory_order_relaxed); }
+    void Clear();
+
+    uint32_t GetCapacity() const { return m_capacity; }
+    uint32_t GetBucketSize() const { return m_bucketSize; }
+    HashGridHashFunction GetHashFunction() const { return m_hashFunction; }
+
+private:
+    uint32_t m_capacity;
+    uint32_t m_bucketSize;
+    HashGridHashFunction m_hashFunction;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_entries;
+};
+
+// 录制或合成的采样序列，按帧连续存放
+struct SharcTraceDesc
+{
+    const float* samplePositions;   // 世界空间 float3（与 shader 中 GetGlobalPos 的结果一致）
+    const float* sampleNormals;     // float3，可以为空，表示不使用法线
+    const float* cameraPositions;   // 每帧一个 float3
+    const uint32_t* frameSampleCounts;
+    uint32_t frameCount;
+    float sceneScale;               // 0 表示 45，与 SHARC_SCENE_SCALE 一致
+    float logarithmBase;            // 0 表示 2，与 SHARC_GRID_LOGARITHM_BASE 一致
+    float levelBias;
+    uint32_t staleFrameNumMax;      // 0 表示 32，与 SharcResolve 中传入的 SHARC_STALE_FRAME_NUM_MIN 一致
+    uint32_t pad1;
+};
+
+struct SharcSimulationSettings
+{
+    uint32_t capacity;
+    uint32_t bucketSize;            // 0 表示 16
+    uint32_t hashFunction;          // HashGridHashFunction
+    uint32_t pad1;
+};
+
+struct SharcSimulationStats
+{
+    uint32_t capacity;
+    uint32_t bucketSize;
+    uint64_t insertCount;
+    uint64_t insertFailures;        // bucket 已满，shader 中这些采样会写到 capacity - 1
+    uint64_t newEntries;
+    uint64_t evictedEntries;        // 超过 staleFrameNumMax 帧没有采样被 resolve 清除
+    float failureRate;
+    float meanProbeLength;
+    uint32_t maxProbeLength;
+    float meanOccupancy;            // 每帧 resolve 之后有效 entry 的比例的平均值
+    float peakOccupancy;
+    float finalOccupancy;
+    float churnPerFrame;            // 平均每帧新建加清除的 entry 数 / capacity
+    float millisecondsPerFrame;
+};
+
+// 按 shader 的 update + resolve 顺序逐帧回放：帧内多线程并发插入，帧末按 staleFrameNumMax 清除过期 entry
+SharcSimulationStats SimulateSharcHashGrid(const SharcTraceDesc& trace, const SharcSimulationSettings& settings);
+
+// 合成场景：相机在一个长方体房间里绕圈移动，每帧从相机向随机方向发射射线，命中点作为采样点
+struct SharcSyntheticTraceDesc
+{
+    uint32_t frameCount;
+    uint32_t samplesPerFrame;       // 对应 (宽 / SHARC_DOWNSCALE) * (高 / SHARC_DOWNSCALE)
+    uint32_t seed;
+    float roomSize;                 // 房间水平方向的边长，高度为其 1/4，0 表示 40
+    float cameraSpeed;              // 每帧移动的距离，0 表示静止
+    float sceneScale;               // 0 表示 45
+};
+
+SharcSimulationStats SimulateSharcSyntheticTrace(const SharcSyntheticTraceDesc& desc, const SharcSimulationSettings& settings);
+
+// 在同一个采样序列上比较各个 hash 函数：插入失败率和探测长度来自完整回放，
+// 分布均匀度和单次 hash 耗时用回放结束时表中仍然有效的 key 计算（即真实的 key 分布）
+struct SharcHashBenchmarkResult
+{
+    uint32_t hashFunction;
+    uint32_t keyCount;              // 参与均匀度和耗时测量的不同 key 数
+    float nanosecondsPerHash;       // CPU 上的耗时，只用于比较相对的 ALU 开销
+    float bucketChiSquared;         // 按 bucket 统计 base slot 的卡方 / 自由度，均匀分布时约为 1
+    float slotCollisionRate;        // base slot 与其它 key 相同的比例，与理想随机 hash 的期望值比较
+    float expectedSlotCollisionRate;
+    SharcSimulationStats simulation;
+};
+
+// results 需要 HashGridHashFunction_Count 个元素，settings.hashFunction 被忽略
+void BenchmarkSharcHashFunctions(const SharcTraceDesc& trace, const SharcSimulationSettings& settings, SharcHashBenchmarkResult* results);
+void BenchmarkSharcSyntheticHashFunctions(const SharcSyntheticTraceDesc& desc, const SharcSimulationSettings& settings, SharcHashBenchmarkResult* results);
@@ -0,0 +1,613 @@
+﻿#include "SharcSnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ParallelFor.h"
+
+namespace
+{
+    constexpr uint32_t c_SnapshotMagic = 0x43524853; // "SHRC"
+    constexpr uint32_t c_SnapshotVersion = 2;
+    // 每个 block 的第一个 key 和校验和写在 block 表里，block 之间可以并行解码和校验
+    constexpr uint32_t c_KeysPerBlock = 4096;
+    // 插入时按 base slot 分区，相邻分区交替处理，bucket 探测越过分区边界也不会与其它线程冲突
+    constexpr uint32_t c_MinSlotsPerPartition = 1 << 16;
+    constexpr uint32_t c_MinEntriesPerBatch = 16384;
+
+    constexpr float c_DefaultSceneScale = 45.f;
+    constexpr float c_DefaultLogarithmBase = 2.f;
+
+    // 与 SharcCommon.h 一致
+    constexpr uint32_t c_SampleNumBitMask = (1u << 18) - 1;
+    constexpr uint32_t c_AccumulatedFrameNumBitOffset = 18;
+    constexpr uint32_t c_AccumulatedFrameNumBitMask = (1u << 6) - 1;
+    constexpr uint32_t c_StaleFrameNumBitOffset = 24;
+
+    struct SnapshotHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t entryCount;
+        uint64_t sceneHash;
+        float sceneScale;
+        float logarithmBase;
+        float levelBias;
+        uint32_t useNormals;
+        float cameraPosition[3];
+        uint32_t keysPerBlock;
+        uint64_t payloadOffset;     // entryCount 个 SharcPackedData
+        uint64_t blockTableOffset;  // 每个 block 一个 SnapshotBlock
+        uint64_t keyStreamOffset;
+        uint64_t keyStreamBytes;
+        uint64_t blockTableChecksum;
+    };
+
+    struct SnapshotBlock
+    {
+        uint64_t firstKey;
+        uint64_t keyStreamOffset;   // 相对 keyStreamOffset，指向 block 中第二个 key 的差分
+        uint64_t checksum;          // block 的 payload 和 key 差分，解码时校验
+    };
+
+    float ResolveSceneScale(float sceneScale) { return sceneScale > 0.f ? sceneScale : c_DefaultSceneScale; }
+    float ResolveLogarithmBase(float logarithmBase) { return logarithmBase > 1.f ? logarithmBase : c_DefaultLogarithmBase; }
+
+    uint32_t GetBlockCount(uint32_t entryCount)
+    {
+        return (entryCount + c_KeysPerBlock - 1) / c_KeysPerBlock;
+    }
+
+    void WriteVarint(std::vector<uint8_t>& stream, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            stream.push_back(uint8_t(value | 0x80));
+            value >>= 7;
+        }
+        stream.push_back(uint8_t(value));
+    }
+
+    bool ReadVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64 && cursor < end; shift += 7)
+        {
+            const uint8_t byte = *cursor++;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    uint64_t MixChecksum(uint64_t hash, uint64_t value)
+    {
+        hash ^= value * 0x9E3779B97F4A7C15ull;
+        hash = (hash << 27) | (hash >> 37);
+        return hash * 0xC2B2AE3D27D4EB4Full;
+    }
+
+    uint64_t ComputeChecksum(uint64_t hash, const uint8_t* data, uint64_t size)
+    {
+        hash = MixChecksum(hash, size);
+        uint64_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            hash = MixChecksum(hash, word);
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, data + i, size_t(size - i));
+        return MixChecksum(hash, tail);
+    }
+
+    // block 的 key 差分在 key stream 中的范围
+    uint64_t GetBlockKeyStreamEnd(const SnapshotBlock* blocks, uint32_t blockCount, uint32_t block, uint64_t keyStreamBytes)
+    {
+        return block + 1 < blockCount ? blocks[block + 1].keyStreamOffset : keyStreamBytes;
+    }
+
+    uint64_t ComputeBlockChecksum(const SharcPackedData* payload, uint32_t entryCount, const SnapshotBlock& block, uint32_t blockIndex,
+        const uint8_t* keyStream, uint64_t keyStreamEnd)
+    {
+        const uint32_t first = blockIndex * c_KeysPerBlock;
+        const uint32_t last = std::min(entryCount, first + c_KeysPerBlock);
+        uint64_t hash = MixChecksum(block.firstKey, block.keyStreamOffset);
+        hash = ComputeChecksum(hash, reinterpret_cast<const uint8_t*>(payload + first), uint64_t(last - first) * sizeof(SharcPackedData));
+        return ComputeChecksum(hash, keyStream + block.keyStreamOffset, keyStreamEnd - block.keyStreamOffset);
+    }
+
+    float ElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 两个 entry 落到同一 voxel：radiance 和采样数相加，帧数取较大值
+    void MergePackedData(SharcPackedData& dst, const SharcPackedData& src)
+    {
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            float dstRadiance, srcRadiance;
+            memcpy(&dstRadiance, &dst.radianceData[i], sizeof(float));
+            memcpy(&srcRadiance, &src.radianceData[i], sizeof(float));
+            dstRadiance += srcRadiance;
+            memcpy(&dst.radianceData[i], &dstRadiance, sizeof(float));
+        }
+
+        const uint32_t sampleNum = std::min((dst.sampleData & c_SampleNumBitMask) + (src.sampleData & c_SampleNumBitMask), c_SampleNumBitMask);
+        const uint32_t frameNum = std::max((dst.sampleData >> c_AccumulatedFrameNumBitOffset) & c_AccumulatedFrameNumBitMask,
+            (src.sampleData >> c_AccumulatedFrameNumBitOffset) & c_AccumulatedFrameNumBitMask);
+        dst.sampleData = sampleNum | (frameNum << c_AccumulatedFrameNumBitOffset);
+    }
+}
+
+SharcSnapshotStats SaveSharcSnapshot(const char* path, const SharcSnapshotDesc& desc, const uint64_t* hashEntries, const SharcPackedData* resolved)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    SharcSnapshotStats stats = {};
+    if (!path || !hashEntries || !resolved || desc.capacity == 0)
+    {
+        stats.result = SharcSnapshotResult_InvalidArgument;
+        return stats;
+    }
+
+    stats.rawBytes = uint64_t(desc.capacity) * (sizeof(uint64_t) + sizeof(SharcPackedData));
+
+    // 只保留有采样的 entry，stale 计数在加载时清零
+    std::vector<std::pair<uint64_t, uint32_t>> liveEntries;
+    for (uint32_t i = 0; i < desc.capacity; i++)
+    {
+        if (hashEntries[i] != HashGridInvalidHashKey && (resolved[i].sampleData & c_SampleNumBitMask) != 0)
+            liveEntries.emplace_back(hashEntries[i], i);
+    }
+    std::sort(liveEntries.begin(), liveEntries.end());
+
+    const uint32_t entryCount = uint32_t(liveEntries.size());
+    const uint32_t blockCount = GetBlockCount(entryCount);
+
+    std::vector<SharcPackedData> payload(entryCount);
+    std::vector<SnapshotBlock> blocks(blockCount);
+    std::vector<uint8_t> keyStream;
+    keyStream.reserve(size_t(entryCount) * 3);
+
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        payload[i] = resolved[liveEntries[i].second];
+
+        const uint64_t key = liveEntries[i].first;
+        if (i % c_KeysPerBlock == 0)
+        {
+            blocks[i / c_KeysPerBlock].firstKey = key;
+            blocks[i / c_KeysPerBlock].keyStreamOffset = keyStream.size();
+        }
+        else
+        {
+            WriteVarint(keyStream, key - liveEntries[i - 1].first);
+        }
+    }
+
+    for (uint32_t block = 0; block < blockCount; block++)
+    {
+        blocks[block].checksum = ComputeBlockChecksum(payload.data(), entryCount, blocks[block], block, keyStream.data(),
+            GetBlockKeyStreamEnd(blocks.data(), blockCount, block, keyStream.size()));
+    }
+
+    SnapshotHeader header = {};
+    header.magic = c_SnapshotMagic;
+    header.version = c_SnapshotVersion;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.entryCount = entryCount;
+    header.sceneHash = desc.sceneHash;
+    header.sceneScale = ResolveSceneScale(desc.sceneScale);
+    header.logarithmBase = ResolveLogarithmBase(desc.logarithmBase);
+    header.levelBias = desc.levelBias;
+    header.useNormals = desc.useNormals ? 1 : 0;
+    memcpy(header.cameraPosition, desc.cameraPosition, sizeof(header.cameraPosition));
+    header.keysPerBlock = c_KeysPerBlock;
+    header.payloadOffset = sizeof(SnapshotHeader);
+    header.blockTableOffset = header.payloadOffset + payload.size() * sizeof(SharcPackedData);
+    header.keyStreamOffset = header.blockTableOffset + blocks.size() * sizeof(SnapshotBlock);
+    header.keyStreamBytes = keyStream.size();
+    header.blockTableChecksum = ComputeChecksum(c_SnapshotMagic, reinterpret_cast<const uint8_t*>(blocks.data()), blocks.size() * sizeof(SnapshotBlock));
+
+    std::vector<uint8_t> body(size_t(header.keyStreamOffset + header.keyStreamBytes - sizeof(SnapshotHeader)));
+    uint8_t* cursor = body.data();
+    if (!payload.empty()) memcpy(cursor, payload.data(), payload.size() * sizeof(SharcPackedData));
+    cursor += payload.size() * sizeof(SharcPackedData);
+    if (!blocks.empty()) memcpy(cursor, blocks.data(), blocks.size() * sizeof(SnapshotBlock));
+    cursor += blocks.size() * sizeof(SnapshotBlock);
+    if (!keyStream.empty()) memcpy(cursor, keyStream.data(), keyStream.size());
+
+    // 后台的定时保存和退出时的同步保存可能同时进行，写临时文件和替换需要串行
+    static std::mutex s_saveMutex;
+    std::lock_guard<std::mutex> saveLock(s_saveMutex);
+
+    const std::string tempPath = std::string(path) + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            stats.result = SharcSnapshotResult_FileError;
+            return stats;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(body.data()), std::streamsize(body.size()));
+        if (!file)
+        {
+            stats.result = SharcSnapshotResult_FileError;
+            return stats;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+        stats.result = SharcSnapshotResult_FileError;
+        return stats;
+    }
+
+    stats.result = SharcSnapshotResult_Ok;
+    stats.entryCount = entryCount;
+    stats.loadedEntries = entryCount;
+    stats.fileBytes = sizeof(SnapshotHeader) + body.size();
+    stats.milliseconds = ElapsedMilliseconds(start);
+    return stats;
+}
+
+SharcSnapshotStats LoadSharcSnapshot(const char* path, const SharcSnapshotDesc& desc, uint64_t* hashEntries, SharcPackedData* resolved)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    SharcSnapshotStats stats = {};
+    const uint32_t bucketSize = desc.bucketSize ? desc.bucketSize : HashGridDefaultBucketSize;
+    if (!path || !hashEntries || !resolved || desc.capacity < bucketSize)
+    {
+        stats.result = SharcSnapshotResult_InvalidArgument;
+        return stats;
+    }
+
+    stats.rawBytes = uint64_t(desc.capacity) * (sizeof(uint64_t) + sizeof(SharcPackedData));
+
+    MappedFile file(path);
+    if (!file.GetData())
+    {
+        stats.result = SharcSnapshotResult_FileError;
+        return stats;
+    }
+    stats.fileBytes = file.GetSize();
+
+    if (file.GetSize() < sizeof(SnapshotHeader))
+    {
+        stats.result = SharcSnapshotResult_InvalidFormat;
+        return stats;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, file.GetData(), sizeof(header));
+    if (header.magic != c_SnapshotMagic || header.headerSize != sizeof(SnapshotHeader))
+    {
+        stats.result = SharcSnapshotResult_InvalidFormat;
+        return stats;
+    }
+    if (header.version != c_SnapshotVersion)
+    {
+        stats.result = SharcSnapshotResult_VersionMismatch;
+        return stats;
+    }
+
+    const uint32_t entryCount = header.entryCount;
+    const uint32_t blockCount = GetBlockCount(entryCount);
+    if (header.keysPerBlock != c_KeysPerBlock ||
+        header.payloadOffset != sizeof(SnapshotHeader) ||
+        header.blockTableOffset != header.payloadOffset + uint64_t(entryCount) * sizeof(SharcPackedData) ||
+        header.keyStreamOffset != header.blockTableOffset + uint64_t(blockCount) * sizeof(SnapshotBlock) ||
+        header.keyStreamOffset + header.keyStreamBytes != file.GetSize() ||
+        ComputeChecksum(c_SnapshotMagic, file.GetData() + header.blockTableOffset, uint64_t(blockCount) * sizeof(SnapshotBlock)) != header.blockTableChecksum)
+    {
+        stats.result = SharcSnapshotResult_InvalidFormat;
+        return stats;
+    }
+
+    if (header.sceneHash != desc.sceneHash)
+    {
+        stats.result = SharcSnapshotResult_SceneMismatch;
+        return stats;
+    }
+
+    HashGridParameters savedGridParameters = {};
+    memcpy(savedGridParameters.cameraPosition, header.cameraPosition, sizeof(savedGridParameters.cameraPosition));
+    savedGridParameters.sceneScale = header.sceneScale;
+    savedGridParameters.logarithmBase = header.logarithmBase;
+    savedGridParameters.levelBias = header.levelBias;
+
+    HashGridParameters gridParameters = {};
+    memcpy(gridParameters.cameraPosition, desc.cameraPosition, sizeof(gridParameters.cameraPosition));
+    gridParameters.sceneScale = ResolveSceneScale(desc.sceneScale);
+    gridParameters.logarithmBase = ResolveLogarithmBase(desc.logarithmBase);
+    gridParameters.levelBias = desc.levelBias;
+
+    if (header.sceneScale != gridParameters.sceneScale || header.logarithmBase != gridParameters.logarithmBase ||
+        header.levelBias != gridParameters.levelBias || header.useNormals != (desc.useNormals ? 1u : 0u))
+    {
+        stats.result = SharcSnapshotResult_GridMismatch;
+        return stats;
+    }
+
+    const HashGridHashFunction hashFunction = desc.hashFunction < HashGridHashFunction_Count ? HashGridHashFunction(desc.hashFunction) : HashGridDefaultHashFunction;
+    const SharcPackedData* payload = reinterpret_cast<const SharcPackedData*>(file.GetData() + header.payloadOffset);
+    const SnapshotBlock* blocks = reinterpret_cast<const SnapshotBlock*>(file.GetData() + header.blockTableOffset);
+    const uint8_t* keyStream = file.GetData() + header.keyStreamOffset;
+
+    // 校验并解码 key，按当前相机重新计算层级；只读文件，出错时 hashEntries / resolved 保持不变
+    const uint32_t partitionSlots = std::max(c_MinSlotsPerPartition, bucketSize);
+    const uint32_t partitionCount = (desc.capacity + partitionSlots - 1) / partitionSlots;
+
+    const bool cameraMoved = memcmp(header.cameraPosition, desc.cameraPosition, sizeof(header.cameraPosition)) != 0;
+
+    std::vector<uint64_t> keys(entryCount);
+    std::vector<uint32_t> baseSlots(entryCount);
+    std::mutex statsMutex;
+    bool corrupted = false;
+    ParallelFor(blockCount, 1, [&](uint32_t blockBegin, uint32_t blockEnd)
+    {
+        uint32_t relevelled = 0;
+        bool blockCorrupted = false;
+        for (uint32_t block = blockBegin; block < blockEnd && !blockCorrupted; block++)
+        {
+            const uint32_t first = block * c_KeysPerBlock;
+            const uint32_t last = std::min(entryCount, first + c_KeysPerBlock);
+            const uint64_t blockKeyStreamEnd = GetBlockKeyStreamEnd(blocks, blockCount, block, header.keyStreamBytes);
+            if (blocks[block].keyStreamOffset > blockKeyStreamEnd || blockKeyStreamEnd > header.keyStreamBytes ||
+                ComputeBlockChecksum(payload, entryCount, blocks[block], block, keyStream, blockKeyStreamEnd) != blocks[block].checksum)
+            {
+                blockCorrupted = true;
+                break;
+            }
+            const uint8_t* cursor = keyStream + blocks[block].keyStreamOffset;
+
+            uint64_t key = blocks[block].firstKey;
+            for (uint32_t i = first; i < last; i++)
+            {
+                if (i != first)
+                {
+                    uint64_t delta;
+                    if (!ReadVarint(cursor, keyStream + blockKeyStreamEnd, delta))
+                    {
+                        blockCorrupted = true;
+                        break;
+                    }
+                    key += delta;
+                }
+
+                // 相机远离后 voxel 应处的层级变粗，换成新层级的 key；变细时保留原 key
+                // 和保存时的相机比较，层级边界附近的 voxel 中心本来就可能算出相邻层级
+                uint64_t newKey = key;
+                float center[3];
+                if (cameraMoved)
+                    HashGridGetPositionFromKey(key, gridParameters, center);
+                if (cameraMoved && HashGridGetLevel(center, gridParameters) > HashGridGetLevel(center, savedGridParameters))
+                {
+                    const uint32_t normalBits = HashGridGetNormalBitsFromKey(key);
+                    const float normal[3] = { (normalBits & 1) ? -1.f : 1.f, (normalBits & 2) ? -1.f : 1.f, (normalBits & 4) ? -1.f : 1.f };
+                    newKey = HashGridComputeSpatialHash(center, header.useNormals ? normal : nullptr, gridParameters);
+                    relevelled++;
+                }
+
+                keys[i] = newKey;
+                baseSlots[i] = HashGridGetBaseSlot(newKey, desc.capacity, bucketSize, hashFunction);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.relevelledEntries += relevelled;
+        corrupted |= blockCorrupted;
+    });
+
+    if (corrupted)
+    {
+        stats.result = SharcSnapshotResult_InvalidFormat;
+        return stats;
+    }
+
+    // 按 base slot 所在分区计数排序，分区内保持文件顺序，结果与线程数无关
+    std::vector<uint32_t> partitionOffsets(partitionCount + 1, 0);
+    for (uint32_t i = 0; i < entryCount; i++)
+        partitionOffsets[baseSlots[i] / partitionSlots + 1]++;
+    for (uint32_t p = 0; p < partitionCount; p++)
+        partitionOffsets[p + 1] += partitionOffsets[p];
+
+    std::vector<uint32_t> order(entryCount);
+    {
+        std::vector<uint32_t> cursors(partitionOffsets.begin(), partitionOffsets.end() - 1);
+        for (uint32_t i = 0; i < entryCount; i++)
+            order[cursors[baseSlots[i] / partitionSlots]++] = i;
+    }
+
+    // 清零与插入合并：偶数分区的任务先清空本分区和下一个分区再插入，探测越界只会进入下一个分区，
+    // 奇数分区插入时本分区和下一个分区都已清空；清零的数据随即被插入使用，不必单独遍历整个缓冲
+    const auto clearPartition = [&](uint32_t partition)
+    {
+        const uint32_t begin = partition * partitionSlots;
+        const uint32_t count = std::min(desc.capacity - begin, partitionSlots);
+        memset(hashEntries + begin, 0, size_t(count) * sizeof(uint64_t));
+        memset(resolved + begin, 0, size_t(count) * sizeof(SharcPackedData));
+    };
+
+    uint32_t loaded = 0;
+    uint32_t merged = 0;
+    uint32_t dropped = 0;
+    for (uint32_t parity = 0; parity < 2; parity++)
+    {
+        const uint32_t passPartitions = (partitionCount + 1 - parity) / 2;
+        ParallelFor(passPartitions, 1, [&](uint32_t begin, uint32_t end)
+        {
+            uint32_t localLoaded = 0, localMerged = 0, localDropped = 0;
+            for (uint32_t pass = begin; pass < end; pass++)
+            {
+                const uint32_t partition = pass * 2 + parity;
+                if (parity == 0)
+                {
+                    clearPartition(partition);
+                    if (partition + 1 < partitionCount)
+                        clearPartition(partition + 1);
+                }
+
+                for (uint32_t o = partitionOffsets[partition]; o < partitionOffsets[partition + 1]; o++)
+                {
+                    const uint32_t i = order[o];
+                    const uint64_t key = keys[i];
+
+                    // 与 HashMapInsert 相同的探测顺序
+                    bool placed = false;
+                    for (uint32_t bucketOffset = 0; bucketOffset < bucketSize; bucketOffset++)
+                    {
+                        const uint32_t slot = baseSlots[i] + bucketOffset;
+                        if (hashEntries[slot] == HashGridInvalidHashKey)
+                        {
+                            hashEntries[slot] = key;
+                            resolved[slot] = payload[i];
+                            // 清除 stale 计数，保留采样数和帧数
+                            resolved[slot].sampleData &= ~(~0u << c_StaleFrameNumBitOffset);
+                            localLoaded++;
+                            placed = true;
+                            break;
+                        }
+                        if (hashEntries[slot] == key)
+                        {
+                            MergePackedData(resolved[slot], payload[i]);
+                            localMerged++;
+                            placed = true;
+                            break;
+                        }
+                    }
+                    localDropped += placed ? 0 : 1;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(statsMutex);
+            loaded += localLoaded;
+            merged += localMerged;
+            dropped += localDropped;
+        });
+    }
+
+    stats.result = SharcSnapshotResult_Ok;
+    stats.entryCount = entryCount;
+    stats.loadedEntries = loaded;
+    stats.mergedEntries = merged;
+    stats.droppedEntries = dropped;
+    stats.milliseconds = ElapsedMilliseconds(start);
+    return stats;
+}
+
+uint32_t CompactSharcEntries(uint64_t* hashEntries, SharcPackedData* resolved, uint32_t capacity)
+{
+    if (!hashEntries || !resolved)
+        return 0;
+
+    // 写入位置不超过读取位置，可以原地进行
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        if (hashEntries[i] == HashGridInvalidHashKey)
+            continue;
+
+        hashEntries[count] = hashEntries[i];
+        resolved[count] = resolved[i];
+        count++;
+    }
+    return count;
+}
+
+SharcSnapshotBenchmarkResult BenchmarkSharcSnapshot(const char* path, uint32_t capacity, uint32_t uploadEntriesPerFrame)
+{
+    SharcSnapshotBenchmarkResult result = {};
+    result.capacity = capacity;
+    if (!path || capacity < HashGridDefaultBucketSize || uploadEntriesPerFrame == 0)
+        return result;
+
+    SharcSnapshotDesc desc = {};
+    desc.sceneHash = 0x5348524342454E43ull;
+    desc.useNormals = 1;
+    desc.capacity = capacity;
+
+    HashGridParameters gridParameters = {};
+    gridParameters.sceneScale = c_DefaultSceneScale;
+    gridParameters.logarithmBase = c_DefaultLogarithmBase;
+
+    // 相机在原点，采样点在边长 400 的立方体内随机分布，法线随机；累计失败 capacity / 2 次时表已基本填满
+    SharcHashMap hashMap(capacity);
+    std::vector<SharcPackedData> resolved(capacity);
+    uint32_t random = capacity | 1u;
+    const auto nextFloat = [&random]()
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return float(random >> 8) * (1.f / 16777216.f) * 2.f - 1.f;
+    };
+
+    uint32_t failures = 0;
+    for (uint64_t sample = 0; sample < uint64_t(capacity) * 8 && failures < capacity / 2; sample++)
+    {
+        const float position[3] = { nextFloat() * 200.f, nextFloat() * 200.f, nextFloat() * 200.f };
+        const float normal[3] = { nextFloat(), nextFloat(), nextFloat() };
+
+        uint32_t cacheIndex;
+        if (!hashMap.Insert(HashGridComputeSpatialHash(position, normal, gridParameters), cacheIndex))
+        {
+            failures++;
+            continue;
+        }
+
+        SharcPackedData& data = resolved[cacheIndex];
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            float radiance;
+            memcpy(&radiance, &data.radianceData[i], sizeof(float));
+            radiance += nextFloat() + 1.f;
+            memcpy(&data.radianceData[i], &radiance, sizeof(float));
+        }
+        const uint32_t sampleNum = std::min((data.sampleData & c_SampleNumBitMask) + 1, c_SampleNumBitMask);
+        data.sampleData = sampleNum | (1u << c_AccumulatedFrameNumBitOffset);
+    }
+
+    std::vector<uint64_t> hashEntries(capacity);
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        hashEntries[i] = hashMap.GetEntry(i);
+        result.liveEntries += hashEntries[i] != HashGridInvalidHashKey ? 1 : 0;
+    }
+
+    result.save = SaveSharcSnapshot(path, desc, hashEntries.data(), resolved.data());
+    if (result.save.result != SharcSnapshotResult_Ok)
+        return result;
+
+    result.load = LoadSharcSnapshot(path, desc, hashEntries.data(), resolved.data());
+    if (result.load.result != SharcSnapshotResult_Ok)
+        return result;
+
+    const auto start = std::chrono::steady_clock::now();
+    result.compactedEntries = CompactSharcEntries(hashEntries.data(), resolved.data(), capacity);
+    result.compactMilliseconds = ElapsedMilliseconds(start);
+
+    const uint64_t entryBytes = sizeof(uint64_t) + sizeof(SharcPackedData);
+    result.uploadFrames = (result.compactedEntries + uploadEntriesPerFrame - 1) / uploadEntriesPerFrame;
+    result.denseUploadBytes = uint64_t(capacity) * entryBytes;
+    result.sparseUploadBytes = uint64_t(result.compactedEntries) * entryBytes;
+    result.maxUploadBytesPerFrame = uint64_t(std::min(result.compactedEntries, uploadEntriesPerFrame)) * entryBytes;
+    return result;
+}
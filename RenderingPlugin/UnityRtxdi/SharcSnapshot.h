@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include "SharcHashGrid.h"
+
+// 与 SharcCommon.h 中的 SharcPackedData 一致（SHARC_USE_FP16 0）
+struct SharcPackedData
+{
+    uint32_t radianceData[3];   // asuint(float3)，累计的 radiance 之和
+    uint32_t sampleData;        // sampleNum | accumulatedFrameNum << 18 | staleFrameNum << 24
+};
+
+// 快照按场景和网格参数区分，参数不一致的文件不会被加载
+struct SharcSnapshotDesc
+{
+    uint64_t sceneHash;         // 由调用方按场景计算
+    float cameraPosition[3];    // 保存时记录；加载时用当前相机重新计算每个 voxel 的层级
+    float sceneScale;           // 0 表示 45，与 SHARC_SCENE_SCALE 一致
+    float logarithmBase;        // 0 表示 2
+    float levelBias;
+    uint32_t useNormals;        // HASH_GRID_USE_NORMALS
+    uint32_t hashFunction;      // HASH_GRID_HASH，加载时计算 base slot
+    uint32_t bucketSize;        // 0 表示 16
+    uint32_t capacity;          // hashEntries / resolved 的元素个数
+};
+
+enum SharcSnapshotResult : uint32_t
+{
+    SharcSnapshotResult_Ok = 0,
+    SharcSnapshotResult_InvalidArgument = 1,
+    SharcSnapshotResult_FileError = 2,
+    SharcSnapshotResult_InvalidFormat = 3,      // magic、大小、block 表或任意 block 的校验和不对
+    SharcSnapshotResult_VersionMismatch = 4,
+    SharcSnapshotResult_SceneMismatch = 5,
+    SharcSnapshotResult_GridMismatch = 6,       // sceneScale / logarithmBase / levelBias / useNormals 不同
+};
+
+struct SharcSnapshotStats
+{
+    SharcSnapshotResult result;
+    uint32_t entryCount;        // 文件中的 entry 数
+    uint32_t loadedEntries;     // 写入 hash 表的 entry 数
+    uint32_t relevelledEntries; // 因相机位置变化换到更粗层级的 entry 数
+    uint32_t mergedEntries;     // 换层级后与其它 entry 合并的数量
+    uint32_t droppedEntries;    // bucket 已满被丢弃的数量
+    uint64_t fileBytes;
+    uint64_t rawBytes;          // 未压缩时 hashEntries + resolved 的大小
+    float milliseconds;
+    uint32_t pad1;
+};
+
+// 只保存有效且有采样的 entry：key 排序后做差分 varint 编码，voxel 数据按原格式连续存放
+// 写入临时文件后再替换，保存中途退出不会破坏已有快照；多个线程同时保存时依次进行
+SharcSnapshotStats SaveSharcSnapshot(const char* path, const SharcSnapshotDesc& desc, const uint64_t* hashEntries, const SharcPackedData* resolved);
+
+// 以内存映射方式读取，清空 hashEntries / resolved 后按 desc.capacity 和 desc.hashFunction 重新插入；失败时两者保持不变
+// 每个 block 在并行解码时各自校验，清零在分区插入时进行；耗时与 capacity 成正比，调用方应在后台线程调用
+// 相机位置变化导致 voxel 应处的层级变粗时换成新层级的 key，落到同一 voxel 的 entry 合并；变细时保留原 key，
+// 由 SHARC_BLEND_ADJACENT_LEVELS 在细层级收敛前提供数据
+SharcSnapshotStats LoadSharcSnapshot(const char* path, const SharcSnapshotDesc& desc, uint64_t* hashEntries, SharcPackedData* resolved);
+
+// 把有效 entry 按槽位顺序移到两个数组的开头，返回个数；加载后只上传这一段，由 SharcRehash 按 key 插入 GPU 上的表，
+// 上传量与有效 entry 数成正比而不是与 capacity 成正比，并且可以分多帧进行
+uint32_t CompactSharcEntries(uint64_t* hashEntries, SharcPackedData* resolved, uint32_t capacity);
+
+struct SharcSnapshotBenchmarkResult
+{
+    uint32_t capacity;
+    uint32_t liveEntries;           // 填充后表中的有效 entry 数
+    SharcSnapshotStats save;
+    SharcSnapshotStats load;
+    float compactMilliseconds;
+    uint32_t compactedEntries;
+    uint32_t uploadFrames;          // 每帧最多上传 uploadEntriesPerFrame 个 entry 时需要的帧数
+    uint64_t denseUploadBytes;      // 整表 SetData hashEntries + resolved 的字节数
+    uint64_t sparseUploadBytes;     // 只上传有效 entry 的字节数
+    uint64_t maxUploadBytesPerFrame;
+};
+
+// 用随机采样点把 capacity 大小的表基本填满，保存到 path 后重新加载并压缩，统计主线程上传的数据量
+SharcSnapshotBenchmarkResult BenchmarkSharcSnapshot(const char* path, uint32_t capacity, uint32_t uploadEntriesPerFrame);
@@ -0,0 +1,338 @@
+﻿#include "TangentGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "ParallelFor.h"
+
+namespace
+{
+    constexpr uint32_t c_InvalidIndex = ~0u;
+    constexpr uint8_t c_NoOrientation = 0xFF;
+
+    struct Float3
+    {
+        float x, y, z;
+    };
+
+    Float3 operator-(const Float3& a, const Float3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    Float3 operator+(const Float3& a, const Float3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    Float3 operator*(const Float3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+    float Dot(const Float3& a, const Float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    Float3 Load3(const float* data, uint32_t index) { return { data[index * 3 + 0], data[index * 3 + 1], data[index * 3 + 2] }; }
+
+    // 与 MikkTSpace 的 NotZero 相同
+    bool NotZero(float value)
+    {
+        return std::fabs(value) > 1.17549435e-38f;
+    }
+
+    // 长度为零时返回原向量
+    Float3 Normalize(const Float3& v)
+    {
+        const float length = std::sqrt(Dot(v, v));
+        return NotZero(length) ? v * (1.0f / length) : v;
+    }
+
+    // 投影到法线平面
+    Float3 Project(const Float3& n, const Float3& v)
+    {
+        return Normalize(v - n * Dot(n, v));
+    }
+
+    // 位置、法线和 uv 的位完全相同的顶点合并为同一个顶点，与 MikkTSpace 按属性合并顶点一致
+    void BuildCanonicalVertices(const PrimitiveBuildDesc& mesh, std::vector<uint32_t>& outCanonical)
+    {
+        const uint32_t vertexCount = mesh.vertexCount;
+        outCanonical.resize(vertexCount);
+
+        uint32_t slotCount = 16;
+        while (slotCount < vertexCount * 2)
+            slotCount <<= 1;
+        std::vector<uint32_t> slots(slotCount, c_InvalidIndex);
+
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            uint32_t key[8];
+            memcpy(key, mesh.positions + v * 3, sizeof(float) * 3);
+            memcpy(key + 3, mesh.normals + v * 3, sizeof(float) * 3);
+            memcpy(key + 6, mesh.uvs + v * 2, sizeof(float) * 2);
+
+            uint32_t hash = 0x811C9DC5u;
+            for (uint32_t k : key)
+                hash = (hash ^ k) * 0x01000193u;
+            hash ^= hash >> 16;
+
+            uint32_t slot = hash & (slotCount - 1);
+            while (slots[slot] != c_InvalidIndex)
+            {
+                const uint32_t other = slots[slot];
+                if (memcmp(mesh.positions + other * 3, key, sizeof(float) * 3) == 0 &&
+                    memcmp(mesh.normals + other * 3, key + 3, sizeof(float) * 3) == 0 &&
+                    memcmp(mesh.uvs + other * 2, key + 6, sizeof(float) * 2) == 0)
+                    break;
+                slot = (slot + 1) & (slotCount - 1);
+            }
+
+            if (slots[slot] == c_InvalidIndex)
+                slots[slot] = v;
+            outCanonical[v] = slots[slot];
+        }
+    }
+
+    // 每个顶点按手性分两组累加，orientation 0 为保持朝向（w = 1）
+    struct TangentAccumulator
+    {
+        Float3 tangent[2];
+        float weight[2];
+    };
+
+    // 垂直于 n 的任意单位向量，用于没有有效三角形的顶点
+    Float3 AnyPerpendicular(const Float3& n)
+    {
+        const Float3 axis = std::fabs(n.x) < 0.9f ? Float3{ 1.f, 0.f, 0.f } : Float3{ 0.f, 1.f, 0.f };
+        return Project(n, axis);
+    }
+}
+
+bool GenerateMeshTangents(const PrimitiveBuildDesc* submeshes, uint32_t submeshCount, MeshTangents& out)
+{
+    out = {};
+    if (!submeshes || submeshCount == 0)
+        return false;
+
+    const PrimitiveBuildDesc& mesh = submeshes[0];
+    if (!mesh.positions || !mesh.normals || !mesh.uvs)
+        return false;
+
+    std::vector<uint32_t> canonical;
+    BuildCanonicalVertices(mesh, canonical);
+
+    std::vector<TangentAccumulator> accumulators(mesh.vertexCount, TangentAccumulator{});
+
+    // 每个有效三角形的手性，c_NoOrientation 为退化三角形；每个顶点被哪些手性的三角形引用
+    std::vector<uint8_t> triangleOrientations;
+    std::vector<uint8_t> vertexOrientations(mesh.vertexCount, 0);
+    out.submeshIndexOffsets.assign(submeshCount, c_InvalidIndex);
+
+    for (uint32_t s = 0; s < submeshCount; s++)
+    {
+        const PrimitiveBuildDesc& desc = submeshes[s];
+        if (!IsValidPrimitiveBuildDesc(desc, ~0u))
+            continue;
+
+        out.submeshIndexOffsets[s] = uint32_t(triangleOrientations.size() * 3);
+
+        const uint32_t triangleCount = desc.indexCount / 3;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            const uint32_t indices[3] = { desc.indices[t * 3 + 0], desc.indices[t * 3 + 1], desc.indices[t * 3 + 2] };
+            const Float3 p[3] = { Load3(mesh.positions, indices[0]), Load3(mesh.positions, indices[1]), Load3(mesh.positions, indices[2]) };
+            const float* uv[3] = { mesh.uvs + indices[0] * 2, mesh.uvs + indices[1] * 2, mesh.uvs + indices[2] * 2 };
+
+            // MikkTSpace 的 eq 18 / 19：uv 空间中 s、t 方向在模型空间的梯度
+            const float t21x = uv[1][0] - uv[0][0];
+            const float t21y = uv[1][1] - uv[0][1];
+            const float t31x = uv[2][0] - uv[0][0];
+            const float t31y = uv[2][1] - uv[0][1];
+            const Float3 d1 = p[1] - p[0];
+            const Float3 d2 = p[2] - p[0];
+
+            const float signedAreaSTx2 = t21x * t31y - t21y * t31x;
+            Float3 os = d1 * t31y - d2 * t21y;
+            const float lengthOs = std::sqrt(Dot(os, os));
+
+            // uv 或位置退化的三角形不参与，MikkTSpace 中它们同样只继承相邻三角形的结果
+            if (!NotZero(signedAreaSTx2) || !NotZero(lengthOs))
+            {
+                triangleOrientations.push_back(c_NoOrientation);
+                continue;
+            }
+
+            const uint32_t orientation = signedAreaSTx2 > 0.0f ? 0 : 1;
+            os = os * ((orientation == 0 ? 1.0f : -1.0f) / lengthOs);
+            triangleOrientations.push_back(uint8_t(orientation));
+
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = indices[corner];
+                const Float3 n = Normalize(Load3(mesh.normals, vertex));
+
+                // 按顶点处两条边在法线平面上的夹角加权
+                const Float3 edge0 = Project(n, p[(corner + 2) % 3] - p[corner]);
+                const Float3 edge1 = Project(n, p[(corner + 1) % 3] - p[corner]);
+                const float angle = std::acos(std::clamp(Dot(edge0, edge1), -1.0f, 1.0f));
+
+                TangentAccumulator& accumulator = accumulators[canonical[vertex]];
+                accumulator.tangent[orientation] = accumulator.tangent[orientation] + Project(n, os) * angle;
+                accumulator.weight[orientation] += angle;
+                vertexOrientations[vertex] |= uint8_t(1u << orientation);
+            }
+        }
+    }
+
+    // 两种手性都引用的顶点保留给保持朝向的一侧，另一侧使用拆分出的顶点
+    std::vector<uint32_t> splitVertices(mesh.vertexCount, c_InvalidIndex);
+    for (uint32_t v = 0; v < mesh.vertexCount; v++)
+    {
+        if (vertexOrientations[v] == 3)
+        {
+            splitVertices[v] = mesh.vertexCount + uint32_t(out.splitSources.size());
+            out.splitSources.push_back(v);
+        }
+    }
+
+    const uint32_t outputVertexCount = mesh.vertexCount + uint32_t(out.splitSources.size());
+    out.tangents.resize(size_t(outputVertexCount) * 4);
+
+    auto writeTangent = [&](uint32_t outputVertex, uint32_t sourceVertex, uint32_t orientation)
+    {
+        const TangentAccumulator& accumulator = accumulators[canonical[sourceVertex]];
+        const Float3 n = Normalize(Load3(mesh.normals, sourceVertex));
+
+        Float3 tangent = Project(n, accumulator.tangent[orientation]);
+        if (!NotZero(Dot(tangent, tangent)))
+            tangent = AnyPerpendicular(n);
+
+        float* dst = out.tangents.data() + size_t(outputVertex) * 4;
+        dst[0] = tangent.x;
+        dst[1] = tangent.y;
+        dst[2] = tangent.z;
+        dst[3] = orientation == 0 ? 1.0f : -1.0f;
+    };
+
+    for (uint32_t v = 0; v < mesh.vertexCount; v++)
+    {
+        // 只被退化三角形引用的顶点取合并后权重较大的一侧
+        uint32_t orientation = vertexOrientations[v] == 2 ? 1 : 0;
+        if (vertexOrientations[v] == 0)
+        {
+            const TangentAccumulator& accumulator = accumulators[canonical[v]];
+            orientation = accumulator.weight[1] > accumulator.weight[0] ? 1 : 0;
+        }
+        writeTangent(v, v, orientation);
+    }
+
+    for (uint32_t i = 0; i < uint32_t(out.splitSources.size()); i++)
+        writeTangent(mesh.vertexCount + i, out.splitSources[i], 1);
+
+    if (out.splitSources.empty())
+    {
+        out.submeshIndexOffsets.clear();
+        return true;
+    }
+
+    // 手性相反的三角形改用拆分出的顶点，退化三角形保持原索引
+    out.indices.resize(triangleOrientations.size() * 3);
+    for (uint32_t s = 0; s < submeshCount; s++)
+    {
+        if (out.submeshIndexOffsets[s] == c_InvalidIndex)
+            continue;
+
+        const PrimitiveBuildDesc& desc = submeshes[s];
+        const uint32_t firstTriangle = out.submeshIndexOffsets[s] / 3;
+        const uint32_t triangleCount = desc.indexCount / 3;
+        uint32_t* indices = out.indices.data() + out.submeshIndexOffsets[s];
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            const bool mirrored = triangleOrientations[firstTriangle + t] == 1;
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = desc.indices[t * 3 + corner];
+                indices[t * 3 + corner] = mirrored && splitVertices[vertex] != c_InvalidIndex ? splitVertices[vertex] : vertex;
+            }
+        }
+    }
+    return true;
+}
+
+const PrimitiveBuildDesc* GeneratedTangents::Resolve(const PrimitiveBuildDesc* descs, uint32_t descCount)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    m_descs.clear();
+    m_meshes.clear();
+    m_meshCount = 0;
+    m_splitVertexCount = 0;
+    m_milliseconds = 0.f;
+
+    // 每个 mesh 的第一个 desc 和 desc 数
+    std::vector<std::pair<uint32_t, uint32_t>> meshes;
+    for (uint32_t i = 0; i < descCount; i++)
+    {
+        if (!(descs[i].flags & PrimitiveBuildFlag_GenerateTangents) || descs[i].tangents)
+            continue;
+
+        if (!meshes.empty() && meshes.back().first + meshes.back().second == i &&
+            descs[i].positions == descs[i - 1].positions && descs[i].vertexCount == descs[i - 1].vertexCount)
+            meshes.back().second++;
+        else
+            meshes.push_back({ i, 1 });
+    }
+
+    if (meshes.empty())
+        return descs;
+
+    m_descs.assign(descs, descs + descCount);
+    m_meshes.resize(meshes.size());
+    std::vector<uint8_t> generated(meshes.size(), 0);
+
+    ParallelFor(uint32_t(meshes.size()), 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t m = begin; m < end; m++)
+        {
+            const PrimitiveBuildDesc& mesh = descs[meshes[m].first];
+            GeneratedMesh& output = m_meshes[m];
+            if (!GenerateMeshTangents(descs + meshes[m].first, meshes[m].second, output.tangents))
+                continue;
+            generated[m] = 1;
+
+            // 拆分出的顶点复制输入顶点的位置、法线和 uv
+            const std::vector<uint32_t>& splitSources = output.tangents.splitSources;
+            if (splitSources.empty())
+                continue;
+
+            auto appendSplitVertices = [&](const float* source, uint32_t stride, std::vector<float>& dst)
+            {
+                dst.resize(size_t(mesh.vertexCount + splitSources.size()) * stride);
+                memcpy(dst.data(), source, size_t(mesh.vertexCount) * stride * sizeof(float));
+                for (size_t i = 0; i < splitSources.size(); i++)
+                    memcpy(dst.data() + (mesh.vertexCount + i) * stride, source + size_t(splitSources[i]) * stride, stride * sizeof(float));
+            };
+            appendSplitVertices(mesh.positions, 3, output.positions);
+            appendSplitVertices(mesh.normals, 3, output.normals);
+            appendSplitVertices(mesh.uvs, 2, output.uvs);
+        }
+    });
+
+    for (uint32_t m = 0; m < meshes.size(); m++)
+    {
+        if (!generated[m])
+            continue;
+
+        const GeneratedMesh& output = m_meshes[m];
+        const bool split = !output.tangents.splitSources.empty();
+        for (uint32_t i = 0; i < meshes[m].second; i++)
+        {
+            PrimitiveBuildDesc& desc = m_descs[meshes[m].first + i];
+            desc.tangents = output.tangents.tangents.data();
+            if (!split)
+                continue;
+
+            desc.positions = output.positions.data();
+            desc.normals = output.normals.data();
+            desc.uvs = output.uvs.data();
+            desc.vertexCount += uint32_t(output.tangents.splitSources.size());
+            if (output.tangents.submeshIndexOffsets[i] != c_InvalidIndex)
+                desc.indices = output.tangents.indices.data() + output.tangents.submeshIndexOffsets[i];
+        }
+        m_meshCount++;
+        m_splitVertexCount += uint32_t(output.tangents.splitSources.size());
+    }
+
+    m_milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return m_descs.data();
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "PrimitiveDataBuilder.h"
+
+// 一个 mesh 生成的切线（float4，w 为 bitangentSign）
+// 两侧三角形手性不同的顶点（镜像 uv 的接缝）拆成两个，拆分出的顶点追加在输入顶点之后，手性相反一侧的三角形改用新顶点
+// 三角形的数量和顺序不变，PrimitiveData 仍与加速结构中的三角形一一对应
+struct MeshTangents
+{
+    std::vector<float> tangents;                // (vertexCount + splitSources.size()) * 4
+    std::vector<uint32_t> splitSources;         // 拆分出的顶点对应的输入顶点
+    std::vector<uint32_t> indices;              // 有拆分时为所有有效 submesh 改写后的索引，按 submesh 顺序连续存放；没有拆分时为空
+    std::vector<uint32_t> submeshIndexOffsets;  // 每个 submesh 在 indices 中的起点，无效的 submesh 为 ~0u，仍使用原索引
+};
+
+// 按 MikkTSpace 的方式为一个 mesh 生成切线
+// submeshes 共享同一组顶点数组，所有 submesh 的三角形一起参与计算，与 Mesh.RecalculateTangents 相同
+// 与 MikkTSpace 一样：每个三角形的切线取 uv 梯度方向并投影到顶点法线平面上，按顶点处的夹角加权；
+// 位置、法线和 uv 完全相同的顶点视为同一个顶点；手性由三角形在 uv 空间的朝向决定，不同手性分别累加
+// MikkTSpace 还会把同一顶点处手性相同但不通过边相连的三角形分成不同的组，这里不区分
+// 需要 positions、normals 和 uvs，缺少时返回 false
+bool GenerateMeshTangents(const PrimitiveBuildDesc* submeshes, uint32_t submeshCount, MeshTangents& out);
+
+// 为带 PrimitiveBuildFlag_GenerateTangents 的 mesh 生成切线，并返回 tangents 指向生成结果的 desc 副本
+// 有顶点被拆分的 mesh，desc 副本中的顶点数组、vertexCount 和 indices 也指向拆分后的副本
+// positions 相同的连续 desc 视为同一个 mesh，每个 mesh 只生成一次，多个 mesh 之间并行
+class GeneratedTangents
+{
+public:
+    // 没有需要生成的 mesh 时直接返回 descs；返回的指针在下一次 Resolve 或析构之前有效
+    const PrimitiveBuildDesc* Resolve(const PrimitiveBuildDesc* descs, uint32_t descCount);
+
+    uint32_t GetMeshCount() const { return m_meshCount; }
+    uint32_t GetSplitVertexCount() const { return m_splitVertexCount; }
+    float GetMilliseconds() const { return m_milliseconds; }
+
+private:
+    struct GeneratedMesh
+    {
+        MeshTangents tangents;
+        std::vector<float> positions;   // 有拆分时为追加了拆分顶点的副本
+        std::vector<float> normals;
+        std::vector<float> uvs;
+    };
+
+    std::vector<PrimitiveBuildDesc> m_descs;
+    std::vector<GeneratedMesh> m_meshes;
+    uint32_t m_meshCount = 0;
+    uint32_t m_splitVertexCount = 0;
+    float m_milliseconds = 0.f;
+};
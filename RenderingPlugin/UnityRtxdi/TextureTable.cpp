@@ -0,0 +1,186 @@
+﻿#include "TextureTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+size_t TextureTable::KeyHash::operator()(const TextureGroupKey& key) const
+{
+    uint32_t hash = 0x9E3779B1u;
+    for (int32_t texture : key.textures)
+    {
+        hash = (hash ^ uint32_t(texture)) * 0x85EBCA77u;
+        hash ^= hash >> 13;
+    }
+    return hash ^ (hash >> 16);
+}
+
+bool TextureTable::KeyEqual::operator()(const TextureGroupKey& a, const TextureGroupKey& b) const
+{
+    return std::equal(std::begin(a.textures), std::end(a.textures), std::begin(b.textures));
+}
+
+uint32_t TextureTable::AcquireGroup(const TextureGroupKey& key)
+{
+    auto it = m_groupIndices.find(key);
+    if (it != m_groupIndices.end())
+    {
+        m_refCounts[it->second]++;
+        return it->second;
+    }
+
+    uint32_t groupIndex;
+    if (!m_freeGroups.empty())
+    {
+        groupIndex = m_freeGroups.back();
+        m_freeGroups.pop_back();
+        m_lastStats.reusedGroupCount++;
+    }
+    else
+    {
+        groupIndex = uint32_t(m_groups.size());
+        m_groups.emplace_back();
+        m_refCounts.push_back(0);
+    }
+
+    m_groups[groupIndex] = key;
+    m_refCounts[groupIndex] = 1;
+    m_groupIndices.emplace(key, groupIndex);
+    m_changedGroups.push_back(groupIndex);
+    m_lastStats.addedGroupCount++;
+    return groupIndex;
+}
+
+void TextureTable::ReleaseGroup(uint32_t groupIndex)
+{
+    if (--m_refCounts[groupIndex] > 0)
+        return;
+
+    m_groupIndices.erase(m_groups[groupIndex]);
+    m_groups[groupIndex] = {};
+    m_freeGroups.insert(std::lower_bound(m_freeGroups.begin(), m_freeGroups.end(), groupIndex, std::greater<uint32_t>()), groupIndex);
+    m_changedGroups.push_back(groupIndex);
+    m_lastStats.freedGroupCount++;
+}
+
+void TextureTable::ResetCounters()
+{
+    m_lastStats.addedGroupCount = 0;
+    m_lastStats.reusedGroupCount = 0;
+    m_lastStats.freedGroupCount = 0;
+    m_lastStats.releasedMaterialCount = 0;
+    m_changedGroups.clear();
+}
+
+void TextureTable::FinishChangedGroups()
+{
+    // 同一次调用中释放后又被复用的组只记一次
+    std::sort(m_changedGroups.begin(), m_changedGroups.end());
+    m_changedGroups.erase(std::unique(m_changedGroups.begin(), m_changedGroups.end()), m_changedGroups.end());
+}
+
+TextureTableStats TextureTable::Update(const MaterialTextureDesc* materials, uint32_t count, uint32_t* outGroupIndices, bool releaseUnlisted)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ResetCounters();
+    m_epoch++;
+
+    // 先标记仍在使用的材质并释放已卸载的材质，空出的 slot 可以直接给本次新增的组
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto it = m_materials.find(materials[i].materialId);
+        if (it != m_materials.end())
+            it->second.epoch = m_epoch;
+    }
+
+    if (releaseUnlisted)
+    {
+        for (auto it = m_materials.begin(); it != m_materials.end();)
+        {
+            if (it->second.epoch == m_epoch)
+            {
+                ++it;
+                continue;
+            }
+
+            ReleaseGroup(it->second.groupIndex);
+            it = m_materials.erase(it);
+            m_lastStats.releasedMaterialCount++;
+        }
+    }
+
+    // 纹理变化的材质先引用新组再释放旧组，仍被其它材质引用的组不会因为引用计数暂时归零而换 slot
+    std::vector<uint32_t> releasedGroups;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const MaterialTextureDesc& desc = materials[i];
+        auto it = m_materials.find(desc.materialId);
+        if (it == m_materials.end())
+        {
+            it = m_materials.emplace(desc.materialId, MaterialEntry{ AcquireGroup(desc.group), m_epoch }).first;
+        }
+        else if (!KeyEqual()(m_groups[it->second.groupIndex], desc.group))
+        {
+            releasedGroups.push_back(it->second.groupIndex);
+            it->second.groupIndex = AcquireGroup(desc.group);
+        }
+
+        if (outGroupIndices)
+            outGroupIndices[i] = it->second.groupIndex;
+    }
+
+    for (uint32_t groupIndex : releasedGroups)
+        ReleaseGroup(groupIndex);
+
+    FinishChangedGroups();
+    m_lastStats.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return GetStats();
+}
+
+TextureTableStats TextureTable::ReleaseMaterials(const int32_t* materialIds, uint32_t count)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ResetCounters();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto it = m_materials.find(materialIds[i]);
+        if (it == m_materials.end())
+            continue;
+
+        ReleaseGroup(it->second.groupIndex);
+        m_materials.erase(it);
+        m_lastStats.releasedMaterialCount++;
+    }
+
+    FinishChangedGroups();
+    m_lastStats.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return GetStats();
+}
+
+uint32_t TextureTable::GetGroupIndex(int32_t materialId) const
+{
+    auto it = m_materials.find(materialId);
+    return it != m_materials.end() ? it->second.groupIndex : ~0u;
+}
+
+void TextureTable::Clear()
+{
+    m_groups.clear();
+    m_refCounts.clear();
+    m_freeGroups.clear();
+    m_changedGroups.clear();
+    m_groupIndices.clear();
+    m_materials.clear();
+    m_lastStats = {};
+}
+
+TextureTableStats TextureTable::GetStats() const
+{
+    TextureTableStats stats = m_lastStats;
+    stats.materialCount = uint32_t(m_materials.size());
+    stats.groupCount = uint32_t(m_groupIndices.size());
+    stats.groupCapacity = uint32_t(m_groups.size());
+    stats.changedGroupCount = uint32_t(m_changedGroups.size());
+    return stats;
+}
@@ -0,0 +1,90 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 每个纹理组按 base / mask / normal / emission 顺序占连续的 4 个 slot，
+// InstanceData.textureOffsetAndFlags 中的纹理偏移为 groupIndex * c_TexturesPerGroup
+constexpr uint32_t c_TexturesPerGroup = 4;
+
+// Unity 纹理的 instance ID，空闲的组全部为 0
+struct TextureGroupKey
+{
+    int32_t textures[c_TexturesPerGroup];
+};
+
+// 与 PathTracingDataBuilder.cs 中的 MaterialTextureDesc 一致
+struct MaterialTextureDesc
+{
+    int32_t materialId;
+    TextureGroupKey group;
+};
+
+struct TextureTableStats
+{
+    uint32_t materialCount;
+    uint32_t groupCount;            // 被至少一个材质引用的组数
+    uint32_t groupCapacity;         // 已使用的最大组号 + 1，即纹理池至少需要 groupCapacity * 4 个 slot
+    uint32_t addedGroupCount;       // 以下四项为最近一次 Update / ReleaseMaterials 的结果
+    uint32_t reusedGroupCount;      // 新增的组中复用已释放 slot 的数量
+    uint32_t freedGroupCount;
+    uint32_t releasedMaterialCount;
+    uint32_t changedGroupCount;     // 内容变化（新增或释放）的组数，见 GetChangedGroups
+    float milliseconds;
+};
+
+// 常驻的纹理组表：内容相同的纹理组只占一组 slot，按材质引用计数
+// 组存在期间组号不变，场景重建时已有的材质拿到相同的组号；没有材质引用的组释放，slot 留给之后新增的组
+class TextureTable
+{
+public:
+    // 批量登记材质的纹理组，outGroupIndices[i] 为 materials[i] 的组号
+    // 材质已登记但纹理变化时改引用新组；releaseUnlisted 时不在 materials 中的旧材质全部释放（材质已卸载）
+    TextureTableStats Update(const MaterialTextureDesc* materials, uint32_t count, uint32_t* outGroupIndices, bool releaseUnlisted);
+    TextureTableStats ReleaseMaterials(const int32_t* materialIds, uint32_t count);
+
+    // 不存在时返回 ~0u
+    uint32_t GetGroupIndex(int32_t materialId) const;
+
+    void Clear();
+
+    // groupCapacity 个
+    const TextureGroupKey* GetGroups() const { return m_groups.data(); }
+    // 最近一次 Update / ReleaseMaterials 中内容变化的组号，升序且不重复，共 changedGroupCount 个
+    // 调用方只需按这些组更新纹理池
+    const uint32_t* GetChangedGroups() const { return m_changedGroups.data(); }
+    TextureTableStats GetStats() const;
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const TextureGroupKey& key) const;
+    };
+
+    struct KeyEqual
+    {
+        bool operator()(const TextureGroupKey& a, const TextureGroupKey& b) const;
+    };
+
+    struct MaterialEntry
+    {
+        uint32_t groupIndex;
+        uint32_t epoch;     // 最近一次出现在 Update 中的批次
+    };
+
+    uint32_t AcquireGroup(const TextureGroupKey& key);
+    void ReleaseGroup(uint32_t groupIndex);
+    void ResetCounters();
+    void FinishChangedGroups();
+
+    std::vector<TextureGroupKey> m_groups;
+    std::vector<uint32_t> m_refCounts;
+    std::vector<uint32_t> m_freeGroups;     // 降序，优先复用小的组号，使表保持紧凑
+    std::vector<uint32_t> m_changedGroups;
+    std::unordered_map<TextureGroupKey, uint32_t, KeyHash, KeyEqual> m_groupIndices;
+    std::unordered_map<int32_t, MaterialEntry> m_materials;
+    uint32_t m_epoch = 0;
+    TextureTableStats m_lastStats = {};
+};
@@ -68,6 +68,7 @@ namespace PathTracing
         public uint gPSR;
         public uint gSHARC;
         public uint gTrimLobe;
+        public uint gSharcCapacity;
 
         public override string ToString()
         {
@@ -147,7 +148,8 @@ namespace PathTracing
     gSampleNum = {gSampleNum},
     gPSR = {gPSR},
     gSHARC = {gSHARC},
-    gTrimLobe = {gTrimLobe}
+    gTrimLobe = {gTrimLobe},
+    gSharcCapacity = {gSharcCapacity}
 }}";
         }
 
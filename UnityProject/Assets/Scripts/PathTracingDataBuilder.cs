@@ -1,6 +1,10 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Runtime.InteropServices;
+using System.Threading.Tasks;
+using Unity.Collections;
+using Unity.Collections.LowLevel.Unsafe;
 using Unity.Mathematics;
 using UnityEngine;
 using UnityEngine.Rendering;
@@ -27,6 +31,95 @@ namespace DefaultNamespace
         public float bitangentSign;
     }
 
+    // 与 UnityRtxdi/PrimitiveDataBuilder.h 一致，指针指向 pinned 的顶点属性和索引数组
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PrimitiveBuildDesc
+    {
+        public IntPtr positions;
+        public IntPtr normals;
+        public IntPtr tangents;
+        public IntPtr uvs;
+        public IntPtr indices;
+        public uint vertexCount;
+        public uint indexCount;
+        public uint primitiveOffset;
+        public PrimitiveBuildFlags flags;
+    }
+
+    [Flags]
+    public enum PrimitiveBuildFlags : uint
+    {
+        None = 0,
+        GenerateTangents = 0x1,
+    }
+
+    public enum PrimitiveBuildPath : uint
+    {
+        Scalar = 0,
+        Avx2 = 1,
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PrimitiveBuildStats
+    {
+        public uint primitiveCount;
+        public uint invalidSubmeshCount;
+        public PrimitiveBuildPath path;
+        public float milliseconds;
+        public uint tangentMeshCount;
+        public float tangentMilliseconds;
+    }
+
+    // 与 UnityRtxdi/PrimitiveCache.h 一致
+    public enum PrimitiveCacheResult : uint
+    {
+        Ok = 0,
+        InvalidArgument = 1,
+        FileError = 2,
+        InvalidFormat = 3,
+        VersionMismatch = 4,
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PrimitiveCacheInfo
+    {
+        public PrimitiveCacheResult loadResult;
+        public uint entryCount;
+        public uint pendingEntryCount;
+        public uint pad1;
+        public ulong fileBytes;
+        public ulong pendingBytes;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PrimitiveCacheBuildStats
+    {
+        public uint meshCount;
+        public uint hitMeshCount;
+        public uint builtMeshCount;
+        public uint corruptMeshCount;
+        public uint primitiveCount;
+        public uint hitPrimitiveCount;
+        public uint invalidSubmeshCount;
+        public PrimitiveBuildPath path;
+        public float hashMilliseconds;
+        public float milliseconds;
+        public uint tangentMeshCount;
+        public float tangentMilliseconds;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PrimitiveCacheSaveStats
+    {
+        public PrimitiveCacheResult result;
+        public uint entryCount;
+        public uint evictedEntryCount;
+        public uint pad1;
+        public ulong fileBytes;
+        public float milliseconds;
+        public uint pad2;
+    }
+
     [StructLayout(LayoutKind.Sequential)]
     public struct InstanceData
     {
@@ -44,11 +137,123 @@ namespace DefaultNamespace
         public float scale;
 
         public uint morphPrimitiveOffset;
-        public uint unused1;
-        public uint unused2;
+        public uint compactVertexOffset;
+        public uint compactIndexOffset;
         public uint unused3;
     }
 
+    // 与 UnityRtxdi/CompactGeometry.h 一致
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CompactVertex
+    {
+        public half2 uv;
+        public half2 normal;
+        public half2 tangent;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CompactSubmesh
+    {
+        public uint vertexOffset;
+        public uint indexOffset;
+        public uint triangleOffset;
+        public uint triangleCount;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CompactGeometryReport
+    {
+        public uint meshCount;
+        public uint submeshCount;
+        public uint triangleCount;
+        public uint sourceVertexCount;
+        public uint vertexCount;
+        public uint index16SubmeshCount;
+        public uint index32SubmeshCount;
+        public uint invalidSubmeshCount;
+        public ulong vertexBytes;
+        public ulong indexBytes;
+        public ulong triangleBytes;
+        public ulong compactBytes;
+        public ulong primitiveDataBytes;
+        public float milliseconds;
+        public uint pad1;
+    }
+
+    // 与 UnityRtxdi/InstanceTable.h 一致
+    [Flags]
+    public enum InstanceField : uint
+    {
+        Transform = 0x1,
+        Material = 0x2,
+        Geometry = 0x4,
+        All = 0x7,
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InstanceRowRange
+    {
+        public uint firstRow;
+        public uint rowCount;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InstanceTableStats
+    {
+        public uint rowCount;
+        public uint liveRowCount;
+        public uint rendererCount;
+        public uint dirtyRowCount;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InstanceTableBenchmarkResult
+    {
+        public uint instanceCount;
+        public uint movingRowsPerFrame;
+        public uint frameCount;
+        public uint mergeGap;
+        public uint maxRanges;
+        public uint truncatedFrameCount;
+        public float updateMicroseconds;
+        public float collectMicroseconds;
+        public float rangesPerFrame;
+        public float uploadedRowsPerFrame;
+        public float uploadedBytesPerFrame;
+        public float fullUploadBytes;
+    }
+
+    // 与 UnityRtxdi/TextureTable.h 一致，纹理为 instance ID，空闲的组全部为 0
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TextureGroupKey
+    {
+        public int baseTexture;
+        public int maskTexture;
+        public int normalTexture;
+        public int emissionTexture;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MaterialTextureDesc
+    {
+        public int materialId;
+        public TextureGroupKey group;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TextureTableStats
+    {
+        public uint materialCount;
+        public uint groupCount;
+        public uint groupCapacity;
+        public uint addedGroupCount;
+        public uint reusedGroupCount;
+        public uint freedGroupCount;
+        public uint releasedMaterialCount;
+        public uint changedGroupCount;
+        public float milliseconds;
+    }
+
     public class PathTracingDataBuilder
     {
         public static PathTracingDataBuilder instance;
@@ -79,51 +284,189 @@ namespace DefaultNamespace
         public Texture2D defaultNormal; // 用于 Normal (0.5, 0.5, 1.0)
         public Texture2D defaultMask; // 用于 Roughness/Metalness (R=0, G=Roughness, B=Metal)
 
-        // 存储最终传给 BindlessPlugin 的总列表
+        // 存储最终传给 BindlessPlugin 的总列表，第 i 组占 [i * 4, i * 4 + 4)，空闲的组为 null
         public List<Texture2D> globalTexturePool = new List<Texture2D>();
 
-
-        // 缓存已添加的纹理组，避免重复上传相同的材质纹理组合
-        private Dictionary<string, uint> textureGroupCache = new Dictionary<string, uint>();
+        // 纹理组登记在 UnityRtxdi 的 TextureTable 中：相同的四张纹理只占一组，组号在重建之间保持不变，
+        // 场景中不再使用的材质在下一次 Build 时释放
+        private const uint TexturesPerGroup = 4;
+        private IntPtr textureTable;
+        private readonly Dictionary<int, uint> materialTextureOffsets = new Dictionary<int, uint>();
+        private readonly Dictionary<int, Texture2D> texturesById = new Dictionary<int, Texture2D>();
+        private readonly List<MaterialTextureDesc> materialTextureDescs = new List<MaterialTextureDesc>();
 
 
         private Dictionary<int, List<uint>> meshPrimitiveCache = new Dictionary<int, List<uint>>();
 
         private uint GetTextureGroupIndex(Material mat)
         {
-            return 0;
             if (mat == null) return 0;
 
-            // 获取四张纹理，如果为空则使用默认值
-            Texture2D texBase = (Texture2D)mat.GetTexture("_BaseMap") ?? defaultWhite;
-            Texture2D texMask = (Texture2D)mat.GetTexture("_MetallicGlossMap") ?? defaultMask;
-            Texture2D texNormal = (Texture2D)mat.GetTexture("_BumpMap") ?? defaultNormal;
-            Texture2D texEmission = (Texture2D)mat.GetTexture("_EmissionMap") ?? defaultBlack;
+            int materialId = mat.GetInstanceID();
+            if (materialTextureOffsets.TryGetValue(materialId, out uint offset))
+                return offset;
 
-            // 生成唯一 Key 判断这四张图是否已经成组添加过
-            string key = $"{texBase.GetInstanceID()}_{texMask.GetInstanceID()}_{texNormal.GetInstanceID()}_{texEmission.GetInstanceID()}";
+            // Build 之后才用到的材质单独登记，不释放其它材质
+            materialTextureDescs.Clear();
+            materialTextureDescs.Add(GetMaterialTextureDesc(mat));
+            RegisterMaterialTextures(false);
+            return materialTextureOffsets[materialId];
+        }
 
-            if (textureGroupCache.TryGetValue(key, out uint startIndex))
+        private int RegisterTexture(Material mat, string property, Texture2D fallback)
+        {
+            // 获取纹理，如果为空则使用默认值
+            Texture2D tex = mat.HasTexture(property) ? mat.GetTexture(property) as Texture2D : null;
+            if (tex == null)
+                tex = fallback;
+
+            int id = tex.GetInstanceID();
+            texturesById[id] = tex;
+            return id;
+        }
+
+        private MaterialTextureDesc GetMaterialTextureDesc(Material mat)
+        {
+            return new MaterialTextureDesc
             {
-                return startIndex;
+                materialId = mat.GetInstanceID(),
+                group = new TextureGroupKey
+                {
+                    baseTexture = RegisterTexture(mat, "_BaseMap", defaultWhite),
+                    maskTexture = RegisterTexture(mat, "_MetallicGlossMap", defaultMask),
+                    normalTexture = RegisterTexture(mat, "_BumpMap", defaultNormal),
+                    emissionTexture = RegisterTexture(mat, "_EmissionMap", defaultBlack),
+                },
+            };
+        }
+
+        // 场景中全部材质一次登记，releaseUnlisted 时释放上一次登记过、这次不在场景中的材质
+        private TextureTableStats RegisterMaterialTextures(bool releaseUnlisted)
+        {
+            if (textureTable == IntPtr.Zero)
+                textureTable = RtxdiNative.CreateTextureTable();
+
+            var descs = materialTextureDescs.ToArray();
+            var groupIndices = new uint[descs.Length];
+            TextureTableStats stats;
+            unsafe
+            {
+                fixed (MaterialTextureDesc* descPtr = descs)
+                fixed (uint* indexPtr = groupIndices)
+                {
+                    stats = RtxdiNative.UpdateTextureTable(textureTable, (IntPtr)descPtr, (uint)descs.Length, (IntPtr)indexPtr, releaseUnlisted ? 1u : 0u);
+                }
+            }
+
+            for (int i = 0; i < descs.Length; i++)
+                materialTextureOffsets[descs[i].materialId] = groupIndices[i] * TexturesPerGroup;
+
+            // 纹理池按组号排列，只改写内容变化的组，其它组的位置不动
+            int slotCount = (int)(stats.groupCapacity * TexturesPerGroup);
+            while (globalTexturePool.Count < slotCount)
+                globalTexturePool.Add(null);
+
+            var groups = GetNativeView<TextureGroupKey>(RtxdiNative.GetTextureTableGroups(textureTable), (int)stats.groupCapacity);
+            if (stats.changedGroupCount > 0)
+            {
+                var changedGroups = GetNativeView<uint>(RtxdiNative.GetTextureTableChangedGroups(textureTable), (int)stats.changedGroupCount);
+                foreach (var groupIndex in changedGroups)
+                {
+                    var group = groups[(int)groupIndex];
+                    uint slot = groupIndex * TexturesPerGroup;
+                    SetPoolTexture(slot + 0, group.baseTexture);
+                    SetPoolTexture(slot + 1, group.maskTexture);
+                    SetPoolTexture(slot + 2, group.normalTexture);
+                    SetPoolTexture(slot + 3, group.emissionTexture);
+                }
             }
 
-            // 如果没添加过，则按顺序连续存入 4 张
-            startIndex = (uint)globalTexturePool.Count;
-            globalTexturePool.Add(texBase); // index + 0
-            globalTexturePool.Add(texMask); // index + 1
-            globalTexturePool.Add(texNormal); // index + 2
-            globalTexturePool.Add(texEmission); // index + 3
+            return stats;
+        }
+
+        private void SetPoolTexture(uint slot, int id)
+        {
+            globalTexturePool[(int)slot] = GetRegisteredTexture(id);
+        }
 
-            textureGroupCache.Add(key, startIndex);
-            return startIndex;
+        private Texture2D GetRegisteredTexture(int id)
+        {
+            return id != 0 && texturesById.TryGetValue(id, out Texture2D tex) ? tex : null;
+        }
+
+        private void BuildTextureTable(Renderer[] renderers)
+        {
+            materialTextureOffsets.Clear();
+            texturesById.Clear();
+            materialTextureDescs.Clear();
+
+            var seenMaterials = new HashSet<int>();
+            foreach (var r in renderers)
+            {
+                foreach (var mat in r.sharedMaterials)
+                {
+                    if (mat != null && seenMaterials.Add(mat.GetInstanceID()))
+                        materialTextureDescs.Add(GetMaterialTextureDesc(mat));
+                }
+            }
+
+            var stats = RegisterMaterialTextures(true);
+            Debug.Log($"Texture table: {stats.groupCount} groups for {stats.materialCount} materials, {stats.addedGroupCount} added ({stats.reusedGroupCount} reused slots), {stats.freedGroupCount} freed, {stats.milliseconds:F2} ms");
         }
 
         public ComputeBuffer _instanceBuffer;
         public ComputeBuffer _primitiveBuffer;
 
+        // 使用 CompactGeometry 时代替 _primitiveBuffer：共享的量化顶点、16 / 32 位索引和每个三角形的面积项
+        public bool useCompactGeometry;
+        public ComputeBuffer _compactVertexBuffer;
+        public ComputeBuffer _compactIndexBuffer;
+        public ComputeBuffer _compactTriangleBuffer;
+
         public List<InstanceData> instanceDataList = new List<InstanceData>();
-        public List<PrimitiveData> primitiveDataList = new List<PrimitiveData>();
+        public int primitiveCount;
+
+        // InstanceData 常驻在 UnityRtxdi 的 InstanceTable 中，每个 renderer 的行号即 RTAS 中的 InstanceID，
+        // 之后每帧只上传变换或材质变化的行
+        private struct TrackedRenderer
+        {
+            public Renderer renderer;
+            public int rendererId;
+            public uint firstRow;
+            public int submeshCount;
+        }
+
+        // 相隔不超过这么多行的脏区间合并上传，减少 SetData 调用
+        private const uint DirtyRangeMergeGap = 16;
+
+        private IntPtr instanceTable;
+        private readonly List<TrackedRenderer> trackedRenderers = new List<TrackedRenderer>();
+        private readonly List<uint> updateRowIndices = new List<uint>();
+        private readonly List<InstanceData> updateRows = new List<InstanceData>();
+        // 按脏行数扩容：区间数不能超过上限，否则 CollectDirtyRanges 会把最后一个区间延伸到最后一个脏行，多传大量没变的行
+        private InstanceRowRange[] dirtyRanges = new InstanceRowRange[256];
+
+        // 按 mesh 内容缓存 PrimitiveData，内容未变的 mesh 下次启动时直接从文件拷贝
+        public bool usePrimitiveCache = true;
+        // 超过这个大小时丢弃本次没有用到的旧 mesh
+        public ulong primitiveCacheMaxBytes = 1UL << 30;
+        private IntPtr primitiveCache;
+        // 重写整个缓存文件可能有几百 MB，在后台线程上进行
+        private Task primitiveCacheSaveTask;
+
+        // PrimitiveData 由 UnityRtxdi 直接写入，Build 期间 pin 住每个 mesh 的顶点属性和 submesh 索引
+        private readonly List<PrimitiveBuildDesc> primitiveBuildDescs = new List<PrimitiveBuildDesc>();
+        private readonly List<GCHandle> pinnedArrays = new List<GCHandle>();
+
+        private IntPtr Pin(Array array)
+        {
+            if (array == null || array.Length == 0)
+                return IntPtr.Zero;
+
+            var handle = GCHandle.Alloc(array, GCHandleType.Pinned);
+            pinnedArrays.Add(handle);
+            return handle.AddrOfPinnedObject();
+        }
 
         [ContextMenu("Build RTAS and Buffers")]
         public void Build(RayTracingAccelerationStructure accelerationStructure)
@@ -134,16 +477,21 @@ namespace DefaultNamespace
             defaultMask = Texture2D.whiteTexture;
 
             instanceDataList.Clear();
-            primitiveDataList.Clear();
-
-            globalTexturePool.Clear();
-            textureGroupCache.Clear();
+            trackedRenderers.Clear();
+            primitiveCount = 0;
+            primitiveBuildDescs.Clear();
 
             meshPrimitiveCache.Clear();
 
+            if (instanceTable == IntPtr.Zero)
+                instanceTable = RtxdiNative.CreateInstanceTable();
+            RtxdiNative.ClearInstanceTable(instanceTable);
+
             var renderers = Object.FindObjectsByType<Renderer>(FindObjectsSortMode.None);
             Debug.Log($"Found {renderers.Length} renderers in scene.");
 
+            BuildTextureTable(renderers);
+
             int globalInstanceIndexCounter = 0;
 
             foreach (var r in renderers)
@@ -163,21 +511,28 @@ namespace DefaultNamespace
                 int subMeshCount = mesh.subMeshCount;
                 int meshInstanceID = mesh.GetInstanceID(); // 获取 Mesh 唯一 ID
 
-                Matrix4x4 localToWorld = r.transform.localToWorldMatrix;
-
                 bool isMeshCached = meshPrimitiveCache.TryGetValue(meshInstanceID, out List<uint> cachedOffsets);
                 List<uint> currentMeshOffsets = isMeshCached ? cachedOffsets : new List<uint>();
 
-                Vector3[] vertices = mesh.vertices;
-                Vector2[] uvs = mesh.uv;
-                Vector3[] normals = mesh.normals;
+                // 顶点属性只在第一次遇到这个 mesh 时需要
+                PrimitiveBuildDesc meshDesc = default;
+                if (!isMeshCached)
+                {
+                    Vector3[] vertices = mesh.vertices;
+
+                    // 切线由原生代码按 MikkTSpace 生成，不修改 mesh 资源
+                    meshDesc.positions = Pin(vertices);
+                    meshDesc.normals = Pin(mesh.normals);
+                    meshDesc.uvs = Pin(mesh.uv);
+                    meshDesc.vertexCount = (uint)vertices.Length;
+                    meshDesc.flags = PrimitiveBuildFlags.GenerateTangents;
+                }
 
-                mesh.RecalculateTangents();
-                Vector4[] tangents = mesh.tangents;
                 Material[] sharedMaterials = r.sharedMaterials;
 
                 uint instanceID = (uint)globalInstanceIndexCounter;
                 RayTracingSubMeshFlags[] subMeshFlags = new RayTracingSubMeshFlags[subMeshCount];
+                InstanceData[] rendererRows = new InstanceData[subMeshCount];
                 uint mask = 0;
 
                 // 【关键修改 3】遍历 SubMesh
@@ -199,7 +554,7 @@ namespace DefaultNamespace
                     }
                     else
                     {
-                        thisSubMeshPrimitiveOffset = (uint)primitiveDataList.Count;
+                        thisSubMeshPrimitiveOffset = (uint)primitiveCount;
 
                         // 记录到缓存列表
                         currentMeshOffsets.Add(thisSubMeshPrimitiveOffset);
@@ -208,72 +563,14 @@ namespace DefaultNamespace
                         // 注意：GetTriangles 返回的是顶点索引，不需要偏移，直接对应 mesh.vertices
                         int[] subMeshTriangles = mesh.GetTriangles(subIdx);
 
-                        // --- 构造 Primitive Data ---
-                        for (int t = 0; t < subMeshTriangles.Length; t += 3)
-                        {
-                            PrimitiveData prim = new PrimitiveData();
-                            int i0 = subMeshTriangles[t];
-                            int i1 = subMeshTriangles[t + 1];
-                            int i2 = subMeshTriangles[t + 2];
-
-                            prim.n0 = EncodeUnitVector(normals[i0], true);
-                            prim.n1 = EncodeUnitVector(normals[i1], true);
-                            prim.n2 = EncodeUnitVector(normals[i2], true);
-
-                            // 增加安全检查，防止 UV 数组越界（有些 Mesh 可能没有 UV）
-
-                            if (uvs.Length == 0)
-                            {
-                                prim.uv0 = half2.zero;
-                                prim.uv1 = half2.zero;
-                                prim.uv2 = half2.zero;
-                            }
-                            else
-                            {
-                                prim.uv0 = new half2(uvs[i0]);
-                                prim.uv1 = new half2(uvs[i1]);
-                                prim.uv2 = new half2(uvs[i2]);
-                            }
-
-                            // 计算面积
-                            Vector3 p0 = vertices[i0];
-                            Vector3 p1 = vertices[i1];
-                            Vector3 p2 = vertices[i2];
-
-                            Vector3 edge20 = p2 - p0;
-                            Vector3 edge10 = p1 - p0;
-                            float worldArea = Vector3.Cross(edge20, edge10).magnitude * 0.5f;
-                            prim.worldArea = Math.Max(worldArea, 1e-9f);
-
-                            // UV 面积
-                            if (uvs.Length > 0)
-                            {
-                                // 3. 计算 UV 面积 (原版代码逻辑)
-                                Vector3 uvEdge20 = uvs[i2] - uvs[i0];
-                                Vector3 uvEdge10 = uvs[i1] - uvs[i0];
-                                float uvArea = Vector3.Cross(uvEdge20, uvEdge10).magnitude * 0.5f;
-                                prim.uvArea = Math.Max(uvArea, 1e-9f);
-                            }
-                            else
-                            {
-                                prim.uvArea = 1e-9f;
-                            }
-
-                            // 切线
-                            {
-                                Vector3 tang0 = tangents[i0];
-                                Vector3 tang1 = tangents[i1];
-                                Vector3 tang2 = tangents[i2];
-
-
-                                prim.t0 = EncodeUnitVector(tang0, true);
-                                prim.t1 = EncodeUnitVector(tang1, true);
-                                prim.t2 = EncodeUnitVector(tang2, true);
-                                prim.bitangentSign = tangents[i0].w;
-                            }
-
-                            primitiveDataList.Add(prim);
-                        }
+                        // --- 构造 Primitive Data，在所有 mesh 收集完之后由原生插件统一生成 ---
+                        PrimitiveBuildDesc desc = meshDesc;
+                        desc.indices = Pin(subMeshTriangles);
+                        desc.indexCount = (uint)subMeshTriangles.Length;
+                        desc.primitiveOffset = thisSubMeshPrimitiveOffset;
+                        primitiveBuildDescs.Add(desc);
+
+                        primitiveCount += subMeshTriangles.Length / 3;
                     }
 
 
@@ -282,77 +579,21 @@ namespace DefaultNamespace
 
 
                     // 矩阵部分
-                    inst.mOverloadedMatrix0 = new float4(localToWorld.m00, localToWorld.m01, localToWorld.m02, localToWorld.m03);
-                    inst.mOverloadedMatrix1 = new float4(localToWorld.m10, localToWorld.m11, localToWorld.m12, localToWorld.m13);
-                    inst.mOverloadedMatrix2 = new float4(localToWorld.m20, localToWorld.m21, localToWorld.m22, localToWorld.m23);
+                    FillTransformData(ref inst, r.transform);
 
                     inst.primitiveOffset = thisSubMeshPrimitiveOffset;
                     inst.morphPrimitiveOffset = 0;
 
-                    // 获取当前 SubMesh 对应的材质
-                    Material mat = null;
-                    if (subIdx < sharedMaterials.Length)
-                    {
-                        mat = sharedMaterials[subIdx];
-                    }
-
-                    // 如果材质索引超出了（比如 Mesh 有 3 个 SubMesh 但 Renderer 只填了 1 个材质），通常取最后一个或默认
-                    if (mat == null && sharedMaterials.Length > 0) mat = sharedMaterials[^1];
-
-                    // 处理材质纹理
-                    uint baseTextureIndex = GetTextureGroupIndex(mat);
+                    // 材质纹理、Flags 和材质属性 Scale
+                    FillMaterialData(ref inst, r, sharedMaterials, subIdx, out bool isTransparent);
 
-                    // 处理 Flags
-                    uint currentFlags = 0;
                     RayTracingSubMeshFlags subMeshFlag = RayTracingSubMeshFlags.Enabled;
-                    // if (mat != null)
-
-                    bool isTransparent = mat.renderQueue >= 3000 || mat.IsKeywordEnabled("_SURFACE_TYPE_TRANSPARENT");
-
-
                     if (!isTransparent)
                         subMeshFlag |= RayTracingSubMeshFlags.ClosestHitOnly;
 
-                    currentFlags |= isTransparent ? FLAG_TRANSPARENT : FLAG_NON_TRANSPARENT;
-                    if (r.gameObject.isStatic)
-                        currentFlags |= FLAG_STATIC;
-
-
-                    inst.textureOffsetAndFlags = ((currentFlags & 0xFF) << FLAG_FIRST_BIT) | (baseTextureIndex & NON_FLAG_MASK);
-
-                    // 处理材质属性 Scale
-                    if (mat != null)
-                    {
-                        Color col = mat.HasProperty("_BaseColor") ? mat.GetColor("_BaseColor") : Color.white;
-                        // 注意：如果使用的是 Standard Shader，属性名可能是 _Color, _MainTex 等，需根据项目实际 Shader 调整
-                        float metalScale = mat.HasProperty("_Metallic") ? mat.GetFloat("_Metallic") : 0.0f;
-                        inst.baseColorAndMetalnessScale = new half4(new half(col.r), new half(col.g), new half(col.b), new half(metalScale));
-
-                        Color emi = mat.HasProperty("_EmissionColor") ? mat.GetColor("_EmissionColor") : Color.black;
-                        if (mat.IsKeywordEnabled("_EMISSION"))
-                        {
-                            // 有些 Shader 需要开启 Keyword 才有 Emission
-                        }
-
-                        float roughScale = mat.HasProperty("_Smoothness") ? (1.0f - mat.GetFloat("_Smoothness")) : 0.5f;
-                        // 如果 Shader 属性叫 _Roughness 直接取即可
-
-                        inst.emissionAndRoughnessScale = new half4(new half(emi.r), new half(emi.g), new half(emi.b), new half(roughScale));
-
-                        Vector2 tiling = mat.mainTextureScale;
-                        inst.normalUvScale = new half2(new half(tiling.x), new half(tiling.y));
-                    }
-                    else
-                    {
-                        inst.baseColorAndMetalnessScale = new half4(new float4(1, 1, 1, 0));
-                        inst.emissionAndRoughnessScale = new half4(new float4(0, 0, 0, 0.5f));
-                        inst.normalUvScale = new half2(new half(1), new half(1));
-                    }
-
-                    inst.scale = r.transform.lossyScale.x;
-
                     // 添加到列表
                     instanceDataList.Add(inst);
+                    rendererRows[subIdx] = inst;
 
                     subMeshFlags[subIdx] = subMeshFlag;
 
@@ -371,54 +612,468 @@ namespace DefaultNamespace
                     meshPrimitiveCache.Add(meshInstanceID, currentMeshOffsets);
                 }
 
+                // 表是清空后按顺序加入的，行号与 globalInstanceIndexCounter 一致
+                if (subMeshCount > 0)
+                {
+                    int rendererId = r.GetInstanceID();
+                    instanceID = AddInstanceRenderer(rendererId, rendererRows);
+                    trackedRenderers.Add(new TrackedRenderer { renderer = r, rendererId = rendererId, firstRow = instanceID, submeshCount = subMeshCount });
+                    r.transform.hasChanged = false;
+                }
+
                 accelerationStructure.UpdateInstanceID(r, instanceID);
                 accelerationStructure.UpdateInstanceMask(r, mask);
 
                 Debug.Log($"updated instance ID {instanceID} and mask {mask} for renderer {r.name}");
             }
 
+            ReleaseGeometryBuffers();
+            if (primitiveCount > 0)
+            {
+                if (useCompactGeometry)
+                    BuildCompactGeometryBuffers();
+                else
+                    BuildPrimitiveBuffer();
+            }
+
+            // CompactGeometry 会改写 InstanceData 中的偏移，最后再整表上传
             _instanceBuffer?.Release();
+            _instanceBuffer = null;
+            UploadDirtyInstances();
+
+            foreach (var handle in pinnedArrays)
+            {
+                handle.Free();
+            }
 
-            if (instanceDataList.Count > 0)
+            pinnedArrays.Clear();
+            primitiveBuildDescs.Clear();
+
+            Debug.Log($"Renderers: {renderers.Length}, Instances: {instanceDataList.Count}, Primitives: {primitiveCount}");
+        }
+
+        private void FillTransformData(ref InstanceData inst, Transform transform)
+        {
+            Matrix4x4 localToWorld = transform.localToWorldMatrix;
+            inst.mOverloadedMatrix0 = new float4(localToWorld.m00, localToWorld.m01, localToWorld.m02, localToWorld.m03);
+            inst.mOverloadedMatrix1 = new float4(localToWorld.m10, localToWorld.m11, localToWorld.m12, localToWorld.m13);
+            inst.mOverloadedMatrix2 = new float4(localToWorld.m20, localToWorld.m21, localToWorld.m22, localToWorld.m23);
+            inst.scale = transform.lossyScale.x;
+        }
+
+        private void FillMaterialData(ref InstanceData inst, Renderer r, Material[] sharedMaterials, int subIdx, out bool isTransparent)
+        {
+            // 获取当前 SubMesh 对应的材质
+            Material mat = null;
+            if (subIdx < sharedMaterials.Length)
+            {
+                mat = sharedMaterials[subIdx];
+            }
+
+            // 如果材质索引超出了（比如 Mesh 有 3 个 SubMesh 但 Renderer 只填了 1 个材质），通常取最后一个或默认
+            if (mat == null && sharedMaterials.Length > 0) mat = sharedMaterials[^1];
+
+            // 处理材质纹理
+            uint baseTextureIndex = GetTextureGroupIndex(mat);
+
+            // 处理 Flags
+            uint currentFlags = 0;
+            // if (mat != null)
+
+            isTransparent = mat.renderQueue >= 3000 || mat.IsKeywordEnabled("_SURFACE_TYPE_TRANSPARENT");
+
+            currentFlags |= isTransparent ? FLAG_TRANSPARENT : FLAG_NON_TRANSPARENT;
+            if (r.gameObject.isStatic)
+                currentFlags |= FLAG_STATIC;
+
+
+            inst.textureOffsetAndFlags = ((currentFlags & 0xFF) << FLAG_FIRST_BIT) | (baseTextureIndex & NON_FLAG_MASK);
+
+            // 处理材质属性 Scale
+            if (mat != null)
+            {
+                Color col = mat.HasProperty("_BaseColor") ? mat.GetColor("_BaseColor") : Color.white;
+                // 注意：如果使用的是 Standard Shader，属性名可能是 _Color, _MainTex 等，需根据项目实际 Shader 调整
+                float metalScale = mat.HasProperty("_Metallic") ? mat.GetFloat("_Metallic") : 0.0f;
+                inst.baseColorAndMetalnessScale = new half4(new half(col.r), new half(col.g), new half(col.b), new half(metalScale));
+
+                Color emi = mat.HasProperty("_EmissionColor") ? mat.GetColor("_EmissionColor") : Color.black;
+                if (mat.IsKeywordEnabled("_EMISSION"))
+                {
+                    // 有些 Shader 需要开启 Keyword 才有 Emission
+                }
+
+                float roughScale = mat.HasProperty("_Smoothness") ? (1.0f - mat.GetFloat("_Smoothness")) : 0.5f;
+                // 如果 Shader 属性叫 _Roughness 直接取即可
+
+                inst.emissionAndRoughnessScale = new half4(new half(emi.r), new half(emi.g), new half(emi.b), new half(roughScale));
+
+                Vector2 tiling = mat.mainTextureScale;
+                inst.normalUvScale = new half2(new half(tiling.x), new half(tiling.y));
+            }
+            else
+            {
+                inst.baseColorAndMetalnessScale = new half4(new float4(1, 1, 1, 0));
+                inst.emissionAndRoughnessScale = new half4(new float4(0, 0, 0, 0.5f));
+                inst.normalUvScale = new half2(new half(1), new half(1));
+            }
+        }
+
+        private uint AddInstanceRenderer(int rendererId, InstanceData[] rows)
+        {
+            unsafe
             {
-                _instanceBuffer = new ComputeBuffer(instanceDataList.Count, Marshal.SizeOf<InstanceData>());
-                _instanceBuffer.SetData(instanceDataList.ToArray());
+                fixed (InstanceData* rowPtr = rows)
+                {
+                    return RtxdiNative.AddInstanceTableRenderer(instanceTable, rendererId, (uint)rows.Length, (IntPtr)rowPtr);
+                }
             }
+        }
+
+        // 每帧调用一次：收集 transform.hasChanged 的 renderer，只上传变化的行
+        public void UpdateInstances()
+        {
+            if (instanceTable == IntPtr.Zero)
+                return;
 
+            updateRowIndices.Clear();
+            updateRows.Clear();
+
+            for (int i = trackedRenderers.Count - 1; i >= 0; i--)
+            {
+                var tracked = trackedRenderers[i];
+
+                // renderer 被销毁后释放它的行，RTAS 在 Automatic 模式下会自行移除实例
+                if (tracked.renderer == null)
+                {
+                    RtxdiNative.RemoveInstanceTableRenderer(instanceTable, tracked.rendererId);
+                    trackedRenderers.RemoveAt(i);
+                    continue;
+                }
+
+                Transform transform = tracked.renderer.transform;
+                if (!transform.hasChanged)
+                    continue;
+                transform.hasChanged = false;
+
+                InstanceData inst = default;
+                FillTransformData(ref inst, transform);
+                for (int subIdx = 0; subIdx < tracked.submeshCount; subIdx++)
+                {
+                    updateRowIndices.Add(tracked.firstRow + (uint)subIdx);
+                    updateRows.Add(inst);
+                }
+            }
+
+            UpdateInstanceRows(InstanceField.Transform);
+            UploadDirtyInstances();
+        }
+
+        // 材质参数在运行时修改后调用，下一次 UpdateInstances 时上传
+        public void MarkMaterialDirty(Renderer r)
+        {
+            if (instanceTable == IntPtr.Zero || r == null)
+                return;
+
+            updateRowIndices.Clear();
+            updateRows.Clear();
+
+            int rendererId = r.GetInstanceID();
+            foreach (var tracked in trackedRenderers)
+            {
+                if (tracked.rendererId != rendererId)
+                    continue;
+
+                Material[] sharedMaterials = r.sharedMaterials;
+
+                // 纹理可能也换了，重新登记这些材质的纹理组
+                foreach (var mat in sharedMaterials)
+                {
+                    if (mat != null)
+                        materialTextureOffsets.Remove(mat.GetInstanceID());
+                }
+
+                for (int subIdx = 0; subIdx < tracked.submeshCount; subIdx++)
+                {
+                    InstanceData inst = default;
+                    FillMaterialData(ref inst, r, sharedMaterials, subIdx, out _);
+                    updateRowIndices.Add(tracked.firstRow + (uint)subIdx);
+                    updateRows.Add(inst);
+                }
+            }
+
+            UpdateInstanceRows(InstanceField.Material);
+        }
+
+        private void UpdateInstanceRows(InstanceField fields)
+        {
+            if (updateRowIndices.Count == 0)
+                return;
+
+            var rowIndices = updateRowIndices.ToArray();
+            var rows = updateRows.ToArray();
+            unsafe
+            {
+                fixed (uint* indexPtr = rowIndices)
+                fixed (InstanceData* rowPtr = rows)
+                {
+                    RtxdiNative.UpdateInstanceTableRows(instanceTable, (IntPtr)indexPtr, (IntPtr)rowPtr, (uint)rows.Length, (uint)fields);
+                }
+            }
+        }
+
+        private void UploadDirtyInstances()
+        {
+            var stats = RtxdiNative.GetInstanceTableStats(instanceTable);
+            if (stats.rowCount == 0)
+                return;
+
+            // 行数超过缓冲大小时按 2 倍扩容，整表重新上传
+            if (_instanceBuffer == null || _instanceBuffer.count < stats.rowCount)
+            {
+                // Release 之后不能再读 count
+                int oldCount = _instanceBuffer?.count ?? 0;
+                _instanceBuffer?.Release();
+                _instanceBuffer = new ComputeBuffer((int)Math.Max(stats.rowCount, (uint)oldCount * 2), Marshal.SizeOf<InstanceData>());
+                RtxdiNative.MarkInstanceTableDirty(instanceTable);
+                stats.dirtyRowCount = stats.rowCount;
+            }
+            else if (stats.dirtyRowCount == 0)
+            {
+                return;
+            }
+
+            // 每个区间至少一行，区间数不会超过脏行数
+            if (dirtyRanges.Length < stats.dirtyRowCount)
+                dirtyRanges = new InstanceRowRange[Math.Max((int)stats.dirtyRowCount, dirtyRanges.Length * 2)];
+
+            uint rangeCount;
+            unsafe
+            {
+                fixed (InstanceRowRange* rangePtr = dirtyRanges)
+                {
+                    rangeCount = RtxdiNative.CollectInstanceTableDirtyRanges(instanceTable, (IntPtr)rangePtr, (uint)dirtyRanges.Length, DirtyRangeMergeGap);
+                }
+            }
+
+            var rows = GetInstanceRows((int)stats.rowCount);
+            for (int i = 0; i < rangeCount; i++)
+            {
+                var range = dirtyRanges[i];
+                _instanceBuffer.SetData(rows, (int)range.firstRow, (int)range.firstRow, (int)range.rowCount);
+            }
+        }
+
+        // InstanceTable 中的行，在下一次 AddInstanceRenderer 之前有效
+        private NativeArray<InstanceData> GetInstanceRows(int count)
+        {
+            return GetNativeView<InstanceData>(RtxdiNative.GetInstanceTableRows(instanceTable), count);
+        }
+
+        // 原生内存的临时视图，只在当前帧、原生对象修改之前使用
+        private static unsafe NativeArray<T> GetNativeView<T>(IntPtr data, int count) where T : struct
+        {
+            var view = NativeArrayUnsafeUtility.ConvertExistingDataToNativeArray<T>((void*)data, count, Allocator.None);
+#if ENABLE_UNITY_COLLECTIONS_CHECKS
+            NativeArrayUnsafeUtility.SetAtomicSafetyHandle(ref view, AtomicSafetyHandle.GetTempMemoryHandle());
+#endif
+            return view;
+        }
+
+        private void ReleaseGeometryBuffers()
+        {
             _primitiveBuffer?.Release();
-            if (primitiveDataList.Count > 0)
+            _primitiveBuffer = null;
+            _compactVertexBuffer?.Release();
+            _compactVertexBuffer = null;
+            _compactIndexBuffer?.Release();
+            _compactIndexBuffer = null;
+            _compactTriangleBuffer?.Release();
+            _compactTriangleBuffer = null;
+        }
+
+        public bool HasCompactGeometry()
+        {
+            return _compactVertexBuffer != null;
+        }
+
+        public void Dispose()
+        {
+            _instanceBuffer?.Release();
+            _instanceBuffer = null;
+            ReleaseGeometryBuffers();
+
+            // 清空后 IsEmpty 为 true，下次 Create 时会重新 Build
+            instanceDataList.Clear();
+            primitiveCount = 0;
+            trackedRenderers.Clear();
+            if (instanceTable != IntPtr.Zero)
             {
-                _primitiveBuffer = new ComputeBuffer(primitiveDataList.Count, Marshal.SizeOf<PrimitiveData>());
-                _primitiveBuffer.SetData(primitiveDataList.ToArray());
+                RtxdiNative.DestroyInstanceTable(instanceTable);
+                instanceTable = IntPtr.Zero;
             }
 
-            Debug.Log($"Renderers: {renderers.Length}, Instances: {instanceDataList.Count}, Primitives: {primitiveDataList.Count}");
+            if (primitiveCache != IntPtr.Zero)
+            {
+                // 后台保存结束前不能销毁，否则会释放正在写出的数据
+                primitiveCacheSaveTask?.Wait();
+                primitiveCacheSaveTask = null;
+                RtxdiNative.DestroyPrimitiveCache(primitiveCache);
+                primitiveCache = IntPtr.Zero;
+            }
+
+            globalTexturePool.Clear();
+            materialTextureOffsets.Clear();
+            texturesById.Clear();
+            if (textureTable != IntPtr.Zero)
+            {
+                RtxdiNative.DestroyTextureTable(textureTable);
+                textureTable = IntPtr.Zero;
+            }
         }
 
-        float SafeSign(float x)
+        private static string GetPrimitiveCachePath()
         {
-            return x >= 0.0f ? 1.0f : -1.0f;
+            return Path.Combine(Application.persistentDataPath, "PrimitiveCache.bin");
         }
 
-        float2 SafeSign(float2 v)
+        private void BuildPrimitiveBuffer()
         {
-            return new float2(SafeSign(v.x), SafeSign(v.y));
+            var primitives = new NativeArray<PrimitiveData>(primitiveCount, Allocator.Persistent, NativeArrayOptions.UninitializedMemory);
+            var descs = primitiveBuildDescs.ToArray();
+
+            if (usePrimitiveCache && primitiveCache == IntPtr.Zero)
+            {
+                primitiveCache = RtxdiNative.CreatePrimitiveCache(GetPrimitiveCachePath());
+                var info = RtxdiNative.GetPrimitiveCacheInfo(primitiveCache);
+                if (info.loadResult == PrimitiveCacheResult.VersionMismatch)
+                    Debug.Log("PrimitiveData format changed, rebuilding the primitive cache.");
+            }
+
+            // 上一次保存还没结束时不等待，这次直接生成，新增的 mesh 下次 Build 时再写入缓存
+            bool saving = primitiveCacheSaveTask != null && !primitiveCacheSaveTask.IsCompleted;
+            bool useCache = usePrimitiveCache && primitiveCache != IntPtr.Zero && !saving;
+            if (usePrimitiveCache && saving)
+                Debug.Log("Primitive cache is still being saved, building primitives without the cache.");
+
+            PrimitiveBuildStats stats;
+            PrimitiveCacheBuildStats cacheStats = default;
+            unsafe
+            {
+                fixed (PrimitiveBuildDesc* descPtr = descs)
+                {
+                    if (useCache)
+                    {
+                        cacheStats = RtxdiNative.BuildScenePrimitiveDataCached(primitiveCache, (IntPtr)descPtr, (uint)descs.Length, (IntPtr)primitives.GetUnsafePtr(), (uint)primitiveCount);
+                        stats = new PrimitiveBuildStats
+                        {
+                            primitiveCount = cacheStats.primitiveCount,
+                            invalidSubmeshCount = cacheStats.invalidSubmeshCount,
+                            path = cacheStats.path,
+                            milliseconds = cacheStats.milliseconds,
+                            tangentMeshCount = cacheStats.tangentMeshCount,
+                            tangentMilliseconds = cacheStats.tangentMilliseconds,
+                        };
+                    }
+                    else
+                    {
+                        stats = RtxdiNative.BuildScenePrimitiveData((IntPtr)descPtr, (uint)descs.Length, (IntPtr)primitives.GetUnsafePtr(), (uint)primitiveCount);
+                    }
+                }
+            }
+
+            _primitiveBuffer = new ComputeBuffer(primitiveCount, Marshal.SizeOf<PrimitiveData>());
+            _primitiveBuffer.SetData(primitives);
+            primitives.Dispose();
+
+            if (useCache)
+            {
+                Debug.Log($"Primitive cache: {cacheStats.hitMeshCount}/{cacheStats.meshCount} meshes hit, {cacheStats.builtMeshCount} built, hash {cacheStats.hashMilliseconds:F1} ms");
+
+                // 只有新增 mesh 时才会写文件
+                if (cacheStats.builtMeshCount > 0)
+                {
+                    IntPtr cache = primitiveCache;
+                    ulong maxBytes = primitiveCacheMaxBytes;
+                    primitiveCacheSaveTask = Task.Run(() => SavePrimitiveCache(cache, maxBytes));
+                }
+            }
+
+            Debug.Log($"Built {stats.primitiveCount} primitives from {descs.Length} submeshes in {stats.milliseconds:F1} ms ({stats.path}), tangents for {stats.tangentMeshCount} meshes in {stats.tangentMilliseconds:F1} ms");
         }
 
+        private static void SavePrimitiveCache(IntPtr cache, ulong maxBytes)
+        {
+            var saveStats = RtxdiNative.SavePrimitiveCache(cache, maxBytes);
+            if (saveStats.result == PrimitiveCacheResult.Ok)
+                Debug.Log($"Saved primitive cache: {saveStats.entryCount} meshes, {saveStats.fileBytes / (1024 * 1024)} MB, {saveStats.evictedEntryCount} evicted, {saveStats.milliseconds:F1} ms");
+            else
+                Debug.LogWarning($"Primitive cache was not saved: {saveStats.result}");
+        }
 
-        half2 EncodeUnitVector(float3 v, bool bSigned = false)
+        private void BuildCompactGeometryBuffers()
         {
-            v /= math.dot(math.abs(v), 1.0f);
+            var descs = primitiveBuildDescs.ToArray();
+            IntPtr builder = RtxdiNative.CreateCompactGeometryBuilder();
+
+            CompactGeometryReport report;
+            unsafe
+            {
+                fixed (PrimitiveBuildDesc* descPtr = descs)
+                {
+                    report = RtxdiNative.BuildCompactGeometry(builder, (IntPtr)descPtr, (uint)descs.Length, (uint)primitiveCount);
+                }
+            }
+
+            _compactVertexBuffer = new ComputeBuffer((int)report.vertexCount, Marshal.SizeOf<CompactVertex>());
+            _compactVertexBuffer.SetData(GetNativeView<CompactVertex>(RtxdiNative.GetCompactGeometryVertices(builder), (int)report.vertexCount));
+
+            int indexWordCount = (int)(report.indexBytes / sizeof(uint));
+            _compactIndexBuffer = new ComputeBuffer(indexWordCount, sizeof(uint), ComputeBufferType.Raw);
+            _compactIndexBuffer.SetData(GetNativeView<uint>(RtxdiNative.GetCompactGeometryIndices(builder), indexWordCount));
+
+            _compactTriangleBuffer = new ComputeBuffer(primitiveCount, Marshal.SizeOf<float2>());
+            _compactTriangleBuffer.SetData(GetNativeView<float2>(RtxdiNative.GetCompactGeometryTriangles(builder), primitiveCount));
+
+            // 每个 submesh 的 primitiveOffset 唯一确定它的顶点和索引位置；空 submesh 与下一个 submesh 的 primitiveOffset 相同，跳过
+            var submeshes = GetNativeView<CompactSubmesh>(RtxdiNative.GetCompactGeometrySubmeshes(builder), descs.Length);
+            var submeshByOffset = new Dictionary<uint, CompactSubmesh>(descs.Length);
+            foreach (var submesh in submeshes)
+            {
+                if (submesh.triangleCount > 0)
+                    submeshByOffset[submesh.triangleOffset] = submesh;
+            }
+
+            RtxdiNative.DestroyCompactGeometryBuilder(builder);
+
+            // InstanceTable 在 Build 开始时清空，行号与 instanceDataList 的下标一致
+            updateRowIndices.Clear();
+            updateRows.Clear();
+            for (int i = 0; i < instanceDataList.Count; i++)
+            {
+                InstanceData inst = instanceDataList[i];
+                if (!submeshByOffset.TryGetValue(inst.primitiveOffset, out var submesh))
+                    continue;
+
+                inst.compactVertexOffset = submesh.vertexOffset;
+                inst.compactIndexOffset = submesh.indexOffset;
+                instanceDataList[i] = inst;
+                updateRowIndices.Add((uint)i);
+                updateRows.Add(inst);
+            }
 
-            float2 octWrap = (1.0f - math.abs(v.yx)) * SafeSign(v.xy);
-            v.xy = v.z >= 0.0f ? v.xy : octWrap;
+            UpdateInstanceRows(InstanceField.Geometry);
 
-            return new half2(bSigned ? v.xy : 0.5f * v.xy + 0.5f);
+            const float mb = 1.0f / (1024 * 1024);
+            Debug.Log($"Compact geometry: {report.compactBytes * mb:F1} MB instead of {report.primitiveDataBytes * mb:F1} MB PrimitiveData " +
+                      $"(vertices {report.vertexBytes * mb:F1} MB, indices {report.indexBytes * mb:F1} MB, triangles {report.triangleBytes * mb:F1} MB), " +
+                      $"{report.vertexCount}/{report.sourceVertexCount} vertices after welding, " +
+                      $"{report.index16SubmeshCount} 16-bit / {report.index32SubmeshCount} 32-bit submeshes, {report.milliseconds:F1} ms");
         }
 
         public bool IsEmpty()
         {
-            return instanceDataList.Count == 0 || primitiveDataList.Count == 0;
+            return instanceDataList.Count == 0 || primitiveCount == 0;
         }
     }
 }
\ No newline at end of file
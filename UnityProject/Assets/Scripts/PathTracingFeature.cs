@@ -5,6 +5,7 @@ using Unity.Mathematics;
 using UnityEngine;
 using UnityEngine.Rendering;
 using UnityEngine.Rendering.Universal;
+using UnityEngine.SceneManagement;
 using static UnityEngine.Rendering.RayTracingAccelerationStructure;
 
 namespace PathTracing
@@ -77,9 +78,8 @@ namespace PathTracing
         public GraphicsBuffer gIn_SobolUint;
 
 
-        private GraphicsBuffer _hashEntriesBuffer;
-        private GraphicsBuffer _accumulationBuffer;
-        private GraphicsBuffer _resolvedBuffer;
+        private SharcCache _sharcCache;
+        private uint _sharcSnapshotFrames;
 
 
         private Dictionary<long, NRDDenoiser> _nrdDenoisers = new();
@@ -111,6 +111,7 @@ namespace PathTracing
 
             if (_dataBuilder.IsEmpty())
             {
+                _dataBuilder.useCompactGeometry = pathTracingSetting.compactGeometry;
                 _dataBuilder.Build(accelerationStructure);
             }
 
@@ -141,7 +142,7 @@ namespace PathTracing
                 gIn_SobolUint.SetData(sobolData);
             }
 
-            if (_accumulationBuffer == null)
+            if (_sharcCache == null)
             {
                 InitializeBuffers();
             }
@@ -160,50 +161,37 @@ namespace PathTracing
                 BiltMaterial = finalMaterial,
                 SharcResolveCs = sharcResolveCs,
                 SharcUpdateTs = sharcUpdateTs,
-                HashEntriesBuffer = _hashEntriesBuffer,
-                AccumulationBuffer = _accumulationBuffer,
-                ResolvedBuffer = _resolvedBuffer,
+                SharcCache = _sharcCache,
+                HashEntriesBuffer = _sharcCache.HashEntriesBuffer,
+                AccumulationBuffer = _sharcCache.AccumulationBuffer,
+                ResolvedBuffer = _sharcCache.ResolvedBuffer,
                 _dataBuilder = _dataBuilder
             };
         }
 
-        static readonly int Capacity = 1 << 22;
+        // 初始容量，之后由 RenderingPlugin 根据读回的占用率调整
+        static readonly uint InitialCapacity = 1 << 22;
 
         public void InitializeBuffers()
         {
-            if (_hashEntriesBuffer != null)
-            {
-                _hashEntriesBuffer.Release();
-                _hashEntriesBuffer = null;
-            }
+            _sharcCache?.Dispose();
+            _sharcCache = new SharcCache(sharcResolveCs, InitialCapacity);
 
-            if (_accumulationBuffer != null)
+            if (pathTracingSetting.sharcSnapshot)
             {
-                _accumulationBuffer.Release();
-                _accumulationBuffer = null;
+                var cameraPosition = Camera.main != null ? Camera.main.transform.position : Vector3.zero;
+                _sharcCache.LoadSnapshot(GetSharcSceneHash(), cameraPosition);
             }
 
-            if (_resolvedBuffer != null)
+            if (_pathTracingPass != null)
             {
-                _resolvedBuffer.Release();
-                _resolvedBuffer = null;
+                _pathTracingPass.SharcCache = _sharcCache;
             }
+        }
 
-            _hashEntriesBuffer = new GraphicsBuffer(GraphicsBuffer.Target.Structured, Capacity, sizeof(ulong));
-            ulong[] clearData = new ulong[Capacity];
-            _hashEntriesBuffer.SetData(clearData);
-
-            // 2. Accumulation Buffer: storing uint4 (16 bytes)
-            // HLSL: RWStructuredBuffer<SharcAccumulationData> gInOut_SharcAccumulated;
-            _accumulationBuffer = new GraphicsBuffer(GraphicsBuffer.Target.Structured, Capacity, sizeof(uint) * 4);
-            uint4[] clearAccumData = new uint4[Capacity];
-            _accumulationBuffer.SetData(clearAccumData);
-
-            // 3. Resolved Buffer: storing uint3 + uint (16 bytes)
-            // HLSL: RWStructuredBuffer<SharcPackedData> gInOut_SharcResolved;
-            _resolvedBuffer = new GraphicsBuffer(GraphicsBuffer.Target.Structured, Capacity, sizeof(uint) * 4);
-            uint4[] clearResolvedData = new uint4[Capacity];
-            _resolvedBuffer.SetData(clearResolvedData);
+        private static ulong GetSharcSceneHash()
+        {
+            return SharcCache.ComputeSceneHash(SceneManager.GetActiveScene().path);
         }
 
         public override void AddRenderPasses(ScriptableRenderer renderer, ref RenderingData renderingData)
@@ -248,9 +236,19 @@ namespace PathTracing
             _pathTracingPass.NrdDenoiser = nrd;
             _pathTracingPass.DLRRDenoiser = dlrr;
 
-            _pathTracingPass.AccumulationBuffer = _accumulationBuffer;
-            _pathTracingPass.HashEntriesBuffer = _hashEntriesBuffer;
-            _pathTracingPass.ResolvedBuffer = _resolvedBuffer;
+            // 插件请求了新的容量时在这里重新分配，本帧就使用新缓冲
+            _sharcCache.Update();
+            _sharcCache.CameraPosition = cam.transform.position;
+
+            if (pathTracingSetting.sharcSnapshot && pathTracingSetting.sharcSnapshotInterval > 0 && ++_sharcSnapshotFrames >= pathTracingSetting.sharcSnapshotInterval)
+            {
+                _sharcSnapshotFrames = 0;
+                _sharcCache.SaveSnapshot(GetSharcSceneHash(), false);
+            }
+
+            _pathTracingPass.AccumulationBuffer = _sharcCache.AccumulationBuffer;
+            _pathTracingPass.HashEntriesBuffer = _sharcCache.HashEntriesBuffer;
+            _pathTracingPass.ResolvedBuffer = _sharcCache.ResolvedBuffer;
 
             if (compositionComputeShader == null
                 || taaComputeShader == null
@@ -269,6 +267,14 @@ namespace PathTracing
             } 
 
             accelerationStructure.Build();
+            if (_dataBuilder.useCompactGeometry != pathTracingSetting.compactGeometry)
+            {
+                _dataBuilder.useCompactGeometry = pathTracingSetting.compactGeometry;
+                _dataBuilder.Build(accelerationStructure);
+            }
+
+            // 只上传变换或材质变化过的 InstanceData 行
+            _dataBuilder.UpdateInstances();
             if (pathTracingSetting.usePackedData)
             {
                 if (!_dataBuilder.IsEmpty())
@@ -311,12 +317,15 @@ namespace PathTracing
             gIn_SobolUint?.Release();
             gIn_SobolUint = null;
 
-            _accumulationBuffer?.Release();
-            _accumulationBuffer = null;
-            _hashEntriesBuffer?.Release();
-            _hashEntriesBuffer = null;
-            _resolvedBuffer?.Release();
-            _resolvedBuffer = null;
+            if (_sharcCache != null && pathTracingSetting.sharcSnapshot)
+            {
+                _sharcCache.SaveSnapshot(GetSharcSceneHash(), true);
+            }
+
+            _sharcCache?.Dispose();
+            _sharcCache = null;
+
+            _dataBuilder.Dispose();
         }
     }
 }
\ No newline at end of file
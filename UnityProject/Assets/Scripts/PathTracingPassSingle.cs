@@ -31,6 +31,7 @@ namespace PathTracing
         public GraphicsBuffer HashEntriesBuffer;
         public GraphicsBuffer AccumulationBuffer;
         public GraphicsBuffer ResolvedBuffer;
+        public SharcCache SharcCache;
         public PathTracingDataBuilder _dataBuilder;
 
         public RayTracingAccelerationStructure AccelerationStructure;
@@ -115,6 +116,9 @@ namespace PathTracing
             internal GraphicsBuffer AccumulationBuffer;
 
             internal GraphicsBuffer ResolvedBuffer;
+            internal GraphicsBuffer SharcStatsBuffer;
+            internal uint SharcCapacity;
+            internal IntPtr SharcDataPtr;
 
             internal int passIndex;
             internal PathTracingDataBuilder _dataBuilder;
@@ -175,13 +179,17 @@ namespace PathTracing
                 natCmd.SetComputeBufferParam(data.SharcResolveCs, 0, g_HashEntriesID, data.HashEntriesBuffer);
                 natCmd.SetComputeBufferParam(data.SharcResolveCs, 0, g_AccumulationBufferID, data.AccumulationBuffer);
                 natCmd.SetComputeBufferParam(data.SharcResolveCs, 0, g_ResolvedBufferID, data.ResolvedBuffer);
+                natCmd.SetComputeBufferParam(data.SharcResolveCs, 0, g_SharcStatsID, data.SharcStatsBuffer);
 
-                ulong SHARC_CAPACITY = 1 << 22;
+                ulong SHARC_CAPACITY = data.SharcCapacity;
                 ulong LINEAR_BLOCK_SIZE = 256;
                 int x = (int)((SHARC_CAPACITY + LINEAR_BLOCK_SIZE - 1) / LINEAR_BLOCK_SIZE);
 
                 natCmd.DispatchCompute(data.SharcResolveCs, 0, x, 1, 1);
 
+                // 读回占用统计，RenderingPlugin 据此调整容量
+                natCmd.IssuePluginEventAndData(GetRenderEventAndDataFunc(), 3, data.SharcDataPtr);
+
                 natCmd.EndSample(sharcResolveMarker);
             }
 
@@ -190,7 +198,16 @@ namespace PathTracing
                 natCmd.BeginSample(opaqueTracingMarker);
 
                 natCmd.SetGlobalBuffer(gIn_InstanceDataID, data._dataBuilder._instanceBuffer);
-                natCmd.SetGlobalBuffer(gIn_PrimitiveDataID, data._dataBuilder._primitiveBuffer);
+                if (data._dataBuilder.HasCompactGeometry())
+                {
+                    natCmd.SetGlobalBuffer(gIn_CompactVerticesID, data._dataBuilder._compactVertexBuffer);
+                    natCmd.SetGlobalBuffer(gIn_CompactIndicesID, data._dataBuilder._compactIndexBuffer);
+                    natCmd.SetGlobalBuffer(gIn_CompactTrianglesID, data._dataBuilder._compactTriangleBuffer);
+                }
+                else
+                {
+                    natCmd.SetGlobalBuffer(gIn_PrimitiveDataID, data._dataBuilder._primitiveBuffer);
+                }
 
 
                 natCmd.SetRayTracingShaderPass(data.OpaqueTs, "Test2");
@@ -483,6 +500,16 @@ namespace PathTracing
                 Shader.DisableKeyword("_USEPACK");
             }
 
+            // 与实际构建的格式一致，而不是直接看设置
+            if (_dataBuilder != null && _dataBuilder.HasCompactGeometry())
+            {
+                Shader.EnableKeyword("_USECOMPACT");
+            }
+            else
+            {
+                Shader.DisableKeyword("_USECOMPACT");
+            }
+
             var resourceData = frameData.Get<UniversalResourceData>();
 
             int2 outputResolution = new int2((int)(cameraData.camera.pixelWidth * cameraData.renderScale), (int)(cameraData.camera.pixelHeight * cameraData.renderScale));
@@ -515,6 +542,9 @@ namespace PathTracing
             passData.AccumulationBuffer = AccumulationBuffer;
             passData.HashEntriesBuffer = HashEntriesBuffer;
             passData.ResolvedBuffer = ResolvedBuffer;
+            passData.SharcStatsBuffer = SharcCache.StatsBuffer;
+            passData.SharcCapacity = SharcCache.Capacity;
+            passData.SharcDataPtr = SharcCache.GetInteropDataPtr();
             passData.passIndex = isXr ? xrPass.multipassId : 0;
             passData._dataBuilder = _dataBuilder;
 
@@ -668,6 +698,7 @@ namespace PathTracing
                 gPSR = m_Settings.psr ? (uint)1 : 0,
                 gSHARC = m_Settings.SHARC ? (uint)1 : 0,
                 gTrimLobe = m_Settings.specularLobeTrimming ? 1u : 0,
+                gSharcCapacity = SharcCache.Capacity,
             };
 
             // Debug.Log(globalConstants.ToString());
@@ -136,5 +136,15 @@ namespace PathTracing
         public UpscalerMode upscalerMode;
  
         public bool usePackedData;
+
+        // 用共享顶点 + 索引代替每个三角形 48 字节的 PrimitiveData，修改后会重新构建场景数据
+        public bool compactGeometry;
+
+        [Header("Sharc 快照")]
+        // 场景开始时加载上次保存的 radiance cache，退出时保存
+        public bool sharcSnapshot;
+
+        // 每隔多少帧额外保存一次，0 表示只在退出时保存
+        public uint sharcSnapshotInterval;
     }
 }
\ No newline at end of file
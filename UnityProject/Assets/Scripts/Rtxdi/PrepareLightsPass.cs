@@ -1,38 +1,222 @@
-﻿using System.Collections.Generic;
+﻿using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using Unity.Collections;
+using Unity.Collections.LowLevel.Unsafe;
 using UnityEngine;
 
 namespace DefaultNamespace
 {
-    public class PrepareLightsPass
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct PrepareLightsInstance
+    {
+        public fixed float objectToWorld[12]; // 3x4，行主序
+        public fixed float emissiveRadiance[3];
+        public uint geometryInstanceIndex;
+
+        public IntPtr positions; // float3
+        public IntPtr indices; // uint * 3
+        public uint triangleCount;
+        public uint vertexCount;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PrepareLightsDesc
+    {
+        public IntPtr instances;
+        public uint instanceCount;
+
+        public IntPtr infiniteLights;
+        public uint infiniteLightCount;
+
+        public uint environmentLightPresent;
+
+        public IntPtr lightBuffer;
+        public uint maxLights;
+
+        public IntPtr geometryInstanceToLight;
+        public uint geometryInstanceCount;
+    }
+
+    public class PrepareLightsPass : IDisposable
     {
         const uint RTXDI_INVALID_LIGHT_INDEX = 0xFFFFFFFF;
-        
-        
-        public RTXDI_LightBufferParameters Process()
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        private static extern RTXDI_LightBufferParameters PrepareLightBuffer(IntPtr context, ref PrepareLightsDesc desc);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        private static extern IntPtr CreateLightIndexMapper();
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        private static extern void DestroyLightIndexMapper(IntPtr mapper);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        private static extern LightIndexMappingStats UpdateLightIndexMapping(IntPtr mapper, ref PrepareLightsDesc desc, IntPtr instanceIds,
+            RTXDI_LightBufferParameters lightBufferParams, IntPtr currentToPrevious, IntPtr previousToCurrent);
+
+        // 跨帧保存上一帧的光源布局，用于生成 LightIndexMappingBuffer
+        private IntPtr m_lightIndexMapper = CreateLightIndexMapper();
+
+        // 每帧复用，只在几何实例数或光源上限变大时重新分配
+        private uint[] m_geometryInstanceToLight = Array.Empty<uint>();
+        private uint[] m_lightIndexMapping = Array.Empty<uint>();
+
+        // 最近一次完整上传映射的缓冲和光源上限，缓冲重建或 maxLights 变化（previousToCurrent 的起点随之移动）时必须重新上传
+        private GraphicsBuffer m_uploadedLightIndexMappingBuffer;
+        private uint m_uploadedMaxLights;
+
+        public LightIndexMappingStats LastLightIndexMappingStats { get; private set; }
+
+        // 在 Native 端多线程生成光源缓冲，并把光源区间写回 ImportanceSamplingContext
+        public unsafe RTXDI_LightBufferParameters Process(IntPtr importanceSamplingContext, RtxdiResources resources)
         {
-            
-            RTXDI_LightBufferParameters outLightBufferParams = new RTXDI_LightBufferParameters();
-            
-            List<PrepareLightsTask>tasks;
-            
-            uint lightBufferOffset = 0;
-            
-            var allMeshRenderers = GameObject.FindObjectsOfType<MeshRenderer>();
-            int geometryInstanceCount =  allMeshRenderers.Length;
-            
-            uint[] geometryInstanceToLight = new uint[geometryInstanceCount];
-            
-            System.Array.Fill(geometryInstanceToLight, RTXDI_INVALID_LIGHT_INDEX);
-            
-             
-            
-            
-            foreach (var instance in allMeshRenderers)
+            var allMeshRenderers = GameObject.FindObjectsByType<MeshRenderer>(FindObjectsSortMode.None);
+
+            var meshes = new List<Mesh>();
+            var renderers = new List<MeshRenderer>();
+            foreach (var r in allMeshRenderers)
+            {
+                MeshFilter mf = r.GetComponent<MeshFilter>();
+                if (mf == null || mf.sharedMesh == null)
+                    continue;
+
+                meshes.Add(mf.sharedMesh);
+                renderers.Add(r);
+            }
+
+            var instances = new List<PrepareLightsInstance>();
+            var instanceIds = new List<ulong>();
+            var tempArrays = new List<IDisposable>();
+            uint geometryInstanceCount = 0;
+
+            using var meshDataArray = Mesh.AcquireReadOnlyMeshData(meshes);
+
+            for (int i = 0; i < renderers.Count; i++)
+            {
+                MeshRenderer r = renderers[i];
+                Mesh.MeshData meshData = meshDataArray[i];
+                Material[] sharedMaterials = r.sharedMaterials;
+                Matrix4x4 localToWorld = r.transform.localToWorldMatrix;
+
+                NativeArray<Vector3> vertices = default;
+
+                // 与 PathTracingDataBuilder 一致：每个 SubMesh 对应一个几何实例
+                for (int subIdx = 0; subIdx < meshData.subMeshCount; subIdx++)
+                {
+                    uint geometryInstanceIndex = geometryInstanceCount++;
+
+                    Material mat = subIdx < sharedMaterials.Length ? sharedMaterials[subIdx] : null;
+                    if (mat == null && sharedMaterials.Length > 0) mat = sharedMaterials[^1];
+                    if (mat == null || !mat.HasProperty("_EmissionColor"))
+                        continue;
+
+                    Color emi = mat.GetColor("_EmissionColor");
+                    if (emi.maxColorComponent <= 0.0f)
+                        continue;
+
+                    if (!vertices.IsCreated)
+                    {
+                        vertices = new NativeArray<Vector3>(meshData.vertexCount, Allocator.TempJob, NativeArrayOptions.UninitializedMemory);
+                        meshData.GetVertices(vertices);
+                        tempArrays.Add(vertices);
+                    }
+
+                    var indices = new NativeArray<int>(meshData.GetSubMesh(subIdx).indexCount, Allocator.TempJob, NativeArrayOptions.UninitializedMemory);
+                    meshData.GetIndices(indices, subIdx);
+                    tempArrays.Add(indices);
+
+                    PrepareLightsInstance instance = new PrepareLightsInstance();
+                    for (int row = 0; row < 3; row++)
+                    for (int col = 0; col < 4; col++)
+                        instance.objectToWorld[row * 4 + col] = localToWorld[row, col];
+
+                    instance.emissiveRadiance[0] = emi.r;
+                    instance.emissiveRadiance[1] = emi.g;
+                    instance.emissiveRadiance[2] = emi.b;
+                    instance.geometryInstanceIndex = geometryInstanceIndex;
+                    instance.positions = (IntPtr)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(vertices);
+                    instance.indices = (IntPtr)NativeArrayUnsafeUtility.GetUnsafeReadOnlyPtr(indices);
+                    instance.triangleCount = (uint)indices.Length / 3;
+                    instance.vertexCount = (uint)vertices.Length;
+                    instances.Add(instance);
+
+                    // renderer 和 submesh 在场景变化时保持不变，光源列表重排后仍能对应到上一帧的光源
+                    instanceIds.Add(((ulong)(uint)r.GetInstanceID() << 32) | (uint)subIdx);
+                }
+            }
+
+            uint maxLights = resources.GetMaxEmissiveTriangles();
+            var lightInfos = new NativeArray<RAB_LightInfo>((int)maxLights, Allocator.Temp);
+            if (m_geometryInstanceToLight.Length < geometryInstanceCount)
+                m_geometryInstanceToLight = new uint[geometryInstanceCount];
+            // 前 maxLights 项为 currentToPrevious，后 maxLights 项为 previousToCurrent
+            if (m_lightIndexMapping.Length < maxLights * 2)
+                m_lightIndexMapping = new uint[maxLights * 2];
+            PrepareLightsInstance[] instanceArray = instances.ToArray();
+            ulong[] instanceIdArray = instanceIds.ToArray();
+
+            RTXDI_LightBufferParameters outLightBufferParams;
+
+            fixed (PrepareLightsInstance* instancePtr = instanceArray)
+            fixed (uint* mapPtr = m_geometryInstanceToLight)
+            fixed (ulong* instanceIdPtr = instanceIdArray)
+            fixed (uint* mappingPtr = m_lightIndexMapping)
             {
-                
+                PrepareLightsDesc desc = new PrepareLightsDesc
+                {
+                    instances = (IntPtr)instancePtr,
+                    instanceCount = (uint)instanceArray.Length,
+                    infiniteLights = IntPtr.Zero,
+                    infiniteLightCount = 0,
+                    environmentLightPresent = 0,
+                    lightBuffer = (IntPtr)NativeArrayUnsafeUtility.GetUnsafePtr(lightInfos),
+                    maxLights = maxLights,
+                    geometryInstanceToLight = (IntPtr)mapPtr,
+                    geometryInstanceCount = geometryInstanceCount,
+                };
+
+                outLightBufferParams = PrepareLightBuffer(importanceSamplingContext, ref desc);
+
+                LastLightIndexMappingStats = UpdateLightIndexMapping(m_lightIndexMapper, ref desc, (IntPtr)instanceIdPtr, outLightBufferParams,
+                    (IntPtr)mappingPtr, (IntPtr)(mappingPtr + maxLights));
             }
-            
+
+            foreach (var array in tempArrays)
+                array.Dispose();
+
+            if (resources.LightDataBuffer != null)
+                resources.LightDataBuffer.SetData(lightInfos);
+
+            if (resources.GeometryInstanceToLightBuffer != null)
+            {
+                int count = (int)Math.Min(geometryInstanceCount, resources.GetMaxGeometryInstances());
+                resources.GeometryInstanceToLightBuffer.SetData(m_geometryInstanceToLight, 0, 0, count);
+            }
+
+            // changed 只表示映射相对上一帧是否变化，与缓冲里的内容无关；缓冲和 maxLights 都没变时才能跳过上传
+            if (resources.LightIndexMappingBuffer != null &&
+                (LastLightIndexMappingStats.changed != 0 ||
+                 resources.LightIndexMappingBuffer != m_uploadedLightIndexMappingBuffer ||
+                 maxLights != m_uploadedMaxLights))
+            {
+                resources.LightIndexMappingBuffer.SetData(m_lightIndexMapping, 0, 0, (int)maxLights * 2);
+                m_uploadedLightIndexMappingBuffer = resources.LightIndexMappingBuffer;
+                m_uploadedMaxLights = maxLights;
+            }
+
+            lightInfos.Dispose();
+
             return outLightBufferParams;
         }
+
+        public void Dispose()
+        {
+            if (m_lightIndexMapper != IntPtr.Zero)
+            {
+                DestroyLightIndexMapper(m_lightIndexMapper);
+                m_lightIndexMapper = IntPtr.Zero;
+            }
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,163 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+public enum ReGIRMode : uint
+{
+    Disabled = 0,
+    Grid = 1,
+    Onion = 2
+};
+
+public enum LocalLightReGIRPresamplingMode : uint
+{
+    Uniform = 0,
+    Power_RIS = 1
+};
+
+public enum LocalLightReGIRFallbackSamplingMode : uint
+{
+    Uniform = 0,
+    Power_RIS = 1
+};
+
+[StructLayout(LayoutKind.Sequential)]
+public struct RtxdiUint3
+{
+    public uint x;
+    public uint y;
+    public uint z;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct RtxdiFloat3
+{
+    public float x;
+    public float y;
+    public float z;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReGIRStaticParameters
+{
+    public ReGIRMode Mode;
+    public uint LightsPerCell;
+
+    // ReGIRGridStaticParameters
+    public RtxdiUint3 GridSize;
+
+    // ReGIROnionStaticParameters
+    public uint OnionDetailLayers;
+    public uint OnionCoverageLayers;
+
+    public static ReGIRStaticParameters Default => new ReGIRStaticParameters
+    {
+        Mode = ReGIRMode.Onion,
+        LightsPerCell = 512,
+        GridSize = new RtxdiUint3 { x = 16, y = 16, z = 16 },
+        OnionDetailLayers = 5,
+        OnionCoverageLayers = 10,
+    };
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReGIRDynamicParameters
+{
+    public float regirCellSize;
+    public RtxdiFloat3 center;
+    public LocalLightReGIRFallbackSamplingMode fallbackSamplingMode;
+    public LocalLightReGIRPresamplingMode presamplingMode;
+    public float regirSamplingJitter;
+    public uint regirNumBuildSamples;
+}
+
+public struct ReGIR_CommonParameters
+{
+    public uint enable;
+    public float centerX;
+    public float centerY;
+    public float centerZ;
+
+    public uint risBufferOffset;
+    public uint lightsPerCell;
+    public float cellSize;
+    public float samplingJitter;
+
+    public uint localLightSamplingFallbackMode;
+    public uint localLightPresamplingMode;
+    public uint numRegirBuildSamples;
+    public uint pad1;
+};
+
+public struct ReGIR_GridParameters
+{
+    public uint cellsX;
+    public uint cellsY;
+    public uint cellsZ;
+    public uint pad1;
+};
+
+public unsafe struct ReGIR_OnionParameters
+{
+    public const int MaxLayerGroups = 8; // RTXDI_ONION_MAX_LAYER_GROUPS
+    public const int MaxRings = 52; // RTXDI_ONION_MAX_RINGS
+
+    // ReGIR_OnionLayerGroup[8]，每个 12 个 32 位字段，C# 端只需要保证大小一致
+    public fixed uint layers[MaxLayerGroups * 12];
+    // ReGIR_OnionRing[52]，每个 4 个 32 位字段
+    public fixed uint rings[MaxRings * 4];
+
+    public uint numLayerGroups;
+    public float cubicRootFactor;
+    public float linearFactor;
+    public float pad1;
+};
+
+public struct ReGIR_Parameters
+{
+    public ReGIR_CommonParameters commonParams;
+    public ReGIR_GridParameters gridParams;
+    public ReGIR_OnionParameters onionParams;
+};
+
+// 与 UnityRtxdi/ReGIRAutoSizing.h 一致，数值参数为 0 时使用默认值
+[StructLayout(LayoutKind.Sequential)]
+public struct ReGIRAutoSizeDesc
+{
+    public IntPtr lightPositions; // float3
+    public uint lightCount;
+    public uint lightPositionStride; // 0 表示紧密排列，传 sizeof(RAB_LightInfo) 可以直接用光源缓冲
+    public RtxdiFloat3 cameraPosition;
+    public float viewDistance;
+
+    public ulong memoryBudgetInBytes;
+    public ReGIRMode mode;
+    public uint bytesPerLightSlot;
+    public uint minLightsPerCell;
+    public uint maxLightsPerCell;
+    public float occupancyPercentile;
+    public float minSlotUtilization;
+};
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReGIROccupancyStats
+{
+    public uint cellCount;
+    public uint occupiedCellCount;
+    public uint overloadedCellCount;
+    public uint maxCellOccupancy;
+    public uint lightsInside;
+    public uint lightsOutside;
+    public float meanOccupancy;
+    public float slotUtilization;
+};
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReGIRAutoSizeResult
+{
+    public ReGIRStaticParameters staticParams;
+    public ReGIRDynamicParameters dynamicParams;
+    public uint lightSlotCount;
+    public uint valid;
+    public ulong sizeInBytes;
+    public ReGIROccupancyStats occupancy;
+};
@@ -45,6 +45,9 @@ namespace DefaultNamespace
         [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
         public static extern ReSTIRDI_ShadingParameters GetShadingParameters(IntPtr contextPtr);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReservoirBufferDesc GetReSTIRDIReservoirBufferDesc(IntPtr context, ReSTIRDI_ResamplingMode mode);
+
         // ================= Setters Imports (New) =================
         // 注意：为了匹配 C++，这里可以直接传值，或者为了性能用 ref。
         // 因为 C++ 导出层是按值接收 (Copy)，如果想优化，C++ 导出层应改写为接收指针，这里用 ref。
@@ -72,11 +75,18 @@ namespace DefaultNamespace
         [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
         public static extern IntPtr CreateReSTIRDIContext(int width, int height);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateReSTIRDIContextWithParams(ref ReSTIRDIStaticParameters parameters);
+
         [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
         public static extern void DestroyReSTIRDIContext(IntPtr context);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void ResizeReSTIRDIContext(IntPtr context, int width, int height, out ReservoirRemapParameters remap);
+
 
         IntPtr contextPtr;
+        private bool ownsContext = true;
         private bool disposedValue;
 
 
@@ -89,15 +99,42 @@ namespace DefaultNamespace
             }
         }
 
+        // 包装 ImportanceSamplingContext 持有的 DI context，Dispose 时不会销毁它
+        public static ReSTIRDIContext FromImportanceSamplingContext(IntPtr importanceSamplingContext)
+        {
+            IntPtr context = RtxdiNative.GetImportanceSamplingReSTIRDIContext(importanceSamplingContext);
+            if (context == IntPtr.Zero)
+            {
+                throw new Exception("ImportanceSamplingContext is null.");
+            }
+            return new ReSTIRDIContext(context, false);
+        }
+
+        private ReSTIRDIContext(IntPtr context, bool owns)
+        {
+            contextPtr = context;
+            ownsContext = owns;
+        }
+
+        // 可以开启棋盘采样、指定 NeighborOffsetCount（必须是 2 的幂），参数非法时 Native 端会打印原因
+        public ReSTIRDIContext(ReSTIRDIStaticParameters staticParameters)
+        {
+            contextPtr = CreateReSTIRDIContextWithParams(ref staticParameters);
+            if (contextPtr == IntPtr.Zero)
+            {
+                throw new Exception("Failed to create ReSTIR DI Context, invalid static parameters.");
+            }
+        }
+
         protected virtual void Dispose(bool disposing)
         {
             if (!disposedValue)
             {
-                if (contextPtr != IntPtr.Zero)
+                if (contextPtr != IntPtr.Zero && ownsContext)
                 {
                     DestroyReSTIRDIContext(contextPtr);
-                    contextPtr = IntPtr.Zero;
                 }
+                contextPtr = IntPtr.Zero;
                 disposedValue = true;
             }
         }
@@ -118,6 +155,8 @@ namespace DefaultNamespace
 
         // ================= Public Methods =================
 
+        public IntPtr NativePtr => contextPtr;
+
         public RTXDI_ReservoirBufferParameters GetReservoirBufferParameters() => GetReservoirBufferParameters(contextPtr);
         public ReSTIRDI_ResamplingMode GetResamplingMode() => GetResamplingMode(contextPtr);
         public RTXDI_RuntimeParameters GetRuntimeParams() => GetRuntimeParameters(contextPtr);
@@ -129,6 +168,17 @@ namespace DefaultNamespace
         
         public unsafe ReSTIRDIStaticParameters* GetStaticParameters() => GetStaticParameters(contextPtr);
 
+        // 按当前分辨率和棋盘模式计算 resamplingMode 最少需要的 DI reservoir 缓冲
+        // 数组数少于 3 时要用 ReSTIRDIReservoirPlanner 的索引代替 GetBufferIndices，见 RtxdiNative.FillResamplingConstants
+        public ReservoirBufferDesc GetReservoirBufferDesc(ReSTIRDI_ResamplingMode resamplingMode) => GetReSTIRDIReservoirBufferDesc(contextPtr, resamplingMode);
+
+        // 分辨率变化时原地调整，帧序号和 reservoir 轮转保持不变；返回值用于在 GPU 上搬运旧 reservoir
+        public ReservoirRemapParameters Resize(int width, int height)
+        {
+            ResizeReSTIRDIContext(contextPtr, width, height, out ReservoirRemapParameters remap);
+            return remap;
+        }
+
         public void SetFrameIndex(uint frameIndex)
         { 
             SetFrameIndex(contextPtr, frameIndex);
@@ -15,4 +15,183 @@ public struct ReSTIRDIStaticParameters
     public uint RenderHeight; // uint32_t -> uint
 
     public CheckerboardMode CheckerboardSamplingMode; // Enum 通常对应 int
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct RISBufferSegmentParameters
+{
+    public uint tileSize;
+    public uint tileCount;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ImportanceSamplingContext_StaticParameters
+{
+    public uint NeighborOffsetCount;
+    public uint renderWidth;
+    public uint renderHeight;
+    public CheckerboardMode CheckerboardSamplingMode;
+
+    public RISBufferSegmentParameters localLightRISBufferParams;
+    public RISBufferSegmentParameters environmentLightRISBufferParams;
+
+    public ReGIRStaticParameters regirStaticParams;
+
+    // 与 C++ 端默认成员初始化保持一致
+    public static ImportanceSamplingContext_StaticParameters Default(uint width, uint height)
+    {
+        return new ImportanceSamplingContext_StaticParameters
+        {
+            NeighborOffsetCount = 8192,
+            renderWidth = width,
+            renderHeight = height,
+            CheckerboardSamplingMode = CheckerboardMode.Off,
+            localLightRISBufferParams = new RISBufferSegmentParameters { tileSize = 1024, tileCount = 128 },
+            environmentLightRISBufferParams = new RISBufferSegmentParameters { tileSize = 1024, tileCount = 128 },
+            regirStaticParams = ReGIRStaticParameters.Default,
+        };
+    }
+}
+
+// 与 UnityRtxdi/RISBufferSegmentPool.h 一致
+public enum RISSegmentName : uint
+{
+    LocalLights = 0,
+    EnvironmentLight = 1,
+    ReGIR = 2
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct RISSegmentRelocation
+{
+    public RISSegmentName name;
+    public uint oldOffset;
+    public uint newOffset;
+    public uint sizeInElements;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct RISBufferLayout
+{
+    public RTXDI_RISBufferSegmentParameters localLightsRISBufferSegmentParams;
+    public RTXDI_RISBufferSegmentParameters environmentLightRISBufferSegmentParams;
+    public uint regirCellOffset;
+    public uint regirLightSlotCount;
+    public uint totalSizeInElements;
+    public uint pad1;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct RISBufferReconfigureDesc
+{
+    public RISBufferSegmentParameters localLightRISBufferParams;
+    public RISBufferSegmentParameters environmentLightRISBufferParams;
+    public ReGIRStaticParameters regirStaticParams;
+}
+
+// 与 UnityRtxdi/MultiViewContext.h 一致
+[StructLayout(LayoutKind.Sequential)]
+public struct MultiViewBufferSizes
+{
+    public uint viewSlotCount;
+    public uint neighborOffsetCount;
+    public uint risBufferSizeInElements;
+    public uint risAllocatorSizeInElements;
+
+    public uint diReservoirArrayPitch;
+    public uint diReservoirArrayCount;
+    public uint diReservoirBufferSizeInElements;
+    public uint pad2;
+
+    public uint giReservoirArrayPitch;
+    public uint giReservoirArrayCount;
+    public uint giReservoirBufferSizeInElements;
+    public uint pad3;
+}
+
+// 与 UnityRtxdi/ReSTIRDIReference.h 一致
+[StructLayout(LayoutKind.Sequential)]
+public struct ReSTIRDIReferenceSceneDesc
+{
+    public uint width;
+    public uint height;
+    public uint lightCount;
+    public uint seed;
+    public float lightPowerSpread;
+    public uint pad1;
+    public uint pad2;
+    public uint pad3;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReSTIRDIReferenceStats
+{
+    public uint frameCount;
+    public float relativeMSE;
+    public float lastFrameRelativeMSE;
+    public float relativeBias;
+    public float targetPdfEvaluationsPerPixel;
+    public float millisecondsPerFrame;
+    public float efficiency;
+    public uint pad1;
+}
+
+// 与 UnityRtxdi/ReSTIRDIGovernor.h 一致，没有运行的 pass 填 0，Fused 模式的耗时填在 temporalResamplingMs
+[StructLayout(LayoutKind.Sequential)]
+public struct ReSTIRDIPassTimings
+{
+    public float initialSamplingMs;
+    public float temporalResamplingMs;
+    public float spatialResamplingMs;
+    public float shadingMs;
+}
+
+// 除 targetMs 外填 0 使用默认值
+[StructLayout(LayoutKind.Sequential)]
+public struct ReSTIRDIGovernorSettings
+{
+    public float targetMs;
+    public float upperTolerance;
+    public float lowerTolerance;
+    public float smoothing;
+    public uint downFrames;
+    public uint upFrames;
+    public uint allowModeChanges;
+    public uint pad1;
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReSTIRDIGovernorLevel
+{
+    public DefaultNamespace.ReSTIRDI_ResamplingMode resamplingMode;
+    public uint numPrimaryLocalLightSamples;
+    public uint numPrimaryInfiniteLightSamples;
+    public uint numPrimaryEnvironmentSamples;
+    public uint numPrimaryBrdfSamples;
+    public uint numSpatialSamples;
+    public uint numDisocclusionBoostSamples;
+    public uint pad1;
+}
+
+public enum ReSTIRDIGovernorReason : uint
+{
+    Hold = 0,
+    Warmup = 1,
+    OverBudget = 2,
+    Headroom = 3,
+    AtLimit = 4
+}
+
+[StructLayout(LayoutKind.Sequential)]
+public struct ReSTIRDIGovernorDecision
+{
+    public uint level;
+    public uint levelCount;
+    public int levelChange;
+    public ReSTIRDIGovernorReason reason;
+    public float measuredMs;
+    public float smoothedMs;
+    public float predictedMs;
+    public float targetMs;
+    public ReSTIRDIGovernorLevel config;
 }
\ No newline at end of file
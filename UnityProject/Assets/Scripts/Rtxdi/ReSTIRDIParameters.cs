@@ -2,7 +2,8 @@
 {
     Uniform = 0,
     Power_RIS = 1,
-    ReGIR_RIS = 2
+    ReGIR_RIS = 2,
+    AliasTable = 3 // UnityRtxdi 扩展，见 LocalLightAliasTable.h
 };
 
 public enum ReSTIRDI_TemporalBiasCorrectionMode : uint
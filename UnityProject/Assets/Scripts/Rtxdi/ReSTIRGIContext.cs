@@ -0,0 +1,172 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace DefaultNamespace
+{
+    public enum ReSTIRGI_ResamplingMode : uint
+    {
+        None,
+        Temporal,
+        Spatial,
+        TemporalAndSpatial,
+        FusedSpatiotemporal
+    };
+
+
+    public class ReSTIRGIContext : IDisposable
+    {
+        private const string DllName = "UnityRtxdi";
+
+        // ================= Getters Imports =================
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReSTIRGIStaticParameters GetReSTIRGIStaticParameters(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern uint GetReSTIRGIFrameIndex(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern RTXDI_ReservoirBufferParameters GetReSTIRGIReservoirBufferParameters(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReSTIRGI_ResamplingMode GetReSTIRGIResamplingMode(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReSTIRGI_BufferIndices GetReSTIRGIBufferIndices(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReSTIRGI_TemporalResamplingParameters GetReSTIRGITemporalResamplingParameters(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReSTIRGI_SpatialResamplingParameters GetReSTIRGISpatialResamplingParameters(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReSTIRGI_FinalShadingParameters GetReSTIRGIFinalShadingParameters(IntPtr context);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern ReservoirBufferDesc GetReSTIRGIReservoirBufferDesc(IntPtr context, ReSTIRGI_ResamplingMode mode);
+
+        // ================= Setters Imports =================
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetReSTIRGIFrameIndex(IntPtr context, uint frameIndex);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetReSTIRGIResamplingMode(IntPtr context, ReSTIRGI_ResamplingMode resamplingMode);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetReSTIRGITemporalResamplingParameters(IntPtr context, ReSTIRGI_TemporalResamplingParameters parameters);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetReSTIRGISpatialResamplingParameters(IntPtr context, ReSTIRGI_SpatialResamplingParameters parameters);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void SetReSTIRGIFinalShadingParameters(IntPtr context, ReSTIRGI_FinalShadingParameters parameters);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.StdCall)]
+        private static extern void ResizeReSTIRGIContext(IntPtr context, int width, int height, out ReservoirRemapParameters remap);
+
+        IntPtr contextPtr;
+        private bool ownsContext;
+        private bool disposedValue;
+
+
+        // 参数非法时 Native 端会打印原因
+        public ReSTIRGIContext(ReSTIRGIStaticParameters staticParameters)
+        {
+            contextPtr = RtxdiNative.CreateReSTIRGIContext(ref staticParameters);
+            if (contextPtr == IntPtr.Zero)
+            {
+                throw new Exception("Failed to create ReSTIR GI Context, invalid static parameters.");
+            }
+            ownsContext = true;
+        }
+
+        // 包装 ImportanceSamplingContext 持有的 GI context，Dispose 时不会销毁它
+        public static ReSTIRGIContext FromImportanceSamplingContext(IntPtr importanceSamplingContext)
+        {
+            IntPtr context = RtxdiNative.GetImportanceSamplingReSTIRGIContext(importanceSamplingContext);
+            if (context == IntPtr.Zero)
+            {
+                throw new Exception("ImportanceSamplingContext is null.");
+            }
+            return new ReSTIRGIContext(context, false);
+        }
+
+        private ReSTIRGIContext(IntPtr context, bool owns)
+        {
+            contextPtr = context;
+            ownsContext = owns;
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            if (!disposedValue)
+            {
+                if (contextPtr != IntPtr.Zero && ownsContext)
+                {
+                    RtxdiNative.DestroyReSTIRGIContext(contextPtr);
+                }
+                contextPtr = IntPtr.Zero;
+                disposedValue = true;
+            }
+        }
+
+        ~ReSTIRGIContext()
+        {
+            Dispose(disposing: false);
+        }
+
+        public void Dispose()
+        {
+            Dispose(disposing: true);
+            GC.SuppressFinalize(this);
+        }
+
+        // ================= Public Methods =================
+
+        public IntPtr NativePtr => contextPtr;
+
+        public ReSTIRGIStaticParameters GetStaticParameters() => GetReSTIRGIStaticParameters(contextPtr);
+        public uint GetFrameIndex() => GetReSTIRGIFrameIndex(contextPtr);
+        public RTXDI_ReservoirBufferParameters GetReservoirBufferParameters() => GetReSTIRGIReservoirBufferParameters(contextPtr);
+        public ReSTIRGI_ResamplingMode GetResamplingMode() => GetReSTIRGIResamplingMode(contextPtr);
+        public ReSTIRGI_BufferIndices GetBufferIndices() => GetReSTIRGIBufferIndices(contextPtr);
+        public ReSTIRGI_TemporalResamplingParameters GetTemporalResamplingParameters() => GetReSTIRGITemporalResamplingParameters(contextPtr);
+        public ReSTIRGI_SpatialResamplingParameters GetSpatialResamplingParameters() => GetReSTIRGISpatialResamplingParameters(contextPtr);
+        public ReSTIRGI_FinalShadingParameters GetFinalShadingParameters() => GetReSTIRGIFinalShadingParameters(contextPtr);
+
+        // 按当前分辨率计算 resamplingMode 需要的 GI reservoir 缓冲（数组数、元素数、字节数）
+        public ReservoirBufferDesc GetReservoirBufferDesc(ReSTIRGI_ResamplingMode resamplingMode) => GetReSTIRGIReservoirBufferDesc(contextPtr, resamplingMode);
+
+        // 分辨率变化时原地调整，帧序号和 reservoir 轮转保持不变；返回值用于在 GPU 上搬运旧 reservoir
+        public ReservoirRemapParameters Resize(int width, int height)
+        {
+            ResizeReSTIRGIContext(contextPtr, width, height, out ReservoirRemapParameters remap);
+            return remap;
+        }
+
+        public void SetFrameIndex(uint frameIndex)
+        {
+            SetReSTIRGIFrameIndex(contextPtr, frameIndex);
+        }
+
+        public void SetResamplingMode(ReSTIRGI_ResamplingMode resamplingMode)
+        {
+            SetReSTIRGIResamplingMode(contextPtr, resamplingMode);
+        }
+
+        public void SetTemporalResamplingParameters(ReSTIRGI_TemporalResamplingParameters parameters)
+        {
+            SetReSTIRGITemporalResamplingParameters(contextPtr, parameters);
+        }
+
+        public void SetSpatialResamplingParameters(ReSTIRGI_SpatialResamplingParameters parameters)
+        {
+            SetReSTIRGISpatialResamplingParameters(contextPtr, parameters);
+        }
+
+        public void SetFinalShadingParameters(ReSTIRGI_FinalShadingParameters parameters)
+        {
+            SetReSTIRGIFinalShadingParameters(contextPtr, parameters);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+﻿public enum ResTIRGI_TemporalBiasCorrectionMode : uint
+{
+    Off = 0,
+    Basic = 1,
+    Raytraced = 3
+};
+
+public enum ResTIRGI_SpatialBiasCorrectionMode : uint
+{
+    Off = 0,
+    Basic = 1,
+    Raytraced = 3
+};
+
+public struct ReSTIRGI_BufferIndices
+{
+    public uint secondarySurfaceReSTIRDIOutputBufferIndex;
+    public uint temporalResamplingInputBufferIndex;
+    public uint temporalResamplingOutputBufferIndex;
+    public uint spatialResamplingInputBufferIndex;
+
+    public uint spatialResamplingOutputBufferIndex;
+    public uint finalShadingInputBufferIndex;
+    public uint pad1;
+    public uint pad2;
+};
+
+public struct ReSTIRGI_TemporalResamplingParameters
+{
+    public float depthThreshold;
+    public float normalThreshold;
+    public uint enablePermutationSampling;
+    public uint maxHistoryLength;
+
+    public uint maxReservoirAge;
+    public uint enableBoilingFilter;
+    public float boilingFilterStrength;
+    public uint enableFallbackSampling;
+
+    public ResTIRGI_TemporalBiasCorrectionMode temporalBiasCorrectionMode;
+    public uint uniformRandomNumber;
+    public uint pad2;
+    public uint pad3;
+};
+
+public struct ReSTIRGI_SpatialResamplingParameters
+{
+    public float spatialDepthThreshold;
+    public float spatialNormalThreshold;
+    public uint numSpatialSamples;
+    public float spatialSamplingRadius;
+
+    public ResTIRGI_SpatialBiasCorrectionMode spatialBiasCorrectionMode;
+    public uint pad1;
+    public uint pad2;
+    public uint pad3;
+};
+
+public struct ReSTIRGI_FinalShadingParameters
+{
+    public uint enableFinalVisibility;
+    public uint enableFinalMIS;
+    public uint pad1;
+    public uint pad2;
+};
+
+public struct ReSTIRGI_Parameters
+{
+    public RTXDI_ReservoirBufferParameters reservoirBufferParams;
+    public ReSTIRGI_BufferIndices bufferIndices;
+    public ReSTIRGI_TemporalResamplingParameters temporalResamplingParams;
+    public ReSTIRGI_SpatialResamplingParameters spatialResamplingParams;
+    public ReSTIRGI_FinalShadingParameters finalShadingParams;
+};
+
+// 与 rtxdi::ReSTIRGIStaticParameters 一致
+public struct ReSTIRGIStaticParameters
+{
+    public uint RenderWidth;
+    public uint RenderHeight;
+    public CheckerboardMode CheckerboardSamplingMode;
+}
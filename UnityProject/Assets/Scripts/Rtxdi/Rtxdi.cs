@@ -5,15 +5,33 @@ namespace DefaultNamespace
 {
     public class Rtxdi : MonoBehaviour
     {
-        ReSTIRDIContext restirdiContext; 
+        IntPtr importanceSamplingContext;
+        ReSTIRDIContext restirdiContext;
         RtxdiResources resources;
-        
-        
+        // DI reservoir 只按当前模式的最少数组数分配，缓冲下标由 planner 给出
+        IntPtr reservoirPlanner;
+        ResamplingConstants constants;
+
+        public ResamplingConstants Constants => constants;
+        // 本帧的 constants 与上一帧不同，需要重新上传
+        public bool ConstantsChanged { get; private set; }
+
+
         [ContextMenu("TestReSTIRDI")]
         public void TestReSTIRDI()
         {
-            restirdiContext = new ReSTIRDIContext(1920, 1080);
+            Release();
+
+            var staticParams = ImportanceSamplingContext_StaticParameters.Default(1920, 1080);
+            importanceSamplingContext = RtxdiNative.CreateImportanceSamplingContext(ref staticParams);
+            if (importanceSamplingContext == IntPtr.Zero)
+            {
+                throw new Exception("Failed to create ImportanceSamplingContext.");
+            }
+
+            restirdiContext = ReSTIRDIContext.FromImportanceSamplingContext(importanceSamplingContext);
             resources = new RtxdiResources(restirdiContext, 10, 100, 5);
+            reservoirPlanner = RtxdiNative.CreateReSTIRDIReservoirPlanner();
         }
 
 
@@ -22,10 +40,43 @@ namespace DefaultNamespace
         {
             resources.InitializeNeighborOffsets(restirdiContext.GetStaticParameters()->NeighborOffsetCount);
             restirdiContext.SetFrameIndex((uint)Time.frameCount);
-            
-            
-            
+
+            // 切换到需要更多数组的模式时重新分配，旧的 reservoir 作废，轮转从头开始
+            if (resources.EnsureLightReservoirBuffer(restirdiContext, restirdiContext.GetResamplingMode()))
+                RtxdiNative.ResetReSTIRDIReservoirPlanner(reservoirPlanner);
+
+            fixed (ResamplingConstants* constantsPtr = &constants)
+            {
+                ConstantsChanged = RtxdiNative.FillResamplingConstants(importanceSamplingContext, constantsPtr, null, IntPtr.Zero, reservoirPlanner);
+            }
         }
-        
+
+        void Release()
+        {
+            resources?.Dispose();
+            resources = null;
+
+            // 只是包装，DI context 归 ImportanceSamplingContext 所有
+            restirdiContext?.Dispose();
+            restirdiContext = null;
+
+            if (reservoirPlanner != IntPtr.Zero)
+            {
+                RtxdiNative.DestroyReSTIRDIReservoirPlanner(reservoirPlanner);
+                reservoirPlanner = IntPtr.Zero;
+            }
+
+            if (importanceSamplingContext != IntPtr.Zero)
+            {
+                RtxdiNative.DestroyImportanceSamplingContext(importanceSamplingContext);
+                importanceSamplingContext = IntPtr.Zero;
+            }
+        }
+
+        void OnDestroy()
+        {
+            Release();
+        }
+
     }
-}
\ No newline at end of file
+}
@@ -29,6 +29,14 @@ public struct RTXDI_LightBufferParameters
     public RTXDI_EnvironmentLightBufferParameters environmentLightParams;
 }
 
+public struct RTXDI_RISBufferSegmentParameters
+{
+    public uint bufferOffset;
+    public uint tileSize;
+    public uint tileCount;
+    public uint pad1;
+}
+
 public struct RTXDI_ReservoirBufferParameters
 {
     public uint reservoirBlockRowPitch;
@@ -45,4 +53,221 @@ public struct RTXDI_PackedDIReservoir
     public uint distanceAge;
     public float targetPdf;
     public float weight;
+}
+
+// 与 UnityRtxdi/LocalLightPdfMipBuilder.h 一致
+public struct PdfMipLayout
+{
+    public uint offsetInTexels;
+    public uint width;
+    public uint height;
+    public uint rowPitchInTexels;
+}
+
+public struct PdfMipDirtyRows
+{
+    public uint firstRow;
+    public uint rowCount;
+}
+
+public struct PdfTextureDesc
+{
+    public uint width;
+    public uint height;
+    public uint mipLevels;
+    public uint uploadBufferSizeInTexels;
+}
+
+public struct LocalLightPdfBenchmarkResult
+{
+    public uint lightCount;
+    public uint changedLightsPerFrame;
+    public uint frameCount;
+    public uint mipLevels;
+    public float buildMilliseconds;
+    public float updateMilliseconds;
+    public float texelsWrittenPerFrame;
+    public float uploadedBytesPerFrame;
+    public float fullUploadBytes;
+    public float maxRelativeError;
+}
+
+// 与 UnityRtxdi/LocalLightAliasTable.h 一致
+public struct RTXDI_AliasTableEntry
+{
+    public uint alias;
+    public float probability;
+    public float pdf;
+    public float aliasPdf;
+}
+
+public struct RTXDI_AliasTableParameters
+{
+    public uint entryCount;
+    public float totalPower;
+    public uint pad1;
+    public uint pad2;
+}
+
+public struct LocalLightAliasTableBenchmarkResult
+{
+    public uint lightCount;
+    public uint buildCount;
+    public float buildMilliseconds;
+    public float maxPdfError;
+    public float maxDistributionError;
+}
+
+// 与 UnityRtxdi/ContextResize.h 一致，可直接作为常量缓冲传给 ReservoirRemap.hlsl
+public struct ReservoirRemapParameters
+{
+    public RTXDI_ReservoirBufferParameters oldReservoirBufferParams;
+    public RTXDI_ReservoirBufferParameters newReservoirBufferParams;
+
+    public uint oldReservoirWidth;
+    public uint oldReservoirHeight;
+    public uint newReservoirWidth;
+    public uint newReservoirHeight;
+
+    public uint numReservoirBuffers;
+    public uint oldBufferSizeInReservoirs;
+    public uint newBufferSizeInReservoirs;
+    public uint pad1;
+}
+
+// 与 UnityRtxdi/SamplingTables.h 一致
+public enum NeighborOffsetDistribution : uint
+{
+    Uniform = 0,
+    CenterWeighted = 1,
+}
+
+// 与 UnityRtxdi/ReservoirBufferSizing.h 一致
+public struct ReservoirBufferDesc
+{
+    public uint numReservoirBuffers;
+    public uint reservoirArrayPitch;
+    public uint reservoirStride;
+    public uint totalReservoirCount;
+    public ulong totalSizeInBytes;
+}
+
+// 与 UnityRtxdi/LightIndexMapping.h 一致
+public struct LightIndexMappingStats
+{
+    public uint currentLightCount;
+    public uint previousLightCount;
+    public uint mappedLightCount;
+    public uint changed;
+}
+
+// 与 UnityRtxdi/SharcHashGrid.h 一致，指针指向 pinned 的 float3 / uint 数组
+public struct SharcTraceDesc
+{
+    public System.IntPtr samplePositions;
+    public System.IntPtr sampleNormals;
+    public System.IntPtr cameraPositions;
+    public System.IntPtr frameSampleCounts;
+    public uint frameCount;
+    public float sceneScale;
+    public float logarithmBase;
+    public float levelBias;
+    public uint staleFrameNumMax;
+    public uint pad1;
+}
+
+public struct SharcSyntheticTraceDesc
+{
+    public uint frameCount;
+    public uint samplesPerFrame;
+    public uint seed;
+    public float roomSize;
+    public float cameraSpeed;
+    public float sceneScale;
+}
+
+// 与 HashGridCommon.h 中 HASH_GRID_HASH 的取值一致
+public enum SharcHashFunction : uint
+{
+    Jenkins = 0,
+    Murmur3 = 1,
+    XXHash32 = 2,
+    Pcg = 3,
+    Count
+}
+
+public struct SharcSimulationSettings
+{
+    public uint capacity;
+    public uint bucketSize;
+    public SharcHashFunction hashFunction;
+    public uint pad1;
+}
+
+public struct SharcSimulationStats
+{
+    public uint capacity;
+    public uint bucketSize;
+    public ulong insertCount;
+    public ulong insertFailures;
+    public ulong newEntries;
+    public ulong evictedEntries;
+    public float failureRate;
+    public float meanProbeLength;
+    public uint maxProbeLength;
+    public float meanOccupancy;
+    public float peakOccupancy;
+    public float finalOccupancy;
+    public float churnPerFrame;
+    public float millisecondsPerFrame;
+}
+
+public struct SharcHashBenchmarkResult
+{
+    public SharcHashFunction hashFunction;
+    public uint keyCount;
+    public float nanosecondsPerHash;
+    public float bucketChiSquared;
+    public float slotCollisionRate;
+    public float expectedSlotCollisionRate;
+    public SharcSimulationStats simulation;
+}
+
+// 与 UnityRtxdi/SharcSnapshot.h 一致
+public struct SharcSnapshotDesc
+{
+    public ulong sceneHash;
+    public UnityEngine.Vector3 cameraPosition;
+    public float sceneScale;
+    public float logarithmBase;
+    public float levelBias;
+    public uint useNormals;
+    public SharcHashFunction hashFunction;
+    public uint bucketSize;
+    public uint capacity;
+}
+
+public enum SharcSnapshotResult : uint
+{
+    Ok = 0,
+    InvalidArgument = 1,
+    FileError = 2,
+    InvalidFormat = 3,
+    VersionMismatch = 4,
+    SceneMismatch = 5,
+    GridMismatch = 6,
+}
+
+public struct SharcSnapshotStats
+{
+    public SharcSnapshotResult result;
+    public uint entryCount;
+    public uint loadedEntries;
+    public uint relevelledEntries;
+    public uint mergedEntries;
+    public uint droppedEntries;
+    public ulong fileBytes;
+    public ulong rawBytes;
+    public float milliseconds;
+    public uint pad1;
 }
\ No newline at end of file
@@ -9,6 +9,345 @@ namespace DefaultNamespace
         [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
         public static extern void FillNeighborOffsetBuffer(IntPtr buffer, uint neighborOffsetCount);
 
+        // ================= 采样查找表 =================
+        // 返回的指针由 Native 端缓存持有，不需要释放，参数非法时返回 IntPtr.Zero
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetNeighborOffsetTable(uint neighborOffsetCount, uint radius, NeighborOffsetDistribution distribution);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetBlueNoiseTile(uint size, uint seed);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetFrameSeedTable(uint count);
+
+        // ================= Reservoir 缓冲规划 =================
+        // 按 ReSTIRDIContext.GetReservoirBufferDesc 的数组数分配时使用，每帧 SetFrameIndex 之后调用一次 Update
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateReSTIRDIReservoirPlanner();
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyReSTIRDIReservoirPlanner(IntPtr planner);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern ReSTIRDI_BufferIndices UpdateReSTIRDIReservoirPlanner(IntPtr planner, IntPtr context);
+
+        // 重新分配 reservoir 缓冲后调用，轮转从数组 0 开始
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void ResetReSTIRDIReservoirPlanner(IntPtr planner);
+
+        // ================= 采样数预算控制 =================
+        // 以创建时 context 的采样配置为最高档，按各 pass 的 GPU 耗时升降档；context 为空时返回 IntPtr.Zero
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateReSTIRDIGovernor(IntPtr context, ref ReSTIRDIGovernorSettings settings);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyReSTIRDIGovernor(IntPtr governor);
+
+        // 每帧在 FillResamplingConstants 之前调用，决策已写回 context，返回值用于日志
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern ReSTIRDIGovernorDecision UpdateReSTIRDIGovernor(IntPtr governor, IntPtr context, ref ReSTIRDIPassTimings timings);
+
+        // 修改了 context 的采样数或模式之后调用
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void ResetReSTIRDIGovernor(IntPtr governor, IntPtr context);
+
+        // ================= ReSTIR GI =================
+        // 参数非法时返回 IntPtr.Zero
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateReSTIRGIContext(ref ReSTIRGIStaticParameters parameters);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyReSTIRGIContext(IntPtr context);
+
+        // ================= ImportanceSamplingContext =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateImportanceSamplingContext(ref ImportanceSamplingContext_StaticParameters parameters);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyImportanceSamplingContext(IntPtr context);
+
+        // 同时调整 ReSTIR DI / GI 的分辨率，帧序号和缓冲轮转保持不变
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void ResizeImportanceSamplingContext(IntPtr context, int width, int height, out ReservoirRemapParameters diRemap, out ReservoirRemapParameters giRemap);
+
+        // 返回的 ReSTIRDIContext 指针归 ImportanceSamplingContext 所有，用 ReSTIRDIContext.FromImportanceSamplingContext 包装
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetImportanceSamplingReSTIRDIContext(IntPtr context);
+
+        // 同上，归 ImportanceSamplingContext 所有，用 ReSTIRGIContext.FromImportanceSamplingContext 包装
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetImportanceSamplingReSTIRGIContext(IntPtr context);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void SetReGIRDynamicParameters(IntPtr context, ReGIRDynamicParameters parameters);
+
+        // ReGIR 参数按光源分布自动选择，staticParams 填进 ImportanceSamplingContext_StaticParameters.regirStaticParams
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern ReGIRAutoSizeResult AutoSizeReGIRParameters(ref ReGIRAutoSizeDesc desc);
+
+        // 相机移动较大距离后重新选择 cellSize，dynamicParams 传给 SetReGIRDynamicParameters
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern ReGIRAutoSizeResult FitReGIRDynamicParameters(IntPtr context, ref ReGIRAutoSizeDesc desc);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern ReGIROccupancyStats SimulateReGIRCellOccupancy(IntPtr context, ref ReGIRAutoSizeDesc desc);
+
+        // constants 需要跨帧复用同一块内存，返回 true 表示内容有变化需要重新上传
+        // aliasTableParams 传 null 表示不使用别名表采样，risBuffer 传 IntPtr.Zero 表示沿用 context 创建时的 RIS 分段
+        // planner 不为 IntPtr.Zero 时 restirDI.bufferIndices 取自 ReSTIRDIReservoirPlanner，此时 reservoir 缓冲按 GetReservoirBufferDesc 分配
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern unsafe bool FillResamplingConstants(IntPtr context, ResamplingConstants* constants, RTXDI_AliasTableParameters* aliasTableParams, IntPtr risBuffer, IntPtr planner);
+
+        // ================= Reconfigurable RIS buffer =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateReconfigurableRISBuffer(IntPtr context, uint capacityInElements);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyReconfigurableRISBuffer(IntPtr risBuffer);
+
+        // 放不下时返回 false，context 保持原样
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool ReconfigureRISBuffer(IntPtr risBuffer, IntPtr context, ref RISBufferReconfigureDesc desc);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern RISBufferLayout GetRISBufferLayout(IntPtr risBuffer);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint GetRISSegmentRelocations(IntPtr risBuffer, [Out] RISSegmentRelocation[] outRelocations, uint maxCount, [MarshalAs(UnmanagedType.I1)] bool clear);
+
+        // ================= 多视图 =================
+        // 视图 0 使用共享 context 自带的 DI / GI，其余视图用 AddMultiViewView 添加
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateMultiViewImportanceSamplingContext(ref ImportanceSamplingContext_StaticParameters parameters);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyMultiViewImportanceSamplingContext(IntPtr context);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetMultiViewSharedContext(IntPtr context);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern int AddMultiViewView(IntPtr context, int width, int height, CheckerboardMode checkerboardMode);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern bool RemoveMultiViewView(IntPtr context, int viewIndex);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetMultiViewReSTIRDIContext(IntPtr context, int viewIndex);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetMultiViewReSTIRGIContext(IntPtr context, int viewIndex);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void ResizeMultiViewView(IntPtr context, int viewIndex, int width, int height, out ReservoirRemapParameters diRemap, out ReservoirRemapParameters giRemap);
+
+        // risBuffer 为 ReconfigurableRISBuffer，不为空时 risBufferSizeInElements 为它的容量
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern MultiViewBufferSizes GetMultiViewBufferSizes(IntPtr context, IntPtr risBuffer);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        public static extern unsafe bool FillMultiViewResamplingConstants(IntPtr context, int viewIndex, ResamplingConstants* constants, RTXDI_AliasTableParameters* aliasTableParams, IntPtr risBuffer);
+
+        // ================= Local light PDF =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateLocalLightPdfMipBuilder(uint maxLights);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyLocalLightPdfMipBuilder(IntPtr builder);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern PdfTextureDesc GetLocalLightPdfTextureDesc(IntPtr builder);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void GetLocalLightPdfMipLayouts(IntPtr builder, [Out] PdfMipLayout[] outLayouts);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void GetLocalLightPdfDirtyRows(IntPtr builder, [Out] PdfMipDirtyRows[] outDirtyRows);
+
+        // uploadBuffer 至少 uploadBufferSizeInTexels 个 float，Update 时传入同一块内存
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void BuildLocalLightPdf(IntPtr builder, IntPtr lightPowers, uint lightCount, IntPtr uploadBuffer);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint UpdateLocalLightPdf(IntPtr builder, IntPtr lightIndices, IntPtr lightPowers, uint count, IntPtr uploadBuffer);
+
+        // 每帧随机改变 changedFraction 的光源，比较增量更新与全量重建；1M 光源时耗时数秒，不要在渲染线程上调用
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern LocalLightPdfBenchmarkResult BenchmarkLocalLightPdf(uint lightCount, float changedFraction, uint frameCount);
+
+        // ================= Local light alias table =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateLocalLightAliasTable();
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyLocalLightAliasTable(IntPtr table);
+
+        // entries 至少 lightCount 项（RTXDI_AliasTableEntry），返回值填进 ResamplingConstants.localLightAliasTableParams
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern RTXDI_AliasTableParameters BuildLocalLightAliasTable(IntPtr table, IntPtr lightPowers, uint lightCount, IntPtr entries);
+
+        // 重复 Build 取平均耗时并校验分布；1M 光源时耗时数百毫秒，不要在渲染线程上调用
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern LocalLightAliasTableBenchmarkResult BenchmarkLocalLightAliasTable(uint lightCount, uint buildCount);
+
+        // ================= CPU 参考实现 =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateReSTIRDIReference(ref ReSTIRDIReferenceSceneDesc desc);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyReSTIRDIReference(IntPtr reference);
+
+        // 用 context 当前的参数在合成场景上跑 frameCount 帧，返回误差和开销
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern ReSTIRDIReferenceStats RunReSTIRDIReference(IntPtr reference, IntPtr context, uint frameCount);
+
+        // ================= Sharc 容量模拟 =================
+        // 每组 settings 各自回放一遍，outStats 长度至少为 settingsCount；大容量、长序列时耗时较长，不要在渲染线程上调用
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void SimulateSharcCapacities(ref SharcTraceDesc trace, [In] SharcSimulationSettings[] settings, uint settingsCount, [Out] SharcSimulationStats[] outStats);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void SimulateSharcSyntheticCapacities(ref SharcSyntheticTraceDesc desc, [In] SharcSimulationSettings[] settings, uint settingsCount, [Out] SharcSimulationStats[] outStats);
+
+        // outResults 长度至少为 SharcHashFunction.Count，返回写入的个数
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint BenchmarkSharcHashes(ref SharcTraceDesc trace, ref SharcSimulationSettings settings, [Out] SharcHashBenchmarkResult[] outResults);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint BenchmarkSharcSyntheticHashes(ref SharcSyntheticTraceDesc desc, ref SharcSimulationSettings settings, [Out] SharcHashBenchmarkResult[] outResults);
+
+        // ================= Sharc 快照 =================
+        // hashEntries 为 capacity 个 ulong，resolved 为 capacity 个 SharcPackedData（uint4）；保存 4M entry 需要上百毫秒，不要在主线程上等待
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern SharcSnapshotStats SaveSharcSnapshotFile([MarshalAs(UnmanagedType.LPStr)] string path, ref SharcSnapshotDesc desc, IntPtr hashEntries, IntPtr resolved);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern SharcSnapshotStats LoadSharcSnapshotFile([MarshalAs(UnmanagedType.LPStr)] string path, ref SharcSnapshotDesc desc, IntPtr hashEntries, IntPtr resolved);
+
+        // 把 LoadSharcSnapshotFile 的结果中有效的 entry 移到两个数组开头，返回个数，只需上传这一段
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint CompactSharcSnapshotEntries(IntPtr hashEntries, IntPtr resolved, uint capacity);
+
+        // ================= 场景几何 =================
+        // descs 为 descCount 个 PrimitiveBuildDesc，outPrimitives 为 primitiveCapacity 个 PrimitiveData
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern PrimitiveBuildStats BuildScenePrimitiveData(IntPtr descs, uint descCount, IntPtr outPrimitives, uint primitiveCapacity);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreatePrimitiveCache([MarshalAs(UnmanagedType.LPStr)] string path);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyPrimitiveCache(IntPtr cache);
+
+        // 与 BuildScenePrimitiveData 相同，内容未变的 mesh 直接从缓存文件拷贝
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern PrimitiveCacheBuildStats BuildScenePrimitiveDataCached(IntPtr cache, IntPtr descs, uint descCount, IntPtr outPrimitives, uint primitiveCapacity);
+
+        // 没有新增的 mesh 时不写文件；maxBytes 为 0 时不限制大小
+        // 可以在后台线程上调用，保存期间其它线程调用 BuildScenePrimitiveDataCached 会等到保存结束
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern PrimitiveCacheSaveStats SavePrimitiveCache(IntPtr cache, ulong maxBytes);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern PrimitiveCacheInfo GetPrimitiveCacheInfo(IntPtr cache);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateCompactGeometryBuilder();
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyCompactGeometryBuilder(IntPtr builder);
+
+        // 结果保存在 builder 中，由下面的函数取出后上传
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern CompactGeometryReport BuildCompactGeometry(IntPtr builder, IntPtr descs, uint descCount, uint triangleCapacity);
+
+        // report.vertexCount 个 CompactVertex
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetCompactGeometryVertices(IntPtr builder);
+
+        // report.indexBytes 字节
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetCompactGeometryIndices(IntPtr builder);
+
+        // triangleCapacity 个 float2（worldArea, 带 bitangentSign 符号的 uvArea）
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetCompactGeometryTriangles(IntPtr builder);
+
+        // descCount 个 CompactSubmesh
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetCompactGeometrySubmeshes(IntPtr builder);
+
+        // ================= InstanceTable =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateInstanceTable();
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyInstanceTable(IntPtr table);
+
+        // rows 为 submeshCount 个 InstanceData，返回 renderer 的第一行，即 RTAS 中的 InstanceID
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint AddInstanceTableRenderer(IntPtr table, int rendererId, uint submeshCount, IntPtr rows);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void RemoveInstanceTableRenderer(IntPtr table, int rendererId);
+
+        // fieldMask 为 InstanceField，返回内容实际变化的行数
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint UpdateInstanceTableRows(IntPtr table, IntPtr rowIndices, IntPtr rows, uint count, uint fieldMask);
+
+        // outRanges 为 maxRanges 个 InstanceRowRange，返回写入的区间数
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern uint CollectInstanceTableDirtyRanges(IntPtr table, IntPtr outRanges, uint maxRanges, uint mergeGap);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetInstanceTableRows(IntPtr table);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern InstanceTableStats GetInstanceTableStats(IntPtr table);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void MarkInstanceTableDirty(IntPtr table);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void ClearInstanceTable(IntPtr table);
+
+        // maxRanges 为 0 时与 PathTracingDataBuilder 相同，按脏行数准备区间数组
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern InstanceTableBenchmarkResult BenchmarkInstanceTable(uint instanceCount, float movingFraction, uint frameCount, uint mergeGap, uint maxRanges);
+
+        // ================= TextureTable =================
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr CreateTextureTable();
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void DestroyTextureTable(IntPtr table);
+
+        // materials 为 count 个 MaterialTextureDesc，outGroupIndices 为 count 个组号
+        // releaseUnlisted 非 0 时释放本次未列出的材质
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern TextureTableStats UpdateTextureTable(IntPtr table, IntPtr materials, uint count, IntPtr outGroupIndices, uint releaseUnlisted);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern TextureTableStats ReleaseTextureTableMaterials(IntPtr table, IntPtr materialIds, uint count);
+
+        // groupCapacity 个 TextureGroupKey
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetTextureTableGroups(IntPtr table);
+
+        // 最近一次 Update / ReleaseMaterials 中内容变化的组号，共 changedGroupCount 个
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern IntPtr GetTextureTableChangedGroups(IntPtr table);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern TextureTableStats GetTextureTableStats(IntPtr table);
+
+        [DllImport("UnityRtxdi.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void ClearTextureTable(IntPtr table);
+
 
 
     }
@@ -5,9 +5,6 @@ using UnityEngine;
 
 public class RtxdiResources : IDisposable
 {
-    // RTXDI 常量，通常为 2 或 3，取决于 SDK 版本
-    private const int c_NumReSTIRDIReservoirBuffers = 3; 
-
     private bool m_neighborOffsetsInitialized = false;
     private uint m_maxEmissiveMeshes;
     private uint m_maxEmissiveTriangles;
@@ -19,6 +16,10 @@ public class RtxdiResources : IDisposable
     public GraphicsBuffer GeometryInstanceToLightBuffer { get; private set; }
     public GraphicsBuffer NeighborOffsetsBuffer { get; private set; }
     public GraphicsBuffer LightReservoirBuffer { get; private set; }
+    // LightReservoirBuffer 当前的布局，数组数来自 ReSTIRDIContext.GetReservoirBufferDesc
+    public ReservoirBufferDesc LightReservoirBufferDesc { get; private set; }
+    // [0, maxLights) 为 currentToPrevious，[maxLights, 2 * maxLights) 为 previousToCurrent
+    public GraphicsBuffer LightIndexMappingBuffer { get; private set; }
 
     public unsafe RtxdiResources(
         ReSTIRDIContext context,
@@ -54,6 +55,17 @@ public class RtxdiResources : IDisposable
             LightDataBuffer.name = "LightDataBuffer";
         }
 
+        // 2.1 LightIndexMappingBuffer，供 RAB_TranslateLightIndex 在光源列表变化后找回上一帧的光源
+        if (maxEmissiveTriangles > 0)
+        {
+            LightIndexMappingBuffer = new GraphicsBuffer(
+                GraphicsBuffer.Target.Structured,
+                (int)maxEmissiveTriangles * 2,
+                sizeof(uint)
+            );
+            LightIndexMappingBuffer.name = "LightIndexMappingBuffer";
+        }
+
         // 3. GeometryInstanceToLightBuffer
         // initial state: ShaderResource
         if (maxGeometryInstances > 0)
@@ -68,7 +80,6 @@ public class RtxdiResources : IDisposable
 
         // 获取参数
         var staticParams = context.GetStaticParameters();
-        var reservoirParams = context.GetReservoirBufferParameters();
 
         // 4. NeighborOffsetsBuffer
         // C++: format = nvrhi::Format::RG8_SNORM (2 bytes per element)
@@ -89,19 +100,34 @@ public class RtxdiResources : IDisposable
         NeighborOffsetsBuffer.name = "NeighborOffsets";
 
         // 5. LightReservoirBuffer
-        // byteSize = sizeof(Packed) * pitch * numBuffers
-        int reservoirStride = Marshal.SizeOf<RTXDI_PackedDIReservoir>();
-        int totalReservoirs = (int)reservoirParams.reservoirArrayPitch * c_NumReSTIRDIReservoirBuffers;
-        
-        if (totalReservoirs > 0)
-        {
-            LightReservoirBuffer = new GraphicsBuffer(
-                GraphicsBuffer.Target.Structured,
-                totalReservoirs,
-                reservoirStride
-            );
-            LightReservoirBuffer.name = "LightReservoirBuffer";
-        }
+        EnsureLightReservoirBuffer(context, context.GetResamplingMode());
+    }
+
+    // 按 resamplingMode 的最少数组数分配，配合 ReSTIRDIReservoirPlanner 的缓冲下标使用
+    // 数组数增加或分辨率变化时重新分配并返回 true，调用方需要重置 planner，旧的 reservoir 不再有效
+    public bool EnsureLightReservoirBuffer(ReSTIRDIContext context, ReSTIRDI_ResamplingMode resamplingMode)
+    {
+        ReservoirBufferDesc desc = context.GetReservoirBufferDesc(resamplingMode);
+        ReservoirBufferDesc current = LightReservoirBufferDesc;
+        if (LightReservoirBuffer != null && desc.reservoirArrayPitch == current.reservoirArrayPitch &&
+            desc.numReservoirBuffers <= current.numReservoirBuffers)
+            return false;
+
+        LightReservoirBuffer?.Dispose();
+        LightReservoirBuffer = null;
+        LightReservoirBufferDesc = default;
+
+        if (desc.totalReservoirCount == 0)
+            return true;
+
+        LightReservoirBuffer = new GraphicsBuffer(
+            GraphicsBuffer.Target.Structured,
+            (int)desc.totalReservoirCount,
+            (int)desc.reservoirStride
+        );
+        LightReservoirBuffer.name = "LightReservoirBuffer";
+        LightReservoirBufferDesc = desc;
+        return true;
     }
 
     public void InitializeNeighborOffsets(uint neighborOffsetCount)
@@ -141,6 +167,9 @@ public class RtxdiResources : IDisposable
         LightDataBuffer?.Dispose();
         LightDataBuffer = null;
 
+        LightIndexMappingBuffer?.Dispose();
+        LightIndexMappingBuffer = null;
+
         GeometryInstanceToLightBuffer?.Dispose();
         GeometryInstanceToLightBuffer = null;
 
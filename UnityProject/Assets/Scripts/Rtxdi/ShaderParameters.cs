@@ -13,27 +13,23 @@ public struct PrepareLightsTask
     public uint lightBufferOffset;
 };
 
+// 由 RtxdiNative.FillResamplingConstants 一次性填充，布局与 C++ / HLSL 端一致
 public struct ResamplingConstants
 {
-    // PlanarViewConstants view;
-    // PlanarViewConstants prevView;
     public RTXDI_RuntimeParameters runtimeParams;
     public RTXDI_LightBufferParameters lightBufferParams;
-    public RTXDI_ReservoirBufferParameters restirDIReservoirBufferParams;
+    public RTXDI_RISBufferSegmentParameters localLightsRISBufferSegmentParams;
+    public RTXDI_RISBufferSegmentParameters environmentLightRISBufferSegmentParams;
+    public RTXDI_AliasTableParameters localLightAliasTableParams;
 
     public uint frameIndex;
-    public uint numInitialSamples;
-    public uint numSpatialSamples;
     public uint pad1;
+    public uint pad2;
+    public uint pad3;
 
-    public uint numInitialBRDFSamples;
-    public float brdfCutoff;
-    public uint2 pad2;
-
-    public uint enableResampling;
-    public uint unbiasedMode;
-    public uint inputBufferIndex;
-    public uint outputBufferIndex;
+    public ReSTIRDI_Parameters restirDI;
+    public ReGIR_Parameters regir;
+    public ReSTIRGI_Parameters restirGI;
 };
 
 // See TriangleLight.hlsli for encoding format
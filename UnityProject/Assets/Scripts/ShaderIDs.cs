@@ -10,6 +10,7 @@ namespace PathTracing
         public static readonly int g_HashEntriesID = Shader.PropertyToID("gInOut_SharcHashEntriesBuffer");
         public static readonly int g_AccumulationBufferID = Shader.PropertyToID("gInOut_SharcAccumulated");
         public static readonly int g_ResolvedBufferID = Shader.PropertyToID("gInOut_SharcResolved");
+        public static readonly int g_SharcStatsID = Shader.PropertyToID("gInOut_SharcStats");
         
         
         
@@ -60,6 +61,9 @@ namespace PathTracing
         public static int gWorldTlasID = Shader.PropertyToID("gWorldTlas");
         public static int gIn_InstanceDataID = Shader.PropertyToID("gIn_InstanceData");
         public static int gIn_PrimitiveDataID = Shader.PropertyToID("gIn_PrimitiveData");
+        public static int gIn_CompactVerticesID = Shader.PropertyToID("gIn_CompactVertices");
+        public static int gIn_CompactIndicesID = Shader.PropertyToID("gIn_CompactIndices");
+        public static int gIn_CompactTrianglesID = Shader.PropertyToID("gIn_CompactTriangles");
 
 
         // TraceTransparency
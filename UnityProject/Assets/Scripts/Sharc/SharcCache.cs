@@ -0,0 +1,500 @@
+﻿using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Threading.Tasks;
+using DefaultNamespace;
+using Unity.Collections;
+using Unity.Collections.LowLevel.Unsafe;
+using UnityEngine;
+using UnityEngine.Rendering;
+
+namespace PathTracing
+{
+    // 与 RenderingPlugin/SharcCapacityPolicy.h 一致
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SharcOccupancyStats
+    {
+        public uint liveEntries;
+        public uint evictedEntries;
+        public uint sampledEntries;
+        public uint pad1;
+    }
+
+    // 数值为 0 时使用插件中的默认值
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SharcCapacitySettings
+    {
+        public uint minCapacity;
+        public uint maxCapacity;
+        public float growOccupancy;
+        public float shrinkOccupancy;
+        public float targetOccupancy;
+        public uint growFrames;
+        public uint shrinkFrames;
+        public uint cooldownFrames;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SharcCapacityDecision
+    {
+        public uint capacity;
+        public uint requestedCapacity;
+        public uint sampleCount;
+        public uint pad1;
+        public float occupancy;
+        public float peakOccupancy;
+        public SharcOccupancyStats lastStats;
+    }
+
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public struct SharcFrameData
+    {
+        public IntPtr statsBuffer;
+        public uint capacity;
+        public int instanceId;
+    }
+
+    // 持有 Sharc 的三个缓冲，容量由原生插件根据读回的占用率决定，变化时在这里重新分配并 rehash
+    public class SharcCache : IDisposable
+    {
+        [DllImport("RenderingPlugin")]
+        private static extern int CreateSharcCacheInstance(ref SharcCapacitySettings settings, uint initialCapacity);
+
+        [DllImport("RenderingPlugin")]
+        private static extern void DestroySharcCacheInstance(int id);
+
+        [DllImport("RenderingPlugin")]
+        private static extern SharcCapacityDecision GetSharcCacheDecision(int id);
+
+        [DllImport("RenderingPlugin")]
+        private static extern void SetSharcCacheCapacity(int id, uint capacity);
+
+        private static readonly int g_PrevHashEntriesID = Shader.PropertyToID("gIn_SharcPrevHashEntriesBuffer");
+        private static readonly int g_PrevResolvedID = Shader.PropertyToID("gIn_SharcPrevResolved");
+        private static readonly int g_RehashPrevCapacityID = Shader.PropertyToID("gSharcRehashPrevCapacity");
+        private static readonly int g_RehashCapacityID = Shader.PropertyToID("gSharcRehashCapacity");
+
+        private const int LINEAR_BLOCK_SIZE = 256;
+        private const int BufferCount = 3;
+
+        // 快照每帧最多上传的 entry 数，每个 entry 24 字节，约 6 MB
+        private const int SnapshotUploadEntriesPerFrame = 1 << 18;
+
+        // 与 Shared.hlsl / SharcCommon.h / HashGridCommon.h 中的网格参数一致，任意一项变化后旧快照不会被加载
+        private const float SnapshotSceneScale = 45.0f;
+        private const float SnapshotLogarithmBase = 2.0f;
+        private const float SnapshotLevelBias = 0.0f;
+        private const uint SnapshotUseNormals = 1;
+        private const SharcHashFunction SnapshotHashFunction = SharcHashFunction.XXHash32;
+        private const uint SnapshotBucketSize = 16;
+
+        public GraphicsBuffer HashEntriesBuffer { get; private set; }
+        public GraphicsBuffer AccumulationBuffer { get; private set; }
+        public GraphicsBuffer ResolvedBuffer { get; private set; }
+        public GraphicsBuffer StatsBuffer { get; private set; }
+
+        public uint Capacity { get; private set; }
+        public SharcCapacityDecision LastDecision { get; private set; }
+
+        // 保存快照时记录的相机位置，加载时据此判断 voxel 是否需要换层级
+        public Vector3 CameraPosition { get; set; }
+
+        private readonly int instanceId;
+        private readonly ComputeShader resolveCs;
+        private readonly int rehashKernel;
+
+        private NativeArray<SharcFrameData> buffer;
+        private uint frameIndex;
+
+        // 后台加载并压缩的快照，完成后在 Update 中分批上传
+        private Task<(SharcSnapshotStats stats, uint entryCount)> loadTask;
+        private NativeArray<ulong> loadHashEntries;
+        private NativeArray<uint> loadResolved;
+        private string loadPath;
+        private Vector3 loadCameraPosition;
+        private SharcSnapshotStats loadStats;
+        private uint loadEntryCount;
+        private uint loadUploadedEntries;
+
+        // 每帧上传的一段 entry，SharcRehash 从这里按 key 插入当前的表
+        private GraphicsBuffer snapshotHashEntriesBuffer;
+        private GraphicsBuffer snapshotResolvedBuffer;
+
+        // 后台写文件的定时保存，未完成时不再发起新的保存
+        private Task saveTask;
+        private bool saveInFlight;
+
+        public SharcCache(ComputeShader sharcResolveCs, uint initialCapacity, SharcCapacitySettings settings = default)
+        {
+            resolveCs = sharcResolveCs;
+            rehashKernel = resolveCs != null ? resolveCs.FindKernel("SharcRehash") : -1;
+
+            instanceId = CreateSharcCacheInstance(ref settings, initialCapacity);
+            LastDecision = GetSharcCacheDecision(instanceId);
+
+            // 插件会把容量规整为 2 的幂并限制在 min/max 之间
+            Capacity = LastDecision.capacity != 0 ? LastDecision.capacity : initialCapacity;
+            AllocateBuffers(Capacity, out var hashEntries, out var accumulation, out var resolved);
+            HashEntriesBuffer = hashEntries;
+            AccumulationBuffer = accumulation;
+            ResolvedBuffer = resolved;
+
+            StatsBuffer = new GraphicsBuffer(GraphicsBuffer.Target.Structured, 4, sizeof(uint));
+            StatsBuffer.SetData(new uint[4]);
+
+            buffer = new NativeArray<SharcFrameData>(BufferCount, Allocator.Persistent);
+
+            Debug.Log($"[Sharc] Created Cache Instance {instanceId} with capacity {Capacity}");
+        }
+
+        private static void AllocateBuffers(uint capacity, out GraphicsBuffer hashEntries, out GraphicsBuffer accumulation, out GraphicsBuffer resolved)
+        {
+            var count = (int)capacity;
+
+            hashEntries = new GraphicsBuffer(GraphicsBuffer.Target.Structured, count, sizeof(ulong));
+            // HLSL: RWStructuredBuffer<SharcAccumulationData> gInOut_SharcAccumulated;
+            accumulation = new GraphicsBuffer(GraphicsBuffer.Target.Structured, count, sizeof(uint) * 4);
+            // HLSL: RWStructuredBuffer<SharcPackedData> gInOut_SharcResolved;
+            resolved = new GraphicsBuffer(GraphicsBuffer.Target.Structured, count, sizeof(uint) * 4);
+
+            // 三个缓冲都需要清零，共用一块 16 字节一项的内存
+            var clearData = new NativeArray<byte>(count * sizeof(uint) * 4, Allocator.Persistent, NativeArrayOptions.ClearMemory);
+            hashEntries.SetData(clearData.Reinterpret<ulong>(sizeof(byte)), 0, 0, count);
+            accumulation.SetData(clearData);
+            resolved.SetData(clearData);
+            clearData.Dispose();
+        }
+
+        // 每帧在主线程调用，插件请求的容量与当前不同时重新分配并把有效 entry 搬到新缓冲
+        public bool Update()
+        {
+            ApplyLoadedSnapshot();
+
+            var decision = GetSharcCacheDecision(instanceId);
+            LastDecision = decision;
+
+            if (decision.requestedCapacity == 0 || decision.requestedCapacity == Capacity || rehashKernel < 0)
+                return false;
+
+            Resize(decision.requestedCapacity);
+            return true;
+        }
+
+        private void Resize(uint newCapacity)
+        {
+            var prevCapacity = Capacity;
+            var prevHashEntries = HashEntriesBuffer;
+            var prevAccumulation = AccumulationBuffer;
+            var prevResolved = ResolvedBuffer;
+
+            AllocateBuffers(newCapacity, out var hashEntries, out var accumulation, out var resolved);
+
+            var cmd = new CommandBuffer { name = "Sharc Rehash" };
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, g_PrevHashEntriesID, prevHashEntries);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, g_PrevResolvedID, prevResolved);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, ShaderIDs.g_HashEntriesID, hashEntries);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, ShaderIDs.g_ResolvedBufferID, resolved);
+            cmd.SetComputeIntParam(resolveCs, g_RehashPrevCapacityID, (int)prevCapacity);
+            cmd.SetComputeIntParam(resolveCs, g_RehashCapacityID, (int)newCapacity);
+            cmd.DispatchCompute(resolveCs, rehashKernel, (int)((prevCapacity + LINEAR_BLOCK_SIZE - 1) / LINEAR_BLOCK_SIZE), 1, 1);
+            Graphics.ExecuteCommandBuffer(cmd);
+            cmd.Release();
+
+            // Release 会等到 GPU 不再使用之后才真正释放
+            prevHashEntries.Release();
+            prevAccumulation.Release();
+            prevResolved.Release();
+
+            HashEntriesBuffer = hashEntries;
+            AccumulationBuffer = accumulation;
+            ResolvedBuffer = resolved;
+            Capacity = newCapacity;
+
+            SetSharcCacheCapacity(instanceId, newCapacity);
+
+            Debug.Log($"[Sharc] Cache Instance {instanceId} resized {prevCapacity} -> {newCapacity} (occupancy {LastDecision.occupancy:F3})");
+        }
+
+        // 场景路径的 FNV-1a，作为快照文件名和文件头中的 sceneHash
+        public static ulong ComputeSceneHash(string scenePath)
+        {
+            var hash = 14695981039346656037ul;
+            foreach (var c in scenePath ?? string.Empty)
+            {
+                hash ^= c;
+                hash *= 1099511628211ul;
+            }
+
+            return hash;
+        }
+
+        public static string GetSnapshotPath(ulong sceneHash)
+        {
+            return Path.Combine(Application.persistentDataPath, $"SharcSnapshot_{sceneHash:x16}.bin");
+        }
+
+        private static SharcSnapshotDesc CreateSnapshotDesc(ulong sceneHash, Vector3 cameraPosition, uint capacity)
+        {
+            return new SharcSnapshotDesc
+            {
+                sceneHash = sceneHash,
+                cameraPosition = cameraPosition,
+                sceneScale = SnapshotSceneScale,
+                logarithmBase = SnapshotLogarithmBase,
+                levelBias = SnapshotLevelBias,
+                useNormals = SnapshotUseNormals,
+                hashFunction = SnapshotHashFunction,
+                bucketSize = SnapshotBucketSize,
+                capacity = capacity
+            };
+        }
+
+        public bool IsLoadingSnapshot => loadTask != null;
+
+        // 场景开始时调用，在后台线程解码快照并把有效 entry 压缩到数组开头；完成后每次 Update 上传一段，
+        // 由 SharcRehash 按 key 插入当前的表，上传量与有效 entry 数成正比，4M 满表约 15 帧传完，每帧约 6 MB
+        // 加载期间缓存从空表开始，已经写入的 entry 保留，与快照相同的 key 使用快照的数据；期间容量变化也不影响插入
+        public bool LoadSnapshot(ulong sceneHash, Vector3 cameraPosition)
+        {
+            var path = GetSnapshotPath(sceneHash);
+            if (loadTask != null || !File.Exists(path))
+                return false;
+
+            var desc = CreateSnapshotDesc(sceneHash, cameraPosition, Capacity);
+            loadHashEntries = new NativeArray<ulong>((int)Capacity, Allocator.Persistent, NativeArrayOptions.UninitializedMemory);
+            loadResolved = new NativeArray<uint>((int)Capacity * 4, Allocator.Persistent, NativeArrayOptions.UninitializedMemory);
+            loadPath = path;
+            loadCameraPosition = cameraPosition;
+
+            IntPtr hashEntriesPtr, resolvedPtr;
+            unsafe
+            {
+                hashEntriesPtr = (IntPtr)loadHashEntries.GetUnsafePtr();
+                resolvedPtr = (IntPtr)loadResolved.GetUnsafePtr();
+            }
+
+            loadTask = Task.Run(() =>
+            {
+                var stats = RtxdiNative.LoadSharcSnapshotFile(path, ref desc, hashEntriesPtr, resolvedPtr);
+                var entryCount = stats.result == SharcSnapshotResult.Ok ? RtxdiNative.CompactSharcSnapshotEntries(hashEntriesPtr, resolvedPtr, desc.capacity) : 0;
+                return (stats, entryCount);
+            });
+            return true;
+        }
+
+        private void ApplyLoadedSnapshot()
+        {
+            if (loadTask == null || !loadTask.IsCompleted)
+                return;
+
+            // 第一次看到加载完成时检查结果并创建上传用的缓冲
+            if (snapshotHashEntriesBuffer == null)
+            {
+                if (loadTask.IsFaulted)
+                {
+                    Debug.LogWarning($"[Sharc] Snapshot {loadPath} was not loaded: {loadTask.Exception?.GetBaseException().Message}");
+                    ReleaseLoad();
+                    return;
+                }
+
+                (loadStats, loadEntryCount) = loadTask.Result;
+                if (loadStats.result != SharcSnapshotResult.Ok)
+                {
+                    Debug.LogWarning($"[Sharc] Snapshot {loadPath} was not loaded: {loadStats.result}");
+                    ReleaseLoad();
+                    return;
+                }
+
+                if (loadEntryCount == 0 || rehashKernel < 0)
+                {
+                    ReleaseLoad();
+                    return;
+                }
+
+                var chunkSize = (int)Math.Min(loadEntryCount, SnapshotUploadEntriesPerFrame);
+                snapshotHashEntriesBuffer = new GraphicsBuffer(GraphicsBuffer.Target.Structured, chunkSize, sizeof(ulong));
+                snapshotResolvedBuffer = new GraphicsBuffer(GraphicsBuffer.Target.Structured, chunkSize, sizeof(uint) * 4);
+                loadUploadedEntries = 0;
+            }
+
+            UploadSnapshotEntries();
+        }
+
+        private void UploadSnapshotEntries()
+        {
+            var start = (int)loadUploadedEntries;
+            var count = (int)Math.Min(loadEntryCount - loadUploadedEntries, SnapshotUploadEntriesPerFrame);
+
+            // 与 Resize 相同的插入方式，只是来源换成这一段快照
+            var cmd = new CommandBuffer { name = "Sharc Snapshot Upload" };
+            cmd.SetBufferData(snapshotHashEntriesBuffer, loadHashEntries, start, 0, count);
+            cmd.SetBufferData(snapshotResolvedBuffer, loadResolved, start * 4, 0, count * 4);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, g_PrevHashEntriesID, snapshotHashEntriesBuffer);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, g_PrevResolvedID, snapshotResolvedBuffer);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, ShaderIDs.g_HashEntriesID, HashEntriesBuffer);
+            cmd.SetComputeBufferParam(resolveCs, rehashKernel, ShaderIDs.g_ResolvedBufferID, ResolvedBuffer);
+            cmd.SetComputeIntParam(resolveCs, g_RehashPrevCapacityID, count);
+            cmd.SetComputeIntParam(resolveCs, g_RehashCapacityID, (int)Capacity);
+            cmd.DispatchCompute(resolveCs, rehashKernel, (count + LINEAR_BLOCK_SIZE - 1) / LINEAR_BLOCK_SIZE, 1, 1);
+            Graphics.ExecuteCommandBuffer(cmd);
+            cmd.Release();
+
+            loadUploadedEntries += (uint)count;
+            if (loadUploadedEntries < loadEntryCount)
+                return;
+
+            CameraPosition = loadCameraPosition;
+            Debug.Log($"[Sharc] Loaded snapshot {loadPath}: {loadStats.loadedEntries}/{loadStats.entryCount} entries, {loadStats.relevelledEntries} relevelled, " +
+                      $"{loadStats.mergedEntries} merged, {loadStats.droppedEntries} dropped, {loadStats.milliseconds:F1} ms, " +
+                      $"uploaded {loadEntryCount} entries over {(loadEntryCount + SnapshotUploadEntriesPerFrame - 1) / SnapshotUploadEntriesPerFrame} frames");
+            ReleaseLoad();
+        }
+
+        private void ReleaseLoad()
+        {
+            loadTask = null;
+            if (loadHashEntries.IsCreated)
+                loadHashEntries.Dispose();
+            if (loadResolved.IsCreated)
+                loadResolved.Dispose();
+
+            // Release 会等到 GPU 不再使用之后才真正释放
+            snapshotHashEntriesBuffer?.Release();
+            snapshotHashEntriesBuffer = null;
+            snapshotResolvedBuffer?.Release();
+            snapshotResolvedBuffer = null;
+        }
+
+        // 读回 hash 表和 resolved 缓冲后在后台线程写文件；waitForCompletion 用于退出时同步保存
+        // 上一次后台保存未完成或快照还在加载时跳过定时保存；同步保存先等待之前的保存写完，保证最后写入的是最新的数据
+        public void SaveSnapshot(ulong sceneHash, bool waitForCompletion)
+        {
+            if (loadTask != null)
+                return;
+
+            if (waitForCompletion)
+            {
+                AsyncGPUReadback.WaitAllRequests();
+                saveTask?.Wait();
+            }
+            else if (saveInFlight)
+            {
+                return;
+            }
+
+            saveInFlight = true;
+            var path = GetSnapshotPath(sceneHash);
+            var desc = CreateSnapshotDesc(sceneHash, CameraPosition, Capacity);
+
+            var hashEntries = new NativeArray<ulong>((int)Capacity, Allocator.Persistent, NativeArrayOptions.UninitializedMemory);
+            var resolved = new NativeArray<uint>((int)Capacity * 4, Allocator.Persistent, NativeArrayOptions.UninitializedMemory);
+            var pending = 2;
+            var failed = false;
+
+            void OnReadback(AsyncGPUReadbackRequest request)
+            {
+                failed |= request.hasError;
+                if (--pending > 0)
+                    return;
+
+                if (failed)
+                {
+                    Debug.LogWarning("[Sharc] Snapshot readback failed");
+                    hashEntries.Dispose();
+                    resolved.Dispose();
+                    saveInFlight = false;
+                    return;
+                }
+
+                IntPtr hashEntriesPtr, resolvedPtr;
+                unsafe
+                {
+                    hashEntriesPtr = (IntPtr)hashEntries.GetUnsafeReadOnlyPtr();
+                    resolvedPtr = (IntPtr)resolved.GetUnsafeReadOnlyPtr();
+                }
+
+                if (waitForCompletion)
+                {
+                    WriteSnapshot(path, desc, hashEntriesPtr, resolvedPtr);
+                    hashEntries.Dispose();
+                    resolved.Dispose();
+                    saveInFlight = false;
+                    return;
+                }
+
+                // NativeArray 只在主线程上释放
+                saveTask = Task.Run(() => WriteSnapshot(path, desc, hashEntriesPtr, resolvedPtr));
+                saveTask.ContinueWith(_ =>
+                {
+                    hashEntries.Dispose();
+                    resolved.Dispose();
+                    saveInFlight = false;
+                }, TaskScheduler.FromCurrentSynchronizationContext());
+            }
+
+            AsyncGPUReadback.RequestIntoNativeArray(ref hashEntries, HashEntriesBuffer, OnReadback);
+            AsyncGPUReadback.RequestIntoNativeArray(ref resolved, ResolvedBuffer, OnReadback);
+
+            if (waitForCompletion)
+                AsyncGPUReadback.WaitAllRequests();
+        }
+
+        private static void WriteSnapshot(string path, SharcSnapshotDesc desc, IntPtr hashEntries, IntPtr resolved)
+        {
+            var stats = RtxdiNative.SaveSharcSnapshotFile(path, ref desc, hashEntries, resolved);
+            if (stats.result == SharcSnapshotResult.Ok)
+                Debug.Log($"[Sharc] Saved snapshot {path}: {stats.entryCount} entries, {stats.fileBytes / 1024} KB (raw {stats.rawBytes / 1024} KB), {stats.milliseconds:F1} ms");
+            else
+                Debug.LogWarning($"[Sharc] Snapshot {path} was not saved: {stats.result}");
+        }
+
+        public IntPtr GetInteropDataPtr()
+        {
+            var index = (int)(frameIndex % BufferCount);
+            buffer[index] = new SharcFrameData
+            {
+                statsBuffer = StatsBuffer.GetNativeBufferPtr(),
+                capacity = Capacity,
+                instanceId = instanceId
+            };
+            frameIndex++;
+            unsafe
+            {
+                return (IntPtr)buffer.GetUnsafePtr() + index * sizeof(SharcFrameData);
+            }
+        }
+
+        public void Dispose()
+        {
+            if (buffer.IsCreated)
+            {
+                buffer.Dispose();
+            }
+
+            // 后台线程仍在写入加载缓冲或读取保存缓冲时不能释放
+            try
+            {
+                loadTask?.Wait();
+            }
+            catch (AggregateException)
+            {
+                // 加载失败时没有需要应用的数据，只需释放缓冲
+            }
+
+            ReleaseLoad();
+            saveTask?.Wait();
+
+            HashEntriesBuffer?.Release();
+            HashEntriesBuffer = null;
+            AccumulationBuffer?.Release();
+            AccumulationBuffer = null;
+            ResolvedBuffer?.Release();
+            ResolvedBuffer = null;
+            StatsBuffer?.Release();
+            StatsBuffer = null;
+
+            DestroySharcCacheInstance(instanceId);
+            Debug.Log($"[Sharc] Destroyed Cache Instance {instanceId}");
+        }
+    }
+}
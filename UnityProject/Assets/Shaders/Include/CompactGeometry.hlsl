@@ -0,0 +1,57 @@
+// 命中着色读取的三角形属性：_USECOMPACT 时从共享顶点和索引展开成 PrimitiveData，否则直接读取 PrimitiveData
+// 包含前需要先定义 PrimitiveData 和 InstanceData
+
+#if _USECOMPACT
+// 与 UnityRtxdi/CompactGeometry.h 一致：顶点由同一 mesh 的 submesh 共享，三角形只存面积项
+struct CompactVertex
+{
+    float16_t2 uv;
+    float16_t2 n;
+    float16_t2 t;
+};
+
+StructuredBuffer<CompactVertex> gIn_CompactVertices;
+ByteAddressBuffer gIn_CompactIndices;
+StructuredBuffer<float2> gIn_CompactTriangles; // worldArea, uvArea（符号为 bitangentSign）
+
+uint3 LoadCompactIndices(uint indexOffset, uint triangleIndex)
+{
+    uint byteOffset = indexOffset & 0x7FFFFFFF;
+    if (indexOffset & 0x80000000)
+        return gIn_CompactIndices.Load3(byteOffset + triangleIndex * 12);
+
+    // 16 位索引每个三角形 6 字节，按 4 字节对齐读取两个 word
+    byteOffset += triangleIndex * 6;
+    uint2 words = gIn_CompactIndices.Load2(byteOffset & ~3u);
+    if (byteOffset & 2)
+        return uint3(words.x >> 16, words.y & 0xFFFF, words.y >> 16);
+    return uint3(words.x & 0xFFFF, words.x >> 16, words.y & 0xFFFF);
+}
+
+// 展开成 PrimitiveData，命中着色的其余部分不变
+PrimitiveData LoadCompactPrimitive(InstanceData instanceData, uint triangleIndex)
+{
+    uint3 indices = instanceData.compactVertexOffset + LoadCompactIndices(instanceData.compactIndexOffset, triangleIndex);
+    CompactVertex v0 = gIn_CompactVertices[indices.x];
+    CompactVertex v1 = gIn_CompactVertices[indices.y];
+    CompactVertex v2 = gIn_CompactVertices[indices.z];
+    float2 areas = gIn_CompactTriangles[instanceData.primitiveOffset + triangleIndex];
+
+    PrimitiveData primitiveData;
+    primitiveData.uv0 = v0.uv;
+    primitiveData.uv1 = v1.uv;
+    primitiveData.uv2 = v2.uv;
+    primitiveData.worldArea = areas.x;
+    primitiveData.n0 = v0.n;
+    primitiveData.n1 = v1.n;
+    primitiveData.n2 = v2.n;
+    primitiveData.uvArea = abs(areas.y);
+    primitiveData.t0 = v0.t;
+    primitiveData.t1 = v1.t;
+    primitiveData.t2 = v2.t;
+    primitiveData.bitangentSign = areas.y < 0.0 ? -1.0 : 1.0;
+    return primitiveData;
+}
+#else
+StructuredBuffer<PrimitiveData> gIn_PrimitiveData;
+#endif
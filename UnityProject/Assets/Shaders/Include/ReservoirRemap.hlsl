@@ -0,0 +1,50 @@
+#ifndef RESERVOIR_REMAP_HLSL
+#define RESERVOIR_REMAP_HLSL
+
+// 与 UnityRtxdi/ContextResize.h 中的 ReservoirRemapParameters 一致
+struct ReservoirRemapParameters
+{
+    uint4 oldReservoirBufferParams; // reservoirBlockRowPitch, reservoirArrayPitch, pad, pad
+    uint4 newReservoirBufferParams;
+
+    uint oldReservoirWidth;
+    uint oldReservoirHeight;
+    uint newReservoirWidth;
+    uint newReservoirHeight;
+
+    uint numReservoirBuffers;
+    uint oldBufferSizeInReservoirs;
+    uint newBufferSizeInReservoirs;
+    uint pad1;
+};
+
+#ifndef RTXDI_RESERVOIR_BLOCK_SIZE
+#define RTXDI_RESERVOIR_BLOCK_SIZE 16
+#endif
+
+// 与 RTXDI_ReservoirPositionToPointer 相同的寻址方式
+uint ReservoirRemap_PositionToPointer(uint2 pitches, uint2 reservoirPosition, uint reservoirArrayIndex)
+{
+    uint2 blockIdx = reservoirPosition / RTXDI_RESERVOIR_BLOCK_SIZE;
+    uint2 positionInBlock = reservoirPosition % RTXDI_RESERVOIR_BLOCK_SIZE;
+
+    return reservoirArrayIndex * pitches.y
+        + blockIdx.y * pitches.x
+        + blockIdx.x * (RTXDI_RESERVOIR_BLOCK_SIZE * RTXDI_RESERVOIR_BLOCK_SIZE)
+        + positionInBlock.y * RTXDI_RESERVOIR_BLOCK_SIZE
+        + positionInBlock.x;
+}
+
+// 新分辨率下的 reservoir 按屏幕比例找到旧分辨率下对应的 reservoir
+// 每个线程处理一个新 reservoir，对 numReservoirBuffers 个数组逐一拷贝，旧缓冲和新缓冲不能是同一块内存
+void ReservoirRemap_GetPointers(ReservoirRemapParameters params, uint2 newReservoirPosition, uint reservoirArrayIndex,
+    out uint oldPointer, out uint newPointer)
+{
+    float2 scale = float2(params.oldReservoirWidth, params.oldReservoirHeight) / float2(params.newReservoirWidth, params.newReservoirHeight);
+    uint2 oldPosition = min(uint2((float2(newReservoirPosition) + 0.5) * scale), uint2(params.oldReservoirWidth, params.oldReservoirHeight) - 1);
+
+    oldPointer = ReservoirRemap_PositionToPointer(params.oldReservoirBufferParams.xy, oldPosition, reservoirArrayIndex);
+    newPointer = ReservoirRemap_PositionToPointer(params.newReservoirBufferParams.xy, newReservoirPosition, reservoirArrayIndex);
+}
+
+#endif
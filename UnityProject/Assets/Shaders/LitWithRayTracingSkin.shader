@@ -164,6 +164,7 @@ Shader "Custom/LitWithRayTracingSkin"
             #include "Include/Payload.hlsl"
 
             #pragma shader_feature_raytracing _USEPACK
+            #pragma shader_feature_raytracing _USECOMPACT
 
             #pragma shader_feature_local_raytracing _EMISSION
             #pragma shader_feature_local_raytracing _NORMALMAP
@@ -219,14 +220,15 @@ Shader "Custom/LitWithRayTracingSkin"
                 float scale; // TODO: handling object scale embedded into the transformation matrix (assuming uniform scale), sign represents triangle winding
 
                 uint32_t morphPrimitiveOffset;
-                uint32_t unused1;
-                uint32_t unused2;
+                uint32_t compactVertexOffset;
+                uint32_t compactIndexOffset; // 最高位为 1 表示 32 位索引
                 uint32_t unused3;
             };
 
 
             StructuredBuffer<InstanceData> gIn_InstanceData;
-            StructuredBuffer<PrimitiveData> gIn_PrimitiveData;
+
+            #include "Include/CompactGeometry.hlsl"
 
 
             struct Vertex
@@ -319,8 +321,12 @@ Shader "Custom/LitWithRayTracingSkin"
                 uint instanceIndex = InstanceID() + GeometryIndex();
                 InstanceData instanceData = gIn_InstanceData[instanceIndex];
 
+                #if _USECOMPACT
+                PrimitiveData primitiveData = LoadCompactPrimitive(instanceData, PrimitiveIndex());
+                #else
                 uint primitiveIndex = instanceData.primitiveOffset + PrimitiveIndex();
                 PrimitiveData primitiveData = gIn_PrimitiveData[primitiveIndex];
+                #endif
 
                 float worldArea = primitiveData.worldArea * instanceData.scale * instanceData.scale;
 
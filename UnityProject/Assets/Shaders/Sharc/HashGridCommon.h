@@ -36,6 +36,16 @@
 #define HASH_GRID_NORMAL_BIAS               1e-3f
 #endif
 
+// Hash used to map a key to its base slot, values match HashGridHashFunction in UnityRtxdi/SharcHashGrid.h
+#define HASH_GRID_HASH_JENKINS              0       // two 32-bit Jenkins hashes, one per key half
+#define HASH_GRID_HASH_MURMUR3              1       // Murmur3 fmix64, needs 64-bit multiplies
+#define HASH_GRID_HASH_XXHASH32             2       // xxHash32 over the two key halves, 32-bit ALU only
+#define HASH_GRID_HASH_PCG                  3       // two chained PCG 32-bit hashes
+
+#ifndef HASH_GRID_HASH
+#define HASH_GRID_HASH                      HASH_GRID_HASH_JENKINS
+#endif
+
 #define HashGridIndex uint
 #define HashGridKey uint64_t
 
@@ -65,10 +75,56 @@ uint HashGridHashJenkins32(uint a)
     return a;
 }
 
+#if HASH_GRID_HASH == HASH_GRID_HASH_MURMUR3
+// https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+uint HashGridHash32(HashGridKey hashKey)
+{
+    hashKey ^= hashKey >> 33;
+    hashKey *= 0xff51afd7ed558ccdull;
+    hashKey ^= hashKey >> 33;
+    hashKey *= 0xc4ceb9fe1a85ec53ull;
+    hashKey ^= hashKey >> 33;
+
+    return uint(hashKey & 0xFFFFFFFF);
+}
+#elif HASH_GRID_HASH == HASH_GRID_HASH_XXHASH32
+// https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md, two 32-bit lanes with zero seed
+uint HashGridHash32(HashGridKey hashKey)
+{
+    uint h = 0x165667B1u + 8u;
+    h += uint((hashKey >> 0) & 0xFFFFFFFF) * 0xC2B2AE3Du;
+    h = ((h << 17) | (h >> 15)) * 0x27D4EB2Fu;
+    h += uint((hashKey >> 32) & 0xFFFFFFFF) * 0xC2B2AE3Du;
+    h = ((h << 17) | (h >> 15)) * 0x27D4EB2Fu;
+
+    h ^= h >> 15;
+    h *= 0x85EBCA77u;
+    h ^= h >> 13;
+    h *= 0xC2B2AE3Du;
+    h ^= h >> 16;
+
+    return h;
+}
+#elif HASH_GRID_HASH == HASH_GRID_HASH_PCG
+// https://www.reedbeta.com/blog/hash-functions-for-gpu-rendering/
+uint HashGridHashPcg32(uint v)
+{
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+
+    return (word >> 22u) ^ word;
+}
+
+uint HashGridHash32(HashGridKey hashKey)
+{
+    return HashGridHashPcg32(uint((hashKey >> 0) & 0xFFFFFFFF) + HashGridHashPcg32(uint((hashKey >> 32) & 0xFFFFFFFF)));
+}
+#else
 uint HashGridHash32(HashGridKey hashKey)
 {
     return HashGridHashJenkins32(uint((hashKey >> 0) & 0xFFFFFFFF)) ^ HashGridHashJenkins32(uint((hashKey >> 32) & 0xFFFFFFFF));
 }
+#endif
 
 uint HashGridGetBaseSlot(const HashGridKey hashKey, uint capacity)
 {